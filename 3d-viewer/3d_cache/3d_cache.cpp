@@ -24,12 +24,17 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <iterator>
 #include <mutex>
 #include <sstream>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include <wx/datetime.h>
 #include <wx/filename.h>
@@ -63,7 +68,9 @@
 
 #define MASK_3D_CACHE "3D_CACHE"
 
-static std::mutex mutex3D_cache;
+// Size of the read buffer used to compute the SHA1 of the model files
+#define SHA1_READ_BUFFER_SIZE ( 1024 * 1024 )
+
 static std::mutex mutex3D_cacheManager;
 
 
@@ -143,6 +150,9 @@ public:
     std::string   pluginInfo;   // PluginName:Version string
     SCENEGRAPH*   sceneData;
     S3DMODEL*     renderData;
+
+    bool          loadAttempted;    // false until the model file was looked up
+    std::mutex    mutex;            // serializes the loading of this entry
 };
 
 
@@ -150,6 +160,7 @@ S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
     sceneData = NULL;
     renderData = NULL;
+    loadAttempted = false;
     memset( sha1sum, 0, 20 );
 }
 
@@ -174,6 +185,9 @@ void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
     }
 
     memcpy( sha1sum, aSHA1Sum, 20 );
+
+    // the cache file names derive from the hash
+    m_CacheBaseName.clear();
 }
 
 
@@ -213,7 +227,8 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr,
+                             bool aRenderDataOnly )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -228,57 +243,81 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
         return NULL;
     }
 
-    // check cache if file is already loaded
-    std::lock_guard<std::mutex> lock( mutex3D_cache );
-
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
+    S3D_CACHE_ENTRY* ep = NULL;
 
-    if( mi != m_CacheMap.end() )
     {
-        wxFileName fname( full3Dpath );
+        // The cache map is only locked to find or create the entry; the model itself is
+        // loaded under the lock of its entry, so different models can be loaded concurrently
+        std::lock_guard<std::mutex> lock( m_cacheMutex );
 
-        if( fname.FileExists() )    // Only check if file exists. If not, it will
-        {                           // use the same model in cache.
-            bool reload = false;
-            wxDateTime fmdate = fname.GetModificationTime();
+        std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
+        mi = m_CacheMap.find( full3Dpath );
 
-            if( fmdate != mi->second->modTime )
-            {
-                unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
-                mi->second->modTime = fmdate;
+        if( mi != m_CacheMap.end() )
+        {
+            ep = mi->second;
+        }
+        else
+        {
+            ep = new S3D_CACHE_ENTRY;
+            m_CacheList.push_back( ep );
+            m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >( full3Dpath, ep ) );
+        }
+    }
 
-                if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
-                {
-                    mi->second->SetSHA1( hashSum );
-                    reload = true;
-                }
-            }
+    std::lock_guard<std::mutex> entryLock( ep->mutex );
 
-            if( reload )
-            {
-                if( NULL != mi->second->sceneData )
-                {
-                    S3D::DestroyNode( mi->second->sceneData );
-                    mi->second->sceneData = NULL;
-                }
+    if( NULL != aCachePtr )
+        *aCachePtr = ep;
 
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
+    // a cache item was just created; search the Filename->Cachename map
+    if( !ep->loadAttempted )
+    {
+        ep->loadAttempted = true;
+        return checkCache( full3Dpath, ep, aRenderDataOnly );
+    }
 
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
+    wxFileName fname( full3Dpath );
+
+    if( fname.FileExists() )    // Only check if file exists. If not, it will
+    {                           // use the same model in cache.
+        bool reload = false;
+        wxDateTime fmdate = fname.GetModificationTime();
+
+        if( fmdate != ep->modTime )
+        {
+            unsigned char hashSum[20];
+            getSHA1( full3Dpath, hashSum );
+            ep->modTime = fmdate;
+
+            if( !isSHA1Same( hashSum, ep->sha1sum ) )
+            {
+                ep->SetSHA1( hashSum );
+                reload = true;
             }
         }
 
-        if( NULL != aCachePtr )
-            *aCachePtr = mi->second;
+        if( reload )
+        {
+            if( NULL != ep->sceneData )
+            {
+                S3D::DestroyNode( ep->sceneData );
+                ep->sceneData = NULL;
+            }
+
+            if( NULL != ep->renderData )
+                S3D::Destroy3DModel( &ep->renderData );
 
-        return mi->second->sceneData;
+            std::lock_guard<std::mutex> pluginLock( m_pluginMutex );
+            ep->sceneData = m_Plugins->Load3DModel( full3Dpath, ep->pluginInfo );
+        }
     }
 
-    // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    // the entry may only hold the render data read from a render cache file
+    if( !aRenderDataOnly && NULL == ep->sceneData && NULL != ep->renderData )
+        return loadSceneData( full3Dpath, ep );
+
+    return ep->sceneData;
 }
 
 
@@ -288,75 +327,50 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheEntry,
+                                  bool aRenderDataOnly )
 {
-    if( aCachePtr )
-        *aCachePtr = NULL;
-
     unsigned char sha1sum[20];
+    wxFileName fname( aFileName );
+    aCacheEntry->modTime = fname.GetModificationTime();
 
     if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
     {
         // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-        m_CacheList.push_back( ep );
-        wxFileName fname( aFileName );
-        ep->modTime = fname.GetModificationTime();
-
-        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-            ( aFileName, ep ) ).second == false )
-        {
-            wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                        __FILE__, __FUNCTION__, __LINE__, aFileName );
-
-            m_CacheList.pop_back();
-            delete ep;
-        }
-        else
-        {
-            if( aCachePtr )
-                *aCachePtr = ep;
-
-        }
-
+        // or we do not have a configured cache file directory, we keep the entry
+        // without scene data to prevent further attempts at loading the file
         return NULL;
     }
 
-    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-    m_CacheList.push_back( ep );
-    wxFileName fname( aFileName );
-    ep->modTime = fname.GetModificationTime();
+    aCacheEntry->SetSHA1( sha1sum );
 
-    if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-                               ( aFileName, ep ) ).second == false )
-    {
-        wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                    __FILE__, __FUNCTION__, __LINE__, aFileName );
-
-        m_CacheList.pop_back();
-        delete ep;
+    // the render data can be used as is by the renderers, no need for the scene graph
+    if( aRenderDataOnly && loadRenderCacheData( aCacheEntry ) )
         return NULL;
-    }
 
-    if( aCachePtr )
-        *aCachePtr = ep;
+    return loadSceneData( aFileName, aCacheEntry );
+}
 
-    ep->SetSHA1( sha1sum );
 
-    wxString bname = ep->GetCacheBaseName();
+SCENEGRAPH* S3D_CACHE::loadSceneData( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheEntry )
+{
+    wxString bname = aCacheEntry->GetCacheBaseName();
     wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
-    if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
+    if( wxFileName::FileExists( cachename ) && loadCacheData( aCacheEntry ) )
+        return aCacheEntry->sceneData;
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+    // The plugins are not guaranteed to be reentrant (some of them change the process
+    // locale while parsing) and the scene graph node naming used when writing the cache
+    // file is not thread safe either
+    std::lock_guard<std::mutex> pluginLock( m_pluginMutex );
 
-    if( NULL != ep->sceneData )
-        saveCacheData( ep );
+    aCacheEntry->sceneData = m_Plugins->Load3DModel( aFileName, aCacheEntry->pluginInfo );
 
-    return ep->sceneData;
+    if( NULL != aCacheEntry->sceneData )
+        saveCacheData( aCacheEntry );
+
+    return aCacheEntry->sceneData;
 }
 
 
@@ -387,12 +401,16 @@ bool S3D_CACHE::getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
     if( NULL == fp )
         return false;
 
+    // Model files are often several MB large: read them by large blocks, bypassing the
+    // stdio buffer, to avoid thousands of small reads
+    setvbuf( fp, NULL, _IONBF, 0 );
+
     boost::uuids::detail::sha1 dblock;
-    unsigned char block[4096];
+    std::vector<unsigned char> block( SHA1_READ_BUFFER_SIZE );
     size_t bsize = 0;
 
-    while( ( bsize = fread( &block, 1, 4096, fp ) ) > 0 )
-        dblock.process_bytes( block, bsize );
+    while( ( bsize = fread( block.data(), 1, block.size(), fp ) ) > 0 )
+        dblock.process_bytes( block.data(), bsize );
 
     fclose( fp );
     unsigned int digest[5];
@@ -457,6 +475,37 @@ bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
 }
 
 
+bool S3D_CACHE::loadRenderCacheData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dm" );
+
+    if( !wxFileName::FileExists( fname ) )
+        return false;
+
+    if( NULL != aCacheItem->renderData )
+        S3D::Destroy3DModel( &aCacheItem->renderData );
+
+    aCacheItem->renderData = S3D::ReadModelCache( fname.ToUTF8(), m_Plugins, checkTag );
+
+    return NULL != aCacheItem->renderData;
+}
+
+
+bool S3D_CACHE::saveRenderCacheData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( NULL == aCacheItem->renderData || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dm" );
+
+    return S3D::WriteModelCache( fname.ToUTF8(), *aCacheItem->renderData,
+                                 aCacheItem->pluginInfo.c_str() );
+}
+
+
 bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
 {
     if( NULL == aCacheItem )
@@ -598,6 +647,8 @@ bool S3D_CACHE::SetProject( PROJECT* aProject )
 
     if( m_FNResolver->SetProject( aProject, &hasChanged ) && hasChanged )
     {
+        std::lock_guard<std::mutex> lock( m_cacheMutex );
+
         m_CacheMap.clear();
 
         std::list< S3D_CACHE_ENTRY* >::iterator sL = m_CacheList.begin();
@@ -638,6 +689,8 @@ std::list< wxString > const* S3D_CACHE::GetFileFilters() const
 
 void S3D_CACHE::FlushCache( bool closePlugins )
 {
+    std::lock_guard<std::mutex> lock( m_cacheMutex );
+
     std::list< S3D_CACHE_ENTRY* >::iterator sCL = m_CacheList.begin();
     std::list< S3D_CACHE_ENTRY* >::iterator eCL = m_CacheList.end();
 
@@ -665,34 +718,68 @@ void S3D_CACHE::ClosePlugins()
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
 {
     S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
-
-    if( !sp )
-        return NULL;
+    load( aModelFileName, &cp, true );
 
+    // the model cannot be found
     if( !cp )
-    {
-        wxLogTrace( MASK_3D_CACHE,
-                    "%s:%s:%d\n  * [BUG] model loaded with no associated S3D_CACHE_ENTRY",
-                    __FILE__, __FUNCTION__, __LINE__ );
-
         return NULL;
-    }
+
+    std::lock_guard<std::mutex> entryLock( cp->mutex );
 
     if( cp->renderData )
         return cp->renderData;
 
-    S3DMODEL* mp = S3D::GetModel( sp );
+    if( !cp->sceneData )
+        return NULL;
+
+    S3DMODEL* mp = S3D::GetModel( cp->sceneData );
     cp->renderData = mp;
 
+    // next time, the render data will be read from the render cache file
+    if( mp )
+        saveRenderCacheData( cp );
+
     return mp;
 }
 
+
+void S3D_CACHE::LoadModels( const std::vector<wxString>& aModelFileNames )
+{
+    std::vector<wxString> files( aModelFileNames );
+
+    std::sort( files.begin(), files.end() );
+    files.erase( std::unique( files.begin(), files.end() ), files.end() );
+
+    if( files.empty() )
+        return;
+
+    std::atomic<size_t> nextFile( 0 );
+
+    auto load_models = [&]() -> size_t
+    {
+        for( size_t ii = nextFile++; ii < files.size(); ii = nextFile++ )
+            GetModel( files[ii] );
+
+        return 1;
+    };
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), files.size() );
+
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, load_models );
+
+    // Finalize the threads
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii].wait();
+}
+
 void S3D_CACHE::CleanCacheDir( int aNumDaysOld )
 {
     wxDir         dir;
-    wxString      fileSpec = wxT( "*.3dc" );
-    wxArrayString fileList; // Holds list of ".3dc" files found in cache directory
+    wxArrayString fileList; // Holds list of ".3dc" and ".3dm" files found in cache directory
     size_t        numFilesFound = 0;
 
     wxFileName thisFile;
@@ -708,8 +795,10 @@ void S3D_CACHE::CleanCacheDir( int aNumDaysOld )
     {
         thisFile.SetPath( m_CacheDir ); // Set the base path to the cache folder
 
-        // Get a list of all the ".3dc" files in the cache directory
-        numFilesFound = dir.GetAllFiles( m_CacheDir, &fileList, fileSpec );
+        // Get a list of all the ".3dc" and ".3dm" files in the cache directory
+        dir.GetAllFiles( m_CacheDir, &fileList, wxT( "*.3dc" ) );
+        dir.GetAllFiles( m_CacheDir, &fileList, wxT( "*.3dm" ) );
+        numFilesFound = fileList.GetCount();
 
         for( unsigned int i = 0; i < numFilesFound; i++ )
         {
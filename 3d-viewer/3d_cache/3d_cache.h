@@ -34,6 +34,8 @@
 #include "kicad_string.h"
 #include <list>
 #include <map>
+#include <mutex>
+#include <vector>
 #include "plugins/3dapi/c3dmodel.h"
 #include <project.h>
 #include <wx/string.h>
@@ -68,18 +70,27 @@ private:
     wxString            m_CacheDir;
     wxString            m_ConfigDir;       /// base configuration path for 3D items
 
-    /** Find or create cache entry for file name
+    std::mutex          m_cacheMutex;      /// protects m_CacheList and m_CacheMap
+    std::mutex          m_pluginMutex;     /// serializes the calls to the plugins
+
+    /** Fill a new cache entry for file name
      *
-     * Searches the cache list for the given filename and retrieves
-     * the cache data; a cache entry is created if one does not
-     * already exist.
+     * Retrieves the cache data of the given filename from the cache
+     * directory, or loads the model using the plugins and saves it in
+     * the cache directory.  The caller must hold the lock of the entry.
      *
-     * @param[in]   aFileName   file name (full or partial path)
-     * @param[out]  aCachePtr   optional return address for cache entry pointer
+     * @param[in]   aFileName   file name (full path)
+     * @param[in]   aCacheEntry the new cache entry of the file
+     * @param[in]   aRenderDataOnly true to only load the render data when
+     *                          a render cache file exists (returns NULL then)
      * @return      SCENEGRAPH object associated with file name
      * @retval      NULL    on error
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheEntry,
+                            bool aRenderDataOnly );
+
+    // load the scene data of an entry from its cache file or using the plugins
+    SCENEGRAPH* loadSceneData( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheEntry );
 
     /**
      * Function getSHA1
@@ -98,8 +109,16 @@ private:
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
-    // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    // load render data from a render cache file (.3dm)
+    bool loadRenderCacheData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save render data to a render cache file (.3dm)
+    bool saveRenderCacheData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // the real load function (can supply a cache entry pointer to member functions);
+    // with aRenderDataOnly, the scene data is not loaded if the render data is cached
+    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                      bool aRenderDataOnly = false );
 
 public:
     S3D_CACHE();
@@ -177,20 +196,32 @@ public:
     /**
      * Function GetModel
      * attempts to load the scene data for a model and to translate it
-     * into an S3D_MODEL structure for display by a renderer
+     * into an S3D_MODEL structure for display by a renderer. The render
+     * data is saved in a render cache file (.3dm) and read back from it
+     * the next time, without loading the scene data.
      *
      * @param aModelFileName is the full path to the model to be loaded
      * @return is a pointer to the render data or NULL if not available
      */
     S3DMODEL* GetModel( const wxString& aModelFileName );
 
+    /**
+     * Function LoadModels
+     * loads the render data of a list of models, so the next
+     * GetModel() calls for these models return immediately. The unique
+     * models of the list are loaded concurrently.
+     *
+     * @param aModelFileNames is the list of the models to load, may contain duplicates
+     */
+    void LoadModels( const std::vector<wxString>& aModelFileNames );
+
     /**
      * Function Delete up old cache files in cache directory
      *
-     * Deletes ".3dc" files in the cache directory that are older than
-     * "aNumDaysOld".
+     * Deletes ".3dc" and ".3dm" files in the cache directory that are older
+     * than "aNumDaysOld".
      *
-     * @param aNumDaysOld is age threshold to delete ".3dc" cache files
+     * @param aNumDaysOld is age threshold to delete the cache files
      */
     void CleanCacheDir( int aNumDaysOld );
 };
@@ -21,6 +21,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -43,6 +45,18 @@ static char BadNode[] = " * [BUG] NULL pointer passed for aNode\n";
 // version format of the cache file
 #define SG_VERSION_TAG "VERSION:2"
 
+// signature and version of the render data cache file
+#define S3D_MODEL_CACHE_MAGIC "KICAD3DM"
+#define S3D_MODEL_CACHE_VERSION 1
+
+// bits of the SMESH flags stored in the render data cache file
+#define S3D_MODEL_CACHE_HAS_TEXCOORDS 1
+#define S3D_MODEL_CACHE_HAS_COLORS    2
+
+// the render data arrays are written and read as raw float arrays
+static_assert( sizeof( SFVEC2F ) == 2 * sizeof( float ), "SFVEC2F must not be padded" );
+static_assert( sizeof( SFVEC3F ) == 3 * sizeof( float ), "SFVEC3F must not be padded" );
+
 
 static void formatMaterial( SMATERIAL& mat, SGAPPEARANCE const* app )
 {
@@ -468,6 +482,343 @@ SGNODE* S3D::ReadCache( const char* aFileName, void* aPluginMgr,
 }
 
 
+static void writeModelCacheU32( std::ostream& aFile, uint32_t aValue )
+{
+    aFile.write( reinterpret_cast<const char*>( &aValue ), sizeof( aValue ) );
+}
+
+
+static bool readModelCacheU32( std::istream& aFile, uint32_t& aValue )
+{
+    aFile.read( reinterpret_cast<char*>( &aValue ), sizeof( aValue ) );
+    return aFile.good();
+}
+
+
+template <typename T>
+static void writeModelCacheArray( std::ostream& aFile, const T* aArray, size_t aSize )
+{
+    if( aSize )
+        aFile.write( reinterpret_cast<const char*>( aArray ), sizeof( T ) * aSize );
+}
+
+
+template <typename T>
+static T* readModelCacheArray( std::istream& aFile, size_t aSize )
+{
+    if( !aSize )
+        return NULL;
+
+    T* array = new T[aSize];
+    aFile.read( reinterpret_cast<char*>( array ), sizeof( T ) * aSize );
+
+    return array;
+}
+
+
+bool S3D::WriteModelCache( const char* aFileName, const S3DMODEL& aModel,
+        const char* aPluginInfo )
+{
+    if( NULL == aFileName || aFileName[0] == 0 )
+        return false;
+
+    wxString ofile = wxString::FromUTF8Unchecked( aFileName );
+
+    if( wxFileName::Exists( ofile ) && !wxFileName::FileExists( ofile ) )
+    {
+        wxString errmsg;
+        errmsg << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
+        errmsg << " * [INFO] " << "specified path is a directory" << " '";
+        errmsg << aFileName << "'";
+        wxLogTrace( MASK_3D_SG, errmsg );
+        return false;
+    }
+
+    // Several cache entries can save the same model at once (the models are loaded
+    // concurrently): each one writes a file of its own, renamed once complete, so a reader
+    // never sees a partially written file
+    wxFileName ofileName( ofile );
+    wxString   tmpfile = wxFileName::CreateTempFileName( ofileName.GetPathWithSep()
+                                                         + ofileName.GetName() );
+
+    if( tmpfile.empty() )
+    {
+        wxLogTrace( MASK_3D_SG, "%s:%s:%d\n * [INFO] failed to create a file for '%s'",
+                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+        return false;
+    }
+
+    const std::string tmpName( tmpfile.ToUTF8() );
+
+    OPEN_OSTREAM( output, tmpName.c_str() );
+
+    if( output.fail() )
+    {
+        wxString errmsg;
+        errmsg << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
+        errmsg << " * [INFO] " << "failed to open file" << " '" << tmpfile << "'";
+        wxLogTrace( MASK_3D_SG, errmsg );
+        wxRemoveFile( tmpfile );
+        return false;
+    }
+
+    // Header: signature, version, byte order mark and plugin info. The plugin info
+    // string is padded so all the following items stay 4 bytes aligned.
+    std::string pluginInfo = ( NULL != aPluginInfo && aPluginInfo[0] != 0 ) ?
+                             aPluginInfo : "INTERNAL:0.0.0.0";
+
+    output.write( S3D_MODEL_CACHE_MAGIC, 8 );
+    writeModelCacheU32( output, S3D_MODEL_CACHE_VERSION );
+    writeModelCacheU32( output, 0x01020304 );
+    writeModelCacheU32( output, pluginInfo.size() );
+    pluginInfo.resize( ( pluginInfo.size() + 3 ) & ~3, 0 );
+    output.write( pluginInfo.data(), pluginInfo.size() );
+
+    writeModelCacheU32( output, aModel.m_MaterialsSize );
+    writeModelCacheU32( output, aModel.m_MeshesSize );
+
+    for( unsigned int i = 0; i < aModel.m_MaterialsSize; ++i )
+    {
+        const SMATERIAL& mat = aModel.m_Materials[i];
+
+        writeModelCacheArray( output, &mat.m_Ambient, 1 );
+        writeModelCacheArray( output, &mat.m_Diffuse, 1 );
+        writeModelCacheArray( output, &mat.m_Emissive, 1 );
+        writeModelCacheArray( output, &mat.m_Specular, 1 );
+        writeModelCacheArray( output, &mat.m_Shininess, 1 );
+        writeModelCacheArray( output, &mat.m_Transparency, 1 );
+    }
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel.m_Meshes[i];
+        uint32_t     flags = 0;
+
+        if( mesh.m_Texcoords )
+            flags |= S3D_MODEL_CACHE_HAS_TEXCOORDS;
+
+        if( mesh.m_Color )
+            flags |= S3D_MODEL_CACHE_HAS_COLORS;
+
+        writeModelCacheU32( output, mesh.m_VertexSize );
+        writeModelCacheU32( output, mesh.m_FaceIdxSize );
+        writeModelCacheU32( output, mesh.m_MaterialIdx );
+        writeModelCacheU32( output, flags );
+
+        writeModelCacheArray( output, mesh.m_Positions, mesh.m_VertexSize );
+        writeModelCacheArray( output, mesh.m_Normals, mesh.m_VertexSize );
+
+        if( mesh.m_Texcoords )
+            writeModelCacheArray( output, mesh.m_Texcoords, mesh.m_VertexSize );
+
+        if( mesh.m_Color )
+            writeModelCacheArray( output, mesh.m_Color, mesh.m_VertexSize );
+
+        writeModelCacheArray( output, mesh.m_FaceIdx, mesh.m_FaceIdxSize );
+    }
+
+    bool rval = output.good();
+    CLOSE_STREAM( output );
+
+    if( !rval )
+    {
+        wxLogTrace( MASK_3D_SG, "%s:%s:%d\n * [INFO] problems encountered writing cache file '%s'",
+                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+
+        // delete the defective file
+        wxRemoveFile( tmpfile );
+        return false;
+    }
+
+    // The rename can fail if another writer or a reader has the file open: the cache file
+    // is then written by the other writer
+    if( !wxRenameFile( tmpfile, ofile, true ) )
+    {
+        wxLogTrace( MASK_3D_SG, "%s:%s:%d\n * [INFO] could not replace cache file '%s'",
+                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+
+        wxRemoveFile( tmpfile );
+        return false;
+    }
+
+    return true;
+}
+
+
+S3DMODEL* S3D::ReadModelCache( const char* aFileName, void* aPluginMgr,
+        bool (*aTagCheck)( const char*, void* ) )
+{
+    if( NULL == aFileName || aFileName[0] == 0 )
+        return NULL;
+
+    if( !wxFileName::FileExists( wxString::FromUTF8Unchecked( aFileName ) ) )
+        return NULL;
+
+    OPEN_ISTREAM( file, aFileName );
+
+    if( file.fail() )
+    {
+        wxLogTrace( MASK_3D_SG, "%s:%s:%d\n * [INFO] failed to open file '%s'",
+                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+        return NULL;
+    }
+
+    // The counts read from the file are checked against the bytes left, so a truncated or
+    // corrupted file is rejected before anything is allocated for it
+    file.seekg( 0, std::ios_base::end );
+    const uint64_t fileSize = file.good() ? static_cast<uint64_t>( file.tellg() ) : 0;
+    file.seekg( 0, std::ios_base::beg );
+
+    auto bytesLeft =
+            [&]() -> uint64_t
+            {
+                std::streamoff pos = file.tellg();
+
+                if( pos < 0 || static_cast<uint64_t>( pos ) > fileSize )
+                    return 0;
+
+                return fileSize - static_cast<uint64_t>( pos );
+            };
+
+    char     magic[8];
+    uint32_t version = 0;
+    uint32_t byteOrder = 0;
+    uint32_t pluginInfoSize = 0;
+
+    file.read( magic, 8 );
+
+    if( !file.good() || memcmp( magic, S3D_MODEL_CACHE_MAGIC, 8 )
+        || !readModelCacheU32( file, version ) || version != S3D_MODEL_CACHE_VERSION
+        || !readModelCacheU32( file, byteOrder ) || byteOrder != 0x01020304
+        || !readModelCacheU32( file, pluginInfoSize ) || pluginInfoSize > 1024 )
+    {
+        wxLogTrace( MASK_3D_SG, "%s:%s:%d\n * [INFO] invalid or obsolete cache file '%s'",
+                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+        CLOSE_STREAM( file );
+        return NULL;
+    }
+
+    std::string pluginInfo( ( pluginInfoSize + 3 ) & ~3, 0 );
+    file.read( &pluginInfo[0], pluginInfo.size() );
+    pluginInfo.resize( pluginInfoSize );
+
+    // check the plugin tag
+    if( !file.good() || ( NULL != aTagCheck && NULL != aPluginMgr
+                          && !aTagCheck( pluginInfo.c_str(), aPluginMgr ) ) )
+    {
+        CLOSE_STREAM( file );
+        return NULL;
+    }
+
+    uint32_t materialsSize = 0;
+    uint32_t meshesSize = 0;
+
+    // A material is 4 colors and 2 floats, a mesh has at least its 4 counts
+    const uint64_t materialBytes = 4 * sizeof( SFVEC3F ) + 2 * sizeof( float );
+    const uint64_t meshHeaderBytes = 4 * sizeof( uint32_t );
+
+    if( !readModelCacheU32( file, materialsSize ) || !readModelCacheU32( file, meshesSize )
+        || materialsSize * materialBytes + meshesSize * meshHeaderBytes > bytesLeft() )
+    {
+        wxLogTrace( MASK_3D_SG, "%s:%s:%d\n * [INFO] invalid cache file '%s'",
+                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+        CLOSE_STREAM( file );
+        return NULL;
+    }
+
+    S3DMODEL* model = S3D::New3DModel();
+
+    model->m_MaterialsSize = materialsSize;
+    model->m_Materials = materialsSize ? new SMATERIAL[materialsSize] : NULL;
+
+    for( unsigned int i = 0; i < materialsSize; ++i )
+    {
+        SMATERIAL& mat = model->m_Materials[i];
+
+        file.read( reinterpret_cast<char*>( &mat.m_Ambient ), sizeof( SFVEC3F ) );
+        file.read( reinterpret_cast<char*>( &mat.m_Diffuse ), sizeof( SFVEC3F ) );
+        file.read( reinterpret_cast<char*>( &mat.m_Emissive ), sizeof( SFVEC3F ) );
+        file.read( reinterpret_cast<char*>( &mat.m_Specular ), sizeof( SFVEC3F ) );
+        file.read( reinterpret_cast<char*>( &mat.m_Shininess ), sizeof( float ) );
+        file.read( reinterpret_cast<char*>( &mat.m_Transparency ), sizeof( float ) );
+    }
+
+    model->m_MeshesSize = meshesSize;
+    model->m_Meshes = meshesSize ? new SMESH[meshesSize] : NULL;
+
+    for( unsigned int i = 0; i < meshesSize; ++i )
+        S3D::INIT_SMESH( model->m_Meshes[i] );
+
+    // The arrays are read straight into the render data, without any parsing
+    for( unsigned int i = 0; i < meshesSize && file.good(); ++i )
+    {
+        SMESH&   mesh = model->m_Meshes[i];
+        uint32_t vertexSize = 0;
+        uint32_t faceIdxSize = 0;
+        uint32_t materialIdx = 0;
+        uint32_t flags = 0;
+
+        if( !readModelCacheU32( file, vertexSize ) || !readModelCacheU32( file, faceIdxSize )
+            || !readModelCacheU32( file, materialIdx ) || !readModelCacheU32( file, flags )
+            || ( materialIdx >= materialsSize ) || ( faceIdxSize % 3 ) != 0 )
+        {
+            file.setstate( std::ios_base::failbit );
+            break;
+        }
+
+        uint64_t vertexBytes = 2 * sizeof( SFVEC3F );
+
+        if( flags & S3D_MODEL_CACHE_HAS_TEXCOORDS )
+            vertexBytes += sizeof( SFVEC2F );
+
+        if( flags & S3D_MODEL_CACHE_HAS_COLORS )
+            vertexBytes += sizeof( SFVEC3F );
+
+        if( uint64_t( vertexSize ) * vertexBytes
+                    + uint64_t( faceIdxSize ) * sizeof( unsigned int ) > bytesLeft() )
+        {
+            file.setstate( std::ios_base::failbit );
+            break;
+        }
+
+        mesh.m_VertexSize = vertexSize;
+        mesh.m_FaceIdxSize = faceIdxSize;
+        mesh.m_MaterialIdx = materialIdx;
+        mesh.m_Positions = readModelCacheArray<SFVEC3F>( file, vertexSize );
+        mesh.m_Normals = readModelCacheArray<SFVEC3F>( file, vertexSize );
+
+        if( flags & S3D_MODEL_CACHE_HAS_TEXCOORDS )
+            mesh.m_Texcoords = readModelCacheArray<SFVEC2F>( file, vertexSize );
+
+        if( flags & S3D_MODEL_CACHE_HAS_COLORS )
+            mesh.m_Color = readModelCacheArray<SFVEC3F>( file, vertexSize );
+
+        mesh.m_FaceIdx = readModelCacheArray<unsigned int>( file, faceIdxSize );
+
+        // The renderers index the vertex arrays with the face indices
+        for( uint32_t j = 0; j < faceIdxSize && file.good(); ++j )
+        {
+            if( mesh.m_FaceIdx[j] >= vertexSize )
+                file.setstate( std::ios_base::failbit );
+        }
+    }
+
+    bool rval = file.good();
+    CLOSE_STREAM( file );
+
+    if( !rval )
+    {
+        wxLogTrace( MASK_3D_SG, "%s:%s:%d\n * [INFO] problems encountered reading cache file '%s'",
+                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+
+        S3D::Destroy3DModel( &model );
+        return NULL;
+    }
+
+    return model;
+}
+
+
 S3DMODEL* S3D::GetModel( SCENEGRAPH* aNode )
 {
     if( NULL == aNode )
@@ -92,6 +92,9 @@ BOARD_ADAPTER::BOARD_ADAPTER() :
     m_calc_seg_min_factor3DU = 0.0f;
     m_calc_seg_max_factor3DU = 0.0f;
 
+    m_layersDirty = LSET::AllLayersMask();
+    m_layersBuildCount = 0;
+
     SetFlag( FL_USE_REALISTIC_MODE, true );
     SetFlag( FL_MODULE_ATTRIBUTES_NORMAL, true );
     SetFlag( FL_SHOW_BOARD_BODY, true );
@@ -150,6 +150,36 @@ class BOARD_ADAPTER
      */
     void InitSettings( REPORTER* aStatusReporter, REPORTER* aWarningReporter );
 
+    /**
+     * @brief SetLayersDirty - Mark layers as changed, so the next InitSettings() call
+     * rebuilds them. Layers not marked keep the objects built previously, as long as
+     * the board and the settings used to build the layers did not change.
+     * @param aLayers: the layers to rebuild (all layers to rebuild everything)
+     */
+    void SetLayersDirty( const LSET& aLayers ) noexcept
+    {
+        m_layersDirty |= aLayers;
+    }
+
+    /**
+     * @brief GetRebuiltLayers - Get the layers rebuilt by the last InitSettings() call
+     * @return all the layers if everything was rebuilt
+     */
+    const LSET& GetRebuiltLayers() const noexcept
+    {
+        return m_layersRebuilt;
+    }
+
+    /**
+     * @brief GetLayersBuildCount - Get the number of times the layers were built, so
+     * a render can know if the layers were built since its own last reload
+     * @return the number of calls to InitSettings()
+     */
+    unsigned int GetLayersBuildCount() const noexcept
+    {
+        return m_layersBuildCount;
+    }
+
     /**
      * @brief BiuTo3Dunits - Board integer units To 3D units
      * @return the conversion factor to transform a position from the board to 3d units
@@ -566,7 +596,29 @@ class BOARD_ADAPTER
      */
     bool createBoardPolygon( wxString* aErrorMsg );
     void createLayers( REPORTER* aStatusReporter );
-    void destroyLayers();
+    void destroyLayers( const LSET& aLayers = LSET::AllLayersMask() );
+
+    /**
+     * Create the holes and the plated pads, shared by all the copper layers.
+     */
+    void createCopperHoles( const std::vector<const TRACK*>& aTrackList,
+                            const std::vector<PCB_LAYER_ID>& aCopperLayers );
+
+    /**
+     * Create the objects and the contours of a copper layer.
+     * Only uses aDstContainer and aDstPoly, so several layers can be created in parallel.
+     *
+     * @param aDstPoly can be null if the contours are not needed
+     */
+    void createCopperLayer( PCB_LAYER_ID aLayerId, const std::vector<const TRACK*>& aTrackList,
+                            CBVHCONTAINER2D* aDstContainer, SHAPE_POLY_SET* aDstPoly );
+
+    /**
+     * Create the objects and the contours of a technical layer.
+     * Only uses aDstContainer and aDstPoly, so several layers can be created in parallel.
+     */
+    void createTechLayer( PCB_LAYER_ID aLayerId, CBVHCONTAINER2D* aDstContainer,
+                          SHAPE_POLY_SET* aDstPoly );
 
     // Helper functions to create the board
      void createNewTrack( const TRACK* aTrack, CGENERICCONTAINER2D *aDstContainer,
@@ -791,6 +843,43 @@ private:
     float m_calc_seg_max_factor3DU;
 
 
+    // Layers rebuild
+
+    /// The settings the layers objects depend on: when one of them changes, all the
+    /// layers are rebuilt
+    struct LAYERS_BUILD_SETTINGS
+    {
+        const BOARD*      m_board = nullptr;
+        double            m_biuTo3Dunits = 0.0;
+        float             m_epoxyThickness3DU = 0.0f;
+        unsigned int      m_copperLayersCount = 0;
+        std::vector<bool> m_drawFlags;
+        RENDER_ENGINE     m_renderEngine = RENDER_ENGINE::OPENGL_LEGACY;
+        LSET              m_enabledLayers;
+
+        bool operator==( const LAYERS_BUILD_SETTINGS& aOther ) const
+        {
+            return m_board == aOther.m_board && m_biuTo3Dunits == aOther.m_biuTo3Dunits
+                   && m_epoxyThickness3DU == aOther.m_epoxyThickness3DU
+                   && m_copperLayersCount == aOther.m_copperLayersCount
+                   && m_drawFlags == aOther.m_drawFlags && m_renderEngine == aOther.m_renderEngine
+                   && m_enabledLayers == aOther.m_enabledLayers;
+        }
+    };
+
+    /// Settings used by the last layers build
+    LAYERS_BUILD_SETTINGS m_layersBuildSettings;
+
+    /// Layers changed since the last layers build, see SetLayersDirty()
+    LSET         m_layersDirty;
+
+    /// Layers rebuilt by the last layers build
+    LSET         m_layersRebuilt;
+
+    /// Number of layers builds
+    unsigned int m_layersBuildCount;
+
+
     // Statistics
 
     /// Number of tracks in the board
@@ -49,34 +49,32 @@
 #include <geometry/shape_circle.h>
 #include <geometry/shape_rect.h>
 #include <geometry/shape_simple.h>
-#include <gr_text.h>
 #include <utility>
 #include <vector>
 
 
-// These variables are parameters used in addTextSegmToContainer.
-// But addTextSegmToContainer is a call-back function,
-// so we cannot send them as arguments.
-static int s_textWidth;
-static CGENERICCONTAINER2D *s_dstcontainer = NULL;
-static float s_biuTo3Dunits;
-static const BOARD_ITEM *s_boardItem = NULL;
-
-// This is a call back function, used by GRText to draw the 3D text shape:
-void addTextSegmToContainer( int x0, int y0, int xf, int yf, void* aData )
+// Add the segments of a text shape to a container.  The segments come from the shape
+// cache of the text, see EDA_TEXT::TransformTextShapeToSegmentList().
+static void addTextSegmentsToContainer( const std::vector<wxPoint>& aSegments, int aTextWidth,
+                                        float aBiuTo3Dunits, const BOARD_ITEM& aBoardItem,
+                                        CGENERICCONTAINER2D* aDstContainer )
 {
-    const SFVEC2F start3DU( x0 * s_biuTo3Dunits, -y0 * s_biuTo3Dunits );
-    const SFVEC2F end3DU  ( xf * s_biuTo3Dunits, -yf * s_biuTo3Dunits );
+    for( size_t ii = 0; ii + 1 < aSegments.size(); ii += 2 )
+    {
+        const SFVEC2F start3DU( aSegments[ii].x * aBiuTo3Dunits,
+                                -aSegments[ii].y * aBiuTo3Dunits );
+        const SFVEC2F end3DU  ( aSegments[ii + 1].x * aBiuTo3Dunits,
+                                -aSegments[ii + 1].y * aBiuTo3Dunits );
 
-    if( Is_segment_a_circle( start3DU, end3DU ) )
-        s_dstcontainer->Add( new CFILLEDCIRCLE2D( start3DU,
-                                                  ( s_textWidth / 2 ) * s_biuTo3Dunits,
-                                                  *s_boardItem) );
-    else
-        s_dstcontainer->Add( new CROUNDSEGMENT2D( start3DU,
-                                                  end3DU,
-                                                  s_textWidth * s_biuTo3Dunits,
-                                                  *s_boardItem ) );
+        if( Is_segment_a_circle( start3DU, end3DU ) )
+            aDstContainer->Add( new CFILLEDCIRCLE2D( start3DU,
+                                                     ( aTextWidth / 2 ) * aBiuTo3Dunits,
+                                                     aBoardItem ) );
+        else
+            aDstContainer->Add( new CROUNDSEGMENT2D( start3DU, end3DU,
+                                                     aTextWidth * aBiuTo3Dunits,
+                                                     aBoardItem ) );
+    }
 }
 
 
@@ -88,44 +86,14 @@ void BOARD_ADAPTER::AddShapeWithClearanceToContainer( const TEXTE_PCB* aText,
                                                       PCB_LAYER_ID aLayerId,
                                                       int aClearanceValue )
 {
-    wxSize size = aText->GetTextSize();
-
-    if( aText->IsMirrored() )
-        size.x = -size.x;
+    std::vector<wxPoint> segments;
+    int                  penWidth = 0;      // force max width for bold
 
-    s_boardItem    = (const BOARD_ITEM *) &aText;
-    s_dstcontainer = aDstContainer;
-    s_textWidth    = aText->GetEffectiveTextPenWidth() + ( 2 * aClearanceValue );
-    s_biuTo3Dunits = m_biuTo3Dunits;
+    aText->TransformTextShapeToSegmentList( segments, aText->GetTextAngle(), penWidth );
 
-    // not actually used, but needed by GRText
-    const COLOR4D dummy_color = COLOR4D::BLACK;
-    bool          forceBold = true;
-    int           penWidth = 0;         // force max width for bold
-
-    if( aText->IsMultilineAllowed() )
-    {
-        wxArrayString strings_list;
-        wxStringSplit( aText->GetShownText(), strings_list, '\n' );
-        std::vector<wxPoint> positions;
-        positions.reserve( strings_list.Count() );
-        aText->GetLinePositions( positions, strings_list.Count());
-
-        for( unsigned ii = 0; ii < strings_list.Count(); ++ii )
-        {
-            wxString txt = strings_list.Item( ii );
-
-            GRText( nullptr, positions[ii], dummy_color, txt, aText->GetTextAngle(), size,
-                    aText->GetHorizJustify(), aText->GetVertJustify(), penWidth,
-                    aText->IsItalic(), forceBold, addTextSegmToContainer );
-        }
-    }
-    else
-    {
-        GRText( nullptr, aText->GetTextPos(), dummy_color, aText->GetShownText(),
-                aText->GetTextAngle(), size, aText->GetHorizJustify(), aText->GetVertJustify(),
-                penWidth, aText->IsItalic(), forceBold, addTextSegmToContainer );
-    }
+    addTextSegmentsToContainer( segments,
+                                aText->GetEffectiveTextPenWidth() + ( 2 * aClearanceValue ),
+                                m_biuTo3Dunits, *aText, aDstContainer );
 }
 
 
@@ -232,23 +200,16 @@ void BOARD_ADAPTER::AddGraphicsShapesWithClearanceToContainer( const MODULE* aMo
     if( aModule->Value().GetLayer() == aLayerId && aModule->Value().IsVisible() )
         texts.push_back( &aModule->Value() );
 
-    s_boardItem    = (const BOARD_ITEM *)&aModule->Value();
-    s_dstcontainer = aDstContainer;
-    s_biuTo3Dunits = m_biuTo3Dunits;
-
     for( TEXTE_MODULE* text : texts )
     {
-        s_textWidth = text->GetEffectiveTextPenWidth() + ( 2 * aInflateValue );
-        wxSize size = text->GetTextSize();
-        bool   forceBold = true;
-        int    penWidth = 0;        // force max width for bold
+        std::vector<wxPoint> segments;
+        int                  penWidth = 0;      // force max width for bold
 
-        if( text->IsMirrored() )
-            size.x = -size.x;
+        text->TransformTextShapeToSegmentList( segments, text->GetDrawRotation(), penWidth );
 
-        GRText( NULL, text->GetTextPos(), BLACK, text->GetShownText(), text->GetDrawRotation(),
-                size, text->GetHorizJustify(), text->GetVertJustify(), penWidth, text->IsItalic(),
-                forceBold, addTextSegmToContainer );
+        addTextSegmentsToContainer( segments,
+                                    text->GetEffectiveTextPenWidth() + ( 2 * aInflateValue ),
+                                    m_biuTo3Dunits, aModule->Value(), aDstContainer );
     }
 }
 
@@ -47,24 +47,48 @@
 #include <thread>
 #include <algorithm>
 #include <atomic>
+#include <future>
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
 #include <profile.h>
 #endif
 
 
-void BOARD_ADAPTER::destroyLayers()
+/**
+ * Delete the items of \a aMap built for one of \a aLayers.
+ */
+template <class MAP>
+static void destroyLayersFromMap( MAP& aMap, const LSET& aLayers )
 {
-    if( !m_layers_poly.empty() )
+    for( auto it = aMap.begin(); it != aMap.end(); )
     {
-        for( auto& poly : m_layers_poly )
-            delete poly.second;
-
-        m_layers_poly.clear();
+        if( aLayers.test( it->first ) )
+        {
+            delete it->second;
+            it = aMap.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
     }
+}
+
+
+void BOARD_ADAPTER::destroyLayers( const LSET& aLayers )
+{
+    destroyLayersFromMap( m_layers_poly, aLayers );
+    destroyLayersFromMap( m_layers_container2D, aLayers );
+
+    // Holes and plated pads are shared by all the copper layers
+    if( ( aLayers & LSET::AllCuMask() ).none() )
+        return;
 
     delete m_F_Cu_PlatedPads_poly;
+    m_F_Cu_PlatedPads_poly = nullptr;
+
     delete m_B_Cu_PlatedPads_poly;
+    m_B_Cu_PlatedPads_poly = nullptr;
 
     if( !m_layers_inner_holes_poly.empty() )
     {
@@ -82,16 +106,11 @@ void BOARD_ADAPTER::destroyLayers()
         m_layers_outer_holes_poly.clear();
     }
 
-    if( !m_layers_container2D.empty() )
-    {
-        for( auto& poly : m_layers_container2D )
-            delete poly.second;
-
-        m_layers_container2D.clear();
-    }
-
     delete m_platedpads_container2D_F_Cu;
+    m_platedpads_container2D_F_Cu = nullptr;
+
     delete m_platedpads_container2D_B_Cu;
+    m_platedpads_container2D_B_Cu = nullptr;
 
     if( !m_layers_holes2D.empty() )
     {
@@ -117,7 +136,40 @@ void BOARD_ADAPTER::destroyLayers()
 
 void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
 {
-    destroyLayers();
+    LAYERS_BUILD_SETTINGS buildSettings;
+
+    buildSettings.m_board             = m_board;
+    buildSettings.m_biuTo3Dunits      = m_biuTo3Dunits;
+    buildSettings.m_epoxyThickness3DU = m_epoxyThickness3DU;
+    buildSettings.m_copperLayersCount = m_copperLayersCount;
+    buildSettings.m_drawFlags         = m_drawFlags;
+    buildSettings.m_renderEngine      = m_render_engine;
+
+    for( int layer = 0; layer < PCB_LAYER_ID_COUNT; ++layer )
+    {
+        if( Is3DLayerEnabled( ToLAYER_ID( layer ) ) )
+            buildSettings.m_enabledLayers.set( layer );
+    }
+
+    // Only rebuild the layers marked as changed, unless something used by all the
+    // layers has changed
+    LSET dirtyLayers = m_layersDirty;
+
+    if( !( buildSettings == m_layersBuildSettings ) )
+        dirtyLayers = LSET::AllLayersMask();
+
+    m_layersBuildSettings = buildSettings;
+    m_layersDirty.reset();
+    m_layersRebuilt = dirtyLayers;
+    m_layersBuildCount++;
+
+    destroyLayers( dirtyLayers );
+
+    // The holes and plated pads are shared by all the copper layers
+    const bool rebuildCopper = ( dirtyLayers & LSET::AllCuMask() ).any();
+
+    const bool copperThickness = GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
+                                 && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY );
 
     // Build Copper layers
     // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L692
@@ -132,49 +184,7 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
     PCB_LAYER_ID cu_seq[MAX_CU_LAYERS];
     LSET         cu_set = LSET::AllCuMask( m_copperLayersCount );
 
-    m_stats_nr_tracks               = 0;
-    m_stats_track_med_width         = 0;
-    m_stats_nr_vias                 = 0;
-    m_stats_via_med_hole_diameter   = 0;
-    m_stats_nr_holes                = 0;
-    m_stats_hole_med_diameter       = 0;
-
-    // Prepare track list, convert in a vector. Calc statistic for the holes
-    // /////////////////////////////////////////////////////////////////////////
-    std::vector< const TRACK *> trackList;
-    trackList.clear();
-    trackList.reserve( m_board->Tracks().size() );
-
-    for( TRACK* track : m_board->Tracks() )
-    {
-        if( !Is3DLayerEnabled( track->GetLayer() ) ) // Skip non enabled layers
-            continue;
-
-        // Note: a TRACK holds normal segment tracks and
-        // also vias circles (that have also drill values)
-        trackList.push_back( track );
-
-        if( track->Type() == PCB_VIA_T )
-        {
-            const VIA *via = static_cast< const VIA*>( track );
-            m_stats_nr_vias++;
-            m_stats_via_med_hole_diameter += via->GetDrillValue() * m_biuTo3Dunits;
-        }
-        else
-        {
-            m_stats_nr_tracks++;
-        }
-
-        m_stats_track_med_width += track->GetWidth() * m_biuTo3Dunits;
-    }
-
-    if( m_stats_nr_tracks )
-        m_stats_track_med_width /= (float)m_stats_nr_tracks;
-
-    if( m_stats_nr_vias )
-        m_stats_via_med_hole_diameter /= (float)m_stats_nr_vias;
-
-    // Prepare copper layers index and containers
+    // Prepare copper layers index
     // /////////////////////////////////////////////////////////////////////////
     std::vector< PCB_LAYER_ID > layer_id;
     layer_id.clear();
@@ -191,42 +201,93 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
             continue;
 
         layer_id.push_back( curr_layer_id );
+    }
+
+    // Prepare track list, convert in a vector. Calc statistic for the holes
+    // /////////////////////////////////////////////////////////////////////////
+    std::vector< const TRACK *> trackList;
+
+    if( rebuildCopper )
+    {
+        m_stats_nr_tracks               = 0;
+        m_stats_track_med_width         = 0;
+        m_stats_nr_vias                 = 0;
+        m_stats_via_med_hole_diameter   = 0;
+        m_stats_nr_holes                = 0;
+        m_stats_hole_med_diameter       = 0;
 
-        CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
-        m_layers_container2D[curr_layer_id] = layerContainer;
+        trackList.reserve( m_board->Tracks().size() );
 
-        if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-                && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+        for( TRACK* track : m_board->Tracks() )
         {
-            SHAPE_POLY_SET* layerPoly    = new SHAPE_POLY_SET;
-            m_layers_poly[curr_layer_id] = layerPoly;
+            if( !Is3DLayerEnabled( track->GetLayer() ) ) // Skip non enabled layers
+                continue;
+
+            // Note: a TRACK holds normal segment tracks and
+            // also vias circles (that have also drill values)
+            trackList.push_back( track );
+
+            if( track->Type() == PCB_VIA_T )
+            {
+                const VIA *via = static_cast< const VIA*>( track );
+                m_stats_nr_vias++;
+                m_stats_via_med_hole_diameter += via->GetDrillValue() * m_biuTo3Dunits;
+            }
+            else
+            {
+                m_stats_nr_tracks++;
+            }
+
+            m_stats_track_med_width += track->GetWidth() * m_biuTo3Dunits;
         }
-    }
 
-    m_F_Cu_PlatedPads_poly = new SHAPE_POLY_SET;
-    m_B_Cu_PlatedPads_poly = new SHAPE_POLY_SET;
+        if( m_stats_nr_tracks )
+            m_stats_track_med_width /= (float)m_stats_nr_tracks;
 
-    m_platedpads_container2D_F_Cu = new CBVHCONTAINER2D;
-    m_platedpads_container2D_B_Cu = new CBVHCONTAINER2D;
+        if( m_stats_nr_vias )
+            m_stats_via_med_hole_diameter /= (float)m_stats_nr_vias;
 
-    if( aStatusReporter )
-        aStatusReporter->Report( _( "Create tracks and vias" ) );
+        if( aStatusReporter )
+            aStatusReporter->Report( _( "Create tracks and vias" ) );
 
-    // Create tracks as objects and add it to container
+        createCopperHoles( trackList, layer_id );
+    }
+
+    // Prepare the layers to build.  Each layer is built from its own container and
+    // polygon set, so the layers can be built in parallel.
     // /////////////////////////////////////////////////////////////////////////
+    struct LAYER_TO_BUILD
+    {
+        PCB_LAYER_ID               m_layer;
+        std::vector<const TRACK*>  m_tracks;     // copper layers only
+        CBVHCONTAINER2D*           m_container;
+        SHAPE_POLY_SET*            m_poly;
+    };
+
+    std::vector<LAYER_TO_BUILD> layersToBuild;
+
     for( PCB_LAYER_ID curr_layer_id : layer_id )
     {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
+        if( !dirtyLayers.test( curr_layer_id ) )
+            continue;
 
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
+        LAYER_TO_BUILD layer;
 
-        // Add track segments shapes and via annulus shapes
-        unsigned int nTracks = trackList.size();
+        layer.m_layer     = curr_layer_id;
+        layer.m_container = new CBVHCONTAINER2D;
+        layer.m_poly      = nullptr;
+        m_layers_container2D[curr_layer_id] = layer.m_container;
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
+        if( copperThickness )
         {
-            const TRACK *track = trackList[trackIdx];
+            layer.m_poly = new SHAPE_POLY_SET;
+            m_layers_poly[curr_layer_id] = layer.m_poly;
+        }
 
+        // Select the tracks and vias annulus of this layer here: the via test
+        // uses the board connectivity, which is not made to be used by several threads
+        for( const TRACK* track : trackList )
+        {
             // NOTE: Vias can be on multiple layers
             if( !track->IsOnLayer( curr_layer_id ) )
                 continue;
@@ -237,21 +298,126 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
             if( via && !via->IsPadOnLayer( curr_layer_id ) && IsCopperLayer( curr_layer_id ) )
                 continue;
 
-            // Add object item to layer container
-            createNewTrack( track, layerContainer, 0.0f );
+            layer.m_tracks.push_back( track );
         }
+
+        layersToBuild.push_back( std::move( layer ) );
+    }
+
+    // draw graphic items, on technical layers
+    static const PCB_LAYER_ID teckLayerList[] = {
+            B_Adhes,
+            F_Adhes,
+            B_Paste,
+            F_Paste,
+            B_SilkS,
+            F_SilkS,
+            B_Mask,
+            F_Mask,
+
+            // Aux Layers
+            Dwgs_User,
+            Cmts_User,
+            Eco1_User,
+            Eco2_User,
+            Edge_Cuts,
+            Margin
+        };
+
+    // User layers are not drawn here, only technical layers
+    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
+         seq;
+         ++seq )
+    {
+        const PCB_LAYER_ID curr_layer_id = *seq;
+
+        if( !Is3DLayerEnabled( curr_layer_id ) || !dirtyLayers.test( curr_layer_id ) )
+            continue;
+
+        LAYER_TO_BUILD layer;
+
+        layer.m_layer     = curr_layer_id;
+        layer.m_container = new CBVHCONTAINER2D;
+        layer.m_poly      = new SHAPE_POLY_SET;
+        m_layers_container2D[curr_layer_id] = layer.m_container;
+        m_layers_poly[curr_layer_id] = layer.m_poly;
+
+        layersToBuild.push_back( std::move( layer ) );
+    }
+
+    // Pads build their shapes on demand: build them now, not from the worker threads
+    for( MODULE* module : m_board->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+            pad->GetEffectiveShape();
+    }
+
+    // Build the layers
+    // /////////////////////////////////////////////////////////////////////////
+    if( !layersToBuild.empty() )
+    {
+        std::atomic<size_t> nextLayer( 0 );
+
+        size_t parallelThreadCount = std::min<size_t>(
+                std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
+                layersToBuild.size() );
+
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        // The texts are converted by GRText(), which locks the shared basic_gal
+        auto build_layers = [&]() -> size_t
+        {
+            for( size_t ii = nextLayer++; ii < layersToBuild.size(); ii = nextLayer++ )
+            {
+                const LAYER_TO_BUILD& layer = layersToBuild[ii];
+
+                if( IsCopperLayer( layer.m_layer ) )
+                    createCopperLayer( layer.m_layer, layer.m_tracks, layer.m_container,
+                                       layer.m_poly );
+                else
+                    createTechLayer( layer.m_layer, layer.m_container, layer.m_poly );
+            }
+
+            return 1;
+        };
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, build_layers );
+
+        // Finalize the threads
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
     }
 
+    // We only need the Solder mask to initialize the BVH
+    // because..?
+    if( dirtyLayers.test( B_Mask ) && m_layers_container2D[B_Mask] )
+        m_layers_container2D[B_Mask]->BuildBVH();
+
+    if( dirtyLayers.test( F_Mask ) && m_layers_container2D[F_Mask] )
+        m_layers_container2D[F_Mask]->BuildBVH();
+}
+
+
+void BOARD_ADAPTER::createCopperHoles( const std::vector<const TRACK*>& aTrackList,
+                                       const std::vector<PCB_LAYER_ID>& aCopperLayers )
+{
+    m_F_Cu_PlatedPads_poly = new SHAPE_POLY_SET;
+    m_B_Cu_PlatedPads_poly = new SHAPE_POLY_SET;
+
+    m_platedpads_container2D_F_Cu = new CBVHCONTAINER2D;
+    m_platedpads_container2D_B_Cu = new CBVHCONTAINER2D;
+
     // Create VIAS and THTs objects and add it to holes containers
     // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    for( PCB_LAYER_ID curr_layer_id : aCopperLayers )
     {
         // ADD TRACKS
-        unsigned int nTracks = trackList.size();
+        unsigned int nTracks = aTrackList.size();
 
         for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
         {
-            const TRACK *track = trackList[trackIdx];
+            const TRACK *track = aTrackList[trackIdx];
 
             if( !track->IsOnLayer( curr_layer_id ) )
                 continue;
@@ -295,7 +461,7 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
                                                                   hole_inner_radius + thickness,
                                                                   *track ) );
                 }
-                else if( curr_layer_id == layer_id[0] ) // it only adds once the THT holes
+                else if( curr_layer_id == aCopperLayers[0] ) // it only adds once the THT holes
                 {
                     // Add through hole object
                     // /////////////////////////////////////////////////////////
@@ -329,14 +495,14 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
 
     // Create VIAS and THTs objects and add it to holes containers
     // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    for( PCB_LAYER_ID curr_layer_id : aCopperLayers )
     {
         // ADD TRACKS
-        const unsigned int nTracks = trackList.size();
+        const unsigned int nTracks = aTrackList.size();
 
         for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
         {
-            const TRACK *track = trackList[trackIdx];
+            const TRACK *track = aTrackList[trackIdx];
 
             if( !track->IsOnLayer( curr_layer_id ) )
                 continue;
@@ -389,7 +555,7 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
                     TransformCircleToPolygon( *layerInnerHolesPoly, via->GetStart(),
                             holediameter / 2, ARC_HIGH_DEF );
                 }
-                else if( curr_layer_id == layer_id[0] ) // it only adds once the THT holes
+                else if( curr_layer_id == aCopperLayers[0] ) // it only adds once the THT holes
                 {
                     const int holediameter = via->GetDrillValue();
                     const int hole_outer_radius = (holediameter / 2)+ GetCopperThicknessBIU();
@@ -415,39 +581,6 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
         }
     }
 
-    // Creates vertical outline contours of the tracks and add it to the poly of the layer
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        for( PCB_LAYER_ID curr_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD TRACKS
-            unsigned int nTracks = trackList.size();
-
-            for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-            {
-                const TRACK *track = trackList[trackIdx];
-
-                if( !track->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                // Skip vias annulus when not connected on this layer (if removing is enabled)
-                const VIA *via = dyn_cast< const VIA*>( track );
-
-                if( via && !via->IsPadOnLayer( curr_layer_id ) && IsCopperLayer( curr_layer_id ) )
-                    continue;
-
-                // Add the track/via contour
-                track->TransformShapeWithClearanceToPolygon( *layerPoly, curr_layer_id, 0 );
-            }
-        }
-    }
-
     // Add holes of modules
     // /////////////////////////////////////////////////////////////////////////
     for( MODULE* module : m_board->Modules() )
@@ -508,34 +641,6 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
         }
     }
 
-    // Add modules PADs objects to containers
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
-    {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD PADS
-        for( MODULE* module : m_board->Modules() )
-        {
-            // Note: NPTH pads are not drawn on copper layers when the pad
-            // has same shape as its hole
-            AddPadsShapesWithClearanceToContainer( module,
-                                                   layerContainer,
-                                                   curr_layer_id,
-                                                   0,
-                                                   true,
-                                                   true,
-                                                   false );
-
-            // Micro-wave modules may have items on copper layers
-            AddGraphicsShapesWithClearanceToContainer( module,
-                                                       layerContainer,
-                                                       curr_layer_id,
-                                                       0 );
-        }
-    }
-
     // ADD PLATED PADS
     for( MODULE* module : m_board->Modules() )
     {
@@ -556,30 +661,10 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
                                                true );
     }
 
-    // Add modules PADs poly contourns (vertical outlines)
+    // ADD PLATED PADS contourns
     if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
             && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
     {
-        for( PCB_LAYER_ID curr_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // Add pads to polygon list
-            for( auto module : m_board->Modules() )
-            {
-                // Note: NPTH pads are not drawn on copper layers when the pad
-                // has same shape as its hole
-                module->TransformPadsShapesWithClearanceToPolygon( curr_layer_id, *layerPoly,
-                                                                   0, ARC_HIGH_DEF, true,
-                                                                   true, false );
-
-                transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-            }
-        }
-
-        // ADD PLATED PADS contourns
         for( auto module : m_board->Modules() )
         {
             module->TransformPadsShapesWithClearanceToPolygon( F_Cu, *m_F_Cu_PlatedPads_poly,
@@ -594,462 +679,309 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
 
             //transformGraphicModuleEdgeToPolygonSet( module, B_Cu, *m_B_Cu_PlatedPads_poly );
         }
-    }
 
+        m_F_Cu_PlatedPads_poly->Simplify( SHAPE_POLY_SET::PM_FAST );
+        m_B_Cu_PlatedPads_poly->Simplify( SHAPE_POLY_SET::PM_FAST );
+    }
 
-    // Add graphic item on copper layers to object containers
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    // Simplify holes polygon contours
+    // /////////////////////////////////////////////////////////////////////////
+    for( PCB_LAYER_ID layer : aCopperLayers )
     {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // Add graphic items on copper layers (texts and other graphics)
-        for( auto item : m_board->Drawings() )
+        if( m_layers_outer_holes_poly.find( layer ) != m_layers_outer_holes_poly.end() )
         {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-            {
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            }
-            break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
+            // found
+            SHAPE_POLY_SET *polyLayer = m_layers_outer_holes_poly[layer];
+            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
 
-            case PCB_DIM_ALIGNED_T:
-            case PCB_DIM_CENTER_T:
-            case PCB_DIM_ORTHOGONAL_T:
-            case PCB_DIM_LEADER_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
+            wxASSERT( m_layers_inner_holes_poly.find( layer ) != m_layers_inner_holes_poly.end() );
 
-            default:
-                wxLogTrace( m_logTrace,
-                            wxT( "createLayers: item type: %d not implemented" ),
-                            item->Type() );
-            break;
-            }
+            polyLayer = m_layers_inner_holes_poly[layer];
+            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
         }
     }
 
-    // Add graphic item on copper layers to poly contourns (vertical outlines)
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+    // This will make a union of all added contourns
+    m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
+    m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST );
+    m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
+    m_through_outer_ring_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+    // Build BVH (Bounding volume hierarchy) for holes and vias
+    m_through_holes_inner.BuildBVH();
+    m_through_holes_outer.BuildBVH();
+    m_through_holes_outer_ring.BuildBVH();
+
+    if( !m_layers_holes2D.empty() )
     {
-        for( PCB_LAYER_ID cur_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( cur_layer_id ) != m_layers_poly.end() );
+        for( auto& hole : m_layers_holes2D)
+            hole.second->BuildBVH();
+    }
+}
 
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[cur_layer_id];
 
-            // Add graphic items on copper layers (texts and other )
-            for( BOARD_ITEM* item : m_board->Drawings() )
-            {
-                if( !item->IsOnLayer( cur_layer_id ) )
-                    continue;
+void BOARD_ADAPTER::createCopperLayer( PCB_LAYER_ID aLayerId,
+                                       const std::vector<const TRACK*>& aTrackList,
+                                       CBVHCONTAINER2D* aDstContainer, SHAPE_POLY_SET* aDstPoly )
+{
+    // Add track segments shapes and via annulus shapes, and their vertical outline contours
+    for( const TRACK* track : aTrackList )
+    {
+        createNewTrack( track, aDstContainer, 0 );
 
-                switch( item->Type() )
-                {
-                case PCB_LINE_T:
-                    ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly,
-                                                                                   cur_layer_id, 0 );
-                    break;
-
-                case PCB_TEXT_T:
-                    ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
-                    break;
-
-                default:
-                    wxLogTrace( m_logTrace, wxT( "createLayers: item type: %d not implemented" ),
-                                item->Type() );
-                    break;
-                }
-            }
-        }
+        if( aDstPoly )
+            track->TransformShapeWithClearanceToPolygon( *aDstPoly, aLayerId, 0 );
     }
 
-    if( GetFlag( FL_ZONE ) )
+    // Add modules PADs objects and poly contourns (vertical outlines)
+    for( MODULE* module : m_board->Modules() )
     {
-        if( aStatusReporter )
-            aStatusReporter->Report( _( "Create zones" ) );
+        // Note: NPTH pads are not drawn on copper layers when the pad
+        // has same shape as its hole
+        AddPadsShapesWithClearanceToContainer( module,
+                                               aDstContainer,
+                                               aLayerId,
+                                               0,
+                                               true,
+                                               true,
+                                               false );
 
-        std::vector<std::pair<const ZONE_CONTAINER*, PCB_LAYER_ID>> zones;
+        // Micro-wave modules may have items on copper layers
+        AddGraphicsShapesWithClearanceToContainer( module,
+                                                   aDstContainer,
+                                                   aLayerId,
+                                                   0 );
 
-        for( ZONE_CONTAINER* zone : m_board->Zones() )
+        if( aDstPoly )
         {
-            for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
-                zones.emplace_back( std::make_pair( zone, layer ) );
+            module->TransformPadsShapesWithClearanceToPolygon( aLayerId, *aDstPoly,
+                                                               0, ARC_HIGH_DEF, true,
+                                                               true, false );
+
+            transformGraphicModuleEdgeToPolygonSet( module, aLayerId, *aDstPoly );
         }
+    }
 
-        // Add zones objects
-        // /////////////////////////////////////////////////////////////////////
-        std::atomic<size_t> nextZone( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
+    // Add graphic items on copper layers (texts and other graphics)
+    for( BOARD_ITEM* item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        switch( item->Type() )
         {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t areaId = nextZone.fetch_add( 1 );
-                            areaId < zones.size();
-                            areaId = nextZone.fetch_add( 1 ) )
-                {
-                    const ZONE_CONTAINER* zone = zones[areaId].first;
-
-                    if( zone == nullptr )
-                        break;
-
-                    PCB_LAYER_ID layer = zones[areaId].second;
+        case PCB_LINE_T:
+            AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                              aDstContainer,
+                                              aLayerId,
+                                              0 );
+
+            if( aDstPoly )
+                ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *aDstPoly,
+                                                                               aLayerId, 0 );
+            break;
 
-                    auto layerContainer = m_layers_container2D.find( layer );
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
+                                              aDstContainer,
+                                              aLayerId,
+                                              0 );
 
-                    if( layerContainer != m_layers_container2D.end() )
-                        AddSolidAreasShapesToContainer( zone, layerContainer->second, layer );
-                }
+            if( aDstPoly )
+                ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *aDstPoly, 0 );
+            break;
 
-                threadsFinished++;
-            } );
+        case PCB_DIM_ALIGNED_T:
+        case PCB_DIM_CENTER_T:
+        case PCB_DIM_ORTHOGONAL_T:
+        case PCB_DIM_LEADER_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                              aDstContainer,
+                                              aLayerId,
+                                              0 );
+            break;
 
-            t.detach();
+        default:
+            wxLogTrace( m_logTrace,
+                        wxT( "createLayers: item type: %d not implemented" ),
+                        item->Type() );
+            break;
         }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-
     }
 
-    if( GetFlag( FL_ZONE ) && GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+    // Add zones objects and poly contourns
+    if( GetFlag( FL_ZONE ) )
     {
-        // Add copper zones
         for( ZONE_CONTAINER* zone : m_board->Zones() )
         {
-            if( zone == nullptr )
-                break;
+            if( !zone->IsOnLayer( aLayerId ) )
+                continue;
 
-            for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
-            {
-                auto layerContainer = m_layers_poly.find( layer );
+            AddSolidAreasShapesToContainer( zone, aDstContainer, aLayerId );
 
-                if( layerContainer != m_layers_poly.end() )
-                    zone->TransformSolidAreasShapesToPolygon( layer, *layerContainer->second );
-            }
+            if( aDstPoly )
+                zone->TransformSolidAreasShapesToPolygon( aLayerId, *aDstPoly );
         }
     }
 
-    // Simplify layer polygons
-
-    if( aStatusReporter )
-        aStatusReporter->Report( _( "Simplifying copper layers polygons" ) );
+    if( !aDstPoly )
+        return;
 
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+    // Simplify layer polygons
+    if( aLayerId == F_Cu && m_F_Cu_PlatedPads_poly )
     {
-        if( m_F_Cu_PlatedPads_poly && ( m_layers_poly.find( F_Cu ) != m_layers_poly.end() ) )
-        {
-            SHAPE_POLY_SET *layerPoly_F_Cu = m_layers_poly[F_Cu];
-            layerPoly_F_Cu->BooleanSubtract( *m_F_Cu_PlatedPads_poly, SHAPE_POLY_SET::POLYGON_MODE::PM_FAST );
-
-            m_F_Cu_PlatedPads_poly->Simplify( SHAPE_POLY_SET::PM_FAST );
-        }
-
-        if( m_B_Cu_PlatedPads_poly && ( m_layers_poly.find( B_Cu ) != m_layers_poly.end() ) )
-        {
-            SHAPE_POLY_SET *layerPoly_B_Cu = m_layers_poly[B_Cu];
-            layerPoly_B_Cu->BooleanSubtract( *m_B_Cu_PlatedPads_poly, SHAPE_POLY_SET::POLYGON_MODE::PM_FAST );
-
-            m_B_Cu_PlatedPads_poly->Simplify( SHAPE_POLY_SET::PM_FAST );
-        }
+        aDstPoly->BooleanSubtract( *m_F_Cu_PlatedPads_poly,
+                                   SHAPE_POLY_SET::POLYGON_MODE::PM_FAST );
+    }
+    else if( aLayerId == B_Cu && m_B_Cu_PlatedPads_poly )
+    {
+        aDstPoly->BooleanSubtract( *m_B_Cu_PlatedPads_poly,
+                                   SHAPE_POLY_SET::POLYGON_MODE::PM_FAST );
+    }
+    else
+    {
+        // This will make a union of all added contours
+        aDstPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+    }
+}
 
-        std::vector< PCB_LAYER_ID > layer_id_without_F_and_B;
-        layer_id_without_F_and_B.clear();
-        layer_id_without_F_and_B.reserve( layer_id.size() );
 
-        for( size_t i = 0; i < layer_id.size(); ++i )
-        {
-            if( ( layer_id[i] != F_Cu ) &&
-                ( layer_id[i] != B_Cu ) )
-                layer_id_without_F_and_B.push_back( layer_id[i] );
-        }
+void BOARD_ADAPTER::createTechLayer( PCB_LAYER_ID aLayerId, CBVHCONTAINER2D* aDstContainer,
+                                     SHAPE_POLY_SET* aDstPoly )
+{
+    // Add drawing objects
+    for( BOARD_ITEM* item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
 
-        if( layer_id_without_F_and_B.size() > 0 )
+        switch( item->Type() )
         {
-            std::atomic<size_t> nextItem( 0 );
-            std::atomic<size_t> threadsFinished( 0 );
-
-            size_t parallelThreadCount = std::min<size_t>(
-                    std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-                    layer_id_without_F_and_B.size() );
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            {
-                std::thread t = std::thread( [&nextItem, &threadsFinished, &layer_id_without_F_and_B, this]()
-                {
-                    for( size_t i = nextItem.fetch_add( 1 );
-                                i < layer_id_without_F_and_B.size();
-                                i = nextItem.fetch_add( 1 ) )
-                    {
-                        auto layerPoly = m_layers_poly.find( layer_id_without_F_and_B[i] );
-
-                        if( layerPoly != m_layers_poly.end() )
-                            // This will make a union of all added contours
-                            layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
-                    }
+        case PCB_LINE_T:
+            AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                              aDstContainer,
+                                              aLayerId,
+                                              0 );
+            break;
 
-                    threadsFinished++;
-                } );
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
+                                              aDstContainer,
+                                              aLayerId,
+                                              0 );
+            break;
 
-                t.detach();
-            }
+        case PCB_DIM_ALIGNED_T:
+        case PCB_DIM_CENTER_T:
+        case PCB_DIM_ORTHOGONAL_T:
+        case PCB_DIM_LEADER_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                              aDstContainer,
+                                              aLayerId,
+                                              0 );
+            break;
 
-            while( threadsFinished < parallelThreadCount )
-                std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        default:
+            break;
         }
     }
 
-    // Simplify holes polygon contours
-    // /////////////////////////////////////////////////////////////////////////
-    if( aStatusReporter )
-        aStatusReporter->Report( _( "Simplify holes contours" ) );
 
-    for( PCB_LAYER_ID layer : layer_id )
+    // Add drawing contours
+    for( BOARD_ITEM* item : m_board->Drawings() )
     {
-        if( m_layers_outer_holes_poly.find( layer ) != m_layers_outer_holes_poly.end() )
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        switch( item->Type() )
         {
-            // found
-            SHAPE_POLY_SET *polyLayer = m_layers_outer_holes_poly[layer];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+        case PCB_LINE_T:
+            ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *aDstPoly,
+                                                                           aLayerId, 0 );
+            break;
 
-            wxASSERT( m_layers_inner_holes_poly.find( layer ) != m_layers_inner_holes_poly.end() );
+        case PCB_TEXT_T:
+            ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *aDstPoly, 0 );
+            break;
 
-            polyLayer = m_layers_inner_holes_poly[layer];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+        default:
+            break;
         }
     }
 
-    // End Build Copper layers
 
-    // This will make a union of all added contourns
-    m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_ring_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-
-    // Build Tech layers
-    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L1059
-    // /////////////////////////////////////////////////////////////////////////
-    if( aStatusReporter )
-        aStatusReporter->Report( _( "Build Tech layers" ) );
-
-    // draw graphic items, on technical layers
-    static const PCB_LAYER_ID teckLayerList[] = {
-            B_Adhes,
-            F_Adhes,
-            B_Paste,
-            F_Paste,
-            B_SilkS,
-            F_SilkS,
-            B_Mask,
-            F_Mask,
-
-            // Aux Layers
-            Dwgs_User,
-            Cmts_User,
-            Eco1_User,
-            Eco2_User,
-            Edge_Cuts,
-            Margin
-        };
-
-    // User layers are not drawn here, only technical layers
-    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
-         seq;
-         ++seq )
+    // Add modules tech layers - objects
+    // /////////////////////////////////////////////////////////////////////
+    for( MODULE* module : m_board->Modules() )
     {
-        const PCB_LAYER_ID curr_layer_id = *seq;
-
-        if( !Is3DLayerEnabled( curr_layer_id ) )
-            continue;
-
-        CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
-        m_layers_container2D[curr_layer_id] = layerContainer;
-
-        SHAPE_POLY_SET *layerPoly = new SHAPE_POLY_SET;
-        m_layers_poly[curr_layer_id] = layerPoly;
-
-        // Add drawing objects
-        for( BOARD_ITEM* item : m_board->Drawings() )
+        if( (aLayerId == F_SilkS) || (aLayerId == B_SilkS) )
         {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
+            int     linewidth = g_DrawDefaultLineThickness;
 
-            switch( item->Type() )
+            for( D_PAD* pad : module->Pads() )
             {
-            case PCB_LINE_T:
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_DIM_ALIGNED_T:
-            case PCB_DIM_CENTER_T:
-            case PCB_DIM_ORTHOGONAL_T:
-            case PCB_DIM_LEADER_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            default:
-                break;
+                if( !pad->IsOnLayer( aLayerId ) )
+                    continue;
+
+                buildPadShapeThickOutlineAsSegments( pad, aDstContainer, linewidth );
             }
         }
-
-
-        // Add drawing contours
-        for( BOARD_ITEM* item : m_board->Drawings() )
+        else
         {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-                ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly,
-                                                                               curr_layer_id, 0 );
-                break;
-
-            case PCB_TEXT_T:
-                ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
-                break;
-
-            default:
-                break;
-            }
+            AddPadsShapesWithClearanceToContainer( module, aDstContainer, aLayerId, 0,
+                                                   false,
+                                                   false,
+                                                   false );
         }
 
+        AddGraphicsShapesWithClearanceToContainer( module, aDstContainer, aLayerId, 0 );
+    }
 
-        // Add modules tech layers - objects
-        // /////////////////////////////////////////////////////////////////////
-        for( MODULE* module : m_board->Modules() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                int     linewidth = g_DrawDefaultLineThickness;
 
-                for( D_PAD* pad : module->Pads() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
+    // Add modules tech layers - contours
+    for( MODULE* module : m_board->Modules() )
+    {
+        if( (aLayerId == F_SilkS) || (aLayerId == B_SilkS) )
+        {
+            const int linewidth = g_DrawDefaultLineThickness;
 
-                    buildPadShapeThickOutlineAsSegments( pad, layerContainer, linewidth );
-                }
-            }
-            else
+            for( D_PAD* pad : module->Pads() )
             {
-                AddPadsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0,
-                                                       false,
-                                                       false,
-                                                       false );
-            }
+                if( !pad->IsOnLayer( aLayerId ) )
+                    continue;
 
-            AddGraphicsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0 );
+                buildPadShapeThickOutlineAsPolygon( pad, *aDstPoly, linewidth );
+            }
         }
-
-
-        // Add modules tech layers - contours
-        for( MODULE* module : m_board->Modules() )
+        else
         {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                const int linewidth = g_DrawDefaultLineThickness;
+            module->TransformPadsShapesWithClearanceToPolygon( aLayerId, *aDstPoly, 0 );
+        }
 
-                for( D_PAD* pad : module->Pads() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
+        // On tech layers, use a poor circle approximation, only for texts (stroke font)
+        module->TransformGraphicTextWithClearanceToPolygonSet( aLayerId, *aDstPoly, 0 );
 
-                    buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
-                }
-            }
-            else
-            {
-                module->TransformPadsShapesWithClearanceToPolygon( curr_layer_id, *layerPoly, 0 );
-            }
+        // Add the remaining things with dynamic seg count for circles
+        transformGraphicModuleEdgeToPolygonSet( module, aLayerId, *aDstPoly );
+    }
 
-            // On tech layers, use a poor circle approximation, only for texts (stroke font)
-            module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id, *layerPoly, 0 );
 
-            // Add the remaining things with dynamic seg count for circles
-            transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
+    // Draw non copper zones
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
+        {
+            if( zone->IsOnLayer( aLayerId ) )
+                AddSolidAreasShapesToContainer( zone, aDstContainer, aLayerId );
         }
 
-
-        // Draw non copper zones
-        if( GetFlag( FL_ZONE ) )
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
         {
-            for( ZONE_CONTAINER* zone : m_board->Zones() )
-            {
-                if( zone->IsOnLayer( curr_layer_id ) )
-                    AddSolidAreasShapesToContainer( zone, layerContainer, curr_layer_id );
-            }
-
-            for( ZONE_CONTAINER* zone : m_board->Zones() )
-            {
-                if( zone->IsOnLayer( curr_layer_id ) )
-                    zone->TransformSolidAreasShapesToPolygon( curr_layer_id, *layerPoly );
-            }
+            if( zone->IsOnLayer( aLayerId ) )
+                zone->TransformSolidAreasShapesToPolygon( aLayerId, *aDstPoly );
         }
-
-        // This will make a union of all added contours
-        layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
     }
-    // End Build Tech layers
-
-    // Build BVH (Bounding volume hierarchy) for holes and vias
 
-    if( aStatusReporter )
-        aStatusReporter->Report( _( "Build BVH for holes and vias" ) );
-
-    m_through_holes_inner.BuildBVH();
-    m_through_holes_outer.BuildBVH();
-    m_through_holes_outer_ring.BuildBVH();
-
-    if( !m_layers_holes2D.empty() )
-    {
-        for( auto& hole : m_layers_holes2D)
-            hole.second->BuildBVH();
-    }
-
-    // We only need the Solder mask to initialize the BVH
-    // because..?
-    if( m_layers_container2D[B_Mask] )
-        m_layers_container2D[B_Mask]->BuildBVH();
-
-    if( m_layers_container2D[F_Mask] )
-        m_layers_container2D[F_Mask]->BuildBVH();
+    // This will make a union of all added contours
+    aDstPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
 }
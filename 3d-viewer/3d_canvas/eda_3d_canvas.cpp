@@ -292,7 +292,8 @@ void EDA_3D_CANVAS::GetScreenshot( wxImage &aDstImage )
 }
 
 
-void EDA_3D_CANVAS::ReloadRequest( BOARD *aBoard , S3D_CACHE *aCachePointer )
+void EDA_3D_CANVAS::ReloadRequest( BOARD *aBoard , S3D_CACHE *aCachePointer,
+                                   const LSET& aDirtyLayers )
 {
     if( aCachePointer != NULL )
         m_boardAdapter.Set3DCacheManager( aCachePointer );
@@ -303,7 +304,7 @@ void EDA_3D_CANVAS::ReloadRequest( BOARD *aBoard , S3D_CACHE *aCachePointer )
     m_boardAdapter.SetColorSettings( Pgm().GetSettingsManager().GetColorSettings() );
 
     if( m_3d_render )
-        m_3d_render->ReloadRequest();
+        m_3d_render->ReloadRequest( aDirtyLayers );
 }
 
 
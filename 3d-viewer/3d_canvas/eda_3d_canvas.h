@@ -78,7 +78,13 @@ class EDA_3D_CANVAS : public HIDPI_GL_CANVAS
         m_parentInfoBar = aInfoBar;
     }
 
-    void ReloadRequest( BOARD *aBoard = NULL, S3D_CACHE *aCachePointer = NULL );
+    /**
+     * @brief ReloadRequest - Request to rebuild the 3D scene at the next redraw
+     * @param aDirtyLayers: the layers whose items have changed since the last request,
+     * so only these layers have to be rebuilt
+     */
+    void ReloadRequest( BOARD *aBoard = NULL, S3D_CACHE *aCachePointer = NULL,
+                        const LSET& aDirtyLayers = LSET::AllLayersMask() );
 
     /**
      * @brief IsReloadRequestPending - Query if there is a pending reload request
@@ -356,9 +356,6 @@ CLAYERS_OGL_DISP_LISTS* C3D_RENDER_OGL_LEGACY::generateLayerListFromContainer( c
 
     CLAYER_TRIANGLES *layerTriangles = new CLAYER_TRIANGLES( nrTrianglesEstimation );
 
-    // store in a list so it will be latter deleted
-    m_triangles.push_back( layerTriangles );
-
     // Load the 2D (X,Y axis) component of shapes
     for( LIST_OBJECT2D::const_iterator itemOnLayer = listObject2d.begin();
          itemOnLayer != listObject2d.end();
@@ -405,10 +402,17 @@ CLAYERS_OGL_DISP_LISTS* C3D_RENDER_OGL_LEGACY::generateLayerListFromContainer( c
                                                   m_boardAdapter.BiuTo3Dunits(), false );
     // Create display list
     // /////////////////////////////////////////////////////////////////////
-    return new CLAYERS_OGL_DISP_LISTS( *layerTriangles,
-                                       m_ogl_circle_texture,
-                                       layer_z_bot,
-                                       layer_z_top );
+    CLAYERS_OGL_DISP_LISTS* layerDispList = new CLAYERS_OGL_DISP_LISTS( *layerTriangles,
+                                                                        m_ogl_circle_texture,
+                                                                        layer_z_bot,
+                                                                        layer_z_top );
+
+    // The triangles are no more needed once stored in the display list. Deleting them
+    // here (and not at the next full reload) keeps the memory bounded when only a few
+    // layers are rebuilt at each reload.
+    delete layerTriangles;
+
+    return layerDispList;
 }
 
 
@@ -416,14 +420,29 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusReporter, REPORTER* aWarnin
 {
     m_reloadRequested = false;
 
-    ogl_free_all_display_lists();
-
     COBJECT2D_STATS::Instance().ResetStats();
 
     unsigned stats_startReloadTime = GetRunningMicroSecs();
 
     m_boardAdapter.InitSettings( aStatusReporter, aWarningReporter );
 
+    // The display lists of the layers the board adapter did not rebuild can be kept,
+    // if they were generated from the previous build of the layers.
+    const LSET rebuiltLayers = m_boardAdapter.GetRebuiltLayers();
+    const bool partialReload = ( m_ogl_disp_list_board != nullptr )
+                               && ( m_boardAdapter.GetLayersBuildCount()
+                                    == m_lastLayersBuildCount + 1 )
+                               && ( rebuiltLayers != LSET::AllLayersMask() );
+
+    m_lastLayersBuildCount = m_boardAdapter.GetLayersBuildCount();
+
+    if( partialReload )
+        ogl_free_layers_display_lists( rebuiltLayers );
+    else
+        ogl_free_all_display_lists();
+
+    const bool reloadCopper = !partialReload || ( rebuiltLayers & LSET::AllCuMask() ).any();
+
     SFVEC3F camera_pos = m_boardAdapter.GetBoardCenter3DU();
     m_camera.SetBoardLookAtPos( camera_pos );
 
@@ -499,95 +518,99 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusReporter, REPORTER* aWarnin
     // Create Through Holes and vias
     // /////////////////////////////////////////////////////////////////////////
 
-    if( aStatusReporter )
-        aStatusReporter->Report( _( "Load OpenGL: holes and vias" ) );
-
-    m_ogl_disp_list_through_holes_outer = generate_holes_display_list(
-            m_boardAdapter.GetThroughHole_Outer().GetList(),
-            m_boardAdapter.GetThroughHole_Outer_poly(),
-            1.0f,
-            0.0f,
-            false );
-
-    SHAPE_POLY_SET bodyHoles = m_boardAdapter.GetThroughHole_Outer_poly();
-
-    bodyHoles.BooleanAdd( m_boardAdapter.GetThroughHole_Outer_poly_NPTH(),
-                          SHAPE_POLY_SET::PM_FAST );
-
-    m_ogl_disp_list_through_holes_outer_with_npth = generate_holes_display_list(
-            m_boardAdapter.GetThroughHole_Outer().GetList(),
-            bodyHoles,
-            1.0f,
-            0.0f,
-            false );
-
-    m_ogl_disp_list_through_holes_vias_outer = generate_holes_display_list(
-            m_boardAdapter.GetThroughHole_Vias_Outer().GetList(),
-            m_boardAdapter.GetThroughHole_Vias_Outer_poly(),
-            1.0f,
-            0.0f,
-            false );
-
-    if( m_boardAdapter.GetFlag( FL_CLIP_SILK_ON_VIA_ANNULUS ) )
+    // They only depend on the copper layers
+    if( reloadCopper )
     {
-        m_ogl_disp_list_through_holes_vias_outer_ring = generate_holes_display_list(
-                m_boardAdapter.GetThroughHole_Vias_Outer_Ring().GetList(),
-                m_boardAdapter.GetThroughHole_Vias_Outer_Ring_poly(),
+        if( aStatusReporter )
+            aStatusReporter->Report( _( "Load OpenGL: holes and vias" ) );
+
+        m_ogl_disp_list_through_holes_outer = generate_holes_display_list(
+                m_boardAdapter.GetThroughHole_Outer().GetList(),
+                m_boardAdapter.GetThroughHole_Outer_poly(),
                 1.0f,
                 0.0f,
                 false );
-    }
-
-    // Not in use
-    //m_ogl_disp_list_through_holes_vias_inner = generate_holes_display_list(
-    //      m_boardAdapter.GetThroughHole_Vias_Inner().GetList(),
-    //      m_boardAdapter.GetThroughHole_Vias_Inner_poly(),
-    //      1.0f, 0.0f,
-    //      false );
 
-    const MAP_POLY & innerMapHoles = m_boardAdapter.GetPolyMapHoles_Inner();
-    const MAP_POLY & outerMapHoles = m_boardAdapter.GetPolyMapHoles_Outer();
+        SHAPE_POLY_SET bodyHoles = m_boardAdapter.GetThroughHole_Outer_poly();
 
-    wxASSERT( innerMapHoles.size() == outerMapHoles.size() );
+        bodyHoles.BooleanAdd( m_boardAdapter.GetThroughHole_Outer_poly_NPTH(),
+                              SHAPE_POLY_SET::PM_FAST );
 
-    const MAP_CONTAINER_2D &map_holes = m_boardAdapter.GetMapLayersHoles();
+        m_ogl_disp_list_through_holes_outer_with_npth = generate_holes_display_list(
+                m_boardAdapter.GetThroughHole_Outer().GetList(),
+                bodyHoles,
+                1.0f,
+                0.0f,
+                false );
 
-    if( outerMapHoles.size() > 0 )
-    {
-        float layer_z_bot = 0.0f;
-        float layer_z_top = 0.0f;
+        m_ogl_disp_list_through_holes_vias_outer = generate_holes_display_list(
+                m_boardAdapter.GetThroughHole_Vias_Outer().GetList(),
+                m_boardAdapter.GetThroughHole_Vias_Outer_poly(),
+                1.0f,
+                0.0f,
+                false );
 
-        for( MAP_POLY::const_iterator ii = outerMapHoles.begin();
-             ii != outerMapHoles.end();
-             ++ii )
+        if( m_boardAdapter.GetFlag( FL_CLIP_SILK_ON_VIA_ANNULUS ) )
         {
-            PCB_LAYER_ID layer_id = static_cast<PCB_LAYER_ID>(ii->first);
-            const SHAPE_POLY_SET *poly = static_cast<const SHAPE_POLY_SET *>(ii->second);
-            const CBVHCONTAINER2D *container = map_holes.at( layer_id );
+            m_ogl_disp_list_through_holes_vias_outer_ring = generate_holes_display_list(
+                    m_boardAdapter.GetThroughHole_Vias_Outer_Ring().GetList(),
+                    m_boardAdapter.GetThroughHole_Vias_Outer_Ring_poly(),
+                    1.0f,
+                    0.0f,
+                    false );
+        }
 
-            get_layer_z_pos( layer_id, layer_z_top, layer_z_bot );
+        // Not in use
+        //m_ogl_disp_list_through_holes_vias_inner = generate_holes_display_list(
+        //      m_boardAdapter.GetThroughHole_Vias_Inner().GetList(),
+        //      m_boardAdapter.GetThroughHole_Vias_Inner_poly(),
+        //      1.0f, 0.0f,
+        //      false );
 
-            m_ogl_disp_lists_layers_holes_outer[layer_id] = generate_holes_display_list(
-                        container->GetList(), *poly, layer_z_top, layer_z_bot, false );
-        }
+        const MAP_POLY & innerMapHoles = m_boardAdapter.GetPolyMapHoles_Inner();
+        const MAP_POLY & outerMapHoles = m_boardAdapter.GetPolyMapHoles_Outer();
 
-        for( MAP_POLY::const_iterator ii = innerMapHoles.begin();
-             ii != innerMapHoles.end();
-             ++ii )
+        wxASSERT( innerMapHoles.size() == outerMapHoles.size() );
+
+        const MAP_CONTAINER_2D &map_holes = m_boardAdapter.GetMapLayersHoles();
+
+        if( outerMapHoles.size() > 0 )
         {
-            PCB_LAYER_ID layer_id = static_cast<PCB_LAYER_ID>(ii->first);
-            const SHAPE_POLY_SET *poly = static_cast<const SHAPE_POLY_SET *>(ii->second);
-            const CBVHCONTAINER2D *container = map_holes.at( layer_id );
+            float layer_z_bot = 0.0f;
+            float layer_z_top = 0.0f;
+
+            for( MAP_POLY::const_iterator ii = outerMapHoles.begin();
+                 ii != outerMapHoles.end();
+                 ++ii )
+            {
+                PCB_LAYER_ID layer_id = static_cast<PCB_LAYER_ID>(ii->first);
+                const SHAPE_POLY_SET *poly = static_cast<const SHAPE_POLY_SET *>(ii->second);
+                const CBVHCONTAINER2D *container = map_holes.at( layer_id );
+
+                get_layer_z_pos( layer_id, layer_z_top, layer_z_bot );
+
+                m_ogl_disp_lists_layers_holes_outer[layer_id] = generate_holes_display_list(
+                            container->GetList(), *poly, layer_z_top, layer_z_bot, false );
+            }
+
+            for( MAP_POLY::const_iterator ii = innerMapHoles.begin();
+                 ii != innerMapHoles.end();
+                 ++ii )
+            {
+                PCB_LAYER_ID layer_id = static_cast<PCB_LAYER_ID>(ii->first);
+                const SHAPE_POLY_SET *poly = static_cast<const SHAPE_POLY_SET *>(ii->second);
+                const CBVHCONTAINER2D *container = map_holes.at( layer_id );
 
-            get_layer_z_pos( layer_id, layer_z_top, layer_z_bot );
+                get_layer_z_pos( layer_id, layer_z_top, layer_z_bot );
 
-            m_ogl_disp_lists_layers_holes_inner[layer_id] = generate_holes_display_list(
-                        container->GetList(), *poly, layer_z_top, layer_z_bot, false );
+                m_ogl_disp_lists_layers_holes_inner[layer_id] = generate_holes_display_list(
+                            container->GetList(), *poly, layer_z_top, layer_z_bot, false );
+            }
         }
-    }
 
-    // Generate vertical cylinders of vias and pads (copper)
-    generate_3D_Vias_and_Pads();
+        // Generate vertical cylinders of vias and pads (copper)
+        generate_3D_Vias_and_Pads();
+    }
 
     // Add layers maps
 
@@ -605,6 +628,10 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusReporter, REPORTER* aWarnin
         if( !m_boardAdapter.Is3DLayerEnabled( layer_id ) )
             continue;
 
+        // Kept from the previous reload
+        if( m_ogl_disp_lists_layers.find( layer_id ) != m_ogl_disp_lists_layers.end() )
+            continue;
+
         const CBVHCONTAINER2D *container2d = static_cast<const CBVHCONTAINER2D *>(ii->second);
 
         // Load the vertical (Z axis) component of shapes
@@ -622,10 +649,13 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER* aStatusReporter, REPORTER* aWarnin
 
     }// for each layer on
 
-    m_ogl_disp_lists_platedPads_F_Cu = generateLayerListFromContainer( m_boardAdapter.GetPlatedPads_Front(),
-                                                                       m_boardAdapter.GetPolyPlatedPads_Front(), F_Cu );
-    m_ogl_disp_lists_platedPads_B_Cu = generateLayerListFromContainer( m_boardAdapter.GetPlatedPads_Back(),
-                                                                       m_boardAdapter.GetPolyPlatedPads_Back(), B_Cu );
+    if( reloadCopper )
+    {
+        m_ogl_disp_lists_platedPads_F_Cu = generateLayerListFromContainer( m_boardAdapter.GetPlatedPads_Front(),
+                                                                           m_boardAdapter.GetPolyPlatedPads_Front(), F_Cu );
+        m_ogl_disp_lists_platedPads_B_Cu = generateLayerListFromContainer( m_boardAdapter.GetPlatedPads_Back(),
+                                                                           m_boardAdapter.GetPolyPlatedPads_Back(), B_Cu );
+    }
 
     // Load 3D models
     // /////////////////////////////////////////////////////////////////////////
@@ -884,6 +914,24 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER* aStatusReporter )
        (!m_boardAdapter.GetFlag( FL_MODULE_ATTRIBUTES_VIRTUAL )) )
         return;
 
+    // Load the models not already in memory concurrently, the loop below will then get
+    // them from the cache
+    std::vector<wxString> modelFiles;
+
+    for( MODULE* module : m_boardAdapter.GetBoard()->Modules() )
+    {
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( model.m_Show && !model.m_Filename.empty()
+                && m_3dmodel_map.find( model.m_Filename ) == m_3dmodel_map.end() )
+            {
+                modelFiles.push_back( model.m_Filename );
+            }
+        }
+    }
+
+    m_boardAdapter.Get3DCacheManager()->LoadModels( modelFiles );
+
     // Go for all modules
     for( MODULE* module : m_boardAdapter.GetBoard()->Modules() )
     {
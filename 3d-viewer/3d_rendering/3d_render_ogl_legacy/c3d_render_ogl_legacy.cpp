@@ -57,7 +57,6 @@ C3D_RENDER_OGL_LEGACY::C3D_RENDER_OGL_LEGACY( BOARD_ADAPTER& aAdapter, CCAMERA&
     m_ogl_disp_lists_layers.clear();
     m_ogl_disp_lists_layers_holes_outer.clear();
     m_ogl_disp_lists_layers_holes_inner.clear();
-    m_triangles.clear();
     m_ogl_disp_list_board = NULL;
 
     m_ogl_disp_lists_platedPads_F_Cu = nullptr;
@@ -77,6 +76,8 @@ C3D_RENDER_OGL_LEGACY::C3D_RENDER_OGL_LEGACY( BOARD_ADAPTER& aAdapter, CCAMERA&
     m_last_grid_type     = GRID3D_TYPE::NONE;
 
     m_3dmodel_map.clear();
+
+    m_lastLayersBuildCount = 0;
 }
 
 
@@ -1071,18 +1072,49 @@ void C3D_RENDER_OGL_LEGACY::ogl_free_all_display_lists()
 
     m_ogl_disp_list_grid = 0;
 
-    for( MAP_OGL_DISP_LISTS::const_iterator ii = m_ogl_disp_lists_layers.begin();
-         ii != m_ogl_disp_lists_layers.end();
+    ogl_free_layers_display_lists( LSET::AllLayersMask() );
+
+    for( MAP_3DMODEL::const_iterator ii = m_3dmodel_map.begin();
+         ii != m_3dmodel_map.end();
          ++ii )
     {
-        CLAYERS_OGL_DISP_LISTS *pLayerDispList = static_cast<CLAYERS_OGL_DISP_LISTS*>(ii->second);
-        delete pLayerDispList;
+        C_OGL_3DMODEL *pointer = static_cast<C_OGL_3DMODEL*>(ii->second);
+        delete pointer;
     }
 
-    m_ogl_disp_lists_layers.clear();
+    m_3dmodel_map.clear();
+}
+
+
+void C3D_RENDER_OGL_LEGACY::ogl_free_layers_display_lists( const LSET& aLayers )
+{
+    for( MAP_OGL_DISP_LISTS::iterator ii = m_ogl_disp_lists_layers.begin();
+         ii != m_ogl_disp_lists_layers.end(); )
+    {
+        if( aLayers.test( ii->first ) )
+        {
+            CLAYERS_OGL_DISP_LISTS *pLayerDispList = static_cast<CLAYERS_OGL_DISP_LISTS*>(ii->second);
+            delete pLayerDispList;
+            ii = m_ogl_disp_lists_layers.erase( ii );
+        }
+        else
+        {
+            ++ii;
+        }
+    }
+
+    delete m_ogl_disp_list_board;
+    m_ogl_disp_list_board = 0;
+
+    // Holes, vias and plated pads are built from all the copper layers
+    if( ( aLayers & LSET::AllCuMask() ).none() )
+        return;
 
     delete m_ogl_disp_lists_platedPads_F_Cu;
+    m_ogl_disp_lists_platedPads_F_Cu = nullptr;
+
     delete m_ogl_disp_lists_platedPads_B_Cu;
+    m_ogl_disp_lists_platedPads_B_Cu = nullptr;
 
     for( MAP_OGL_DISP_LISTS::const_iterator ii = m_ogl_disp_lists_layers_holes_outer.begin();
          ii != m_ogl_disp_lists_layers_holes_outer.end();
@@ -1105,30 +1137,6 @@ void C3D_RENDER_OGL_LEGACY::ogl_free_all_display_lists()
 
     m_ogl_disp_lists_layers_holes_inner.clear();
 
-    for( LIST_TRIANGLES::const_iterator ii = m_triangles.begin();
-         ii != m_triangles.end();
-         ++ii )
-    {
-        delete *ii;
-    }
-
-    m_triangles.clear();
-
-
-    for( MAP_3DMODEL::const_iterator ii = m_3dmodel_map.begin();
-         ii != m_3dmodel_map.end();
-         ++ii )
-    {
-        C_OGL_3DMODEL *pointer = static_cast<C_OGL_3DMODEL*>(ii->second);
-        delete pointer;
-    }
-
-    m_3dmodel_map.clear();
-
-
-    delete m_ogl_disp_list_board;
-    m_ogl_disp_list_board = 0;
-
     delete m_ogl_disp_list_through_holes_outer_with_npth;
     m_ogl_disp_list_through_holes_outer_with_npth = 0;
 
@@ -76,6 +76,15 @@ private:
     void ogl_set_arrow_material();
 
     void ogl_free_all_display_lists();
+
+    /**
+     * Free the display lists built from the given layers of the board adapter, the board
+     * display list and, if a copper layer is given, the holes, vias and plated pads lists.
+     * The 3D models and the grid are kept.
+     * @param aLayers = the layers rebuilt by the board adapter.
+     */
+    void ogl_free_layers_display_lists( const LSET& aLayers );
+
     MAP_OGL_DISP_LISTS      m_ogl_disp_lists_layers;
     CLAYERS_OGL_DISP_LISTS* m_ogl_disp_lists_platedPads_F_Cu;
     CLAYERS_OGL_DISP_LISTS* m_ogl_disp_lists_platedPads_B_Cu;
@@ -95,8 +104,6 @@ private:
     //CLAYERS_OGL_DISP_LISTS* m_ogl_disp_list_vias_and_pad_holes_inner_contourn_and_caps;
     CLAYERS_OGL_DISP_LISTS* m_ogl_disp_list_vias_and_pad_holes_outer_contourn_and_caps;
 
-    LIST_TRIANGLES m_triangles; // store pointers so can be deleted latter
-
     GLuint m_ogl_circle_texture;
 
     GLuint m_ogl_disp_list_grid;    ///< oGL list that stores current grid
@@ -108,6 +115,9 @@ private:
 
     MAP_3DMODEL m_3dmodel_map;
 
+    ///< The BOARD_ADAPTER::GetLayersBuildCount() the display lists were generated from
+    unsigned int m_lastLayersBuildCount;
+
 private:
     CLAYERS_OGL_DISP_LISTS *generate_holes_display_list( const LIST_OBJECT2D &aListHolesObject2d,
                                                          const SHAPE_POLY_SET &aPoly,
@@ -28,6 +28,7 @@
  */
 
 #include "cbvh_pbrt.h"
+#include "../raypacket_kernels.h"
 #include <wx/debug.h>
 
 
@@ -59,12 +60,11 @@ static inline unsigned int getFirstHit( const RAYPACKET &aRayPacket,
     if( !aRayPacket.m_Frustum.Intersect( aBBox ) )
         return RAYPACKET_RAYS_PER_PACKET;
 
-    for( unsigned int i = ia + 1; i < RAYPACKET_RAYS_PER_PACKET; ++i )
-    {
-        if( aBBox.Intersect( aRayPacket.m_ray[i], &hitT ) )
-            if( hitT < aHitInfoPacket[i].m_HitInfo.m_tHit )
-                return i;
-    }
+    const uint64_t hits = RAYPACKET_IntersectBBox( aRayPacket, aBBox, ia + 1,
+                                                   RAYPACKET_RAYS_PER_PACKET, aHitInfoPacket );
+
+    if( hits )
+        return RAYPACKET_FirstRay( hits );
 
     return RAYPACKET_RAYS_PER_PACKET;
 }
@@ -77,14 +77,11 @@ static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
                                        unsigned int ia,
                                        HITINFO_PACKET *aHitInfoPacket )
 {
-    for( unsigned int ie = (RAYPACKET_RAYS_PER_PACKET - 1); ie > ia; --ie )
-    {
-        float hitT;
+    const uint64_t hits = RAYPACKET_IntersectBBox( aRayPacket, aBBox, ia + 1,
+                                                   RAYPACKET_RAYS_PER_PACKET, aHitInfoPacket );
 
-        if( aBBox.Intersect( aRayPacket.m_ray[ie], &hitT ) )
-            if( hitT < aHitInfoPacket[ie].m_HitInfo.m_tHit )
-                return ie + 1;
-    }
+    if( hits )
+        return RAYPACKET_LastRay( hits ) + 1;
 
     return ia + 1;
 }
@@ -138,17 +135,16 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
 
                     if( aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
                     {
-                        for( unsigned int i = ia; i < ie; ++i )
+                        const uint64_t hits = obj->IntersectPacket( aRayPacket, ia, ie,
+                                                                    aHitInfoPacket );
+
+                        for( uint64_t rays = hits; rays; rays &= rays - 1 )
                         {
-                            const bool hitted = obj->Intersect( aRayPacket.m_ray[i],
-                                                                aHitInfoPacket[i].m_HitInfo );
+                            const unsigned int i = RAYPACKET_FirstRay( rays );
 
-                            if( hitted )
-                            {
-                                anyHitted |= hitted;
-                                aHitInfoPacket[i].m_hitresult |= hitted;
-                                aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
-                            }
+                            anyHitted = true;
+                            aHitInfoPacket[i].m_hitresult = true;
+                            aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
                         }
                     }
                 }
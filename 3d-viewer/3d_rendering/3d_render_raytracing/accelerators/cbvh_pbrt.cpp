@@ -69,10 +69,14 @@
 #include "cbvh_pbrt.h"
 #include "../../../3d_fastmath.h"
 #include <macros.h>
+#include <profile.h>
 
 #include <boost/range/algorithm/nth_element.hpp>
 #include <boost/range/algorithm/partition.hpp>
+#include <algorithm>
 #include <cstdlib>
+#include <future>
+#include <thread>
 #include <vector>
 
 #include <stack>
@@ -175,6 +179,56 @@ inline uint32_t EncodeMorton3( const SFVEC3F &v )
 }
 
 
+/// Below this number of items, the build steps are not worth being run in parallel
+#define BVH_PARALLEL_MIN_ITEMS 4096
+
+
+/**
+ * Run \a aFunc( aBegin, aEnd ) on chunks of [0, \a aSize) in parallel.
+ *
+ * The chunks are consecutive and of the same size (except the last one), so the
+ * chunk of a given item only depends on \a aSize and \a aChunkCount.
+ */
+template <typename FUNC>
+static void parallelForChunks( size_t aSize, size_t aChunkCount, FUNC aFunc )
+{
+    const size_t chunkSize = ( aSize + aChunkCount - 1 ) / aChunkCount;
+
+    std::atomic<size_t> nextChunk( 0 );
+
+    auto chunkThread = [&]() -> size_t
+    {
+        for( size_t chunk = nextChunk++; chunk < aChunkCount; chunk = nextChunk++ )
+            aFunc( chunk, std::min( chunk * chunkSize, aSize ),
+                   std::min( ( chunk + 1 ) * chunkSize, aSize ) );
+
+        return 1;
+    };
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), aChunkCount );
+
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, chunkThread );
+
+    // Finalize the threads
+    for( auto& ret : returns )
+        ret.wait();
+}
+
+
+static size_t chunkCountFor( size_t aSize )
+{
+    if( aSize < BVH_PARALLEL_MIN_ITEMS )
+        return 1;
+
+    return std::min<size_t>( aSize / BVH_PARALLEL_MIN_ITEMS,
+                             4 * std::max<size_t>( std::thread::hardware_concurrency(), 2 ) );
+}
+
+
 static void RadixSort( std::vector<MortonPrimitive> *v )
 {
     std::vector<MortonPrimitive> tempVector( v->size() );
@@ -185,6 +239,14 @@ static void RadixSort( std::vector<MortonPrimitive> *v )
     wxASSERT( (nBits % bitsPerPass) == 0 );
 
     const int nPasses = nBits / bitsPerPass;
+    const int nBuckets = 1 << bitsPerPass;
+    const int bitMask = (1 << bitsPerPass) - 1;
+
+    // Each pass is split in chunks: every chunk counts its buckets, then
+    // scatters its items to its own slice of each bucket, so the sort stays stable
+    const size_t nChunks = chunkCountFor( v->size() );
+
+    std::vector<int> bucketCount( nChunks * nBuckets );
 
     for( int pass = 0; pass < nPasses; ++pass )
     {
@@ -195,34 +257,65 @@ static void RadixSort( std::vector<MortonPrimitive> *v )
         std::vector<MortonPrimitive> &in  = (pass & 1) ? tempVector : *v;
         std::vector<MortonPrimitive> &out = (pass & 1) ? *v : tempVector;
 
-        // Count number of zero bits in array for current radix sort bit
-        const int nBuckets = 1 << bitsPerPass;
-        int bucketCount[nBuckets] = {0};
-        const int bitMask = (1 << bitsPerPass) - 1;
+        // Count number of items of each bucket in each chunk
+        std::fill( bucketCount.begin(), bucketCount.end(), 0 );
 
-        for( uint32_t i = 0; i < in.size(); ++i )
+        auto countChunk = [&]( size_t aChunk, size_t aBegin, size_t aEnd )
         {
-            const MortonPrimitive &mp = in[i];
-            int bucket = (mp.mortonCode >> lowBit) & bitMask;
+            int* count = &bucketCount[aChunk * nBuckets];
 
-            wxASSERT( (bucket >= 0) && (bucket < nBuckets) );
+            for( size_t i = aBegin; i < aEnd; ++i )
+            {
+                const int bucket = (in[i].mortonCode >> lowBit) & bitMask;
 
-            ++bucketCount[bucket];
-        }
+                wxASSERT( (bucket >= 0) && (bucket < nBuckets) );
 
-        // Compute starting index in output array for each bucket
-        int startIndex[nBuckets];
-        startIndex[0] = 0;
+                ++count[bucket];
+            }
+        };
 
-        for( int i = 1; i < nBuckets; ++i )
-            startIndex[i] = startIndex[i - 1] + bucketCount[i - 1];
+        // Compute starting index in output array for each bucket of each chunk
+        auto computeStartIndexes = [&]()
+        {
+            int startIndex = 0;
+
+            for( int bucket = 0; bucket < nBuckets; ++bucket )
+            {
+                for( size_t chunk = 0; chunk < nChunks; ++chunk )
+                {
+                    const int count = bucketCount[chunk * nBuckets + bucket];
+
+                    bucketCount[chunk * nBuckets + bucket] = startIndex;
+                    startIndex += count;
+                }
+            }
+        };
 
         // Store sorted values in output array
-        for( uint32_t i = 0; i < in.size(); ++i )
+        auto scatterChunk = [&]( size_t aChunk, size_t aBegin, size_t aEnd )
+        {
+            int* startIndex = &bucketCount[aChunk * nBuckets];
+
+            for( size_t i = aBegin; i < aEnd; ++i )
+            {
+                const MortonPrimitive &mp = in[i];
+                const int bucket = (mp.mortonCode >> lowBit) & bitMask;
+
+                out[startIndex[bucket]++] = mp;
+            }
+        };
+
+        if( nChunks == 1 )
         {
-            const MortonPrimitive &mp = in[i];
-            int bucket = (mp.mortonCode >> lowBit) & bitMask;
-            out[startIndex[bucket]++] = mp;
+            countChunk( 0, 0, in.size() );
+            computeStartIndexes();
+            scatterChunk( 0, 0, in.size() );
+        }
+        else
+        {
+            parallelForChunks( in.size(), nChunks, countChunk );
+            computeStartIndexes();
+            parallelForChunks( in.size(), nChunks, scatterChunk );
         }
     }
 
@@ -236,14 +329,24 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
                       int aMaxPrimsInNode,
                       SPLITMETHOD aSplitMethod ) :
     m_maxPrimsInNode( std::min( 255, aMaxPrimsInNode ) ),
-    m_splitMethod( aSplitMethod )
+    m_splitMethod( aSplitMethod ),
+    m_nodes( NULL ),
+    m_totalNodes( 0 ),
+    m_buildNodes( NULL ),
+    m_maxParallelDepth( 0 ),
+    m_sahCost( 0.0f ),
+    m_buildTime( 0 )
 {
     if( aObjectContainer.GetList().empty() )
-    {
-        m_nodes = NULL;
-
         return;
-    }
+
+    const unsigned int startTime = GetRunningMicroSecs();
+
+    // Build the children concurrently until there are enough tasks for all the cores
+    const unsigned int threadCount = std::max( std::thread::hardware_concurrency(), 2u );
+
+    while( ( 1u << m_maxParallelDepth ) < 2 * threadCount )
+        m_maxParallelDepth++;
 
     // Initialize the indexes of ray packet for partition traversal
     for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
@@ -271,17 +374,29 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
     // Build BVH tree for primitives using _primitiveInfo_
     int totalNodes = 0;
 
-    CONST_VECTOR_OBJECT orderedPrims;
-    orderedPrims.clear();
-    orderedPrims.reserve( m_primitives.size() );
+    CONST_VECTOR_OBJECT orderedPrims( m_primitives.size(), NULL );
 
     BVHBuildNode *root;
 
     if( m_splitMethod == SPLITMETHOD::HLBVH )
+    {
         root = HLBVHBuild( primitiveInfo, &totalNodes, orderedPrims);
+    }
     else
+    {
+        // A binary tree with one primitive or more per leaf has less than
+        // twice as many nodes as primitives
+        m_buildNodes = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) *
+                                                            2 * m_primitives.size() ) );
+        m_addresses_pointer_to_mm_free.push_back( m_buildNodes );
+
+        std::atomic<int> atomicTotal( 0 );
+
         root = recursiveBuild( primitiveInfo, 0, m_primitives.size(),
-                               &totalNodes, orderedPrims);
+                               atomicTotal, orderedPrims, 0 );
+
+        totalNodes = atomicTotal;
+    }
 
     wxASSERT( m_primitives.size() == orderedPrims.size() );
 
@@ -305,6 +420,10 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
     flattenBVHTree( root, &offset );
 
     wxASSERT( offset == (unsigned int)totalNodes );
+
+    m_totalNodes = totalNodes;
+    m_buildTime  = GetRunningMicroSecs() - startTime;
+    m_sahCost    = computeSAHCost();
 }
 
 
@@ -426,10 +545,10 @@ struct BucketInfo
 BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                           int start,
                                           int end,
-                                          int *totalNodes,
-                                          CONST_VECTOR_OBJECT &orderedPrims )
+                                          std::atomic<int> &totalNodes,
+                                          CONST_VECTOR_OBJECT &orderedPrims,
+                                          int depth )
 {
-    wxASSERT( totalNodes != NULL );
     wxASSERT( start >= 0 );
     wxASSERT( end   >= 0 );
     wxASSERT( start != end );
@@ -437,11 +556,11 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
     wxASSERT( start <= (int)primitiveInfo.size() );
     wxASSERT( end   <= (int)primitiveInfo.size() );
 
-    (*totalNodes)++;
+    const int nodeIndex = totalNodes++;
 
-    // !TODO: implement an memory Arena
-    BVHBuildNode *node = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) ) );
-    m_addresses_pointer_to_mm_free.push_back( node );
+    wxASSERT( nodeIndex < 2 * (int)m_primitives.size() );
+
+    BVHBuildNode *node = &m_buildNodes[nodeIndex];
 
     node->bounds.Reset();
     node->firstPrimOffset = 0;
@@ -462,13 +581,15 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
     if( nPrimitives == 1 )
     {
         // Create leaf _BVHBuildNode_
-        int firstPrimOffset = orderedPrims.size();
+        // The leaves are in the same order as the primitives in _primitiveInfo_,
+        // so each subtree fills its own range of _orderedPrims_
+        const int firstPrimOffset = start;
 
         for( int i = start; i < end; ++i )
         {
             int primitiveNr = primitiveInfo[i].primitiveNumber;
             wxASSERT( primitiveNr < (int)m_primitives.size() );
-            orderedPrims.push_back( m_primitives[ primitiveNr ] );
+            orderedPrims[i] = m_primitives[ primitiveNr ];
         }
 
         node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -491,7 +612,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                   centroidBounds.Min()[dim] ) < (FLT_EPSILON + FLT_EPSILON) )
         {
             // Create leaf _BVHBuildNode_
-            const int firstPrimOffset = orderedPrims.size();
+            const int firstPrimOffset = start;
 
             for( int i = start; i < end; ++i )
             {
@@ -504,7 +625,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
                 wxASSERT( obj != NULL );
 
-                orderedPrims.push_back( obj );
+                orderedPrims[i] = obj;
             }
 
             node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -660,7 +781,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                     else
                     {
                         // Create leaf _BVHBuildNode_
-                        const int firstPrimOffset = orderedPrims.size();
+                        const int firstPrimOffset = start;
 
                         for( int i = start; i < end; ++i )
                         {
@@ -668,7 +789,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
                             wxASSERT( primitiveNr < (int)m_primitives.size() );
 
-                            orderedPrims.push_back( m_primitives[ primitiveNr ] );
+                            orderedPrims[i] = m_primitives[ primitiveNr ];
                         }
 
                         node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -680,17 +801,39 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
             }
             }
 
-            node->InitInterior( dim,
-                                recursiveBuild( primitiveInfo,
-                                                start,
-                                                mid,
-                                                totalNodes,
-                                                orderedPrims ),
-                                recursiveBuild( primitiveInfo,
-                                                mid,
-                                                end,
-                                                totalNodes,
-                                                orderedPrims) );
+            // The two children work on disjoint ranges of _primitiveInfo_ and
+            // _orderedPrims_, so large ones can be built concurrently
+            if( ( depth < m_maxParallelDepth ) && ( nPrimitives >= BVH_PARALLEL_MIN_ITEMS ) )
+            {
+                std::future<BVHBuildNode *> leftChild = std::async( std::launch::async,
+                        [&]()
+                        {
+                            return recursiveBuild( primitiveInfo, start, mid, totalNodes,
+                                                   orderedPrims, depth + 1 );
+                        } );
+
+                BVHBuildNode *rightChild = recursiveBuild( primitiveInfo, mid, end,
+                                                           totalNodes, orderedPrims,
+                                                           depth + 1 );
+
+                node->InitInterior( dim, leftChild.get(), rightChild );
+            }
+            else
+            {
+                node->InitInterior( dim,
+                                    recursiveBuild( primitiveInfo,
+                                                    start,
+                                                    mid,
+                                                    totalNodes,
+                                                    orderedPrims,
+                                                    depth + 1 ),
+                                    recursiveBuild( primitiveInfo,
+                                                    mid,
+                                                    end,
+                                                    totalNodes,
+                                                    orderedPrims,
+                                                    depth + 1 ) );
+            }
         }
     }
 
@@ -712,31 +855,48 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
     // Compute Morton indices of primitives
     std::vector<MortonPrimitive> mortonPrims( primitiveInfo.size() );
 
-    for( int i = 0; i < (int)primitiveInfo.size(); ++i )
+    auto computeMortonCodes = [&]( size_t aChunk, size_t aBegin, size_t aEnd )
     {
-        // Initialize _mortonPrims[i]_ for _i_th primitive
-        const int mortonBits  = 10;
-        const int mortonScale = 1 << mortonBits;
+        for( size_t i = aBegin; i < aEnd; ++i )
+        {
+            // Initialize _mortonPrims[i]_ for _i_th primitive
+            const int mortonBits  = 10;
+            const int mortonScale = 1 << mortonBits;
 
-        wxASSERT( primitiveInfo[i].primitiveNumber < (int)primitiveInfo.size() );
+            wxASSERT( primitiveInfo[i].primitiveNumber < (int)primitiveInfo.size() );
 
-        mortonPrims[i].primitiveIndex = primitiveInfo[i].primitiveNumber;
+            mortonPrims[i].primitiveIndex = primitiveInfo[i].primitiveNumber;
 
-        const SFVEC3F centroidOffset = bounds.Offset( primitiveInfo[i].centroid );
+            const SFVEC3F centroidOffset = bounds.Offset( primitiveInfo[i].centroid );
 
-        wxASSERT( (centroidOffset.x >= 0.0f) && (centroidOffset.x <= 1.0f) );
-        wxASSERT( (centroidOffset.y >= 0.0f) && (centroidOffset.y <= 1.0f) );
-        wxASSERT( (centroidOffset.z >= 0.0f) && (centroidOffset.z <= 1.0f) );
+            wxASSERT( (centroidOffset.x >= 0.0f) && (centroidOffset.x <= 1.0f) );
+            wxASSERT( (centroidOffset.y >= 0.0f) && (centroidOffset.y <= 1.0f) );
+            wxASSERT( (centroidOffset.z >= 0.0f) && (centroidOffset.z <= 1.0f) );
 
-        mortonPrims[i].mortonCode = EncodeMorton3( centroidOffset *
-                                                   SFVEC3F( (float)mortonScale ) );
-    }
+            mortonPrims[i].mortonCode = EncodeMorton3( centroidOffset *
+                                                       SFVEC3F( (float)mortonScale ) );
+        }
+    };
+
+    const size_t nChunks = chunkCountFor( mortonPrims.size() );
+
+    if( nChunks == 1 )
+        computeMortonCodes( 0, 0, mortonPrims.size() );
+    else
+        parallelForChunks( mortonPrims.size(), nChunks, computeMortonCodes );
 
     // Radix sort primitive Morton indices
     RadixSort( &mortonPrims );
 
     // Create LBVH treelets at bottom of BVH
 
+    // All the treelets share one node arena: a treelet of N primitives needs
+    // less than 2 * N nodes, so it can use the nodes from 2 * its start index
+    BVHBuildNode *treeletNodes = static_cast<BVHBuildNode *>( malloc( 2 * mortonPrims.size() *
+                                                                      sizeof( BVHBuildNode ) ) );
+
+    m_addresses_pointer_to_mm_free.push_back( treeletNodes );
+
     // Find intervals of primitives for each treelet
     std::vector<LBVHTreelet> treeletsToBuild;
 
@@ -749,30 +909,11 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
               (mortonPrims[end].mortonCode & mask) ) )
         {
             // Add entry to _treeletsToBuild_ for this treelet
-            const int numPrimitives = end - start;
-            const int maxBVHNodes = 2 * numPrimitives;
-
-            // !TODO: implement a memory arena
-            BVHBuildNode *nodes = static_cast<BVHBuildNode *>( malloc( maxBVHNodes *
-                                                                           sizeof( BVHBuildNode ) ) );
-
-            m_addresses_pointer_to_mm_free.push_back( nodes );
-
-            for( int i = 0; i < maxBVHNodes; ++i )
-            {
-                nodes[i].bounds.Reset();
-                nodes[i].firstPrimOffset = 0;
-                nodes[i].nPrimitives = 0;
-                nodes[i].splitAxis = 0;
-                nodes[i].children[0] = NULL;
-                nodes[i].children[1] = NULL;
-            }
-
             LBVHTreelet tmpTreelet;
 
             tmpTreelet.startIndex = start;
-            tmpTreelet.numPrimitives = numPrimitives;
-            tmpTreelet.buildNodes = nodes;
+            tmpTreelet.numPrimitives = end - start;
+            tmpTreelet.buildNodes = &treeletNodes[2 * start];
 
             treeletsToBuild.push_back( tmpTreelet );
 
@@ -781,31 +922,60 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
     }
 
     // Create LBVHs for treelets in parallel
-    int atomicTotal = 0;
-    int orderedPrimsOffset = 0;
+    // The treelets store their primitives in the Morton order, so each one fills
+    // _orderedPrims_ from its start index
+    std::atomic<int>    atomicTotal( 0 );
+    std::atomic<size_t> nextTreelet( 0 );
 
     orderedPrims.resize( m_primitives.size() );
 
-    for( int index = 0; index < (int)treeletsToBuild.size(); ++index )
+    auto emitTreelets = [&]() -> size_t
     {
-        // Generate _index_th LBVH treelet
-        int nodesCreated = 0;
-        const int firstBit = 29 - 12;
+        for( size_t index = nextTreelet++; index < treeletsToBuild.size(); index = nextTreelet++ )
+        {
+            // Generate _index_th LBVH treelet
+            int nodesCreated = 0;
+            const int firstBit = 29 - 12;
+
+            LBVHTreelet &tr = treeletsToBuild[index];
+
+            wxASSERT( tr.startIndex < (int)mortonPrims.size() );
+
+            int orderedPrimsOffset = tr.startIndex;
+
+            tr.buildNodes = emitLBVH( tr.buildNodes,
+                                      primitiveInfo,
+                                      &mortonPrims[tr.startIndex],
+                                      tr.numPrimitives,
+                                      &nodesCreated,
+                                      orderedPrims,
+                                      &orderedPrimsOffset,
+                                      firstBit );
 
-        LBVHTreelet &tr = treeletsToBuild[index];
+            atomicTotal += nodesCreated;
+        }
+
+        return 1;
+    };
+
+    if( mortonPrims.size() < BVH_PARALLEL_MIN_ITEMS )
+    {
+        emitTreelets();
+    }
+    else
+    {
+        size_t parallelThreadCount = std::min<size_t>(
+                std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
+                treeletsToBuild.size() );
 
-        wxASSERT( tr.startIndex < (int)mortonPrims.size() );
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
 
-        tr.buildNodes = emitLBVH( tr.buildNodes,
-                                  primitiveInfo,
-                                  &mortonPrims[tr.startIndex],
-                                  tr.numPrimitives,
-                                  &nodesCreated,
-                                  orderedPrims,
-                                  &orderedPrimsOffset,
-                                  firstBit );
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, emitTreelets );
 
-        atomicTotal += nodesCreated;
+        // Finalize the threads
+        for( auto& ret : returns )
+            ret.wait();
     }
 
     *totalNodes = atomicTotal;
@@ -1106,6 +1276,35 @@ int CBVH_PBRT::flattenBVHTree( BVHBuildNode *node, uint32_t *offset )
 }
 
 
+float CBVH_PBRT::computeSAHCost() const
+{
+    if( !m_nodes || ( m_totalNodes == 0 ) )
+        return 0.0f;
+
+    const float rootArea = m_nodes[0].bounds.SurfaceArea();
+
+    if( rootArea <= 0.0f )
+        return 0.0f;
+
+    // Each node is visited with the probability of a ray hitting its box
+    // when it hits the root box: the ratio of the surface areas
+    float cost = 0.0f;
+
+    for( int i = 0; i < m_totalNodes; ++i )
+    {
+        const LinearBVHNode &node = m_nodes[i];
+        const float hitProbability = node.bounds.SurfaceArea() / rootArea;
+
+        if( node.nPrimitives > 0 )
+            cost += hitProbability * node.nPrimitives;
+        else
+            cost += hitProbability;
+    }
+
+    return cost;
+}
+
+
 #define MAX_TODOS 64
 
 bool CBVH_PBRT::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
@@ -71,6 +71,7 @@
 #define _CBVH_PBRT_H_
 
 #include "caccelerator.h"
+#include <atomic>
 #include <cstdint>
 #include <list>
 
@@ -121,13 +122,39 @@ public:
     bool Intersect( const RAYPACKET &aRayPacket, HITINFO_PACKET *aHitInfoPacket ) const override;
     bool IntersectP( const RAY &aRay, float aMaxDistance ) const override;
 
+    /**
+     * @return the number of nodes of the flattened tree.
+     */
+    int GetNodeCount() const { return m_totalNodes; }
+
+    /**
+     * Get the SAH cost of the built tree, to track the tree quality.
+     *
+     * It is the expected number of node traversals and primitive intersections
+     * of a ray hitting the root bounding box, with both costs set to one.
+     */
+    float GetSAHCost() const { return m_sahCost; }
+
+    /**
+     * @return the time spent to build and flatten the tree, in microseconds.
+     */
+    unsigned int GetBuildTime() const { return m_buildTime; }
+
 private:
 
+    /**
+     * Build the subtree of the primitives from \a start to \a end.
+     *
+     * The build nodes are taken from the m_buildNodes arena, \a totalNodes being the
+     * allocation index. The two children of large nodes are built concurrently until
+     * \a depth reaches m_maxParallelDepth.
+     */
     BVHBuildNode *recursiveBuild( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                   int start,
                                   int end,
-                                  int *totalNodes,
-                                  CONST_VECTOR_OBJECT &orderedPrims );
+                                  std::atomic<int> &totalNodes,
+                                  CONST_VECTOR_OBJECT &orderedPrims,
+                                  int depth );
 
     BVHBuildNode *HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primitiveInfo,
                               int *totalNodes,
@@ -151,11 +178,20 @@ private:
     int flattenBVHTree( BVHBuildNode *node,
                         uint32_t *offset );
 
+    float computeSAHCost() const;
+
     // BVH Private Data
     const int           m_maxPrimsInNode;
     SPLITMETHOD         m_splitMethod;
     CONST_VECTOR_OBJECT m_primitives;
     LinearBVHNode       *m_nodes;
+    int                 m_totalNodes;
+
+    BVHBuildNode        *m_buildNodes;          ///< Node arena used by recursiveBuild
+    int                 m_maxParallelDepth;     ///< Max depth to build children concurrently
+
+    float               m_sahCost;
+    unsigned int        m_buildTime;            ///< In microseconds
 
     std::list<void *> m_addresses_pointer_to_mm_free;
 
@@ -28,8 +28,11 @@
  */
 
 #include "ccontainer2d.h"
+#include <algorithm>
 #include <vector>
+#include <future>
 #include <mutex>
+#include <thread>
 #include <boost/range/algorithm/partition.hpp>
 #include <boost/range/algorithm/nth_element.hpp>
 #include <wx/debug.h>
@@ -264,6 +267,9 @@ CBVHCONTAINER2D::~CBVHCONTAINER2D()
 
 #define BVH_CONTAINER2D_MAX_OBJ_PER_LEAF 4
 
+/// Nodes with less objects than this are not worth being split in another thread
+#define BVH_CONTAINER2D_PARALLEL_MIN_OBJ 4096
+
 
 void CBVHCONTAINER2D::BuildBVH()
 {
@@ -288,7 +294,7 @@ void CBVHCONTAINER2D::BuildBVH()
         m_Tree->m_LeafList.push_back( static_cast<const COBJECT2D *>(*ii) );
     }
 
-    recursiveBuild_MIDDLE_SPLIT( m_Tree );
+    recursiveBuild_MIDDLE_SPLIT( m_Tree, m_elements_to_delete, 0 );
 }
 
 
@@ -307,7 +313,7 @@ static bool sortByCentroid_X( const COBJECT2D *a, const COBJECT2D *b )
 
 static bool sortByCentroid_Y( const COBJECT2D *a, const COBJECT2D *b )
 {
-    return a->GetCentroid()[0] < b->GetCentroid()[0];
+    return a->GetCentroid()[1] < b->GetCentroid()[1];
 }
 
 static bool sortByCentroid_Z( const COBJECT2D *a, const COBJECT2D *b )
@@ -315,7 +321,9 @@ static bool sortByCentroid_Z( const COBJECT2D *a, const COBJECT2D *b )
     return a->GetCentroid()[0] < b->GetCentroid()[0];
 }
 
-void CBVHCONTAINER2D::recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent )
+void CBVHCONTAINER2D::recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent,
+                                                   std::list<BVH_CONTAINER_NODE_2D *> &aNodesToDelete,
+                                                   unsigned int aDepth )
 {
     wxASSERT( aNodeParent != NULL );
     wxASSERT( aNodeParent->m_BBox.IsInitialized() == true );
@@ -326,8 +334,8 @@ void CBVHCONTAINER2D::recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeP
         // Create Leaf Nodes
         BVH_CONTAINER_NODE_2D *leftNode  = new BVH_CONTAINER_NODE_2D;
         BVH_CONTAINER_NODE_2D *rightNode = new BVH_CONTAINER_NODE_2D;
-        m_elements_to_delete.push_back( leftNode );
-        m_elements_to_delete.push_back( rightNode );
+        aNodesToDelete.push_back( leftNode );
+        aNodesToDelete.push_back( rightNode );
 
         leftNode->m_BBox.Reset();
         rightNode->m_BBox.Reset();
@@ -376,8 +384,31 @@ void CBVHCONTAINER2D::recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeP
         aNodeParent->m_Children[1] = rightNode;
         aNodeParent->m_LeafList.clear();
 
-        recursiveBuild_MIDDLE_SPLIT( leftNode );
-        recursiveBuild_MIDDLE_SPLIT( rightNode );
+        // Split the top levels in parallel, until there are enough tasks for all the cores
+        const unsigned int parallelTasks = std::max( std::thread::hardware_concurrency(), 2u );
+
+        if( ( ( 1u << aDepth ) < parallelTasks )
+                && ( leftNode->m_LeafList.size() >= BVH_CONTAINER2D_PARALLEL_MIN_OBJ ) )
+        {
+            // The left subtree collects its nodes in its own list, merged once built
+            std::list<BVH_CONTAINER_NODE_2D *> leftNodesToDelete;
+
+            std::future<void> leftBuild = std::async( std::launch::async,
+                    [&]()
+                    {
+                        recursiveBuild_MIDDLE_SPLIT( leftNode, leftNodesToDelete, aDepth + 1 );
+                    } );
+
+            recursiveBuild_MIDDLE_SPLIT( rightNode, aNodesToDelete, aDepth + 1 );
+
+            leftBuild.wait();
+            aNodesToDelete.splice( aNodesToDelete.end(), leftNodesToDelete );
+        }
+        else
+        {
+            recursiveBuild_MIDDLE_SPLIT( leftNode, aNodesToDelete, aDepth + 1 );
+            recursiveBuild_MIDDLE_SPLIT( rightNode, aNodesToDelete, aDepth + 1 );
+        }
     }
     else
     {
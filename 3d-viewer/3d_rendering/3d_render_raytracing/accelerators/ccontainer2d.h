@@ -111,7 +111,16 @@ private:
     BVH_CONTAINER_NODE_2D   *m_Tree;
 
     void destroy();
-    void recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent );
+
+    /**
+     * Split \a aNodeParent until its leaves have few objects.
+     *
+     * The created nodes are added to \a aNodesToDelete. The two children of large
+     * nodes are split concurrently while \a aDepth is small enough.
+     */
+    void recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent,
+                                      std::list<BVH_CONTAINER_NODE_2D *> &aNodesToDelete,
+                                      unsigned int aDepth );
     void recursiveGetListObjectsIntersects( const BVH_CONTAINER_NODE_2D *aNode,
                                             const CBBOX2D & aBBox,
                                             CONST_LIST_OBJECT2D &aOutList ) const;
@@ -1007,7 +1007,15 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER* aStatusReporter, REPORTER* aWarnin
     }
     m_accelerator = 0;
 
-    m_accelerator = new CBVH_PBRT( m_object_container, 8, SPLITMETHOD::MIDDLE );
+    CBVH_PBRT* bvh = new CBVH_PBRT( m_object_container, 8, SPLITMETHOD::MIDDLE );
+
+    // Report the tree quality and build time, to track regressions of the BVH build
+    wxLogTrace( m_logTrace, wxT( "C3D_RENDER_RAYTRACING::reload BVH: %d objects, %d nodes, "
+                                 "SAH cost %.2f, build time %.3f ms" ),
+                (int) m_object_container.GetList().size(), bvh->GetNodeCount(),
+                bvh->GetSAHCost(), bvh->GetBuildTime() / 1e3 );
+
+    m_accelerator = bvh;
 
     if( aStatusReporter )
     {
@@ -1250,6 +1258,30 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // Without a model cache (headless renders without a project), there is no model
+    if( !m_boardAdapter.Get3DCacheManager() )
+        return;
+
+    // Load the models concurrently, the loop below will then get them from the cache
+    std::vector<wxString> modelFiles;
+
+    for( auto module : m_boardAdapter.GetBoard()->Modules() )
+    {
+        if( !m_boardAdapter.ShouldModuleBeDisplayed( (MODULE_ATTR_T) module->GetAttributes() ) )
+            continue;
+
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( ( static_cast<float>( model.m_Opacity ) > FLT_EPSILON ) &&
+                ( model.m_Show && !model.m_Filename.empty() ) )
+            {
+                modelFiles.push_back( model.m_Filename );
+            }
+        }
+    }
+
+    m_boardAdapter.Get3DCacheManager()->LoadModels( modelFiles );
+
     // Go for all modules
     for( auto module : m_boardAdapter.GetBoard()->Modules() )
     {
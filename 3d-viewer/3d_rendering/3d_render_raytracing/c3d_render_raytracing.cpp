@@ -32,7 +32,6 @@
 #include <atomic>
 #include <chrono>
 #include <climits>
-#include <thread>
 
 #include "c3d_render_raytracing.h"
 #include "mortoncodes.h"
@@ -41,6 +40,7 @@
 #include "3d_math.h"
 #include "../common_ogl/ogl_utils.h"
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
+#include <widgets/progress_reporter.h>
 
 // This should be used in future for the function
 // convertLinearToSRGB
@@ -92,6 +92,16 @@ C3D_RENDER_RAYTRACING::~C3D_RENDER_RAYTRACING()
 }
 
 
+CTILE_SCHEDULER& C3D_RENDER_RAYTRACING::tileScheduler()
+{
+    // The threads are only started when the raytracing is used
+    if( !m_tileScheduler )
+        m_tileScheduler.reset( new CTILE_SCHEDULER );
+
+    return *m_tileScheduler;
+}
+
+
 int C3D_RENDER_RAYTRACING::GetWaitForEditingTimeOut()
 {
     return 1000; // ms
@@ -166,6 +176,7 @@ bool C3D_RENDER_RAYTRACING::Redraw(
         // revert to preview mode the first time the Redraw is called
         m_oldWindowsSize = m_windowSize;
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
     std::unique_ptr<BUSY_INDICATOR> busy = CreateBusyIndicator();
@@ -192,6 +203,7 @@ bool C3D_RENDER_RAYTRACING::Redraw(
         requestRedraw = true;
 
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
 
@@ -367,45 +379,26 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte* ptrPBO ,
     m_isPreview = false;
 
     auto startTime = std::chrono::steady_clock::now();
-    bool breakLoop = false;
 
     std::atomic<size_t> numBlocksRendered( 0 );
-    std::atomic<size_t> currentBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
 
-    size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-            m_blockPositions.size() );
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [&]()
-        {
-            for( size_t iBlock = currentBlock.fetch_add( 1 );
-                        iBlock < m_blockPositions.size() && !breakLoop;
-                        iBlock = currentBlock.fetch_add( 1 ) )
+    tileScheduler().Run( m_blockPositions.size(),
+            [&]( size_t iBlock )
             {
                 if( !m_blockPositionsWasProcessed[iBlock] )
                 {
                     rt_render_trace_block( ptrPBO, iBlock );
                     numBlocksRendered++;
                     m_blockPositionsWasProcessed[iBlock] = 1;
-
-                    // Check if it spend already some time render and request to exit
-                    // to display the progress
-                    if( std::chrono::duration_cast<std::chrono::milliseconds>(
-                            std::chrono::steady_clock::now() - startTime ).count() > 150 )
-                        breakLoop = true;
                 }
-            }
-
-            threadsFinished++;
-        } );
-
-        t.detach();
-    }
-
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            },
+            [&]()
+            {
+                // Check if it spend already some time render and request to exit
+                // to display the progress
+                return std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - startTime ).count() > 150;
+            } );
 
     m_nrBlocksRenderProgress += numBlocksRendered;
 
@@ -918,17 +911,8 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_shade( GLubyte* ptrPBO,
 
         m_postshader_ssao.SetShadowsEnabled( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_SHADOWS ) );
 
-        std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t y = nextBlock.fetch_add( 1 );
-                            y < m_realBufferSize.y;
-                            y = nextBlock.fetch_add( 1 ) )
+        tileScheduler().Run( m_realBufferSize.y,
+                [&]( size_t y )
                 {
                     SFVEC3F *ptr = &m_shaderBuffer[ y * m_realBufferSize.x ];
 
@@ -937,16 +921,7 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_shade( GLubyte* ptrPBO,
                         *ptr = m_postshader_ssao.Shade( SFVEC2I( x, y ) );
                         ptr++;
                     }
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+                } );
 
         m_postshader_ssao.SetShadedBuffer( m_shaderBuffer );
 
@@ -969,17 +944,8 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_blur_finish( GLubyte *ptrPBO,
     if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
     {
         // Now blurs the shader result and compute the final color
-        std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t y = nextBlock.fetch_add( 1 );
-                            y < m_realBufferSize.y;
-                            y = nextBlock.fetch_add( 1 ) )
+        tileScheduler().Run( m_realBufferSize.y,
+                [&]( size_t y )
                 {
                     GLubyte *ptr = &ptrPBO[ y * m_realBufferSize.x * 4 ];
 
@@ -998,17 +964,7 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_blur_finish( GLubyte *ptrPBO,
 
                         ptr += 4;
                     }
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-
+                } );
 
         // Debug code
         //m_postshader_ssao.DebugBuffersOutputAsImages();
@@ -1023,19 +979,8 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
 {
     m_isPreview = true;
 
-    std::atomic<size_t> nextBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
-
-    size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-            m_blockPositions.size() );
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [&]()
-        {
-            for( size_t iBlock = nextBlock.fetch_add( 1 );
-                        iBlock < m_blockPositionsFast.size();
-                        iBlock = nextBlock.fetch_add( 1 ) )
+    tileScheduler().Run( m_blockPositionsFast.size(),
+            [&]( size_t iBlock )
             {
                 const SFVEC2UI &windowPosUI = m_blockPositionsFast[ iBlock ];
                 const SFVEC2I windowsPos = SFVEC2I( windowPosUI.x + m_xoffset,
@@ -1636,16 +1581,7 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                         SetPixel( ptr + 12, BlendColor( cRBC, BlendColor( cRB , cC ) ) );
                     }
                 }
-            }
-
-            threadsFinished++;
-        } );
-
-        t.detach();
-    }
-
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            } );
 }
 
 
@@ -1955,6 +1891,185 @@ SFVEC3F C3D_RENDER_RAYTRACING::shadeHit( const SFVEC3F &aBgColor,
 }
 
 
+bool C3D_RENDER_RAYTRACING::RenderToImage( const wxSize& aSize, wxImage& aImage,
+                                           PROGRESS_REPORTER* aProgressReporter )
+{
+    // Render at the requested size without touching the OpenGL state of the window
+    const wxSize windowSize = m_windowSize;
+
+    m_windowSize = aSize;
+    m_camera.SetCurWindowSize( aSize );
+    initialize_block_positions();
+
+    if( m_reloadRequested || !m_accelerator )
+        reload( nullptr, nullptr );
+
+    const bool postProcessing = m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING );
+
+    if( aProgressReporter )
+    {
+        aProgressReporter->SetNumPhases( postProcessing ? 3 : 1 );
+        aProgressReporter->BeginPhase( 0 );
+        aProgressReporter->Report( _( "Rendering..." ) );
+    }
+
+    restart_render_state();
+    m_isPreview = false;
+
+    if( m_camera_light )
+        m_camera_light->SetDirection( -m_camera.GetDir() );
+
+    m_BgColorTop_LinearRGB = ConvertSRGBToLinear( (SFVEC3F)m_boardAdapter.m_BgColorTop );
+    m_BgColorBot_LinearRGB = ConvertSRGBToLinear( (SFVEC3F)m_boardAdapter.m_BgColorBot );
+
+    std::vector<GLubyte> buffer( m_realBufferSize.x * m_realBufferSize.y * 4 );
+
+    tileScheduler().Run( m_blockPositions.size(),
+            [&]( size_t iBlock )
+            {
+                rt_render_trace_block( buffer.data(), iBlock );
+            },
+            [&]()
+            {
+                return aProgressReporter && aProgressReporter->IsCancelled();
+            },
+            [&]( size_t aDone, size_t aTotal )
+            {
+                if( aProgressReporter )
+                {
+                    aProgressReporter->SetCurrentProgress( (double) aDone / aTotal );
+                    aProgressReporter->KeepRefreshing();
+                }
+            } );
+
+    const bool cancelled = aProgressReporter && aProgressReporter->IsCancelled();
+
+    if( !cancelled && postProcessing )
+    {
+        if( aProgressReporter )
+        {
+            aProgressReporter->AdvancePhase( _( "Post processing..." ) );
+            aProgressReporter->KeepRefreshing();
+        }
+
+        rt_render_post_process_shade( buffer.data(), nullptr );
+
+        if( aProgressReporter )
+        {
+            aProgressReporter->AdvancePhase();
+            aProgressReporter->KeepRefreshing();
+        }
+
+        rt_render_post_process_blur_finish( buffer.data(), nullptr );
+    }
+
+    if( !cancelled )
+    {
+        // The traced buffer is centered in the image and is bottom up, as for OpenGL.
+        // The borders get the background gradient, as drawn by Redraw()
+        aImage.Create( aSize.x, aSize.y, false );
+
+        unsigned char* rgb = aImage.GetData();
+
+        for( int y = 0; y < aSize.y; ++y )
+        {
+            const int           bufferY = aSize.y - 1 - y - (int)m_yoffset;
+            const float         posYfactor = (float)( aSize.y - 1 - y ) / (float)aSize.y;
+            const SFVEC3F       bgColor = (SFVEC3F)m_boardAdapter.m_BgColorTop * posYfactor +
+                                          (SFVEC3F)m_boardAdapter.m_BgColorBot *
+                                          ( 1.0f - posYfactor );
+            unsigned char*      pixel = &rgb[y * aSize.x * 3];
+
+            for( int x = 0; x < aSize.x; ++x, pixel += 3 )
+            {
+                const int bufferX = x - (int)m_xoffset;
+
+                if( ( bufferX >= 0 ) && ( bufferX < (int)m_realBufferSize.x ) &&
+                    ( bufferY >= 0 ) && ( bufferY < (int)m_realBufferSize.y ) )
+                {
+                    const GLubyte* src = &buffer[( bufferY * m_realBufferSize.x + bufferX ) * 4];
+
+                    pixel[0] = src[0];
+                    pixel[1] = src[1];
+                    pixel[2] = src[2];
+                }
+                else
+                {
+                    pixel[0] = (unsigned char)glm::clamp( (int)( bgColor.r * 255 ), 0, 255 );
+                    pixel[1] = (unsigned char)glm::clamp( (int)( bgColor.g * 255 ), 0, 255 );
+                    pixel[2] = (unsigned char)glm::clamp( (int)( bgColor.b * 255 ), 0, 255 );
+                }
+            }
+        }
+    }
+
+    // Let the next Redraw() rebuild its buffers for the window size
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+    m_windowSize = windowSize;
+    m_oldWindowsSize = wxSize( 0, 0 );
+
+    if( m_windowSize.x > 0 && m_windowSize.y > 0 )
+        m_camera.SetCurWindowSize( m_windowSize );
+
+    return !cancelled;
+}
+
+
+void C3D_RENDER_RAYTRACING::RenderFirstHits( const wxSize& aSize, wxImage& aImage )
+{
+    m_camera.SetCurWindowSize( aSize );
+
+    if( m_reloadRequested || !m_accelerator )
+        reload( nullptr, nullptr );
+
+    aImage.Create( aSize.x, aSize.y, false );
+
+    unsigned char* rgb = aImage.GetData();
+
+    const unsigned int packetsX = ( aSize.x + RAYPACKET_DIM - 1 ) / RAYPACKET_DIM;
+    const unsigned int packetsY = ( aSize.y + RAYPACKET_DIM - 1 ) / RAYPACKET_DIM;
+    const size_t       packetsCount = (size_t) packetsX * packetsY;
+
+    tileScheduler().Run( packetsCount,
+            [&]( size_t ii )
+            {
+                const SFVEC2I packetPos( ( ii % packetsX ) * RAYPACKET_DIM,
+                                         ( ii / packetsX ) * RAYPACKET_DIM );
+
+                RAYPACKET      packet( m_camera, packetPos );
+                HITINFO_PACKET hitPacket[RAYPACKET_RAYS_PER_PACKET];
+
+                HITINFO_PACKET_init( hitPacket );
+
+                m_accelerator->Intersect( packet, hitPacket );
+
+                for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+                {
+                    for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
+                    {
+                        const int px = packetPos.x + x;
+                        const int py = packetPos.y + y;
+
+                        if( ( px >= aSize.x ) || ( py >= aSize.y ) )
+                            continue;
+
+                        // Map the normal from [-1, 1] to [0, 1], the background is black
+                        const SFVEC3F color = hitPacket[i].m_hitresult
+                                                      ? hitPacket[i].m_HitInfo.m_HitNormal * 0.5f
+                                                                + SFVEC3F( 0.5f )
+                                                      : SFVEC3F( 0.0f );
+
+                        unsigned char* pixel = &rgb[( py * aSize.x + px ) * 3];
+
+                        pixel[0] = (unsigned char) glm::clamp( (int) ( color.r * 255 ), 0, 255 );
+                        pixel[1] = (unsigned char) glm::clamp( (int) ( color.g * 255 ), 0, 255 );
+                        pixel[2] = (unsigned char) glm::clamp( (int) ( color.b * 255 ), 0, 255 );
+                    }
+                }
+            } );
+}
+
+
 void C3D_RENDER_RAYTRACING::initializeNewWindowSize()
 {
     opengl_init_pbo();
@@ -2076,6 +2191,4 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     // Create m_shader buffer
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
-
-    opengl_init_pbo();
 }
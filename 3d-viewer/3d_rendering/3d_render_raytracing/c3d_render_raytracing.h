@@ -37,9 +37,13 @@
 #include "clight.h"
 #include "../cpostshader_ssao.h"
 #include "cmaterial.h"
+#include "ctile_scheduler.h"
 #include <plugins/3dapi/c3dmodel.h>
 
 #include <map>
+#include <memory>
+
+#include <wx/image.h>
 
 /// Vector of materials
 typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
@@ -47,6 +51,8 @@ typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
 /// Maps a S3DMODEL pointer with a created CBLINN_PHONG_MATERIAL vector
 typedef std::map< const S3DMODEL * , MODEL_MATERIALS > MAP_MODEL_MATERIALS;
 
+class PROGRESS_REPORTER;
+
 typedef enum
 {
     RT_RENDER_STATE_TRACING = 0,
@@ -69,6 +75,32 @@ public:
 
     int GetWaitForEditingTimeOut() override;
 
+    /**
+     * Render the view to an image without OpenGL, for instance to write board renders
+     * from a batch job.
+     *
+     * The passes run to completion on the tile scheduler threads, the scene is reloaded
+     * first if needed.
+     * @param aSize is the size of the image to render.
+     * @param aImage receives the rendered image.
+     * @param aProgressReporter, if set, is advanced on the calling thread during the
+     * render and can cancel it.
+     * @return false if the render was cancelled.
+     */
+    bool RenderToImage( const wxSize& aSize, wxImage& aImage,
+                        PROGRESS_REPORTER* aProgressReporter = nullptr );
+
+    /**
+     * Trace the first hit of the rays of the whole view, without OpenGL, and shade it
+     * by its normal.
+     *
+     * This is used to benchmark the ray packet traversal and intersection kernels.
+     * The scene is reloaded first if needed.
+     * @param aSize is the size of the image to render.
+     * @param aImage receives the rendered image.
+     */
+    void RenderFirstHits( const wxSize& aSize, wxImage& aImage );
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
@@ -213,6 +245,11 @@ private:
 
     void render( GLubyte* ptrPBO, REPORTER* aStatusReporter );
     void render_preview( GLubyte *ptrPBO );
+
+    /// @return the threads running the render passes, started on first use
+    CTILE_SCHEDULER& tileScheduler();
+
+    std::unique_ptr<CTILE_SCHEDULER> m_tileScheduler;
 };
 
 #define USE_SRGB_SPACE
@@ -29,30 +29,40 @@
 
 
 #include "cfrustum.h"
+#include "raypacket_kernels.h"
+#include <algorithm>
+#include <cfloat>
 
-// !TODO: optimize wih SSE
-//#if(GLM_ARCH != GLM_ARCH_PURE)
-#if 0
-#error not implemented
-#else
-
-
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define CFRUSTUM_SSE2
+#include <emmintrin.h>
 #endif
 
+
 void CFRUSTUM::GenerateFrustum( const RAY &topLeft,
                                 const RAY &topRight,
                                 const RAY &bottomLeft,
                                 const RAY &bottomRight )
 {
-    m_point[0] = topLeft.m_Origin;
-    m_point[1] = topRight.m_Origin;
-    m_point[2] = bottomLeft.m_Origin;
-    m_point[3] = topLeft.m_Origin;
-
-    m_normals[0] = glm::cross( topRight.m_Dir,    topLeft.m_Dir );              // TOP
-    m_normals[1] = glm::cross( bottomRight.m_Dir, topRight.m_Dir );             // RIGHT
-    m_normals[2] = glm::cross( bottomLeft.m_Dir,  bottomRight.m_Dir );          // BOTTOM
-    m_normals[3] = glm::cross( topLeft.m_Dir,     bottomLeft.m_Dir );           // LEFT
+    const SFVEC3F point[4] = { topLeft.m_Origin,
+                               topRight.m_Origin,
+                               bottomLeft.m_Origin,
+                               topLeft.m_Origin };
+
+    const SFVEC3F normals[4] = {
+        glm::cross( topRight.m_Dir,    topLeft.m_Dir ),     // TOP
+        glm::cross( bottomRight.m_Dir, topRight.m_Dir ),    // RIGHT
+        glm::cross( bottomLeft.m_Dir,  bottomRight.m_Dir ), // BOTTOM
+        glm::cross( topLeft.m_Dir,     bottomLeft.m_Dir )   // LEFT
+    };
+
+    for( unsigned int i = 0; i < 4; ++i )
+    {
+        m_normalX[i] = normals[i].x;
+        m_normalY[i] = normals[i].y;
+        m_normalZ[i] = normals[i].z;
+        m_dist[i]    = glm::dot( point[i], normals[i] );
+    }
 }
 
 
@@ -62,42 +72,48 @@ void CFRUSTUM::GenerateFrustum( const RAY &topLeft,
 // by Nathan Slobody and Adam Wright
 // The frustum test is not exllude all the boxes,
 // when a box is behind and if it is intersecting the planes it will not be discardly but should.
+//
+// A box is inside a plane if one of its 8 corners is inside. Only the corner farthest
+// along the plane normal needs to be tested: for each axis, it is the box min or max
+// that gives the largest product with the normal.
 bool CFRUSTUM::Intersect( const CBBOX &aBBox ) const
 {
-    const SFVEC3F box[8] = { aBBox.Min(),
-                             aBBox.Max(),
-                             SFVEC3F(aBBox.Min().x, aBBox.Min().y, aBBox.Max().z),
-                             SFVEC3F(aBBox.Min().x, aBBox.Max().y, aBBox.Min().z),
-                             SFVEC3F(aBBox.Min().x, aBBox.Max().y, aBBox.Max().z),
-                             SFVEC3F(aBBox.Max().x, aBBox.Min().y, aBBox.Min().z),
-                             SFVEC3F(aBBox.Max().x, aBBox.Min().y, aBBox.Max().z),
-                             SFVEC3F(aBBox.Max().x, aBBox.Max().y, aBBox.Min().z) };
-
-    // test each plane of frustum individually; if the point is on the wrong
-    // side of the plane, the box is outside the frustum and we can exit
-    int out_side = 0;
+    const SFVEC3F &bmin = aBBox.Min();
+    const SFVEC3F &bmax = aBBox.Max();
 
-    for( unsigned int i = 0; i < 4; ++i )
+#ifdef CFRUSTUM_SSE2
+    if( RAYPACKET_GetKernelISA() != RAYPACKET_ISA::SCALAR )
     {
-        const SFVEC3F &pointPlane  = m_point[i];
-        const SFVEC3F &normalPlane = m_normals[i];
-
-        for( unsigned int j = 0; j < 8; ++j )
-        {
-            const SFVEC3F OP = pointPlane - box[j];
-            const float dot = glm::dot( OP, normalPlane );
+        const __m128 nx = _mm_load_ps( m_normalX );
+        const __m128 ny = _mm_load_ps( m_normalY );
+        const __m128 nz = _mm_load_ps( m_normalZ );
+
+        const __m128 px = _mm_max_ps( _mm_mul_ps( nx, _mm_set1_ps( bmin.x ) ),
+                                      _mm_mul_ps( nx, _mm_set1_ps( bmax.x ) ) );
+        const __m128 py = _mm_max_ps( _mm_mul_ps( ny, _mm_set1_ps( bmin.y ) ),
+                                      _mm_mul_ps( ny, _mm_set1_ps( bmax.y ) ) );
+        const __m128 pz = _mm_max_ps( _mm_mul_ps( nz, _mm_set1_ps( bmin.z ) ),
+                                      _mm_mul_ps( nz, _mm_set1_ps( bmax.z ) ) );
+
+        const __m128 inside = _mm_cmplt_ps( _mm_sub_ps( _mm_load_ps( m_dist ),
+                                                        _mm_add_ps( _mm_add_ps( px, py ), pz ) ),
+                                            _mm_set1_ps( FLT_EPSILON ) );
+
+        return _mm_movemask_ps( inside ) == 0xF;
+    }
+#endif
 
-            if( dot < FLT_EPSILON )
-            {
-                out_side++;
+    // test each plane of frustum individually; if the farthest corner is on the wrong
+    // side of the plane, the box is outside the frustum and we can exit
+    for( unsigned int i = 0; i < 4; ++i )
+    {
+        const float farthest = std::max( m_normalX[i] * bmin.x, m_normalX[i] * bmax.x ) +
+                               std::max( m_normalY[i] * bmin.y, m_normalY[i] * bmax.y ) +
+                               std::max( m_normalZ[i] * bmin.z, m_normalZ[i] * bmax.z );
 
-                break;
-            }
-        }
+        if( !( m_dist[i] - farthest < FLT_EPSILON ) )
+            return false;
     }
 
-    if( out_side == 4 )
-        return true;
-
-    return false;
+    return true;
 }
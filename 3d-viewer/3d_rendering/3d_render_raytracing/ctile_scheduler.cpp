@@ -0,0 +1,207 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  ctile_scheduler.cpp
+ * @brief Persistent worker threads processing the tiles of a render pass.
+ */
+
+#include "ctile_scheduler.h"
+
+#include <algorithm>
+
+
+CTILE_SCHEDULER::CTILE_SCHEDULER( size_t aThreadsCount ) :
+        m_tileFunc( nullptr ),
+        m_stopFunc( nullptr ),
+        m_passId( 0 ),
+        m_busyWorkers( 0 ),
+        m_progressStep( 0 ),
+        m_tilesDone( 0 ),
+        m_quit( false )
+{
+    if( aThreadsCount == 0 )
+        aThreadsCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
+
+    for( size_t ii = 0; ii < aThreadsCount; ++ii )
+        m_queues.emplace_back( new WORKER_QUEUE );
+
+    for( size_t ii = 0; ii < aThreadsCount; ++ii )
+        m_threads.emplace_back( &CTILE_SCHEDULER::workerLoop, this, ii );
+}
+
+
+CTILE_SCHEDULER::~CTILE_SCHEDULER()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        m_quit = true;
+    }
+
+    m_wakeWorkers.notify_all();
+
+    for( std::thread& thread : m_threads )
+        thread.join();
+}
+
+
+size_t CTILE_SCHEDULER::Run( size_t aTilesCount,
+                             const std::function<void( size_t aTile )>& aTileFunc,
+                             const std::function<bool()>& aStopFunc,
+                             const std::function<void( size_t aDone, size_t aTotal )>& aProgressFunc )
+{
+    if( aTilesCount == 0 )
+        return 0;
+
+    const size_t workersCount = m_queues.size();
+
+    // Deal the tiles one by one, so every worker starts with the first tiles
+    for( size_t ii = 0; ii < aTilesCount; ++ii )
+        m_queues[ii % workersCount]->m_tiles.push_back( ii );
+
+    std::unique_lock<std::mutex> lock( m_lock );
+
+    m_tileFunc = &aTileFunc;
+    m_stopFunc = aStopFunc ? &aStopFunc : nullptr;
+    m_progressStep = aProgressFunc ? std::max<size_t>( aTilesCount / 100, 1 ) : 0;
+    m_tilesDone = 0;
+    m_busyWorkers = workersCount;
+    m_passId++;
+
+    m_wakeWorkers.notify_all();
+
+    size_t reportedTiles = 0;
+
+    while( m_busyWorkers > 0 )
+    {
+        m_passChanged.wait( lock, [&]()
+                                  {
+                                      return m_busyWorkers == 0
+                                             || ( m_progressStep
+                                                  && m_tilesDone >= reportedTiles + m_progressStep );
+                                  } );
+
+        if( aProgressFunc && m_tilesDone > reportedTiles )
+        {
+            reportedTiles = m_tilesDone;
+
+            lock.unlock();
+            aProgressFunc( reportedTiles, aTilesCount );
+            lock.lock();
+        }
+    }
+
+    m_tileFunc = nullptr;
+    m_stopFunc = nullptr;
+    m_progressStep = 0;
+
+    // Drop the tiles left by a stopped pass
+    for( std::unique_ptr<WORKER_QUEUE>& queue : m_queues )
+        queue->m_tiles.clear();
+
+    return m_tilesDone;
+}
+
+
+void CTILE_SCHEDULER::workerLoop( size_t aWorker )
+{
+    unsigned int passId = 0;
+
+    while( true )
+    {
+        const std::function<void( size_t )>* tileFunc;
+        const std::function<bool()>*         stopFunc;
+        size_t                               progressStep;
+
+        {
+            std::unique_lock<std::mutex> lock( m_lock );
+
+            m_wakeWorkers.wait( lock, [&]() { return m_quit || m_passId != passId; } );
+
+            if( m_quit )
+                return;
+
+            passId = m_passId;
+            tileFunc = m_tileFunc;
+            stopFunc = m_stopFunc;
+            progressStep = m_progressStep;
+        }
+
+        size_t tile;
+
+        while( !( stopFunc && ( *stopFunc )() ) && popTile( aWorker, tile ) )
+        {
+            ( *tileFunc )( tile );
+
+            const size_t done = ++m_tilesDone;
+
+            if( progressStep && ( done % progressStep == 0 ) )
+            {
+                // Take the lock so the notification cannot be missed by Run()
+                std::lock_guard<std::mutex> lock( m_lock );
+                m_passChanged.notify_one();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( m_lock );
+
+            if( --m_busyWorkers == 0 )
+                m_passChanged.notify_one();
+        }
+    }
+}
+
+
+bool CTILE_SCHEDULER::popTile( size_t aWorker, size_t& aTile )
+{
+    {
+        WORKER_QUEUE& queue = *m_queues[aWorker];
+
+        std::lock_guard<std::mutex> lock( queue.m_lock );
+
+        if( !queue.m_tiles.empty() )
+        {
+            aTile = queue.m_tiles.front();
+            queue.m_tiles.pop_front();
+            return true;
+        }
+    }
+
+    // Steal from the back of the other queues, away from the tiles their owner works on
+    for( size_t ii = 1; ii < m_queues.size(); ++ii )
+    {
+        WORKER_QUEUE& victim = *m_queues[( aWorker + ii ) % m_queues.size()];
+
+        std::lock_guard<std::mutex> lock( victim.m_lock );
+
+        if( !victim.m_tiles.empty() )
+        {
+            aTile = victim.m_tiles.back();
+            victim.m_tiles.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,116 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  ctile_scheduler.h
+ * @brief Persistent worker threads processing the tiles of a render pass.
+ */
+
+#ifndef _CTILE_SCHEDULER_H_
+#define _CTILE_SCHEDULER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Run the tiles of a render pass on a set of threads kept alive between the passes.
+ *
+ * Each worker has its own queue of tiles.  A worker takes the tiles from the front of
+ * its queue and, once it is empty, steals them from the back of the queue of the other
+ * workers, so the load stays balanced when some tiles are much slower than others.
+ * The calling thread sleeps until the pass is finished or progressed, there is no
+ * polling.
+ */
+class CTILE_SCHEDULER
+{
+public:
+    /**
+     * @param aThreadsCount is the number of worker threads, 0 to use one per core.
+     */
+    explicit CTILE_SCHEDULER( size_t aThreadsCount = 0 );
+
+    ~CTILE_SCHEDULER();
+
+    CTILE_SCHEDULER( const CTILE_SCHEDULER& ) = delete;
+    CTILE_SCHEDULER& operator=( const CTILE_SCHEDULER& ) = delete;
+
+    size_t GetThreadsCount() const { return m_threads.size(); }
+
+    /**
+     * Process the tiles 0 to \a aTilesCount - 1 and wait for them.
+     *
+     * The first tiles are started first, so a pass sorted by priority shows its most
+     * interesting tiles first.
+     *
+     * @param aTileFunc is called on the worker threads with the index of each tile.
+     * @param aStopFunc, if set, is called by the workers before each tile.  Once it
+     * returns true, the tiles not started yet are dropped.
+     * @param aProgressFunc, if set, is called on the calling thread with the number
+     * of tiles done and the number of tiles, about each percent of the pass.
+     * @return the number of tiles processed.
+     */
+    size_t Run( size_t aTilesCount,
+                const std::function<void( size_t aTile )>& aTileFunc,
+                const std::function<bool()>& aStopFunc = nullptr,
+                const std::function<void( size_t aDone, size_t aTotal )>& aProgressFunc = nullptr );
+
+private:
+    struct WORKER_QUEUE
+    {
+        std::mutex         m_lock;
+        std::deque<size_t> m_tiles;
+    };
+
+    void workerLoop( size_t aWorker );
+
+    /**
+     * Take the next tile of the worker \a aWorker, or steal one from another worker.
+     * @return false if there is no tile left in any queue.
+     */
+    bool popTile( size_t aWorker, size_t& aTile );
+
+    std::vector<std::thread>                   m_threads;
+    std::vector<std::unique_ptr<WORKER_QUEUE>> m_queues;
+
+    std::mutex              m_lock;           ///< Protects the state of the current pass
+    std::condition_variable m_wakeWorkers;    ///< A pass was started or the pool is closed
+    std::condition_variable m_passChanged;    ///< A pass progressed or was finished
+
+    const std::function<void( size_t )>* m_tileFunc;
+    const std::function<bool()>*         m_stopFunc;
+
+    unsigned int        m_passId;             ///< Changed at each pass to wake the workers
+    size_t              m_busyWorkers;        ///< Workers not finished with the current pass
+    size_t              m_progressStep;       ///< Tiles between two progress notifications
+    std::atomic<size_t> m_tilesDone;
+    bool                m_quit;
+};
+
+#endif // _CTILE_SCHEDULER_H_
@@ -42,6 +42,25 @@ static void RAYPACKET_GenerateFrustum( CFRUSTUM *m_Frustum, RAY *m_ray )
 }
 
 
+void RAYPACKET_SOA::Init( const RAY *aRays )
+{
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        m_originX[i] = aRays[i].m_Origin.x;
+        m_originY[i] = aRays[i].m_Origin.y;
+        m_originZ[i] = aRays[i].m_Origin.z;
+
+        m_dirX[i] = aRays[i].m_Dir.x;
+        m_dirY[i] = aRays[i].m_Dir.y;
+        m_dirZ[i] = aRays[i].m_Dir.z;
+
+        m_invDirX[i] = aRays[i].m_InvDir.x;
+        m_invDirY[i] = aRays[i].m_InvDir.y;
+        m_invDirZ[i] = aRays[i].m_InvDir.z;
+    }
+}
+
+
 RAYPACKET::RAYPACKET( const CCAMERA &aCamera, const SFVEC2I &aWindowsPosition )
 {
     unsigned int i = 0;
@@ -66,6 +85,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera, const SFVEC2I &aWindowsPosition )
     wxASSERT( i == RAYPACKET_RAYS_PER_PACKET );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    m_soa.Init( m_ray );
 }
 
 
@@ -75,6 +95,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera,
     RAYPACKET_InitRays( aCamera, aWindowsPosition, m_ray );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    m_soa.Init( m_ray );
 }
 
 
@@ -88,6 +109,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera,
                                            m_ray );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    m_soa.Init( m_ray );
 }
 
 
@@ -119,6 +141,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera,
     wxASSERT( i == RAYPACKET_RAYS_PER_PACKET );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    m_soa.Init( m_ray );
 }
 
 
@@ -148,6 +171,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera,
     wxASSERT( i == RAYPACKET_RAYS_PER_PACKET );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    m_soa.Init( m_ray );
 }
 
 
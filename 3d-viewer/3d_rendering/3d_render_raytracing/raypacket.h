@@ -40,11 +40,36 @@
 #define RAYPACKET_RAYS_PER_PACKET (RAYPACKET_DIM * RAYPACKET_DIM)
 
 
+/**
+ * The rays of a packet stored as a structure of arrays, so the packet kernels
+ * can load the same component of consecutive rays in one SIMD register.
+ */
+struct RAYPACKET_SOA
+{
+    void Init( const RAY *aRays );
+
+    alignas( 32 ) float m_originX[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_originY[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_originZ[RAYPACKET_RAYS_PER_PACKET];
+
+    alignas( 32 ) float m_dirX[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_dirY[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_dirZ[RAYPACKET_RAYS_PER_PACKET];
+
+    alignas( 32 ) float m_invDirX[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_invDirY[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_invDirZ[RAYPACKET_RAYS_PER_PACKET];
+};
+
+
 struct RAYPACKET
 {
     CFRUSTUM    m_Frustum;
     RAY         m_ray[RAYPACKET_RAYS_PER_PACKET];
 
+    /// Copy of m_ray used by the packet kernels, see raypacket_kernels.h
+    RAYPACKET_SOA m_soa;
+
     RAYPACKET( const CCAMERA &aCamera,
                const SFVEC2I &aWindowsPosition );
 
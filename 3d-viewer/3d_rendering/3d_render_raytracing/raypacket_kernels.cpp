@@ -0,0 +1,574 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_kernels.cpp
+ * @brief SIMD kernels testing the rays of a packet against a box or a triangle.
+ */
+
+#include "raypacket_kernels.h"
+#include <cmath>
+#include <wx/debug.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define RAYPACKET_SSE2_KERNELS
+#include <emmintrin.h>
+#endif
+
+// The AVX kernels are built with a target attribute, so the rest of the code does not
+// require AVX: they are only available with the GCC and Clang x86 compilers
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define RAYPACKET_AVX_KERNELS
+#define RAYPACKET_AVX_TARGET __attribute__( ( target( "avx" ) ) )
+#include <immintrin.h>
+#endif
+
+
+RAYPACKET_ISA RAYPACKET_GetBestKernelISA()
+{
+#ifdef RAYPACKET_AVX_KERNELS
+    // s_kernelISA is set from a static initializer, which can run before the one setting
+    // up the CPU model data of __builtin_cpu_supports()
+    __builtin_cpu_init();
+
+    if( __builtin_cpu_supports( "avx" ) )
+        return RAYPACKET_ISA::AVX;
+#endif
+
+#ifdef RAYPACKET_SSE2_KERNELS
+    return RAYPACKET_ISA::SSE2;
+#else
+    return RAYPACKET_ISA::SCALAR;
+#endif
+}
+
+
+static RAYPACKET_ISA s_kernelISA = RAYPACKET_GetBestKernelISA();
+
+
+RAYPACKET_ISA RAYPACKET_GetKernelISA()
+{
+    return s_kernelISA;
+}
+
+
+void RAYPACKET_SetKernelISA( RAYPACKET_ISA aISA )
+{
+    const RAYPACKET_ISA best = RAYPACKET_GetBestKernelISA();
+
+    s_kernelISA = ( static_cast<int>( aISA ) > static_cast<int>( best ) ) ? best : aISA;
+}
+
+
+const char* RAYPACKET_GetKernelISAName( RAYPACKET_ISA aISA )
+{
+    switch( aISA )
+    {
+    case RAYPACKET_ISA::SCALAR: return "scalar";
+    case RAYPACKET_ISA::SSE2:   return "SSE2";
+    case RAYPACKET_ISA::AVX:    return "AVX";
+    }
+
+    return "";
+}
+
+
+// Scalar kernels
+// /////////////////////////////////////////////////////////////////////////////
+
+static uint64_t intersectBBoxScalar( const RAYPACKET &aRayPacket, const CBBOX &aBBox,
+                                     unsigned int aFirst, unsigned int aLast,
+                                     const HITINFO_PACKET *aHitInfoPacket )
+{
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst; i < aLast; ++i )
+    {
+        float hitT;
+
+        if( aBBox.Intersect( aRayPacket.m_ray[i], &hitT ) )
+            if( hitT < aHitInfoPacket[i].m_HitInfo.m_tHit )
+                mask |= uint64_t( 1 ) << i;
+    }
+
+    return mask;
+}
+
+
+static uint64_t intersectTriangleScalar( const RAYPACKET &aRayPacket,
+                                         const RAYPACKET_TRIANGLE &aTri,
+                                         unsigned int aFirst, unsigned int aLast,
+                                         const HITINFO_PACKET *aHitInfoPacket,
+                                         float *aOutT, float *aOutU, float *aOutV )
+{
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst; i < aLast; ++i )
+    {
+        const SFVEC3F &O = aRayPacket.m_ray[i].m_Origin;
+        const SFVEC3F &D = aRayPacket.m_ray[i].m_Dir;
+
+        const float lnd = 1.0f / ( D[aTri.k] + aTri.nu * D[aTri.ku] + aTri.nv * D[aTri.kv] );
+        const float t = ( aTri.nd - O[aTri.k] - aTri.nu * O[aTri.ku] - aTri.nv * O[aTri.kv] )
+                        * lnd;
+
+        if( !( ( aHitInfoPacket[i].m_HitInfo.m_tHit > t ) && ( t > 0.0f ) ) )
+            continue;
+
+        const float hu = O[aTri.ku] + t * D[aTri.ku] - aTri.au;
+        const float hv = O[aTri.kv] + t * D[aTri.kv] - aTri.av;
+        const float beta = hv * aTri.bnu + hu * aTri.bnv;
+
+        if( beta < 0.0f )
+            continue;
+
+        const float gamma = hu * aTri.cnu + hv * aTri.cnv;
+
+        if( gamma < 0.0f )
+            continue;
+
+        if( ( beta + gamma ) > 1.0f )
+            continue;
+
+        if( glm::dot( D, aTri.n ) > 0.0f )
+            continue;
+
+        aOutT[i] = t;
+        aOutU[i] = beta;
+        aOutV[i] = gamma;
+        mask |= uint64_t( 1 ) << i;
+    }
+
+    return mask;
+}
+
+
+static const float* soaComponent( const float* aX, const float* aY, const float* aZ,
+                                  unsigned int aAxis )
+{
+    wxASSERT( aAxis < 3 );
+
+    return ( aAxis == 0 ) ? aX : ( ( aAxis == 1 ) ? aY : aZ );
+}
+
+
+// SSE2 kernels, 4 rays at once
+// /////////////////////////////////////////////////////////////////////////////
+
+#ifdef RAYPACKET_SSE2_KERNELS
+
+static inline __m128 loadHitT4( const HITINFO_PACKET *aHitInfoPacket, unsigned int i )
+{
+    return _mm_set_ps( aHitInfoPacket[i + 3].m_HitInfo.m_tHit,
+                       aHitInfoPacket[i + 2].m_HitInfo.m_tHit,
+                       aHitInfoPacket[i + 1].m_HitInfo.m_tHit,
+                       aHitInfoPacket[i + 0].m_HitInfo.m_tHit );
+}
+
+
+/**
+ * Get the distances to the two planes of a slab, ordered.
+ *
+ * A ray parallel to the slab and starting on one of its planes gives a NaN (0 * inf):
+ * it is inside the slab, as for the scalar test.
+ */
+static inline void slabSSE2( __m128 t0, __m128 t1, __m128& aNear, __m128& aFar )
+{
+    const __m128 ordered = _mm_cmpord_ps( t0, t1 );
+
+    aNear = _mm_or_ps( _mm_and_ps( ordered, _mm_min_ps( t0, t1 ) ),
+                       _mm_andnot_ps( ordered, _mm_set1_ps( -INFINITY ) ) );
+    aFar  = _mm_or_ps( _mm_and_ps( ordered, _mm_max_ps( t0, t1 ) ),
+                       _mm_andnot_ps( ordered, _mm_set1_ps( INFINITY ) ) );
+}
+
+
+static uint64_t intersectBBoxSSE2( const RAYPACKET &aRayPacket, const CBBOX &aBBox,
+                                   unsigned int aFirst, unsigned int aLast,
+                                   const HITINFO_PACKET *aHitInfoPacket )
+{
+    const RAYPACKET_SOA &r = aRayPacket.m_soa;
+
+    const __m128 minX = _mm_set1_ps( aBBox.Min().x );
+    const __m128 minY = _mm_set1_ps( aBBox.Min().y );
+    const __m128 minZ = _mm_set1_ps( aBBox.Min().z );
+    const __m128 maxX = _mm_set1_ps( aBBox.Max().x );
+    const __m128 maxY = _mm_set1_ps( aBBox.Max().y );
+    const __m128 maxZ = _mm_set1_ps( aBBox.Max().z );
+    const __m128 zero = _mm_setzero_ps();
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < aLast; i += 4 )
+    {
+        const __m128 ox = _mm_load_ps( &r.m_originX[i] );
+        const __m128 oy = _mm_load_ps( &r.m_originY[i] );
+        const __m128 oz = _mm_load_ps( &r.m_originZ[i] );
+
+        const __m128 tx0 = _mm_mul_ps( _mm_sub_ps( minX, ox ), _mm_load_ps( &r.m_invDirX[i] ) );
+        const __m128 tx1 = _mm_mul_ps( _mm_sub_ps( maxX, ox ), _mm_load_ps( &r.m_invDirX[i] ) );
+        const __m128 ty0 = _mm_mul_ps( _mm_sub_ps( minY, oy ), _mm_load_ps( &r.m_invDirY[i] ) );
+        const __m128 ty1 = _mm_mul_ps( _mm_sub_ps( maxY, oy ), _mm_load_ps( &r.m_invDirY[i] ) );
+        const __m128 tz0 = _mm_mul_ps( _mm_sub_ps( minZ, oz ), _mm_load_ps( &r.m_invDirZ[i] ) );
+        const __m128 tz1 = _mm_mul_ps( _mm_sub_ps( maxZ, oz ), _mm_load_ps( &r.m_invDirZ[i] ) );
+
+        __m128 nearX, farX, nearY, farY, nearZ, farZ;
+
+        slabSSE2( tx0, tx1, nearX, farX );
+        slabSSE2( ty0, ty1, nearY, farY );
+        slabSSE2( tz0, tz1, nearZ, farZ );
+
+        const __m128 tNear = _mm_max_ps( _mm_max_ps( nearX, nearY ), nearZ );
+        const __m128 tFar  = _mm_min_ps( _mm_min_ps( farX, farY ), farZ );
+
+        const __m128 hit = _mm_and_ps( _mm_cmpge_ps( tFar, _mm_max_ps( tNear, zero ) ),
+                                       _mm_cmplt_ps( tNear, loadHitT4( aHitInfoPacket, i ) ) );
+
+        mask |= uint64_t( _mm_movemask_ps( hit ) ) << i;
+    }
+
+    return mask & RAYPACKET_RangeMask( aFirst, aLast );
+}
+
+
+static uint64_t intersectTriangleSSE2( const RAYPACKET &aRayPacket,
+                                       const RAYPACKET_TRIANGLE &aTri,
+                                       unsigned int aFirst, unsigned int aLast,
+                                       const HITINFO_PACKET *aHitInfoPacket,
+                                       float *aOutT, float *aOutU, float *aOutV )
+{
+    const RAYPACKET_SOA &r = aRayPacket.m_soa;
+
+    const float* ok  = soaComponent( r.m_originX, r.m_originY, r.m_originZ, aTri.k );
+    const float* oku = soaComponent( r.m_originX, r.m_originY, r.m_originZ, aTri.ku );
+    const float* okv = soaComponent( r.m_originX, r.m_originY, r.m_originZ, aTri.kv );
+    const float* dk  = soaComponent( r.m_dirX, r.m_dirY, r.m_dirZ, aTri.k );
+    const float* dku = soaComponent( r.m_dirX, r.m_dirY, r.m_dirZ, aTri.ku );
+    const float* dkv = soaComponent( r.m_dirX, r.m_dirY, r.m_dirZ, aTri.kv );
+
+    const __m128 nu  = _mm_set1_ps( aTri.nu );
+    const __m128 nv  = _mm_set1_ps( aTri.nv );
+    const __m128 nd  = _mm_set1_ps( aTri.nd );
+    const __m128 au  = _mm_set1_ps( aTri.au );
+    const __m128 av  = _mm_set1_ps( aTri.av );
+    const __m128 bnu = _mm_set1_ps( aTri.bnu );
+    const __m128 bnv = _mm_set1_ps( aTri.bnv );
+    const __m128 cnu = _mm_set1_ps( aTri.cnu );
+    const __m128 cnv = _mm_set1_ps( aTri.cnv );
+    const __m128 nx  = _mm_set1_ps( aTri.n.x );
+    const __m128 ny  = _mm_set1_ps( aTri.n.y );
+    const __m128 nz  = _mm_set1_ps( aTri.n.z );
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one  = _mm_set1_ps( 1.0f );
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < aLast; i += 4 )
+    {
+        const __m128 Ok  = _mm_load_ps( &ok[i] );
+        const __m128 Oku = _mm_load_ps( &oku[i] );
+        const __m128 Okv = _mm_load_ps( &okv[i] );
+        const __m128 Dk  = _mm_load_ps( &dk[i] );
+        const __m128 Dku = _mm_load_ps( &dku[i] );
+        const __m128 Dkv = _mm_load_ps( &dkv[i] );
+
+        const __m128 lnd = _mm_div_ps( one, _mm_add_ps( _mm_add_ps( Dk, _mm_mul_ps( nu, Dku ) ),
+                                                        _mm_mul_ps( nv, Dkv ) ) );
+
+        const __m128 t = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( nd, Ok ),
+                                                             _mm_mul_ps( nu, Oku ) ),
+                                                 _mm_mul_ps( nv, Okv ) ),
+                                     lnd );
+
+        __m128 valid = _mm_and_ps( _mm_cmpgt_ps( loadHitT4( aHitInfoPacket, i ), t ),
+                                   _mm_cmpgt_ps( t, zero ) );
+
+        if( !_mm_movemask_ps( valid ) )
+            continue;
+
+        const __m128 hu = _mm_sub_ps( _mm_add_ps( Oku, _mm_mul_ps( t, Dku ) ), au );
+        const __m128 hv = _mm_sub_ps( _mm_add_ps( Okv, _mm_mul_ps( t, Dkv ) ), av );
+
+        const __m128 beta  = _mm_add_ps( _mm_mul_ps( hv, bnu ), _mm_mul_ps( hu, bnv ) );
+        const __m128 gamma = _mm_add_ps( _mm_mul_ps( hu, cnu ), _mm_mul_ps( hv, cnv ) );
+
+        const __m128 DdotN = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_load_ps( &r.m_dirX[i] ), nx ),
+                                                     _mm_mul_ps( _mm_load_ps( &r.m_dirY[i] ), ny ) ),
+                                         _mm_mul_ps( _mm_load_ps( &r.m_dirZ[i] ), nz ) );
+
+        valid = _mm_and_ps( valid, _mm_cmpnlt_ps( beta, zero ) );
+        valid = _mm_and_ps( valid, _mm_cmpnlt_ps( gamma, zero ) );
+        valid = _mm_and_ps( valid, _mm_cmpngt_ps( _mm_add_ps( beta, gamma ), one ) );
+        valid = _mm_and_ps( valid, _mm_cmpngt_ps( DdotN, zero ) );
+
+        const int hits = _mm_movemask_ps( valid );
+
+        if( !hits )
+            continue;
+
+        _mm_storeu_ps( &aOutT[i], t );
+        _mm_storeu_ps( &aOutU[i], beta );
+        _mm_storeu_ps( &aOutV[i], gamma );
+
+        mask |= uint64_t( hits ) << i;
+    }
+
+    return mask & RAYPACKET_RangeMask( aFirst, aLast );
+}
+
+#endif // RAYPACKET_SSE2_KERNELS
+
+
+// AVX kernels, 8 rays at once
+// /////////////////////////////////////////////////////////////////////////////
+
+#ifdef RAYPACKET_AVX_KERNELS
+
+RAYPACKET_AVX_TARGET
+static inline __m256 loadHitT8( const HITINFO_PACKET *aHitInfoPacket, unsigned int i )
+{
+    return _mm256_set_ps( aHitInfoPacket[i + 7].m_HitInfo.m_tHit,
+                          aHitInfoPacket[i + 6].m_HitInfo.m_tHit,
+                          aHitInfoPacket[i + 5].m_HitInfo.m_tHit,
+                          aHitInfoPacket[i + 4].m_HitInfo.m_tHit,
+                          aHitInfoPacket[i + 3].m_HitInfo.m_tHit,
+                          aHitInfoPacket[i + 2].m_HitInfo.m_tHit,
+                          aHitInfoPacket[i + 1].m_HitInfo.m_tHit,
+                          aHitInfoPacket[i + 0].m_HitInfo.m_tHit );
+}
+
+
+/// See slabSSE2()
+RAYPACKET_AVX_TARGET
+static inline void slabAVX( __m256 t0, __m256 t1, __m256& aNear, __m256& aFar )
+{
+    const __m256 ordered = _mm256_cmp_ps( t0, t1, _CMP_ORD_Q );
+
+    aNear = _mm256_blendv_ps( _mm256_set1_ps( -INFINITY ), _mm256_min_ps( t0, t1 ), ordered );
+    aFar  = _mm256_blendv_ps( _mm256_set1_ps( INFINITY ), _mm256_max_ps( t0, t1 ), ordered );
+}
+
+
+RAYPACKET_AVX_TARGET
+static uint64_t intersectBBoxAVX( const RAYPACKET &aRayPacket, const CBBOX &aBBox,
+                                  unsigned int aFirst, unsigned int aLast,
+                                  const HITINFO_PACKET *aHitInfoPacket )
+{
+    const RAYPACKET_SOA &r = aRayPacket.m_soa;
+
+    const __m256 minX = _mm256_set1_ps( aBBox.Min().x );
+    const __m256 minY = _mm256_set1_ps( aBBox.Min().y );
+    const __m256 minZ = _mm256_set1_ps( aBBox.Min().z );
+    const __m256 maxX = _mm256_set1_ps( aBBox.Max().x );
+    const __m256 maxY = _mm256_set1_ps( aBBox.Max().y );
+    const __m256 maxZ = _mm256_set1_ps( aBBox.Max().z );
+    const __m256 zero = _mm256_setzero_ps();
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~7u; i < aLast; i += 8 )
+    {
+        const __m256 ox = _mm256_load_ps( &r.m_originX[i] );
+        const __m256 oy = _mm256_load_ps( &r.m_originY[i] );
+        const __m256 oz = _mm256_load_ps( &r.m_originZ[i] );
+
+        const __m256 ix = _mm256_load_ps( &r.m_invDirX[i] );
+        const __m256 iy = _mm256_load_ps( &r.m_invDirY[i] );
+        const __m256 iz = _mm256_load_ps( &r.m_invDirZ[i] );
+
+        const __m256 tx0 = _mm256_mul_ps( _mm256_sub_ps( minX, ox ), ix );
+        const __m256 tx1 = _mm256_mul_ps( _mm256_sub_ps( maxX, ox ), ix );
+        const __m256 ty0 = _mm256_mul_ps( _mm256_sub_ps( minY, oy ), iy );
+        const __m256 ty1 = _mm256_mul_ps( _mm256_sub_ps( maxY, oy ), iy );
+        const __m256 tz0 = _mm256_mul_ps( _mm256_sub_ps( minZ, oz ), iz );
+        const __m256 tz1 = _mm256_mul_ps( _mm256_sub_ps( maxZ, oz ), iz );
+
+        __m256 nearX, farX, nearY, farY, nearZ, farZ;
+
+        slabAVX( tx0, tx1, nearX, farX );
+        slabAVX( ty0, ty1, nearY, farY );
+        slabAVX( tz0, tz1, nearZ, farZ );
+
+        const __m256 tNear = _mm256_max_ps( _mm256_max_ps( nearX, nearY ), nearZ );
+        const __m256 tFar  = _mm256_min_ps( _mm256_min_ps( farX, farY ), farZ );
+
+        const __m256 hit = _mm256_and_ps(
+                _mm256_cmp_ps( tFar, _mm256_max_ps( tNear, zero ), _CMP_GE_OQ ),
+                _mm256_cmp_ps( tNear, loadHitT8( aHitInfoPacket, i ), _CMP_LT_OQ ) );
+
+        mask |= uint64_t( _mm256_movemask_ps( hit ) ) << i;
+    }
+
+    return mask & RAYPACKET_RangeMask( aFirst, aLast );
+}
+
+
+RAYPACKET_AVX_TARGET
+static uint64_t intersectTriangleAVX( const RAYPACKET &aRayPacket,
+                                      const RAYPACKET_TRIANGLE &aTri,
+                                      unsigned int aFirst, unsigned int aLast,
+                                      const HITINFO_PACKET *aHitInfoPacket,
+                                      float *aOutT, float *aOutU, float *aOutV )
+{
+    const RAYPACKET_SOA &r = aRayPacket.m_soa;
+
+    const float* ok  = soaComponent( r.m_originX, r.m_originY, r.m_originZ, aTri.k );
+    const float* oku = soaComponent( r.m_originX, r.m_originY, r.m_originZ, aTri.ku );
+    const float* okv = soaComponent( r.m_originX, r.m_originY, r.m_originZ, aTri.kv );
+    const float* dk  = soaComponent( r.m_dirX, r.m_dirY, r.m_dirZ, aTri.k );
+    const float* dku = soaComponent( r.m_dirX, r.m_dirY, r.m_dirZ, aTri.ku );
+    const float* dkv = soaComponent( r.m_dirX, r.m_dirY, r.m_dirZ, aTri.kv );
+
+    const __m256 nu  = _mm256_set1_ps( aTri.nu );
+    const __m256 nv  = _mm256_set1_ps( aTri.nv );
+    const __m256 nd  = _mm256_set1_ps( aTri.nd );
+    const __m256 au  = _mm256_set1_ps( aTri.au );
+    const __m256 av  = _mm256_set1_ps( aTri.av );
+    const __m256 bnu = _mm256_set1_ps( aTri.bnu );
+    const __m256 bnv = _mm256_set1_ps( aTri.bnv );
+    const __m256 cnu = _mm256_set1_ps( aTri.cnu );
+    const __m256 cnv = _mm256_set1_ps( aTri.cnv );
+    const __m256 nx  = _mm256_set1_ps( aTri.n.x );
+    const __m256 ny  = _mm256_set1_ps( aTri.n.y );
+    const __m256 nz  = _mm256_set1_ps( aTri.n.z );
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one  = _mm256_set1_ps( 1.0f );
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~7u; i < aLast; i += 8 )
+    {
+        const __m256 Ok  = _mm256_load_ps( &ok[i] );
+        const __m256 Oku = _mm256_load_ps( &oku[i] );
+        const __m256 Okv = _mm256_load_ps( &okv[i] );
+        const __m256 Dk  = _mm256_load_ps( &dk[i] );
+        const __m256 Dku = _mm256_load_ps( &dku[i] );
+        const __m256 Dkv = _mm256_load_ps( &dkv[i] );
+
+        const __m256 lnd = _mm256_div_ps( one,
+                _mm256_add_ps( _mm256_add_ps( Dk, _mm256_mul_ps( nu, Dku ) ),
+                               _mm256_mul_ps( nv, Dkv ) ) );
+
+        const __m256 t = _mm256_mul_ps(
+                _mm256_sub_ps( _mm256_sub_ps( _mm256_sub_ps( nd, Ok ), _mm256_mul_ps( nu, Oku ) ),
+                               _mm256_mul_ps( nv, Okv ) ),
+                lnd );
+
+        __m256 valid = _mm256_and_ps(
+                _mm256_cmp_ps( loadHitT8( aHitInfoPacket, i ), t, _CMP_GT_OQ ),
+                _mm256_cmp_ps( t, zero, _CMP_GT_OQ ) );
+
+        if( !_mm256_movemask_ps( valid ) )
+            continue;
+
+        const __m256 hu = _mm256_sub_ps( _mm256_add_ps( Oku, _mm256_mul_ps( t, Dku ) ), au );
+        const __m256 hv = _mm256_sub_ps( _mm256_add_ps( Okv, _mm256_mul_ps( t, Dkv ) ), av );
+
+        const __m256 beta  = _mm256_add_ps( _mm256_mul_ps( hv, bnu ), _mm256_mul_ps( hu, bnv ) );
+        const __m256 gamma = _mm256_add_ps( _mm256_mul_ps( hu, cnu ), _mm256_mul_ps( hv, cnv ) );
+
+        const __m256 DdotN = _mm256_add_ps(
+                _mm256_add_ps( _mm256_mul_ps( _mm256_load_ps( &r.m_dirX[i] ), nx ),
+                               _mm256_mul_ps( _mm256_load_ps( &r.m_dirY[i] ), ny ) ),
+                _mm256_mul_ps( _mm256_load_ps( &r.m_dirZ[i] ), nz ) );
+
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( beta, zero, _CMP_NLT_UQ ) );
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( gamma, zero, _CMP_NLT_UQ ) );
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( _mm256_add_ps( beta, gamma ), one,
+                                                     _CMP_NGT_UQ ) );
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( DdotN, zero, _CMP_NGT_UQ ) );
+
+        const int hits = _mm256_movemask_ps( valid );
+
+        if( !hits )
+            continue;
+
+        _mm256_storeu_ps( &aOutT[i], t );
+        _mm256_storeu_ps( &aOutU[i], beta );
+        _mm256_storeu_ps( &aOutV[i], gamma );
+
+        mask |= uint64_t( hits ) << i;
+    }
+
+    return mask & RAYPACKET_RangeMask( aFirst, aLast );
+}
+
+#endif // RAYPACKET_AVX_KERNELS
+
+
+// Dispatch
+// /////////////////////////////////////////////////////////////////////////////
+
+uint64_t RAYPACKET_IntersectBBox( const RAYPACKET &aRayPacket, const CBBOX &aBBox,
+                                  unsigned int aFirst, unsigned int aLast,
+                                  const HITINFO_PACKET *aHitInfoPacket )
+{
+    wxASSERT( aFirst <= aLast );
+    wxASSERT( aLast <= RAYPACKET_RAYS_PER_PACKET );
+
+    switch( s_kernelISA )
+    {
+#ifdef RAYPACKET_AVX_KERNELS
+    case RAYPACKET_ISA::AVX:
+        return intersectBBoxAVX( aRayPacket, aBBox, aFirst, aLast, aHitInfoPacket );
+#endif
+
+#ifdef RAYPACKET_SSE2_KERNELS
+    case RAYPACKET_ISA::SSE2:
+        return intersectBBoxSSE2( aRayPacket, aBBox, aFirst, aLast, aHitInfoPacket );
+#endif
+
+    default:
+        return intersectBBoxScalar( aRayPacket, aBBox, aFirst, aLast, aHitInfoPacket );
+    }
+}
+
+
+uint64_t RAYPACKET_IntersectTriangle( const RAYPACKET &aRayPacket,
+                                      const RAYPACKET_TRIANGLE &aTriangle,
+                                      unsigned int aFirst, unsigned int aLast,
+                                      const HITINFO_PACKET *aHitInfoPacket,
+                                      float *aOutT, float *aOutU, float *aOutV )
+{
+    wxASSERT( aFirst <= aLast );
+    wxASSERT( aLast <= RAYPACKET_RAYS_PER_PACKET );
+
+    switch( s_kernelISA )
+    {
+#ifdef RAYPACKET_AVX_KERNELS
+    case RAYPACKET_ISA::AVX:
+        return intersectTriangleAVX( aRayPacket, aTriangle, aFirst, aLast, aHitInfoPacket,
+                                     aOutT, aOutU, aOutV );
+#endif
+
+#ifdef RAYPACKET_SSE2_KERNELS
+    case RAYPACKET_ISA::SSE2:
+        return intersectTriangleSSE2( aRayPacket, aTriangle, aFirst, aLast, aHitInfoPacket,
+                                      aOutT, aOutU, aOutV );
+#endif
+
+    default:
+        return intersectTriangleScalar( aRayPacket, aTriangle, aFirst, aLast, aHitInfoPacket,
+                                        aOutT, aOutU, aOutV );
+    }
+}
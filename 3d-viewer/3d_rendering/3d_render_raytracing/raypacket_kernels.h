@@ -0,0 +1,168 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_kernels.h
+ * @brief SIMD kernels testing the rays of a packet against a box or a triangle.
+ *
+ * The kernels process 4 (SSE2) or 8 (AVX) rays at once from the RAYPACKET_SOA copy of
+ * the rays. The instruction set is chosen at run time from the ones supported by the
+ * build and the CPU, with a scalar fallback doing the same tests one ray at a time.
+ */
+
+#ifndef _RAYPACKET_KERNELS_H_
+#define _RAYPACKET_KERNELS_H_
+
+#include "raypacket.h"
+#include "hitinfo.h"
+#include <cstdint>
+
+static_assert( RAYPACKET_RAYS_PER_PACKET == 64, "A mask of packet rays is an uint64_t" );
+
+
+enum class RAYPACKET_ISA
+{
+    SCALAR,
+    SSE2,
+    AVX
+};
+
+
+/**
+ * @return the fastest instruction set supported by both this build and the CPU.
+ */
+RAYPACKET_ISA RAYPACKET_GetBestKernelISA();
+
+/**
+ * @return the instruction set used by the packet kernels.
+ */
+RAYPACKET_ISA RAYPACKET_GetKernelISA();
+
+/**
+ * Set the instruction set used by the packet kernels, to compare them in benchmarks.
+ * @param aISA is the wanted instruction set, lowered to RAYPACKET_GetBestKernelISA().
+ */
+void RAYPACKET_SetKernelISA( RAYPACKET_ISA aISA );
+
+const char* RAYPACKET_GetKernelISAName( RAYPACKET_ISA aISA );
+
+
+/**
+ * @return the mask of the rays from \a aFirst to \a aLast (excluded).
+ */
+inline uint64_t RAYPACKET_RangeMask( unsigned int aFirst, unsigned int aLast )
+{
+    const uint64_t belowLast = ( aLast >= RAYPACKET_RAYS_PER_PACKET ) ? ~uint64_t( 0 )
+                                                                      : ( uint64_t( 1 ) << aLast ) - 1;
+
+    return belowLast & ~( ( uint64_t( 1 ) << aFirst ) - 1 );
+}
+
+
+/**
+ * @return the index of the first ray of a non empty mask.
+ */
+inline unsigned int RAYPACKET_FirstRay( uint64_t aMask )
+{
+#if defined( __GNUC__ )
+    return __builtin_ctzll( aMask );
+#else
+    unsigned int i = 0;
+
+    while( !( aMask & 1 ) )
+    {
+        aMask >>= 1;
+        ++i;
+    }
+
+    return i;
+#endif
+}
+
+
+/**
+ * @return the index of the last ray of a non empty mask.
+ */
+inline unsigned int RAYPACKET_LastRay( uint64_t aMask )
+{
+#if defined( __GNUC__ )
+    return 63 - __builtin_clzll( aMask );
+#else
+    unsigned int i = 63;
+
+    while( !( aMask & ( uint64_t( 1 ) << 63 ) ) )
+    {
+        aMask <<= 1;
+        --i;
+    }
+
+    return i;
+#endif
+}
+
+
+/**
+ * Intersect the rays from \a aFirst to \a aLast (excluded) of a packet with a box.
+ *
+ * @param aHitInfoPacket is the current hit of the rays, a ray hitting the box farther
+ * than its current hit is not in the result.
+ * @return the mask of the rays hitting the box.
+ */
+uint64_t RAYPACKET_IntersectBBox( const RAYPACKET &aRayPacket, const CBBOX &aBBox,
+                                  unsigned int aFirst, unsigned int aLast,
+                                  const HITINFO_PACKET *aHitInfoPacket );
+
+
+/**
+ * The constants of the projection triangle test of CTRIANGLE, for the packet kernel.
+ *
+ * k is the dominant axis of the normal, ku and kv the two other axes.
+ */
+struct RAYPACKET_TRIANGLE
+{
+    unsigned int k, ku, kv;
+    float        nu, nv, nd;
+    float        au, av;        ///< The first vertex along ku and kv
+    float        bnu, bnv;
+    float        cnu, cnv;
+    SFVEC3F      n;             ///< The face normal, to discard the back faces
+};
+
+
+/**
+ * Intersect the rays from \a aFirst to \a aLast (excluded) of a packet with the front
+ * face of a triangle.
+ *
+ * @param aHitInfoPacket is the current hit of the rays, a ray hitting the triangle
+ * farther than its current hit is not in the result.
+ * @param aOutT, aOutU, aOutV receive, at the index of each ray in the result, the
+ * distance and the barycentric coordinates of its hit.
+ * @return the mask of the rays hitting the triangle.
+ */
+uint64_t RAYPACKET_IntersectTriangle( const RAYPACKET &aRayPacket,
+                                      const RAYPACKET_TRIANGLE &aTriangle,
+                                      unsigned int aFirst, unsigned int aLast,
+                                      const HITINFO_PACKET *aHitInfoPacket,
+                                      float *aOutT, float *aOutU, float *aOutV );
+
+#endif // _RAYPACKET_KERNELS_H_
@@ -31,6 +31,7 @@
 #define _COBJECT2D_H_
 
 #include "cbbox2d.h"
+#include <atomic>
 #include <cstring>
 
 #include <class_board_item.h>
@@ -134,7 +135,8 @@ class COBJECT2D_STATS
 public:
     void ResetStats()
     {
-        memset( m_counter, 0, sizeof( unsigned int ) * static_cast<int>( OBJECT2D_TYPE::MAX ) );
+        for( std::atomic<unsigned int>& counter : m_counter )
+            counter = 0;
     }
 
     unsigned int GetCountOf( OBJECT2D_TYPE aObjType ) const
@@ -164,7 +166,8 @@ private:
     ~COBJECT2D_STATS(){}
 
 private:
-    unsigned int m_counter[static_cast<int>( OBJECT2D_TYPE::MAX )];
+    // Objects are created from several threads when building the board layers
+    std::atomic<unsigned int> m_counter[static_cast<int>( OBJECT2D_TYPE::MAX )];
 
     static COBJECT2D_STATS *s_instance;
 };
@@ -132,7 +132,8 @@ void Convert_shape_line_polygon_to_triangles( SHAPE_POLY_SET &aPolyList,
                                               const BOARD_ITEM &aBoardItem )
 {
 
-    aPolyList.CacheTriangulation( false );
+    // Usually called from the threads building the layers
+    aPolyList.CacheTriangulation( false, false );
     const double conver_d = (double)aBiuTo3DunitsScale;
 
     for( unsigned int j = 0; j < aPolyList.TriangulatedPolyCount(); j++ )
@@ -32,6 +32,7 @@
 
 #include "cbbox.h"
 #include "../hitinfo.h"
+#include <cstdint>
 #include "../cmaterial.h"
 
 
@@ -102,6 +103,18 @@ public:
      */
     virtual bool IntersectP( const RAY &aRay, float aMaxDistance ) const = 0;
 
+    /**
+     * Intersect the rays from \a aFirst to \a aLast (excluded) of a packet.
+     *
+     * The hit information of the rays hitting the object closer than their current hit
+     * is updated, as done by Intersect(). The default implementation intersects the rays
+     * one at a time.
+     * @return the mask of the rays hitting the object.
+     */
+    virtual uint64_t IntersectPacket( const RAYPACKET &aRayPacket,
+                                      unsigned int aFirst, unsigned int aLast,
+                                      HITINFO_PACKET *aHitInfoPacket ) const;
+
     const CBBOX &GetBBox() const { return m_bbox; }
 
     const SFVEC3F &GetCentroid() const { return m_centroid; }
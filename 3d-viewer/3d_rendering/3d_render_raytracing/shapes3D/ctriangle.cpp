@@ -32,6 +32,7 @@
 
 
 #include "ctriangle.h"
+#include "../raypacket_kernels.h"
 
 
 void CTRIANGLE::pre_calc_const()
@@ -246,6 +247,16 @@ bool CTRIANGLE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
     if( glm::dot( D, m_n ) > 0.0f )
         return false;
 
+    setHitInfo( aRay, aHitInfo, t, u, v );
+
+    return true;
+#undef ku
+#undef kv
+}
+
+
+void CTRIANGLE::setHitInfo( const RAY &aRay, HITINFO &aHitInfo, float t, float u, float v ) const
+{
     aHitInfo.m_tHit = t;
     aHitInfo.m_HitPoint = aRay.at( t );
 
@@ -257,10 +268,44 @@ bool CTRIANGLE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
     m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
     aHitInfo.pHitObject = this;
+}
 
-    return true;
-#undef ku
-#undef kv
+
+uint64_t CTRIANGLE::IntersectPacket( const RAYPACKET &aRayPacket,
+                                     unsigned int aFirst, unsigned int aLast,
+                                     HITINFO_PACKET *aHitInfoPacket ) const
+{
+    RAYPACKET_TRIANGLE tri;
+
+    tri.k   = m_k;
+    tri.ku  = s_modulo[m_k + 1];
+    tri.kv  = s_modulo[m_k + 2];
+    tri.nu  = m_nu;
+    tri.nv  = m_nv;
+    tri.nd  = m_nd;
+    tri.au  = m_vertex[0][tri.ku];
+    tri.av  = m_vertex[0][tri.kv];
+    tri.bnu = m_bnu;
+    tri.bnv = m_bnv;
+    tri.cnu = m_cnu;
+    tri.cnv = m_cnv;
+    tri.n   = m_n;
+
+    float hitT[RAYPACKET_RAYS_PER_PACKET];
+    float hitU[RAYPACKET_RAYS_PER_PACKET];
+    float hitV[RAYPACKET_RAYS_PER_PACKET];
+
+    const uint64_t mask = RAYPACKET_IntersectTriangle( aRayPacket, tri, aFirst, aLast,
+                                                       aHitInfoPacket, hitT, hitU, hitV );
+
+    for( uint64_t hits = mask; hits; hits &= hits - 1 )
+    {
+        const unsigned int i = RAYPACKET_FirstRay( hits );
+
+        setHitInfo( aRayPacket.m_ray[i], aHitInfoPacket[i].m_HitInfo, hitT[i], hitU[i], hitV[i] );
+    }
+
+    return mask;
 }
 
 
@@ -70,10 +70,15 @@ public:
                          REPORTER* aWarningReporter = NULL ) = 0;
 
     /**
-     * @brief ReloadRequest - !TODO: this must be reviewed to add flags to
-     * improve specific render
+     * @brief ReloadRequest - Request to rebuild the scene at the next redraw
+     * @param aDirtyLayers: the layers whose items have changed, all the layers by
+     * default. The other layers are not rebuilt by the board adapter.
      */
-    void ReloadRequest() { m_reloadRequested = true; }
+    void ReloadRequest( const LSET& aDirtyLayers = LSET::AllLayersMask() )
+    {
+        m_boardAdapter.SetLayersDirty( aDirtyLayers );
+        m_reloadRequested = true;
+    }
 
     /**
      * @brief IsReloadRequestPending - Query if there is a pending reload request
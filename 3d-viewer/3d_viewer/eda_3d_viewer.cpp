@@ -253,17 +253,17 @@ void EDA_3D_VIEWER::setupUIConditions()
 }
 
 
-void EDA_3D_VIEWER::ReloadRequest()
+void EDA_3D_VIEWER::ReloadRequest( const LSET& aDirtyLayers )
 {
     // This will schedule a request to load later
     if( m_canvas )
-        m_canvas->ReloadRequest( GetBoard(), Prj().Get3DCacheManager() );
+        m_canvas->ReloadRequest( GetBoard(), Prj().Get3DCacheManager(), aDirtyLayers );
 }
 
 
-void EDA_3D_VIEWER::NewDisplay( bool aForceImmediateRedraw )
+void EDA_3D_VIEWER::NewDisplay( bool aForceImmediateRedraw, const LSET& aDirtyLayers )
 {
-    ReloadRequest();
+    ReloadRequest( aDirtyLayers );
 
     // After the ReloadRequest call, the refresh often takes a bit of time,
     // and it is made here only on request.
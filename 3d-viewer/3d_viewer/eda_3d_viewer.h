@@ -86,11 +86,11 @@ class EDA_3D_VIEWER : public EDA_3D_BOARD_HOLDER, public KIWAY_PLAYER
      * changes are committed.
      * This is made because the 3D rebuild can take a long time, and this rebuild
      * cannot always made after each change, for calculation time reason.
+     * @param aDirtyLayers = the layers whose items have changed, to only rebuild
+     * these layers. All the layers by default.
      */
-    void ReloadRequest();
+    void ReloadRequest( const LSET& aDirtyLayers = LSET::AllLayersMask() );
 
-    // !TODO: review this function: it need a way to tell what changed,
-    // to only reload/rebuild things that have really changed
     /**
      * Reload and refresh (rebuild)  the 3D scene.
      * Warning: rebuilding the 3D scene can take a bit of time, so
@@ -98,8 +98,11 @@ class EDA_3D_VIEWER : public EDA_3D_BOARD_HOLDER, public KIWAY_PLAYER
      * the next 3D canvas refresh (on zoom for instance)
      * @param aForceImmediateRedraw = true to immediately rebuild the 3D scene,
      * false to wait a refresh later.
+     * @param aDirtyLayers = the layers whose items have changed, to only rebuild
+     * these layers. All the layers by default.
      */
-    void NewDisplay( bool aForceImmediateRedraw = false );
+    void NewDisplay( bool aForceImmediateRedraw = false,
+                     const LSET& aDirtyLayers = LSET::AllLayersMask() );
 
     BOARD_ADAPTER& GetAdapter() override { return m_boardAdapter; }
     CCAMERA& GetCurrentCamera() override { return m_currentCamera; }
@@ -27,6 +27,17 @@
 
 #include <commit.h>
 #include <base_struct.h>
+#include <properties_undo_item.h>
+
+template <class Container, class F>
+void eraseIf( Container& c, F&& f )
+{
+    c.erase( std::remove_if( c.begin(),
+                    c.end(),
+                    std::forward<F>( f ) ),
+            c.end() );
+}
+
 
 COMMIT::COMMIT()
 {
@@ -39,6 +50,8 @@ COMMIT::~COMMIT()
     {
         if( ent.m_copy )
             delete ent.m_copy;
+
+        delete ent.m_properties;
     }
 }
 
@@ -69,7 +82,7 @@ COMMIT& COMMIT::Stage( EDA_ITEM* aItem, CHANGE_TYPE aChangeType )
             assert( parent );
 
             if( parent )
-                clone = parent->Clone();
+                clone = cloneWithoutPropertyChanges( parent );
 
             assert( clone );
 
@@ -87,6 +100,75 @@ COMMIT& COMMIT::Stage( EDA_ITEM* aItem, CHANGE_TYPE aChangeType )
 }
 
 
+COMMIT& COMMIT::ModifyProperties( EDA_ITEM* aItem )
+{
+    EDA_ITEM* parent = parentObject( aItem );
+
+    // The first modification of an item is the one to undo
+    if( m_changedItems.count( aItem ) )
+        return *this;
+
+    // A copy of the parent covers the properties of its children
+    if( parent != aItem && m_changedItems.count( parent ) )
+    {
+        COMMIT_LINE* parentEntry = findEntry( parent );
+
+        if( parentEntry && !parentEntry->m_properties )
+            return *this;
+    }
+
+    COMMIT_LINE ent;
+
+    ent.m_item = aItem;
+    ent.m_type = CHT_MODIFY;
+    ent.m_copy = nullptr;
+    ent.m_properties = new PROPERTIES_UNDO_ITEM( aItem );
+
+    m_changedItems.insert( aItem );
+    m_propertyParents.insert( parent );
+    m_changes.push_back( ent );
+
+    return *this;
+}
+
+
+EDA_ITEM* COMMIT::cloneWithoutPropertyChanges( EDA_ITEM* aParent )
+{
+    if( !m_propertyParents.count( aParent ) )
+        return aParent->Clone();
+
+    std::vector<COMMIT_LINE> entries;
+
+    for( const COMMIT_LINE& ent : m_changes )
+    {
+        if( ent.m_properties && parentObject( ent.m_item ) == aParent )
+            entries.push_back( ent );
+    }
+
+    // Swapping the values twice leaves the items in their current state
+    for( COMMIT_LINE& ent : entries )
+        ent.m_properties->Swap( ent.m_item );
+
+    EDA_ITEM* clone = aParent->Clone();
+
+    for( auto it = entries.rbegin(); it != entries.rend(); ++it )
+    {
+        it->m_properties->Swap( it->m_item );
+        delete it->m_properties;
+        m_changedItems.erase( it->m_item );
+    }
+
+    eraseIf( m_changes, [aParent, this]( const COMMIT_LINE& aEnt )
+                        {
+                            return aEnt.m_properties && parentObject( aEnt.m_item ) == aParent;
+                        } );
+
+    m_propertyParents.erase( aParent );
+
+    return clone;
+}
+
+
 COMMIT& COMMIT::Stage( std::vector<EDA_ITEM*>& container, CHANGE_TYPE aChangeType )
 {
     for( EDA_ITEM* item : container )
@@ -137,16 +219,6 @@ int COMMIT::GetStatus( EDA_ITEM* aItem )
 }
 
 
-template <class Container, class F>
-void eraseIf( Container& c, F&& f )
-{
-    c.erase( std::remove_if( c.begin(),
-                    c.end(),
-                    std::forward<F>( f ) ),
-            c.end() );
-}
-
-
 COMMIT& COMMIT::createModified( EDA_ITEM* aItem, EDA_ITEM* aCopy, int aExtraFlags )
 {
     EDA_ITEM* parent = parentObject( aItem );
@@ -172,6 +244,9 @@ void COMMIT::makeEntry( EDA_ITEM* aItem, CHANGE_TYPE aType, EDA_ITEM* aCopy )
     if( m_changedItems.find( aItem ) != m_changedItems.end() )
     {
         eraseIf( m_changes, [aItem] ( const COMMIT_LINE& aEnt ) {
+            if( aEnt.m_item == aItem )
+                delete aEnt.m_properties;
+
             return aEnt.m_item == aItem;
         } );
     }
@@ -181,6 +256,7 @@ void COMMIT::makeEntry( EDA_ITEM* aItem, CHANGE_TYPE aType, EDA_ITEM* aCopy )
     ent.m_item = aItem;
     ent.m_type = aType;
     ent.m_copy = aCopy;
+    ent.m_properties = nullptr;
 
     m_changedItems.insert( aItem );
     m_changes.push_back( ent );
@@ -88,6 +88,7 @@ EDA_BASE_FRAME::EDA_BASE_FRAME( wxWindow* aParent, FRAME_T aFrameType,
         m_autoSaveState( false ),
         m_autoSaveInterval(-1 ),
         m_UndoRedoCountMax( DEFAULT_MAX_UNDO_ITEMS ),
+        m_UndoRedoMemoryMax( 0 ),
         m_userUnits( EDA_UNITS::MILLIMETRES ),
         m_isClosing( false ),
         m_isNonUserClose( false )
@@ -903,6 +904,28 @@ void EDA_BASE_FRAME::ClearUndoRedoList()
 }
 
 
+/**
+ * @return the number of oldest commands of \a aList to delete so the estimated memory used by
+ * the commands fits in \a aBudget bytes.  The newest command is always kept.
+ */
+static int commandsOverBudget( const UNDO_REDO_CONTAINER& aList, size_t aBudget )
+{
+    int    count = aList.m_CommandsList.size();
+    size_t total = 0;
+
+    // The newest commands are the last ones
+    for( int ii = count - 1; ii >= 0; --ii )
+    {
+        total += aList.m_CommandsList[ii]->m_MemorySize;
+
+        if( total > aBudget && ii < count - 1 )
+            return ii + 1;
+    }
+
+    return 0;
+}
+
+
 void EDA_BASE_FRAME::PushCommandToUndoList( PICKED_ITEMS_LIST* aNewitem )
 {
     m_undoList.PushCommand( aNewitem );
@@ -915,6 +938,15 @@ void EDA_BASE_FRAME::PushCommandToUndoList( PICKED_ITEMS_LIST* aNewitem )
         if( extraitems > 0 )
             ClearUndoORRedoList( UNDO_LIST, extraitems );
     }
+
+    // Delete the oldest items, if the memory budget is exceeded
+    if( m_UndoRedoMemoryMax > 0 )
+    {
+        int extraitems = commandsOverBudget( m_undoList, m_UndoRedoMemoryMax );
+
+        if( extraitems > 0 )
+            ClearUndoORRedoList( UNDO_LIST, extraitems );
+    }
 }
 
 
@@ -930,6 +962,15 @@ void EDA_BASE_FRAME::PushCommandToRedoList( PICKED_ITEMS_LIST* aNewitem )
         if( extraitems > 0 )
             ClearUndoORRedoList( REDO_LIST, extraitems );
     }
+
+    // Delete the oldest items, if the memory budget is exceeded
+    if( m_UndoRedoMemoryMax > 0 )
+    {
+        int extraitems = commandsOverBudget( m_redoList, m_UndoRedoMemoryMax );
+
+        if( extraitems > 0 )
+            ClearUndoORRedoList( REDO_LIST, extraitems );
+    }
 }
 
 
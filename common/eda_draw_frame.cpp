@@ -545,6 +545,7 @@ void EDA_DRAW_FRAME::LoadSettings( APP_SETTINGS_BASE* aCfg )
     SetUserUnits( static_cast<EDA_UNITS>( aCfg->m_System.units ) );
 
     m_UndoRedoCountMax = aCfg->m_System.max_undo_items;
+    m_UndoRedoMemoryMax = size_t( std::max( aCfg->m_System.max_undo_memory, 0 ) ) * 1024 * 1024;
     m_firstRunDialogSetting = aCfg->m_System.first_run_shown;
 
     m_galDisplayOptions.ReadConfig( *cmnCfg, *window, this );
@@ -570,6 +571,7 @@ void EDA_DRAW_FRAME::SaveSettings( APP_SETTINGS_BASE* aCfg )
     aCfg->m_System.units = static_cast<int>( m_userUnits );
     aCfg->m_System.first_run_shown = m_firstRunDialogSetting;
     aCfg->m_System.max_undo_items = GetMaxUndoItems();
+    aCfg->m_System.max_undo_memory = GetMaxUndoMemory() / ( 1024 * 1024 );
 
     m_galDisplayOptions.WriteConfig( *window );
 
@@ -36,6 +36,7 @@
 #include <base_units.h>
 #include <basic_gal.h>        // for BASIC_GAL, basic_gal
 #include <common.h>           // for wxStringSplit
+#include <convert_basic_shapes_to_polygon.h> // for TransformOvalToPolygon
 #include <convert_to_biu.h>   // for Mils2iu
 #include <core/typeinfo.h>    // for KICAD_T, SCH_LABEL_T, SCH_TEXT_T, SCH_G...
 #include <eda_rect.h>         // for EDA_RECT
@@ -51,6 +52,7 @@
 #include <geometry/shape.h>
 #include <geometry/shape_segment.h>
 #include <geometry/shape_compound.h>
+#include <geometry/shape_poly_set.h>
 
 
 #include <wx/debug.h>         // for wxASSERT
@@ -118,6 +120,16 @@ EDA_TEXT::~EDA_TEXT()
 }
 
 
+EDA_TEXT::SHAPE_CACHE::SHAPE_CACHE()
+{
+}
+
+
+EDA_TEXT::SHAPE_CACHE::~SHAPE_CACHE()
+{
+}
+
+
 void EDA_TEXT::SetText( const wxString& aText )
 {
     m_text = aText;
@@ -187,6 +199,8 @@ bool EDA_TEXT::Replace( wxFindReplaceData& aSearchData )
 
 int EDA_TEXT::LenSize( const wxString& aLine, int aThickness ) const
 {
+    std::lock_guard<std::recursive_mutex> lock( basic_gal_mutex );
+
     basic_gal.SetFontItalic( IsItalic() );
     basic_gal.SetFontBold( IsBold() );
     basic_gal.SetLineWidth( (float) aThickness );
@@ -580,22 +594,62 @@ static void addTextSegmToBuffer( int x0, int y0, int xf, int yf, void* aData )
 }
 
 
-void EDA_TEXT::TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuffer ) const
+static bool sameEffects( const TEXT_EFFECTS& aLeft, const TEXT_EFFECTS& aRight )
+{
+    return aLeft.bits == aRight.bits && aLeft.hjustify == aRight.hjustify
+           && aLeft.vjustify == aRight.vjustify && aLeft.size == aRight.size
+           && aLeft.penwidth == aRight.penwidth && aLeft.angle == aRight.angle
+           && aLeft.pos == aRight.pos;
+}
+
+
+EDA_TEXT::SHAPE_CACHE_ENTRY& EDA_TEXT::updateShapeCache( double aAngle, int aPenWidth ) const
 {
+    // Texts are converted for a few angles and pen widths only: keep the latest ones
+    const size_t MAX_CACHE_ENTRIES = 4;
+
+    SHAPE_CACHE& cache = m_shapeCache;
+    wxString     text = GetShownText();
+
+    if( !sameEffects( cache.m_effects, m_e ) || cache.m_text != text )
+    {
+        cache.m_entries.clear();
+        cache.m_text = text;
+        cache.m_effects = m_e;
+    }
+
+    for( SHAPE_CACHE_ENTRY& entry : cache.m_entries )
+    {
+        if( entry.m_angle == aAngle && entry.m_penWidth == aPenWidth )
+            return entry;
+    }
+
+    if( cache.m_entries.size() >= MAX_CACHE_ENTRIES )
+        cache.m_entries.erase( cache.m_entries.begin() );
+
+    cache.m_entries.emplace_back();
+
+    SHAPE_CACHE_ENTRY& entry = cache.m_entries.back();
+
+    entry.m_angle = aAngle;
+    entry.m_penWidth = aPenWidth;
+    entry.m_polygonsValid = false;
+    entry.m_clearance = 0;
+    entry.m_error = 0;
+
     wxSize size = GetTextSize();
 
     if( IsMirrored() )
         size.x = -size.x;
 
     bool forceBold = true;
-    int  penWidth = 0;      // use max-width for bold text
 
     COLOR4D color = COLOR4D::BLACK;  // not actually used, but needed by GRText
 
     if( IsMultilineAllowed() )
     {
         wxArrayString strings_list;
-        wxStringSplit( GetShownText(), strings_list, wxChar('\n') );
+        wxStringSplit( text, strings_list, wxChar('\n') );
         std::vector<wxPoint> positions;
         positions.reserve( strings_list.Count() );
         GetLinePositions( positions, strings_list.Count());
@@ -603,17 +657,67 @@ void EDA_TEXT::TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuf
         for( unsigned ii = 0; ii < strings_list.Count(); ii++ )
         {
             wxString txt = strings_list.Item( ii );
-            GRText( NULL, positions[ii], color, txt, GetTextAngle(), size, GetHorizJustify(),
-                    GetVertJustify(), penWidth, IsItalic(), forceBold, addTextSegmToBuffer,
-                    &aCornerBuffer );
+            GRText( NULL, positions[ii], color, txt, aAngle, size, GetHorizJustify(),
+                    GetVertJustify(), aPenWidth, IsItalic(), forceBold, addTextSegmToBuffer,
+                    &entry.m_strokes );
         }
     }
     else
     {
-        GRText( NULL, GetTextPos(), color, GetText(), GetTextAngle(), size, GetHorizJustify(),
-                GetVertJustify(), penWidth, IsItalic(), forceBold, addTextSegmToBuffer,
-                &aCornerBuffer );
+        GRText( NULL, GetTextPos(), color, text, aAngle, size, GetHorizJustify(),
+                GetVertJustify(), aPenWidth, IsItalic(), forceBold, addTextSegmToBuffer,
+                &entry.m_strokes );
     }
+
+    return entry;
+}
+
+
+void EDA_TEXT::TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuffer ) const
+{
+    TransformTextShapeToSegmentList( aCornerBuffer, GetTextAngle(), 0 );
+}
+
+
+void EDA_TEXT::TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuffer,
+                                                double aAngle, int aPenWidth ) const
+{
+    std::lock_guard<std::mutex> lock( m_shapeCache.m_lock );
+    const SHAPE_CACHE_ENTRY&    entry = updateShapeCache( aAngle, aPenWidth );
+
+    aCornerBuffer.insert( aCornerBuffer.end(), entry.m_strokes.begin(), entry.m_strokes.end() );
+}
+
+
+void EDA_TEXT::TransformTextShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
+                                                         int aClearanceValue, int aError,
+                                                         double aAngle, int aPenWidth ) const
+{
+    std::lock_guard<std::mutex> lock( m_shapeCache.m_lock );
+    SHAPE_CACHE_ENTRY&          entry = updateShapeCache( aAngle, aPenWidth );
+
+    if( !entry.m_polygonsValid || entry.m_clearance != aClearanceValue
+            || entry.m_error != aError )
+    {
+        if( !entry.m_polygons )
+            entry.m_polygons.reset( new SHAPE_POLY_SET );
+
+        entry.m_polygons->RemoveAllContours();
+
+        int width = GetEffectiveTextPenWidth() + ( 2 * aClearanceValue );
+
+        for( size_t ii = 0; ii + 1 < entry.m_strokes.size(); ii += 2 )
+        {
+            TransformOvalToPolygon( *entry.m_polygons, entry.m_strokes[ii],
+                                    entry.m_strokes[ii + 1], width, aError );
+        }
+
+        entry.m_clearance = aClearanceValue;
+        entry.m_error = aError;
+        entry.m_polygonsValid = true;
+    }
+
+    aCornerBuffer.Append( *entry.m_polygons );
 }
 
 
@@ -0,0 +1,710 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/gal_display_list.h>
+#include <hash_eda.h>
+
+using namespace KIGFX;
+
+
+static void hashLineChain( size_t& aHash, const SHAPE_LINE_CHAIN& aChain )
+{
+    hash_combine( aHash, aChain.PointCount(), aChain.IsClosed() );
+
+    for( int ii = 0; ii < aChain.PointCount(); ++ii )
+        hash_combine( aHash, aChain.CPoint( ii ).x, aChain.CPoint( ii ).y );
+}
+
+
+static bool sameLineChain( const SHAPE_LINE_CHAIN& aChainA, const SHAPE_LINE_CHAIN& aChainB )
+{
+    if( aChainA.PointCount() != aChainB.PointCount() || aChainA.IsClosed() != aChainB.IsClosed() )
+        return false;
+
+    for( int ii = 0; ii < aChainA.PointCount(); ++ii )
+    {
+        if( aChainA.CPoint( ii ) != aChainB.CPoint( ii ) )
+            return false;
+    }
+
+    return true;
+}
+
+
+static void hashPolySet( size_t& aHash, const SHAPE_POLY_SET& aPolySet )
+{
+    hash_combine( aHash, aPolySet.OutlineCount() );
+
+    for( int ii = 0; ii < aPolySet.OutlineCount(); ++ii )
+    {
+        hashLineChain( aHash, aPolySet.COutline( ii ) );
+
+        for( int jj = 0; jj < aPolySet.HoleCount( ii ); ++jj )
+            hashLineChain( aHash, aPolySet.CHole( ii, jj ) );
+    }
+}
+
+
+static bool samePolySet( const SHAPE_POLY_SET& aPolySetA, const SHAPE_POLY_SET& aPolySetB )
+{
+    if( aPolySetA.OutlineCount() != aPolySetB.OutlineCount() )
+        return false;
+
+    for( int ii = 0; ii < aPolySetA.OutlineCount(); ++ii )
+    {
+        if( aPolySetA.HoleCount( ii ) != aPolySetB.HoleCount( ii )
+                || !sameLineChain( aPolySetA.COutline( ii ), aPolySetB.COutline( ii ) ) )
+            return false;
+
+        for( int jj = 0; jj < aPolySetA.HoleCount( ii ); ++jj )
+        {
+            if( !sameLineChain( aPolySetA.CHole( ii, jj ), aPolySetB.CHole( ii, jj ) ) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+GAL_DISPLAY_LIST::GAL_DISPLAY_LIST( GAL_DISPLAY_OPTIONS& aOptions ) :
+    GAL( aOptions ),
+    m_entryValid( false ),
+    m_openGlTarget( false ),
+    m_cairoTarget( false )
+{
+}
+
+
+void GAL_DISPLAY_LIST::SetReplayTarget( GAL* aTarget )
+{
+    SetWorldScreenMatrix( aTarget->GetWorldScreenMatrix() );
+    screenWorldMatrix = aTarget->GetScreenWorldMatrix();
+    worldScale = aTarget->GetWorldScale();
+    zoomFactor = aTarget->GetZoomFactor();
+    lookAtPoint = aTarget->GetLookAtPoint();
+    globalFlipX = aTarget->IsFlippedX();
+    globalFlipY = aTarget->IsFlippedY();
+    depthRange = VECTOR2D( aTarget->GetMinDepth(), aTarget->GetMaxDepth() );
+
+    m_openGlTarget = aTarget->IsOpenGlEngine();
+    m_cairoTarget = aTarget->IsCairoEngine();
+}
+
+
+int GAL_DISPLAY_LIST::BeginEntry()
+{
+    m_entries.push_back( { m_commands.size(), m_commands.size() } );
+    m_entryValid = true;
+
+    addCommand( CMD_SET_IS_FILL ).m_args[0] = isFillEnabled;
+    addCommand( CMD_SET_IS_STROKE ).m_args[0] = isStrokeEnabled;
+    addColor( CMD_SET_FILL_COLOR, fillColor );
+    addColor( CMD_SET_STROKE_COLOR, strokeColor );
+    addCommand( CMD_SET_LINE_WIDTH ).m_args[0] = lineWidth;
+
+    return (int) m_entries.size() - 1;
+}
+
+
+bool GAL_DISPLAY_LIST::EndEntry()
+{
+    ENTRY& entry = m_entries.back();
+
+    if( !m_entryValid )
+    {
+        m_commands.resize( entry.m_firstCommand );
+        m_entries.pop_back();
+        return false;
+    }
+
+    entry.m_lastCommand = m_commands.size();
+    return true;
+}
+
+
+void GAL_DISPLAY_LIST::Clear()
+{
+    m_commands.clear();
+    m_points.clear();
+    m_polySets.clear();
+    m_lineChains.clear();
+    m_texts.clear();
+    m_entries.clear();
+
+    shapeTemplates.reset();
+    shapeTemplateIds.clear();
+}
+
+
+void GAL_DISPLAY_LIST::Replay( int aEntry, GAL* aGal, const COLOR4D* aColor ) const
+{
+    const ENTRY& entry = m_entries[aEntry];
+
+    for( size_t ii = entry.m_firstCommand; ii < entry.m_lastCommand; ++ii )
+    {
+        const COMMAND&  cmd = m_commands[ii];
+        const VECTOR2D* points = cmd.m_count ? &m_points[cmd.m_data] : nullptr;
+        const double*   args = cmd.m_args;
+
+        switch( cmd.m_type )
+        {
+        case CMD_LINE:
+            aGal->DrawLine( cmd.m_p0, cmd.m_p1 );
+            break;
+
+        case CMD_SEGMENT:
+            aGal->DrawSegment( cmd.m_p0, cmd.m_p1, args[0] );
+            break;
+
+        case CMD_POLYLINE:
+            aGal->DrawPolyline( points, (int) cmd.m_count );
+            break;
+
+        case CMD_LINE_CHAIN_POLYLINE:
+            aGal->DrawPolyline( m_lineChains[cmd.m_data] );
+            break;
+
+        case CMD_CIRCLE:
+            aGal->DrawCircle( cmd.m_p0, args[0] );
+            break;
+
+        case CMD_ARC:
+            aGal->DrawArc( cmd.m_p0, args[0], args[1], args[2] );
+            break;
+
+        case CMD_ARC_SEGMENT:
+            aGal->DrawArcSegment( cmd.m_p0, args[0], args[1], args[2], args[3] );
+            break;
+
+        case CMD_RECTANGLE:
+            aGal->DrawRectangle( cmd.m_p0, cmd.m_p1 );
+            break;
+
+        case CMD_POLYGON:
+            aGal->DrawPolygon( points, (int) cmd.m_count );
+            break;
+
+        case CMD_POLY_SET:
+            aGal->DrawPolygon( m_polySets[cmd.m_data] );
+            break;
+
+        case CMD_LINE_CHAIN_POLYGON:
+            aGal->DrawPolygon( m_lineChains[cmd.m_data] );
+            break;
+
+        case CMD_CURVE:
+            aGal->DrawCurve( cmd.m_p0, points[0], points[1], cmd.m_p1, args[0] );
+            break;
+
+        case CMD_BITMAP_TEXT:
+        {
+            const TEXT& text = m_texts[cmd.m_data];
+
+            aGal->SetGlyphSize( text.m_glyphSize );
+            aGal->SetFontBold( text.m_bold );
+            aGal->SetFontItalic( text.m_italic );
+            aGal->SetTextMirrored( text.m_mirrored );
+            aGal->SetHorizontalJustify( text.m_horizontalJustify );
+            aGal->SetVerticalJustify( text.m_verticalJustify );
+            aGal->BitmapText( text.m_text, cmd.m_p0, args[0] );
+            break;
+        }
+
+        case CMD_SET_IS_FILL:
+            aGal->SetIsFill( args[0] != 0.0 );
+            break;
+
+        case CMD_SET_IS_STROKE:
+            aGal->SetIsStroke( args[0] != 0.0 );
+            break;
+
+        case CMD_SHAPE_INSTANCE:
+            aGal->DrawShapeInstance( aGal->GetShapeTemplate( *shapeTemplates, (int) cmd.m_data ),
+                                     cmd.m_p0, cmd.m_p1.x,
+                                     aColor ? *aColor
+                                            : COLOR4D( args[0], args[1], args[2], args[3] ) );
+            break;
+
+        case CMD_SET_FILL_COLOR:
+            aGal->SetFillColor( aColor ? *aColor : COLOR4D( args[0], args[1], args[2], args[3] ) );
+            break;
+
+        case CMD_SET_STROKE_COLOR:
+            aGal->SetStrokeColor( aColor ? *aColor : COLOR4D( args[0], args[1], args[2], args[3] ) );
+            break;
+
+        case CMD_SET_LINE_WIDTH:
+            aGal->SetLineWidth( (float) args[0] );
+            break;
+
+        case CMD_SET_LAYER_DEPTH:
+            aGal->SetLayerDepth( args[0] );
+            break;
+
+        case CMD_ROTATE:
+            aGal->Rotate( args[0] );
+            break;
+
+        case CMD_TRANSLATE:
+            aGal->Translate( cmd.m_p0 );
+            break;
+
+        case CMD_SCALE:
+            aGal->Scale( cmd.m_p0 );
+            break;
+
+        case CMD_SAVE:
+            aGal->Save();
+            break;
+
+        case CMD_RESTORE:
+            aGal->Restore();
+            break;
+        }
+    }
+}
+
+
+int GAL_DISPLAY_LIST::CopyEntry( const GAL_DISPLAY_LIST& aOther, int aEntry )
+{
+    // The attributes are part of the copied commands
+    m_entries.push_back( { m_commands.size(), m_commands.size() } );
+    m_entryValid = true;
+
+    aOther.Replay( aEntry, this );
+
+    EndEntry();
+    return (int) m_entries.size() - 1;
+}
+
+
+size_t GAL_DISPLAY_LIST::HashEntry( int aEntry ) const
+{
+    const ENTRY& entry = m_entries[aEntry];
+    size_t       hash = entry.m_lastCommand - entry.m_firstCommand;
+
+    for( size_t ii = entry.m_firstCommand; ii < entry.m_lastCommand; ++ii )
+    {
+        const COMMAND& cmd = m_commands[ii];
+
+        hash_combine( hash, (int) cmd.m_type );
+
+        switch( cmd.m_type )
+        {
+        case CMD_SET_FILL_COLOR:
+        case CMD_SET_STROKE_COLOR:
+            break;
+
+        case CMD_POLY_SET:
+            hashPolySet( hash, m_polySets[cmd.m_data] );
+            break;
+
+        case CMD_LINE_CHAIN_POLYLINE:
+        case CMD_LINE_CHAIN_POLYGON:
+            hashLineChain( hash, m_lineChains[cmd.m_data] );
+            break;
+
+        case CMD_BITMAP_TEXT:
+            hash_combine( hash, cmd.m_p0.x, cmd.m_p0.y, cmd.m_args[0],
+                          m_texts[cmd.m_data].m_text.ToStdWstring() );
+            break;
+
+        case CMD_SHAPE_INSTANCE:
+            hash_combine( hash, cmd.m_p0.x, cmd.m_p0.y, cmd.m_p1.x,
+                          shapeTemplates->HashEntry( (int) cmd.m_data ) );
+            break;
+
+        default:
+            hash_combine( hash, cmd.m_p0.x, cmd.m_p0.y, cmd.m_p1.x, cmd.m_p1.y,
+                          cmd.m_args[0], cmd.m_args[1], cmd.m_args[2], cmd.m_args[3] );
+
+            for( size_t jj = 0; jj < cmd.m_count; ++jj )
+                hash_combine( hash, m_points[cmd.m_data + jj].x, m_points[cmd.m_data + jj].y );
+
+            break;
+        }
+    }
+
+    return hash;
+}
+
+
+bool GAL_DISPLAY_LIST::SameEntry( int aEntry, const GAL_DISPLAY_LIST& aOther,
+                                  int aOtherEntry ) const
+{
+    const ENTRY& entry = m_entries[aEntry];
+    const ENTRY& otherEntry = aOther.m_entries[aOtherEntry];
+
+    if( entry.m_lastCommand - entry.m_firstCommand
+            != otherEntry.m_lastCommand - otherEntry.m_firstCommand )
+        return false;
+
+    for( size_t ii = 0; ii < entry.m_lastCommand - entry.m_firstCommand; ++ii )
+    {
+        if( !sameCommand( m_commands[entry.m_firstCommand + ii], aOther,
+                          aOther.m_commands[otherEntry.m_firstCommand + ii] ) )
+            return false;
+    }
+
+    return true;
+}
+
+
+bool GAL_DISPLAY_LIST::sameCommand( const COMMAND& aCmd, const GAL_DISPLAY_LIST& aOther,
+                                    const COMMAND& aOtherCmd ) const
+{
+    if( aCmd.m_type != aOtherCmd.m_type )
+        return false;
+
+    switch( aCmd.m_type )
+    {
+    case CMD_SET_FILL_COLOR:
+    case CMD_SET_STROKE_COLOR:
+        return true;
+
+    case CMD_POLY_SET:
+        return samePolySet( m_polySets[aCmd.m_data], aOther.m_polySets[aOtherCmd.m_data] );
+
+    case CMD_LINE_CHAIN_POLYLINE:
+    case CMD_LINE_CHAIN_POLYGON:
+        return sameLineChain( m_lineChains[aCmd.m_data], aOther.m_lineChains[aOtherCmd.m_data] );
+
+    case CMD_BITMAP_TEXT:
+    {
+        const TEXT& text = m_texts[aCmd.m_data];
+        const TEXT& otherText = aOther.m_texts[aOtherCmd.m_data];
+
+        return aCmd.m_p0 == aOtherCmd.m_p0 && aCmd.m_args[0] == aOtherCmd.m_args[0]
+               && text.m_text == otherText.m_text && text.m_glyphSize == otherText.m_glyphSize
+               && text.m_bold == otherText.m_bold && text.m_italic == otherText.m_italic
+               && text.m_mirrored == otherText.m_mirrored
+               && text.m_horizontalJustify == otherText.m_horizontalJustify
+               && text.m_verticalJustify == otherText.m_verticalJustify;
+    }
+
+    case CMD_SHAPE_INSTANCE:
+        return aCmd.m_p0 == aOtherCmd.m_p0 && aCmd.m_p1.x == aOtherCmd.m_p1.x
+               && shapeTemplates->SameEntry( (int) aCmd.m_data, *aOther.shapeTemplates,
+                                             (int) aOtherCmd.m_data );
+
+    default:
+        break;
+    }
+
+    if( aCmd.m_p0 != aOtherCmd.m_p0 || aCmd.m_p1 != aOtherCmd.m_p1
+            || aCmd.m_count != aOtherCmd.m_count )
+        return false;
+
+    for( int ii = 0; ii < 4; ++ii )
+    {
+        if( aCmd.m_args[ii] != aOtherCmd.m_args[ii] )
+            return false;
+    }
+
+    for( size_t ii = 0; ii < aCmd.m_count; ++ii )
+    {
+        if( m_points[aCmd.m_data + ii] != aOther.m_points[aOtherCmd.m_data + ii] )
+            return false;
+    }
+
+    return true;
+}
+
+
+GAL_DISPLAY_LIST::COMMAND& GAL_DISPLAY_LIST::addCommand( COMMAND_TYPE aType )
+{
+    m_commands.emplace_back();
+
+    COMMAND& cmd = m_commands.back();
+    cmd.m_type = aType;
+    cmd.m_args[0] = cmd.m_args[1] = cmd.m_args[2] = cmd.m_args[3] = 0.0;
+    cmd.m_data = 0;
+    cmd.m_count = 0;
+
+    return cmd;
+}
+
+
+void GAL_DISPLAY_LIST::addColor( COMMAND_TYPE aType, const COLOR4D& aColor )
+{
+    COMMAND& cmd = addCommand( aType );
+    cmd.m_args[0] = aColor.r;
+    cmd.m_args[1] = aColor.g;
+    cmd.m_args[2] = aColor.b;
+    cmd.m_args[3] = aColor.a;
+}
+
+
+void GAL_DISPLAY_LIST::addPoints( COMMAND_TYPE aType, const VECTOR2D* aPoints, int aCount )
+{
+    COMMAND& cmd = addCommand( aType );
+    cmd.m_data = m_points.size();
+    cmd.m_count = aCount;
+
+    m_points.insert( m_points.end(), aPoints, aPoints + aCount );
+}
+
+
+void GAL_DISPLAY_LIST::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    COMMAND& cmd = addCommand( CMD_LINE );
+    cmd.m_p0 = aStartPoint;
+    cmd.m_p1 = aEndPoint;
+}
+
+
+void GAL_DISPLAY_LIST::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                                    double aWidth )
+{
+    COMMAND& cmd = addCommand( CMD_SEGMENT );
+    cmd.m_p0 = aStartPoint;
+    cmd.m_p1 = aEndPoint;
+    cmd.m_args[0] = aWidth;
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolyline( const std::deque<VECTOR2D>& aPointList )
+{
+    COMMAND& cmd = addCommand( CMD_POLYLINE );
+    cmd.m_data = m_points.size();
+    cmd.m_count = aPointList.size();
+
+    m_points.insert( m_points.end(), aPointList.begin(), aPointList.end() );
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolyline( const VECTOR2D aPointList[], int aListSize )
+{
+    addPoints( CMD_POLYLINE, aPointList, aListSize );
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain )
+{
+    addCommand( CMD_LINE_CHAIN_POLYLINE ).m_data = m_lineChains.size();
+    m_lineChains.push_back( aLineChain );
+}
+
+
+void GAL_DISPLAY_LIST::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
+{
+    COMMAND& cmd = addCommand( CMD_CIRCLE );
+    cmd.m_p0 = aCenterPoint;
+    cmd.m_args[0] = aRadius;
+}
+
+
+void GAL_DISPLAY_LIST::DrawArc( const VECTOR2D& aCenterPoint, double aRadius,
+                                double aStartAngle, double aEndAngle )
+{
+    COMMAND& cmd = addCommand( CMD_ARC );
+    cmd.m_p0 = aCenterPoint;
+    cmd.m_args[0] = aRadius;
+    cmd.m_args[1] = aStartAngle;
+    cmd.m_args[2] = aEndAngle;
+}
+
+
+void GAL_DISPLAY_LIST::DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius,
+                                       double aStartAngle, double aEndAngle, double aWidth )
+{
+    COMMAND& cmd = addCommand( CMD_ARC_SEGMENT );
+    cmd.m_p0 = aCenterPoint;
+    cmd.m_args[0] = aRadius;
+    cmd.m_args[1] = aStartAngle;
+    cmd.m_args[2] = aEndAngle;
+    cmd.m_args[3] = aWidth;
+}
+
+
+void GAL_DISPLAY_LIST::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    COMMAND& cmd = addCommand( CMD_RECTANGLE );
+    cmd.m_p0 = aStartPoint;
+    cmd.m_p1 = aEndPoint;
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
+{
+    COMMAND& cmd = addCommand( CMD_POLYGON );
+    cmd.m_data = m_points.size();
+    cmd.m_count = aPointList.size();
+
+    m_points.insert( m_points.end(), aPointList.begin(), aPointList.end() );
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolygon( const VECTOR2D aPointList[], int aListSize )
+{
+    addPoints( CMD_POLYGON, aPointList, aListSize );
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
+{
+    // The copy keeps the triangulation cached by the painter for the OpenGL GAL
+    addCommand( CMD_POLY_SET ).m_data = m_polySets.size();
+    m_polySets.push_back( aPolySet );
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet )
+{
+    addCommand( CMD_LINE_CHAIN_POLYGON ).m_data = m_lineChains.size();
+    m_lineChains.push_back( aPolySet );
+}
+
+
+void GAL_DISPLAY_LIST::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
+                                  const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint,
+                                  double aFilterValue )
+{
+    const VECTOR2D controlPoints[2] = { aControlPointA, aControlPointB };
+
+    addPoints( CMD_CURVE, controlPoints, 2 );
+
+    COMMAND& cmd = m_commands.back();
+    cmd.m_p0 = aStartPoint;
+    cmd.m_p1 = aEndPoint;
+    cmd.m_args[0] = aFilterValue;
+}
+
+
+void GAL_DISPLAY_LIST::DrawBitmap( const BITMAP_BASE& aBitmap )
+{
+    // The bitmap would have to outlive the recording
+    m_entryValid = false;
+}
+
+
+void GAL_DISPLAY_LIST::SetIsFill( bool aIsFillEnabled )
+{
+    GAL::SetIsFill( aIsFillEnabled );
+    addCommand( CMD_SET_IS_FILL ).m_args[0] = aIsFillEnabled;
+}
+
+
+void GAL_DISPLAY_LIST::SetIsStroke( bool aIsStrokeEnabled )
+{
+    GAL::SetIsStroke( aIsStrokeEnabled );
+    addCommand( CMD_SET_IS_STROKE ).m_args[0] = aIsStrokeEnabled;
+}
+
+
+void GAL_DISPLAY_LIST::SetFillColor( const COLOR4D& aColor )
+{
+    GAL::SetFillColor( aColor );
+    addColor( CMD_SET_FILL_COLOR, aColor );
+}
+
+
+void GAL_DISPLAY_LIST::SetStrokeColor( const COLOR4D& aColor )
+{
+    GAL::SetStrokeColor( aColor );
+    addColor( CMD_SET_STROKE_COLOR, aColor );
+}
+
+
+void GAL_DISPLAY_LIST::SetLineWidth( float aLineWidth )
+{
+    GAL::SetLineWidth( aLineWidth );
+    addCommand( CMD_SET_LINE_WIDTH ).m_args[0] = aLineWidth;
+}
+
+
+void GAL_DISPLAY_LIST::SetLayerDepth( double aLayerDepth )
+{
+    GAL::SetLayerDepth( aLayerDepth );
+    addCommand( CMD_SET_LAYER_DEPTH ).m_args[0] = aLayerDepth;
+}
+
+
+void GAL_DISPLAY_LIST::SetNegativeDrawMode( bool aSetting )
+{
+    // Only the OpenGL and Cairo GALs know how to draw in negative
+    if( aSetting )
+        m_entryValid = false;
+}
+
+
+void GAL_DISPLAY_LIST::BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                                   double aRotationAngle )
+{
+    COMMAND& cmd = addCommand( CMD_BITMAP_TEXT );
+    cmd.m_p0 = aPosition;
+    cmd.m_args[0] = aRotationAngle;
+    cmd.m_data = m_texts.size();
+
+    m_texts.push_back( { aText, GetGlyphSize(), IsFontBold(), IsFontItalic(), IsTextMirrored(),
+                         GetHorizontalJustify(), GetVerticalJustify() } );
+}
+
+
+void GAL_DISPLAY_LIST::DrawShapeInstance( int aTemplate, const VECTOR2D& aPosition,
+                                          double aRotation, const COLOR4D& aColor )
+{
+    addColor( CMD_SHAPE_INSTANCE, aColor );
+
+    COMMAND& cmd = m_commands.back();
+    cmd.m_p0 = aPosition;
+    cmd.m_p1 = VECTOR2D( aRotation, 0.0 );
+    cmd.m_data = aTemplate;
+}
+
+
+void GAL_DISPLAY_LIST::Transform( const MATRIX3x3D& aTransformation )
+{
+    m_entryValid = false;
+}
+
+
+void GAL_DISPLAY_LIST::Rotate( double aAngle )
+{
+    addCommand( CMD_ROTATE ).m_args[0] = aAngle;
+}
+
+
+void GAL_DISPLAY_LIST::Translate( const VECTOR2D& aTranslation )
+{
+    addCommand( CMD_TRANSLATE ).m_p0 = aTranslation;
+}
+
+
+void GAL_DISPLAY_LIST::Scale( const VECTOR2D& aScale )
+{
+    addCommand( CMD_SCALE ).m_p0 = aScale;
+}
+
+
+void GAL_DISPLAY_LIST::Save()
+{
+    addCommand( CMD_SAVE );
+}
+
+
+void GAL_DISPLAY_LIST::Restore()
+{
+    addCommand( CMD_RESTORE );
+}
@@ -27,6 +27,7 @@
 #include <wx/log.h>
 
 #include <gal/graphics_abstraction_layer.h>
+#include <gal/gal_display_list.h>
 #include <gal/definitions.h>
 
 #include <math/util.h>      // for KiROUND
@@ -77,8 +78,6 @@ GAL::GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions ) :
     // Initialize text properties
     ResetTextAttributes();
 
-    strokeFont.LoadNewStrokeFont( newstroke_font, newstroke_font_bufsize );
-
     // subscribe for settings updates
     observerLink = options.Subscribe( this );
 }
@@ -250,3 +249,57 @@ COLOR4D GAL::getCursorColor() const
 
     return color;
 }
+
+
+int GAL::GetShapeTemplate( const GAL_DISPLAY_LIST& aShape, int aEntry )
+{
+    if( !shapeTemplates )
+        shapeTemplates = std::make_unique<GAL_DISPLAY_LIST>( options );
+
+    size_t hash = aShape.HashEntry( aEntry );
+    auto   range = shapeTemplateIds.equal_range( hash );
+
+    for( auto it = range.first; it != range.second; ++it )
+    {
+        if( shapeTemplates->SameEntry( it->second, aShape, aEntry ) )
+            return it->second;
+    }
+
+    int shapeTemplate = shapeTemplates->CopyEntry( aShape, aEntry );
+    shapeTemplateIds.emplace( hash, shapeTemplate );
+
+    return shapeTemplate;
+}
+
+
+void GAL::clearShapeTemplates()
+{
+    shapeTemplates.reset();
+    shapeTemplateIds.clear();
+}
+
+
+void GAL::DrawShapeInstance( int aTemplate, const VECTOR2D& aPosition, double aRotation,
+                             const COLOR4D& aColor )
+{
+    // The template sets its own attributes, they are restored for the next drawings
+    bool    oldIsFill = isFillEnabled;
+    bool    oldIsStroke = isStrokeEnabled;
+    COLOR4D oldFillColor = fillColor;
+    COLOR4D oldStrokeColor = strokeColor;
+    float   oldLineWidth = lineWidth;
+    double  oldLayerDepth = layerDepth;
+
+    Save();
+    Translate( aPosition );
+    Rotate( aRotation );
+    shapeTemplates->Replay( aTemplate, this, &aColor );
+    Restore();
+
+    SetIsFill( oldIsFill );
+    SetIsStroke( oldIsStroke );
+    SetFillColor( oldFillColor );
+    SetStrokeColor( oldStrokeColor );
+    SetLineWidth( oldLineWidth );
+    SetLayerDepth( oldLayerDepth );
+}
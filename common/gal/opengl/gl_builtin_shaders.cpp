@@ -84,6 +84,16 @@ uniform vec2 screenPixelSize;
 uniform float pixelSizeMultiplier;
 uniform float minLinePixelWidth;
 
+// Shape instancing: the vertices belong to a template, moved to every instance
+attribute vec3 attrInstancePosition;
+attribute vec2 attrInstanceRotation;
+attribute vec4 attrInstanceColor;
+uniform float instanced;
+
+// Vertex coordinates and color, after the instance transformation
+vec4 vertex;
+vec4 vertexColor;
+
 
 float roundr( float f, float r )
 {
@@ -98,11 +108,11 @@ vec4 roundv( vec4 x, vec2 t)
 void computeLineCoords( bool posture, vec2 vs, vec2 vp, vec2 texcoord, vec2 dir, float lineWidth, bool endV )
 {
     float lineLength = length(vs);
-    vec4 screenPos = gl_ModelViewProjectionMatrix * gl_Vertex + vec4(1, 1, 0, 0);
+    vec4 screenPos = gl_ModelViewProjectionMatrix * vertex + vec4(1, 1, 0, 0);
     float w = ((lineWidth == 0.0) ? worldPixelSize : lineWidth );
     float pixelWidth = roundr( w / worldPixelSize, 1.0 );
     float aspect = ( lineLength + w ) / w;
-    vec4 color = gl_Color;
+    vec4 color = vertexColor;
     vec2 s = sign( vec2( gl_ModelViewProjectionMatrix[0][0], gl_ModelViewProjectionMatrix[1][1] ) );
 
 
@@ -144,14 +154,14 @@ void computeLineCoords( bool posture, vec2 vs, vec2 vp, vec2 texcoord, vec2 dir,
     shaderParams[1] = aspect;
 
     gl_TexCoord[0].st = vec2(aspect * texcoord.x, texcoord.y);
-    gl_FrontColor = gl_Color;
+    gl_FrontColor = vertexColor;
 }
 
 
 void computeCircleCoords( float mode, float vertexIndex, float radius, float lineWidth )
 {
     vec4 delta;
-    vec4 center = roundv( gl_ModelViewProjectionMatrix * gl_Vertex + vec4(1, 1, 0, 0), screenPixelSize );
+    vec4 center = roundv( gl_ModelViewProjectionMatrix * vertex + vec4(1, 1, 0, 0), screenPixelSize );
     float pixelWidth = roundr( lineWidth / worldPixelSize, 1.0);
     float pixelR = roundr( radius / worldPixelSize, 1.0);
 
@@ -201,7 +211,7 @@ void computeCircleCoords( float mode, float vertexIndex, float radius, float lin
     delta.y *= screenPixelSize.y;
 
     gl_Position = center + delta + adjust;
-    gl_FrontColor = gl_Color;
+    gl_FrontColor = vertexColor;
 }
 
 
@@ -212,6 +222,26 @@ void main()
     // Pass attributes to the fragment shader
     shaderParams = attrShaderParams;
 
+    if( instanced > 0.5 )
+    {
+        vec2 rot = attrInstanceRotation;
+
+        vertex = vec4( gl_Vertex.x * rot.x - gl_Vertex.y * rot.y + attrInstancePosition.x,
+                       gl_Vertex.x * rot.y + gl_Vertex.y * rot.x + attrInstancePosition.y,
+                       gl_Vertex.z + attrInstancePosition.z, gl_Vertex.w );
+        vertexColor = attrInstanceColor;
+
+        // Lines store their direction vector, it turns with the instance
+        if( mode >= SHADER_LINE_A )
+            shaderParams.zw = vec2( shaderParams.z * rot.x - shaderParams.w * rot.y,
+                                    shaderParams.z * rot.y + shaderParams.w * rot.x );
+    }
+    else
+    {
+        vertex = gl_Vertex;
+        vertexColor = gl_Color;
+    }
+
     float lineWidth = shaderParams.y;
     vec2 vs = shaderParams.zw;
     vec2 vp = vec2(-vs.y, vs.x);
@@ -234,8 +264,8 @@ void main()
     else
     {
         // Pass through the coordinates like in the fixed pipeline
-        gl_Position = ftransform();
-        gl_FrontColor = gl_Color;
+        gl_Position = gl_ModelViewProjectionMatrix * vertex;
+        gl_FrontColor = vertexColor;
 
     }
 
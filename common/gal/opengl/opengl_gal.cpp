@@ -36,7 +36,9 @@
 
 #include <advanced_config.h>
 #include <gal/opengl/opengl_gal.h>
+#include <gal/opengl/shape_instancer.h>
 #include <gal/opengl/utils.h>
+#include <gal/gal_display_list.h>
 #include <gal/definitions.h>
 #include <gl_context_mgr.h>
 #include <geometry/shape_poly_set.h>
@@ -203,6 +205,7 @@ OPENGL_GAL::OPENGL_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, wxWindow* aParent,
     cachedManager( nullptr ),
     nonCachedManager( nullptr ),
     overlayManager( nullptr ),
+    currentGroup( 0 ),
     mainBuffer( 0 ),
     overlayBuffer( 0 ),
     isContextLocked( false ),
@@ -294,6 +297,10 @@ OPENGL_GAL::~OPENGL_GAL()
         delete cachedManager;
         delete nonCachedManager;
         delete overlayManager;
+
+        // The buffers have to be released while the context is locked
+        shapeInstancer.reset();
+        templateManager.reset();
     }
 
     GL_CONTEXT_MANAGER::Get().UnlockCtx( glPrivContext );
@@ -487,6 +494,9 @@ void OPENGL_GAL::beginDrawing()
     nonCachedManager->BeginDrawing();
     overlayManager->BeginDrawing();
 
+    if( shapeInstancer )
+        shapeInstancer->BeginDrawing();
+
     if( !isBitmapFontInitialized )
     {
         // Keep bitmap font texture always bound to the second texturing unit
@@ -565,6 +575,9 @@ void OPENGL_GAL::endDrawing()
     nonCachedManager->EndDrawing();
     cachedManager->EndDrawing();
 
+    if( shapeInstancer )
+        shapeInstancer->EndDrawing();
+
     // Overlay container is rendered to a different buffer
     if( overlayBuffer )
         compositor->SetBuffer( overlayBuffer );
@@ -1555,6 +1568,7 @@ int OPENGL_GAL::BeginGroup()
     std::shared_ptr<VERTEX_ITEM> newItem = std::make_shared<VERTEX_ITEM>( *cachedManager );
     int groupNumber = getNewGroupNumber();
     groups.insert( std::make_pair( groupNumber, newItem ) );
+    currentGroup = groupNumber;
 
     return groupNumber;
 }
@@ -1571,6 +1585,9 @@ void OPENGL_GAL::DrawGroup( int aGroupNumber )
 {
     if( groups[aGroupNumber] )
         cachedManager->DrawItem( *groups[aGroupNumber] );
+
+    if( shapeInstancer )
+        shapeInstancer->DrawGroup( aGroupNumber );
 }
 
 
@@ -1578,6 +1595,9 @@ void OPENGL_GAL::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
 {
     if( groups[aGroupNumber] )
         cachedManager->ChangeItemColor( *groups[aGroupNumber], aNewColor );
+
+    if( shapeInstancer )
+        shapeInstancer->ChangeGroupColor( aGroupNumber, aNewColor );
 }
 
 
@@ -1585,6 +1605,9 @@ void OPENGL_GAL::ChangeGroupDepth( int aGroupNumber, int aDepth )
 {
     if( groups[aGroupNumber] )
         cachedManager->ChangeItemDepth( *groups[aGroupNumber], aDepth );
+
+    if( shapeInstancer )
+        shapeInstancer->ChangeGroupDepth( aGroupNumber, aDepth );
 }
 
 
@@ -1592,6 +1615,9 @@ void OPENGL_GAL::DeleteGroup( int aGroupNumber )
 {
     // Frees memory in the container as well
     groups.erase( aGroupNumber );
+
+    if( shapeInstancer )
+        shapeInstancer->DeleteGroup( aGroupNumber );
 }
 
 
@@ -1601,11 +1627,67 @@ void OPENGL_GAL::ClearCache()
 
     groups.clear();
 
+    // The instancer templates are numbered as the GAL ones, they are dropped together
+    clearShapeTemplates();
+
+    if( shapeInstancer )
+        shapeInstancer->Clear();
+
     if( isInitialized )
         cachedManager->Clear();
 }
 
 
+void OPENGL_GAL::DrawShapeInstance( int aTemplate, const VECTOR2D& aPosition, double aRotation,
+                                    const COLOR4D& aColor )
+{
+    const glm::mat4& transform = currentManager->GetTransformation();
+
+    // Instances only store a rotation and a translation, scaled or mirrored shapes are drawn
+    // as usual
+    double det = transform[0][0] * transform[1][1] - transform[0][1] * transform[1][0];
+
+    if( !shapeInstancer || !isGrouping || currentManager != cachedManager
+            || std::abs( det - 1.0 ) > 1e-6 )
+    {
+        super::DrawShapeInstance( aTemplate, aPosition, aRotation, aColor );
+        return;
+    }
+
+    if( !shapeInstancer->HasTemplate( aTemplate ) )
+        addInstancedTemplate( aTemplate );
+
+    glm::vec4 position = transform * glm::vec4( aPosition.x, aPosition.y, 0.0, 1.0 );
+    double    rotation = aRotation + atan2( transform[0][1], transform[0][0] );
+
+    shapeInstancer->AddInstance( currentGroup, aTemplate, VECTOR2D( position.x, position.y ),
+                                 rotation, aColor, layerDepth );
+}
+
+
+void OPENGL_GAL::addInstancedTemplate( int aTemplate )
+{
+    if( !templateManager )
+        templateManager = std::make_unique<VERTEX_MANAGER>( false );
+
+    // Draw the template at the origin with the regular drawing functions, the instance
+    // color replaces the vertex colors
+    VERTEX_MANAGER* manager = currentManager;
+
+    templateManager->Clear();
+    currentManager = templateManager.get();
+
+    super::DrawShapeInstance( aTemplate, VECTOR2D( 0, 0 ), 0.0, COLOR4D::WHITE );
+
+    currentManager = manager;
+
+    unsigned int  size;
+    const VERTEX* vertices = templateManager->GetAllVertices( size );
+
+    shapeInstancer->AddTemplate( aTemplate, vertices, size );
+}
+
+
 void OPENGL_GAL::SetTarget( RENDER_TARGET aTarget )
 {
     switch( aTarget )
@@ -2153,6 +2235,12 @@ void OPENGL_GAL::init()
     nonCachedManager->SetShader( *shader );
     overlayManager->SetShader( *shader );
 
+    if( SHAPE_INSTANCER::IsSupported() )
+    {
+        shapeInstancer = std::make_unique<SHAPE_INSTANCER>();
+        shapeInstancer->SetShader( *shader );
+    }
+
     isInitialized = true;
 }
 
@@ -2211,6 +2299,9 @@ void OPENGL_GAL::EnableDepthTest( bool aEnabled )
     cachedManager->EnableDepthTest( aEnabled );
     nonCachedManager->EnableDepthTest( aEnabled );
     overlayManager->EnableDepthTest( aEnabled );
+
+    if( shapeInstancer )
+        shapeInstancer->EnableDepthTest( aEnabled );
 }
 
 
@@ -0,0 +1,296 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/opengl/shape_instancer.h>
+#include <gal/opengl/shader.h>
+#include <gal/opengl/utils.h>
+
+#include <cmath>
+
+using namespace KIGFX;
+
+
+static void setAttribDivisor( GLuint aAttrib, GLuint aDivisor )
+{
+    if( GLEW_VERSION_3_3 )
+        glVertexAttribDivisor( aAttrib, aDivisor );
+    else
+        glVertexAttribDivisorARB( aAttrib, aDivisor );
+}
+
+
+static void drawArraysInstanced( GLint aFirst, GLsizei aCount, GLsizei aInstances )
+{
+    if( GLEW_VERSION_3_1 )
+        glDrawArraysInstanced( GL_TRIANGLES, aFirst, aCount, aInstances );
+    else
+        glDrawArraysInstancedARB( GL_TRIANGLES, aFirst, aCount, aInstances );
+}
+
+
+SHAPE_INSTANCER::SHAPE_INSTANCER() :
+    m_shader( nullptr ), m_instancedParam( -1 ), m_shaderAttrib( -1 ), m_positionAttrib( -1 ),
+    m_rotationAttrib( -1 ), m_colorAttrib( -1 ), m_templateBuffer( 0 ), m_instanceBuffer( 0 ),
+    m_buffersInitialized( false ), m_templatesDirty( false ), m_enableDepthTest( true )
+{
+}
+
+
+SHAPE_INSTANCER::~SHAPE_INSTANCER()
+{
+    if( m_buffersInitialized )
+    {
+        glBindBuffer( GL_ARRAY_BUFFER, 0 );
+        glDeleteBuffers( 1, &m_templateBuffer );
+        glDeleteBuffers( 1, &m_instanceBuffer );
+    }
+}
+
+
+bool SHAPE_INSTANCER::IsSupported()
+{
+    return GLEW_VERSION_3_3 || ( GLEW_ARB_instanced_arrays && GLEW_ARB_draw_instanced );
+}
+
+
+void SHAPE_INSTANCER::SetShader( SHADER& aShader )
+{
+    m_shader = &aShader;
+    m_instancedParam = m_shader->AddParameter( "instanced" );
+    m_shaderAttrib = m_shader->GetAttribute( "attrShaderParams" );
+    m_positionAttrib = m_shader->GetAttribute( "attrInstancePosition" );
+    m_rotationAttrib = m_shader->GetAttribute( "attrInstanceRotation" );
+    m_colorAttrib = m_shader->GetAttribute( "attrInstanceColor" );
+}
+
+
+void SHAPE_INSTANCER::AddTemplate( int aTemplate, const VERTEX* aVertices, unsigned int aSize )
+{
+    TEMPLATE& shapeTemplate = m_templates[aTemplate];
+
+    shapeTemplate.m_offset = m_vertices.size();
+    shapeTemplate.m_size = aSize;
+
+    // The instance depth is added to the template depth
+    for( unsigned int i = 0; i < aSize; ++i )
+    {
+        m_vertices.push_back( aVertices[i] );
+        m_vertices.back().z = 0.0f;
+    }
+
+    m_templatesDirty = true;
+}
+
+
+void SHAPE_INSTANCER::AddInstance( int aGroup, int aTemplate, const VECTOR2D& aPosition,
+                                   double aRotation, const COLOR4D& aColor, GLfloat aDepth )
+{
+    GROUP_INSTANCE groupInstance;
+    INSTANCE&      instance = groupInstance.m_instance;
+
+    groupInstance.m_template = aTemplate;
+    instance.x = aPosition.x;
+    instance.y = aPosition.y;
+    instance.z = aDepth;
+    instance.cos = std::cos( aRotation );
+    instance.sin = std::sin( aRotation );
+    instance.r = aColor.r * 255.0;
+    instance.g = aColor.g * 255.0;
+    instance.b = aColor.b * 255.0;
+    instance.a = aColor.a * 255.0;
+
+    m_groups[aGroup].push_back( groupInstance );
+}
+
+
+void SHAPE_INSTANCER::ChangeGroupColor( int aGroup, const COLOR4D& aColor )
+{
+    auto it = m_groups.find( aGroup );
+
+    if( it == m_groups.end() )
+        return;
+
+    for( GROUP_INSTANCE& groupInstance : it->second )
+    {
+        groupInstance.m_instance.r = aColor.r * 255.0;
+        groupInstance.m_instance.g = aColor.g * 255.0;
+        groupInstance.m_instance.b = aColor.b * 255.0;
+        groupInstance.m_instance.a = aColor.a * 255.0;
+    }
+}
+
+
+void SHAPE_INSTANCER::ChangeGroupDepth( int aGroup, GLfloat aDepth )
+{
+    auto it = m_groups.find( aGroup );
+
+    if( it == m_groups.end() )
+        return;
+
+    for( GROUP_INSTANCE& groupInstance : it->second )
+        groupInstance.m_instance.z = aDepth;
+}
+
+
+void SHAPE_INSTANCER::DeleteGroup( int aGroup )
+{
+    m_groups.erase( aGroup );
+}
+
+
+void SHAPE_INSTANCER::Clear()
+{
+    m_groups.clear();
+    m_templates.clear();
+    m_vertices.clear();
+    m_templatesDirty = true;
+}
+
+
+void SHAPE_INSTANCER::BeginDrawing()
+{
+    for( auto& shapeTemplate : m_templates )
+        shapeTemplate.second.m_drawn.clear();
+}
+
+
+void SHAPE_INSTANCER::DrawGroup( int aGroup )
+{
+    auto it = m_groups.find( aGroup );
+
+    if( it == m_groups.end() )
+        return;
+
+    for( const GROUP_INSTANCE& groupInstance : it->second )
+        m_templates[groupInstance.m_template].m_drawn.push_back( groupInstance.m_instance );
+}
+
+
+void SHAPE_INSTANCER::uploadTemplates()
+{
+    glBindBuffer( GL_ARRAY_BUFFER, m_templateBuffer );
+    glBufferData( GL_ARRAY_BUFFER, m_vertices.size() * VERTEX_SIZE, m_vertices.data(),
+                  GL_STATIC_DRAW );
+    checkGlError( "uploading shape templates" );
+
+    m_templatesDirty = false;
+}
+
+
+void SHAPE_INSTANCER::EndDrawing()
+{
+    std::vector<INSTANCE> instances;
+
+    for( const auto& shapeTemplate : m_templates )
+    {
+        instances.insert( instances.end(), shapeTemplate.second.m_drawn.begin(),
+                          shapeTemplate.second.m_drawn.end() );
+    }
+
+    if( instances.empty() || !m_shader )
+        return;
+
+    if( !m_buffersInitialized )
+    {
+        glGenBuffers( 1, &m_templateBuffer );
+        glGenBuffers( 1, &m_instanceBuffer );
+        checkGlError( "generating shape instancing buffers" );
+        m_buffersInitialized = true;
+    }
+
+    if( m_enableDepthTest )
+        glEnable( GL_DEPTH_TEST );
+    else
+        glDisable( GL_DEPTH_TEST );
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_COLOR_ARRAY );
+
+    // Template vertices, one set per instance
+    glBindBuffer( GL_ARRAY_BUFFER, m_templateBuffer );
+
+    if( m_templatesDirty )
+        uploadTemplates();
+
+    m_shader->Use();
+    m_shader->SetParameter( m_instancedParam, 1.0f );
+
+    glVertexPointer( COORD_STRIDE, GL_FLOAT, VERTEX_SIZE, (GLvoid*) COORD_OFFSET );
+    glColorPointer( COLOR_STRIDE, GL_UNSIGNED_BYTE, VERTEX_SIZE, (GLvoid*) COLOR_OFFSET );
+    glEnableVertexAttribArray( m_shaderAttrib );
+    glVertexAttribPointer( m_shaderAttrib, SHADER_STRIDE, GL_FLOAT, GL_FALSE,
+                           VERTEX_SIZE, (GLvoid*) SHADER_OFFSET );
+
+    // Instance data, one value per instance
+    glBindBuffer( GL_ARRAY_BUFFER, m_instanceBuffer );
+    glBufferData( GL_ARRAY_BUFFER, instances.size() * sizeof( INSTANCE ), instances.data(),
+                  GL_STREAM_DRAW );
+
+    const GLint instanceAttribs[] = { m_positionAttrib, m_rotationAttrib, m_colorAttrib };
+
+    for( GLint attrib : instanceAttribs )
+    {
+        glEnableVertexAttribArray( attrib );
+        setAttribDivisor( attrib, 1 );
+    }
+
+    size_t firstInstance = 0;
+
+    for( const auto& shapeTemplate : m_templates )
+    {
+        const TEMPLATE& tpl = shapeTemplate.second;
+
+        if( tpl.m_drawn.empty() )
+            continue;
+
+        const size_t base = firstInstance * sizeof( INSTANCE );
+
+        glVertexAttribPointer( m_positionAttrib, 3, GL_FLOAT, GL_FALSE, sizeof( INSTANCE ),
+                               (GLvoid*) ( base + offsetof( INSTANCE, x ) ) );
+        glVertexAttribPointer( m_rotationAttrib, 2, GL_FLOAT, GL_FALSE, sizeof( INSTANCE ),
+                               (GLvoid*) ( base + offsetof( INSTANCE, cos ) ) );
+        glVertexAttribPointer( m_colorAttrib, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof( INSTANCE ),
+                               (GLvoid*) ( base + offsetof( INSTANCE, r ) ) );
+
+        drawArraysInstanced( tpl.m_offset, tpl.m_size, tpl.m_drawn.size() );
+        firstInstance += tpl.m_drawn.size();
+    }
+
+    // The divisors are part of the attribute state, the other managers expect them to be 0
+    for( GLint attrib : instanceAttribs )
+    {
+        setAttribDivisor( attrib, 0 );
+        glDisableVertexAttribArray( attrib );
+    }
+
+    glDisableVertexAttribArray( m_shaderAttrib );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    glDisableClientState( GL_COLOR_ARRAY );
+    glDisableClientState( GL_VERTEX_ARRAY );
+
+    m_shader->SetParameter( m_instancedParam, 0.0f );
+    m_shader->Deactivate();
+
+    checkGlError( "drawing shape instances", false );
+}
@@ -218,6 +218,14 @@ VERTEX* VERTEX_MANAGER::GetVertices( const VERTEX_ITEM& aItem ) const
 }
 
 
+const VERTEX* VERTEX_MANAGER::GetAllVertices( unsigned int& aSize ) const
+{
+    aSize = m_container->GetSize();
+
+    return m_container->GetAllVertices();
+}
+
+
 void VERTEX_MANAGER::SetShader( SHADER& aShader ) const
 {
     m_gpu->SetShader( aShader );
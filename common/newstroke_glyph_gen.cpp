@@ -0,0 +1,174 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file newstroke_glyph_gen.cpp
+ * Build time tool decoding newstroke_font into the static tables declared in
+ * newstroke_glyphs.h, so the application does not decode the font at startup.
+ *
+ * Usage: newstroke_glyph_gen <output.cpp>
+ */
+
+#include <newstroke_font.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+
+// FONT_OFFSET is here for historical reasons, due to the way the stroke font was built.
+// It allows shapes coordinates like W M ... to be >= 0.  Only shapes like j y have
+// coordinates < 0
+#define FONT_OFFSET -10
+
+
+struct GLYPH
+{
+    size_t firstStroke;
+    size_t strokeCount;
+    int    width;
+    int    minY;
+    int    maxY;
+};
+
+
+int main( int argc, char** argv )
+{
+    if( argc != 2 )
+    {
+        fprintf( stderr, "Usage: %s <output.cpp>\n", argv[0] );
+        return 1;
+    }
+
+    std::vector<int>    points;     // x, y pairs
+    std::vector<size_t> strokes;    // first point of each stroke
+    std::vector<GLYPH>  glyphs;
+
+    for( int j = 0; j < newstroke_font_bufsize; j++ )
+    {
+        // In stroke font, coordinates values are coded as <value> + 'R', <value> is an
+        // ASCII char.  The first two values contain the horizontal extent of the char,
+        // " R" raises the pen.
+        const char* data = newstroke_font[j];
+        int         startX = data[0] - 'R';
+        bool        penDown = false;
+        GLYPH       glyph;
+
+        glyph.firstStroke = strokes.size();
+        glyph.width = ( data[1] - 'R' ) - startX;
+        glyph.minY = 0;
+        glyph.maxY = 0;
+
+        for( int i = 2; data[i]; i += 2 )
+        {
+            if( data[i] == ' ' && data[i + 1] == 'R' )
+            {
+                penDown = false;
+                continue;
+            }
+
+            int x = ( data[i] - 'R' ) - startX;
+            int y = data[i + 1] - 'R' + FONT_OFFSET;
+
+            if( !penDown )
+            {
+                strokes.push_back( points.size() / 2 );
+                penDown = true;
+            }
+
+            points.push_back( x );
+            points.push_back( y );
+            glyph.minY = std::min( glyph.minY, y );
+            glyph.maxY = std::max( glyph.maxY, y );
+        }
+
+        glyph.strokeCount = strokes.size() - glyph.firstStroke;
+        glyphs.push_back( glyph );
+    }
+
+    FILE* out = fopen( argv[1], "w" );
+
+    if( !out )
+    {
+        fprintf( stderr, "%s: cannot open %s\n", argv[0], argv[1] );
+        return 1;
+    }
+
+    fprintf( out, "/*\n"
+                  " * Generated by newstroke_glyph_gen from newstroke_font.cpp, do not edit.\n"
+                  " */\n\n"
+                  "#include <newstroke_glyphs.h>\n\n" );
+
+    fprintf( out, "const NEWSTROKE_POINT newstroke_points[] =\n{\n" );
+
+    for( const GLYPH& glyph : glyphs )
+    {
+        if( !glyph.strokeCount )
+            continue;
+
+        size_t first = strokes[glyph.firstStroke];
+        size_t last = glyph.firstStroke + glyph.strokeCount < strokes.size() ?
+                              strokes[glyph.firstStroke + glyph.strokeCount] :
+                              points.size() / 2;
+
+        fprintf( out, "   " );
+
+        for( size_t p = first; p < last; ++p )
+            fprintf( out, " {%d,%d},", points[2 * p], points[2 * p + 1] );
+
+        fprintf( out, "\n" );
+    }
+
+    // Keep the array valid if the font has no point at all
+    if( points.empty() )
+        fprintf( out, "    {0,0}\n" );
+
+    fprintf( out, "};\n\n" );
+
+    fprintf( out, "const unsigned int newstroke_strokes[] =\n{\n" );
+
+    for( size_t s = 0; s < strokes.size(); ++s )
+        fprintf( out, "%s%zu,", s % 16 ? " " : ( s ? "\n    " : "    " ), strokes[s] );
+
+    fprintf( out, "%s%zu\n};\n\n", strokes.empty() ? "    " : "\n    ", points.size() / 2 );
+
+    fprintf( out, "const NEWSTROKE_GLYPH newstroke_glyphs[] =\n{\n" );
+
+    for( const GLYPH& glyph : glyphs )
+    {
+        fprintf( out, "    { %zu, %zu, %d, %d, %d },\n", glyph.firstStroke, glyph.strokeCount,
+                 glyph.width, glyph.minY, glyph.maxY );
+    }
+
+    fprintf( out, "};\n\n" );
+
+    fprintf( out, "const int newstroke_glyph_count = %zu;\n", glyphs.size() );
+
+    if( fclose( out ) != 0 )
+    {
+        fprintf( stderr, "%s: cannot write %s\n", argv[0], argv[1] );
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <properties_undo_item.h>
+#include <property_mgr.h>
+#include <property.h>
+
+#include <algorithm>
+
+
+/**
+ * @return true if both values are known to be equal.  Only the basic types are compared, the
+ * other values (e.g. enums) are considered different so they are kept.
+ */
+static bool sameValue( const wxAny& aFirst, const wxAny& aSecond )
+{
+    if( aFirst.CheckType<int>() && aSecond.CheckType<int>() )
+        return aFirst.As<int>() == aSecond.As<int>();
+
+    if( aFirst.CheckType<double>() && aSecond.CheckType<double>() )
+        return aFirst.As<double>() == aSecond.As<double>();
+
+    if( aFirst.CheckType<bool>() && aSecond.CheckType<bool>() )
+        return aFirst.As<bool>() == aSecond.As<bool>();
+
+    if( aFirst.CheckType<wxString>() && aSecond.CheckType<wxString>() )
+        return aFirst.As<wxString>() == aSecond.As<wxString>();
+
+    return false;
+}
+
+
+PROPERTIES_UNDO_ITEM::PROPERTIES_UNDO_ITEM( EDA_ITEM* aItem ) :
+        EDA_ITEM( NOT_USED ),
+        m_itemUuid( aItem->m_Uuid ),
+        m_itemType( aItem->Type() )
+{
+    PROPERTY_MANAGER& propMgr = PROPERTY_MANAGER::Instance();
+
+    for( PROPERTY_BASE* property : propMgr.GetProperties( TYPE_HASH( *aItem ) ) )
+    {
+        if( property->IsReadOnly() || !property->Available( aItem ) )
+            continue;
+
+        m_values.emplace_back( property, aItem->Get( property ) );
+    }
+}
+
+
+void PROPERTIES_UNDO_ITEM::Reduce( EDA_ITEM* aItem )
+{
+    m_values.erase( std::remove_if( m_values.begin(), m_values.end(),
+                                    [aItem]( const std::pair<PROPERTY_BASE*, wxAny>& aValue )
+                                    {
+                                        return sameValue( aValue.second,
+                                                          aItem->Get( aValue.first ) );
+                                    } ),
+                    m_values.end() );
+
+    m_values.shrink_to_fit();
+}
+
+
+void PROPERTIES_UNDO_ITEM::Swap( EDA_ITEM* aItem )
+{
+    for( std::pair<PROPERTY_BASE*, wxAny>& value : m_values )
+    {
+        wxAny current = aItem->Get( value.first );
+
+        aItem->Set( value.first, value.second );
+        value.second = current;
+    }
+}
+
+
+EDA_ITEM* PROPERTIES_UNDO_ITEM::FindItem( EDA_ITEM* aParent ) const
+{
+    if( aParent->m_Uuid == m_itemUuid )
+        return aParent;
+
+    const KICAD_T scanTypes[] = { m_itemType, EOT };
+    EDA_ITEM*     found = nullptr;
+
+    aParent->Visit(
+            [&]( EDA_ITEM* aItem, void* )
+            {
+                if( aItem->m_Uuid != m_itemUuid )
+                    return SEARCH_RESULT::CONTINUE;
+
+                found = aItem;
+                return SEARCH_RESULT::QUIT;
+            },
+            nullptr, scanTypes );
+
+    return found;
+}
+
+
+size_t PROPERTIES_UNDO_ITEM::GetMemorySize() const
+{
+    size_t size = sizeof( PROPERTIES_UNDO_ITEM );
+
+    for( const std::pair<PROPERTY_BASE*, wxAny>& value : m_values )
+    {
+        size += sizeof( value );
+
+        if( value.second.CheckType<wxString>() )
+            size += value.second.As<wxString>().length() * sizeof( wxChar );
+    }
+
+    return size;
+}
@@ -62,6 +62,7 @@ ITEM_PICKER::ITEM_PICKER( BASE_SCREEN* aScreen, EDA_ITEM* aItem, UNDO_REDO aUndo
 PICKED_ITEMS_LIST::PICKED_ITEMS_LIST()
 {
     m_Status = UNDO_REDO::UNSPECIFIED;
+    m_MemorySize = 0;
 }
 
 PICKED_ITEMS_LIST::~PICKED_ITEMS_LIST()
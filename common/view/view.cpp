@@ -34,9 +34,14 @@
 #include <view/view_overlay.h>
 
 #include <gal/definitions.h>
+#include <gal/gal_display_list.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
 
+#include <atomic>
+#include <future>
+#include <thread>
+
 #ifdef __WXDEBUG__
 #include <profile.h>
 #endif /* __WXDEBUG__  */
@@ -293,7 +298,9 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_parallelUpdates( true ),
+    m_pendingGeometryUpdates( false )
 {
     // Set m_boundary to define the max area size. The default area size
     // is defined here as the max value of a int.
@@ -430,14 +437,14 @@ struct queryVisitor
 {
     typedef typename Container::value_type item_type;
 
-    queryVisitor( Container& aCont, int aLayer ) :
-        m_cont( aCont ), m_layer( aLayer )
+    queryVisitor( Container& aCont, int aLayer, bool aVisibleOnly = true ) :
+        m_cont( aCont ), m_layer( aLayer ), m_visibleOnly( aVisibleOnly )
     {
     }
 
     bool operator()( VIEW_ITEM* aItem )
     {
-        if( aItem->viewPrivData()->getFlags() & VISIBLE )
+        if( !m_visibleOnly || ( aItem->viewPrivData()->getFlags() & VISIBLE ) )
             m_cont.push_back( VIEW::LAYER_ITEM_PAIR( aItem, m_layer ) );
 
         return true;
@@ -445,10 +452,12 @@ struct queryVisitor
 
     Container&  m_cont;
     int         m_layer;
+    bool        m_visibleOnly;
 };
 
 
-int VIEW::Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) const
+int VIEW::Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult,
+                 bool aVisibleOnly ) const
 {
     if( m_orderedLayers.empty() )
         return 0;
@@ -460,10 +469,10 @@ int VIEW::Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) con
     for( i = m_orderedLayers.rbegin(); i != m_orderedLayers.rend(); ++i )
     {
         // ignore layers that do not contain actual items (i.e. the selection box, menus, floats)
-        if( ( *i )->displayOnly || !( *i )->visible )
+        if( ( *i )->displayOnly || ( aVisibleOnly && !( *i )->visible ) )
             continue;
 
-        queryVisitor<std::vector<LAYER_ITEM_PAIR> > visitor( aResult, ( *i )->id );
+        queryVisitor<std::vector<LAYER_ITEM_PAIR> > visitor( aResult, ( *i )->id, aVisibleOnly );
         ( *i )->items->Query( aRect, visitor );
     }
 
@@ -1114,6 +1123,7 @@ void VIEW::Clear()
         layer.items->RemoveAll();
 
     m_nextDrawPriority = 0;
+    m_pendingGeometryUpdates = false;
 
     m_gal->ClearCache();
 }
@@ -1206,7 +1216,8 @@ void VIEW::clearGroupCache()
 }
 
 
-void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
+void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags,
+                           std::vector<std::pair<VIEW_ITEM*, int>>* aGeometryUpdates )
 {
     if( aUpdateFlags & INITIAL_ADD )
     {
@@ -1238,7 +1249,12 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
         if( IsCached( layerId ) )
         {
             if( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT ) )
-                updateItemGeometry( aItem, layerId );
+            {
+                if( aGeometryUpdates )
+                    aGeometryUpdates->emplace_back( aItem, layerId );
+                else
+                    updateItemGeometry( aItem, layerId );
+            }
             else if( aUpdateFlags & COLOR )
                 updateItemColor( aItem, layerId );
         }
@@ -1315,6 +1331,126 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
 }
 
 
+void VIEW::updateItemsGeometry( const std::vector<std::pair<VIEW_ITEM*, int>>& aItemLayers )
+{
+    // Below this count, starting the threads costs more than it saves
+    const size_t minParallelItemLayers = 256;
+
+    // Tasks are whole items: the painter may temporarily modify the item it draws
+    std::vector<size_t> itemStarts;
+
+    for( size_t ii = 0; ii < aItemLayers.size(); ++ii )
+    {
+        if( ii == 0 || aItemLayers[ii].first != aItemLayers[ii - 1].first )
+            itemStarts.push_back( ii );
+    }
+
+    itemStarts.push_back( aItemLayers.size() );
+
+    const size_t itemsCount = itemStarts.size() - 1;
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), itemsCount );
+
+    // Each thread draws with its own painter into its own display list
+    GAL_DISPLAY_OPTIONS                            options;
+    std::vector<std::unique_ptr<GAL_DISPLAY_LIST>> displayLists;
+    std::vector<std::unique_ptr<PAINTER>>          painters;
+
+    if( m_parallelUpdates && aItemLayers.size() >= minParallelItemLayers )
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        {
+            displayLists.emplace_back( new GAL_DISPLAY_LIST( options ) );
+            displayLists.back()->SetReplayTarget( m_gal );
+
+            painters.emplace_back( m_painter->Clone( displayLists.back().get() ) );
+
+            if( !painters.back() )
+                break;
+        }
+    }
+
+    if( painters.empty() || !painters.back() )
+    {
+        for( const std::pair<VIEW_ITEM*, int>& itemLayer : aItemLayers )
+            updateItemGeometry( itemLayer.first, itemLayer.second );
+
+        return;
+    }
+
+    // The display list and entry of each item layer, -1 if it must be drawn directly
+    std::vector<int>    entries( aItemLayers.size(), -1 );
+    std::vector<size_t> entryLists( aItemLayers.size(), 0 );
+    std::atomic<size_t> nextItem( 0 );
+
+    auto record_lambda = [&]( size_t aThread ) -> size_t
+    {
+        GAL_DISPLAY_LIST* displayList = displayLists[aThread].get();
+        PAINTER*          painter = painters[aThread].get();
+
+        for( size_t ii = nextItem++; ii < itemsCount; ii = nextItem++ )
+        {
+            for( size_t jj = itemStarts[ii]; jj < itemStarts[ii + 1]; ++jj )
+            {
+                const std::pair<VIEW_ITEM*, int>& itemLayer = aItemLayers[jj];
+                int entry = displayList->BeginEntry();
+
+                bool drawn = painter->Draw( static_cast<EDA_ITEM*>( itemLayer.first ),
+                                            itemLayer.second );
+
+                if( displayList->EndEntry() && drawn )
+                {
+                    entries[jj] = entry;
+                    entryLists[jj] = aThread;
+                }
+            }
+        }
+
+        return 1;
+    };
+
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, record_lambda, ii );
+
+    // Finalize the threads
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii].wait();
+
+    // Replay the display lists in the item groups, in the order of the items
+    for( size_t ii = 0; ii < aItemLayers.size(); ++ii )
+    {
+        VIEW_ITEM* item = aItemLayers[ii].first;
+        int        layer = aItemLayers[ii].second;
+
+        if( entries[ii] < 0 )
+        {
+            updateItemGeometry( item, layer );
+            continue;
+        }
+
+        auto        viewData = item->viewPrivData();
+        VIEW_LAYER& l = m_layers.at( layer );
+
+        m_gal->SetTarget( l.target );
+        m_gal->SetLayerDepth( l.renderingOrder );
+
+        int group = viewData->getGroup( layer );
+
+        if( group >= 0 )
+            m_gal->DeleteGroup( group );
+
+        group = m_gal->BeginGroup();
+        viewData->setGroup( layer, group );
+
+        displayLists[entryLists[ii]]->Replay( entries[ii], m_gal );
+
+        m_gal->EndGroup();
+    }
+}
+
+
 void VIEW::updateBbox( VIEW_ITEM* aItem )
 {
     int layers[VIEW_MAX_LAYERS], layers_count;
@@ -1415,6 +1551,8 @@ void VIEW::UpdateItems()
     {
         GAL_UPDATE_CONTEXT ctx( m_gal );
 
+        std::vector<std::pair<VIEW_ITEM*, int>> geometryUpdates;
+
         for( VIEW_ITEM* item : *m_allItems )
         {
             auto viewData = item->viewPrivData();
@@ -1424,16 +1562,23 @@ void VIEW::UpdateItems()
 
             if( viewData->m_requiredUpdate != NONE )
             {
-                invalidateItem( item, viewData->m_requiredUpdate );
+                invalidateItem( item, viewData->m_requiredUpdate, &geometryUpdates );
                 viewData->m_requiredUpdate = NONE;
             }
         }
+
+        updateItemsGeometry( geometryUpdates );
+
+        m_pendingGeometryUpdates = false;
     }
 }
 
 
 void VIEW::UpdateAllItems( int aUpdateFlags )
 {
+    if( aUpdateFlags & GEOMETRY_UPDATE_FLAGS )
+        m_pendingGeometryUpdates = true;
+
     for( VIEW_ITEM* item : *m_allItems )
     {
         auto viewData = item->viewPrivData();
@@ -1459,6 +1604,9 @@ void VIEW::UpdateAllItemsConditionally( int aUpdateFlags,
                 continue;
 
             viewData->m_requiredUpdate |= aUpdateFlags;
+
+            if( aUpdateFlags & GEOMETRY_UPDATE_FLAGS )
+                m_pendingGeometryUpdates = true;
         }
     }
 }
@@ -1538,6 +1686,9 @@ void VIEW::Update( VIEW_ITEM* aItem, int aUpdateFlags )
     assert( aUpdateFlags != NONE );
 
     viewData->m_requiredUpdate |= aUpdateFlags;
+
+    if( aUpdateFlags & GEOMETRY_UPDATE_FLAGS )
+        m_pendingGeometryUpdates = true;
 }
 
 
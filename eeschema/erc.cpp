@@ -42,6 +42,10 @@
 #include <ws_proxy_view_item.h>
 #include <wx/ffile.h>
 
+#include <atomic>
+#include <future>
+#include <thread>
+
 
 /* ERC tests :
  *  1 - conflicts between connected pins ( example: 2 connected outputs )
@@ -366,39 +370,83 @@ int ERC_TESTER::TestMultiunitFootprints()
 
 int ERC_TESTER::TestNoConnectPins()
 {
-    int err_count = 0;
-
-    for( const SCH_SHEET_PATH& sheet : m_schematic->GetSheets() )
+    struct NC_CONFLICT
     {
-        std::map<wxPoint, std::vector<SCH_PIN*>> pinMap;
+        wxPoint               m_pos;
+        std::vector<SCH_PIN*> m_pins;
+    };
+
+    SCH_SHEET_LIST sheets = m_schematic->GetSheets();
+
+    // Each sheet is independent, so conflicts are gathered per sheet in parallel and the
+    // markers are added afterwards in sheet order to keep the results deterministic.
+    std::vector<std::vector<NC_CONFLICT>> conflicts( sheets.size() );
+
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                   ( sheets.size() + 3 ) / 4 );
+
+    std::atomic<size_t> nextSheet( 0 );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
 
-        for( SCH_ITEM* item : sheet.LastScreen()->Items().OfType( SCH_COMPONENT_T ) )
+    auto nc_lambda = [&nextSheet, &sheets, &conflicts]() -> size_t
+    {
+        for( size_t ii = nextSheet++; ii < sheets.size(); ii = nextSheet++ )
         {
-            SCH_COMPONENT* comp = static_cast<SCH_COMPONENT*>( item );
+            const SCH_SHEET_PATH&                    sheet = sheets[ii];
+            std::map<wxPoint, std::vector<SCH_PIN*>> pinMap;
 
-            for( SCH_PIN* pin : comp->GetPins( &sheet ) )
+            for( SCH_ITEM* item : sheet.LastScreen()->Items().OfType( SCH_COMPONENT_T ) )
             {
-                if( pin->GetLibPin()->GetType() == ELECTRICAL_PINTYPE::PT_NC )
-                    pinMap[pin->GetPosition()].emplace_back( pin );
+                SCH_COMPONENT* comp = static_cast<SCH_COMPONENT*>( item );
+
+                for( SCH_PIN* pin : comp->GetPins( &sheet ) )
+                {
+                    if( pin->GetLibPin()->GetType() == ELECTRICAL_PINTYPE::PT_NC )
+                        pinMap[pin->GetPosition()].emplace_back( pin );
+                }
+            }
+
+            for( std::pair<const wxPoint, std::vector<SCH_PIN*>>& pair : pinMap )
+            {
+                if( pair.second.size() > 1 )
+                    conflicts[ii].push_back( { pair.first, std::move( pair.second ) } );
             }
         }
 
-        for( auto& pair : pinMap )
+        return 1;
+    };
+
+    if( parallelThreadCount <= 1 )
+        nc_lambda();
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, nc_lambda );
+
+        // Finalize the threads
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    int err_count = 0;
+
+    for( size_t ii = 0; ii < sheets.size(); ++ii )
+    {
+        for( const NC_CONFLICT& conflict : conflicts[ii] )
         {
-            if( pair.second.size() > 1 )
-            {
-                err_count++;
+            const std::vector<SCH_PIN*>& pins = conflict.m_pins;
 
-                std::shared_ptr<ERC_ITEM> ercItem = ERC_ITEM::Create( ERCE_NOCONNECT_CONNECTED );
+            err_count++;
 
-                ercItem->SetItems( pair.second[0], pair.second[1],
-                                   pair.second.size() > 2 ? pair.second[2] : nullptr,
-                                   pair.second.size() > 3 ? pair.second[3] : nullptr );
-                ercItem->SetErrorMessage( _( "Pins with \"no connection\" type are connected" ) );
+            std::shared_ptr<ERC_ITEM> ercItem = ERC_ITEM::Create( ERCE_NOCONNECT_CONNECTED );
 
-                SCH_MARKER* marker = new SCH_MARKER( ercItem, pair.first );
-                sheet.LastScreen()->Append( marker );
-            }
+            ercItem->SetItems( pins[0], pins[1],
+                               pins.size() > 2 ? pins[2] : nullptr,
+                               pins.size() > 3 ? pins[3] : nullptr );
+            ercItem->SetErrorMessage( _( "Pins with \"no connection\" type are connected" ) );
+
+            SCH_MARKER* marker = new SCH_MARKER( ercItem, conflict.m_pos );
+            sheets[ii].LastScreen()->Append( marker );
         }
     }
 
@@ -408,75 +456,137 @@ int ERC_TESTER::TestNoConnectPins()
 
 int ERC_TESTER::TestPinToPin()
 {
-    ERC_SETTINGS&  settings = m_schematic->ErcSettings();
-    const NET_MAP& nets     = m_schematic->ConnectionGraph()->GetNetMap();
+    /**
+     * A pair of connected pins whose types conflict.  Only plain data is gathered by the
+     * worker threads; the ERC items and markers are created afterwards on the calling thread.
+     */
+    struct PIN_CONFLICT
+    {
+        SCH_PIN*    m_pin;
+        SCH_PIN*    m_otherPin;
+        SCH_SCREEN* m_screen;
+        PIN_ERROR   m_error;
+    };
 
-    int errors = 0;
+    const ERC_SETTINGS& settings = m_schematic->ErcSettings();
+    const NET_MAP&      netMap   = m_schematic->ConnectionGraph()->GetNetMap();
 
-    for( const std::pair<NET_NAME_CODE, std::vector<CONNECTION_SUBGRAPH*>> net : nets )
-    {
-        std::vector<SCH_PIN*> pins;
-        std::unordered_map<EDA_ITEM*, SCH_SCREEN*> pinToScreenMap;
+    std::vector<const NET_MAP::value_type*> nets;
+    nets.reserve( netMap.size() );
+
+    for( const NET_MAP::value_type& net : netMap )
+        nets.push_back( &net );
+
+    // One result list per net, merged in net order once all threads have finished
+    std::vector<std::vector<PIN_CONFLICT>> conflicts( nets.size() );
+
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                   ( nets.size() + 3 ) / 4 );
 
-        for( CONNECTION_SUBGRAPH* subgraph: net.second )
+    std::atomic<size_t> nextNet( 0 );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto pin_lambda = [&nextNet, &nets, &conflicts, &settings]() -> size_t
+    {
+        for( size_t ii = nextNet++; ii < nets.size(); ii = nextNet++ )
         {
-            for( EDA_ITEM* item : subgraph->m_items )
+            std::vector<std::pair<SCH_PIN*, SCH_SCREEN*>> pins;
+            bool typePresent[ELECTRICAL_PINTYPES_TOTAL] = { false };
+
+            for( CONNECTION_SUBGRAPH* subgraph : nets[ii]->second )
             {
-                if( item->Type() == SCH_PIN_T )
+                for( EDA_ITEM* item : subgraph->m_items )
                 {
-                    pins.emplace_back( static_cast<SCH_PIN*>( item ) );
-                    pinToScreenMap[item] = subgraph->m_sheet.LastScreen();
+                    if( item->Type() == SCH_PIN_T )
+                    {
+                        SCH_PIN* pin = static_cast<SCH_PIN*>( item );
+
+                        typePresent[ static_cast<int>( pin->GetType() ) ] = true;
+                        pins.emplace_back( pin, subgraph->m_sheet.LastScreen() );
+                    }
                 }
             }
-        }
 
-        // Single-pin nets are handled elsewhere
-        if( pins.size() < 2 )
-            continue;
-
-        std::set<std::pair<SCH_PIN*, SCH_PIN*>> tested;
+            // Single-pin nets are handled elsewhere
+            if( pins.size() < 2 )
+                continue;
 
-        for( SCH_PIN* refPin : pins )
-        {
-            ELECTRICAL_PINTYPE refType = refPin->GetType();
+            // Most nets have no conflicting pin types at all: skip the pairwise test for them
+            bool hasConflict = false;
 
-            for( SCH_PIN* testPin : pins )
+            for( int refType = 0; refType < ELECTRICAL_PINTYPES_TOTAL && !hasConflict; ++refType )
             {
-                if( testPin == refPin )
-                    continue;
+                for( int testType = 0; testType < ELECTRICAL_PINTYPES_TOTAL; ++testType )
+                {
+                    if( typePresent[refType] && typePresent[testType]
+                            && settings.GetPinMapValue( refType, testType ) != PIN_ERROR::OK )
+                    {
+                        hasConflict = true;
+                        break;
+                    }
+                }
+            }
 
-                std::pair<SCH_PIN*, SCH_PIN*> pair1 = std::make_pair( refPin, testPin );
-                std::pair<SCH_PIN*, SCH_PIN*> pair2 = std::make_pair( testPin, refPin );
+            if( !hasConflict )
+                continue;
 
-                if( tested.count( pair1 ) || tested.count( pair2 ) )
-                    continue;
+            // Each pair is tested once, with the first pin of the pair as the reference
+            for( size_t refIdx = 0; refIdx < pins.size(); ++refIdx )
+            {
+                SCH_PIN*           refPin = pins[refIdx].first;
+                ELECTRICAL_PINTYPE refType = refPin->GetType();
 
-                tested.insert( pair1 );
-                tested.insert( pair2 );
+                for( size_t testIdx = refIdx + 1; testIdx < pins.size(); ++testIdx )
+                {
+                    SCH_PIN* testPin = pins[testIdx].first;
 
-                ELECTRICAL_PINTYPE testType = testPin->GetType();
+                    if( testPin == refPin )
+                        continue;
 
-                PIN_ERROR erc = settings.GetPinMapValue( refType, testType );
+                    PIN_ERROR erc = settings.GetPinMapValue( refType, testPin->GetType() );
 
-                if( erc != PIN_ERROR::OK )
-                {
-                    std::shared_ptr<ERC_ITEM> ercItem =
-                            ERC_ITEM::Create( erc == PIN_ERROR::WARNING ? ERCE_PIN_TO_PIN_WARNING :
-                                                                          ERCE_PIN_TO_PIN_ERROR );
-                    ercItem->SetItems( refPin, testPin );
-
-                    ercItem->SetErrorMessage(
-                            wxString::Format( _( "Pins of type %s and %s are connected" ),
-                                    ElectricalPinTypeGetText( refType ),
-                                    ElectricalPinTypeGetText( testType ) ) );
-
-                    SCH_MARKER* marker =
-                            new SCH_MARKER( ercItem, refPin->GetTransformedPosition() );
-                    pinToScreenMap[refPin]->Append( marker );
-                    errors++;
+                    if( erc != PIN_ERROR::OK )
+                        conflicts[ii].push_back( { refPin, testPin, pins[refIdx].second, erc } );
                 }
             }
         }
+
+        return 1;
+    };
+
+    if( parallelThreadCount <= 1 )
+        pin_lambda();
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, pin_lambda );
+
+        // Finalize the threads
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    int errors = 0;
+
+    for( const std::vector<PIN_CONFLICT>& netConflicts : conflicts )
+    {
+        for( const PIN_CONFLICT& conflict : netConflicts )
+        {
+            std::shared_ptr<ERC_ITEM> ercItem =
+                    ERC_ITEM::Create( conflict.m_error == PIN_ERROR::WARNING ?
+                                              ERCE_PIN_TO_PIN_WARNING : ERCE_PIN_TO_PIN_ERROR );
+            ercItem->SetItems( conflict.m_pin, conflict.m_otherPin );
+
+            ercItem->SetErrorMessage(
+                    wxString::Format( _( "Pins of type %s and %s are connected" ),
+                            ElectricalPinTypeGetText( conflict.m_pin->GetType() ),
+                            ElectricalPinTypeGetText( conflict.m_otherPin->GetType() ) ) );
+
+            SCH_MARKER* marker =
+                    new SCH_MARKER( ercItem, conflict.m_pin->GetTransformedPosition() );
+            conflict.m_screen->Append( marker );
+            errors++;
+        }
     }
 
     return errors;
@@ -491,7 +601,7 @@ int ERC_TESTER::TestMultUnitPinConflicts()
 
     std::unordered_map<wxString, std::pair<wxString, SCH_PIN*>> pinToNetMap;
 
-    for( const std::pair<NET_NAME_CODE, std::vector<CONNECTION_SUBGRAPH*>> net : nets )
+    for( const NET_MAP::value_type& net : nets )
     {
         const wxString& netName = net.first.first;
         std::vector<SCH_PIN*> pins;
@@ -546,10 +656,8 @@ int ERC_TESTER::TestSimilarLabels()
 
     std::unordered_map<wxString, SCH_TEXT*> labelMap;
 
-    for( const std::pair<NET_NAME_CODE, std::vector<CONNECTION_SUBGRAPH*>> net : nets )
+    for( const NET_MAP::value_type& net : nets )
     {
-        std::vector<SCH_PIN*> pins;
-
         for( CONNECTION_SUBGRAPH* subgraph : net.second )
         {
             for( EDA_ITEM* item : subgraph->m_items )
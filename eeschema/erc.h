@@ -107,7 +107,11 @@ public:
     int TestNoConnectPins();
 
     /**
-     * Checks the full netlist against the pin-to-pin connectivity requirements
+     * Checks the full netlist against the pin-to-pin connectivity requirements.
+     *
+     * Nets are tested in parallel.  A net is skipped when none of the pin types present on
+     * it conflict in the pin map; the pins of the other nets are compared pairwise, and each
+     * conflicting pair gets one marker, in net order.
      * @return the error count
      */
     int TestPinToPin();
@@ -20,6 +20,7 @@
  */
 
 #include <algorithm>
+#include <atomic>
 
 // For some reason wxWidgets is built with wxUSE_BASE64 unset so expose the wxWidgets
 // base64 code.
@@ -285,7 +286,9 @@ static void formatStroke( OUTPUTFORMATTER* aFormatter, int aNestLevel,
  */
 class SCH_SEXPR_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    // Keep track of the modification status of the library.  Shared by all caches, which
+    // may be loaded concurrently from different threads.
+    static std::atomic<int> m_modHash;
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
@@ -1223,7 +1226,7 @@ void SCH_SEXPR_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias, int aNes
 }
 
 
-int SCH_SEXPR_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_SEXPR_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_SEXPR_PLUGIN_CACHE::SCH_SEXPR_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
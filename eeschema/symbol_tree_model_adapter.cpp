@@ -23,6 +23,12 @@
 #include <wx/window.h>
 #include <widgets/app_progress_dialog.h>
 
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include <common.h>
+
 #include <eda_pattern_match.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
@@ -65,19 +71,93 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNick
                                        aNicknames.size(), aParent );
     }
 
-    unsigned int ii = 0;
+    bool onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
+
+    // Resolve every row (and instantiate its plugin) before starting the threads.  The
+    // library table index and the row plugins are created lazily and are not thread safe.
+    for( const wxString& nickname : aNicknames )
+        m_libs->FindRow( nickname );
+
+    std::vector<std::vector<LIB_PART*>> libSymbols( aNicknames.size() );
+    std::vector<wxString>               libErrors( aNicknames.size() );
+
+    // Parse the libraries in parallel. WARNING! This requires changing the locale, which is
+    // GLOBAL. It is only threadsafe to construct the LOCALE_IO before the threads are created,
+    // destroy it after they finish, and block the main (GUI) thread while they work.
+    // See FOOTPRINT_LIST_IMPL::JoinWorkers().
+    LOCALE_IO toggle_locale;
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), aNicknames.size() );
+
+    std::atomic<size_t> nextLib( 0 );
+    std::atomic<size_t> libsLoaded( 0 );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto loader_lambda = [&]() -> size_t
+    {
+        for( size_t ii = nextLib++; ii < aNicknames.size(); ii = nextLib++ )
+        {
+            try
+            {
+                m_libs->LoadSymbolLib( libSymbols[ii], aNicknames[ii], onlyPowerSymbols );
+            }
+            catch( const IO_ERROR& ioe )
+            {
+                libErrors[ii] = ioe.What();
+                libSymbols[ii].clear();
+            }
+            catch( const std::exception& se )
+            {
+                libErrors[ii] = se.what();
+                libSymbols[ii].clear();
+            }
+
+            libsLoaded++;
+        }
+
+        return 1;
+    };
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, loader_lambda );
 
-    for( const auto& nickname : aNicknames )
+    while( libsLoaded.load() < aNicknames.size() )
     {
         if( prg && wxGetUTCTimeMillis() > nextUpdate )
         {
-            prg->Update( ii, wxString::Format( _( "Loading library \"%s\"" ), nickname ) );
+            size_t loaded = libsLoaded.load();
+
+            if( loaded < aNicknames.size() )
+            {
+                prg->Update( loaded, wxString::Format( _( "Loading library \"%s\"" ),
+                                                       aNicknames[loaded] ) );
+            }
 
             nextUpdate = wxGetUTCTimeMillis() + PROGRESS_INTERVAL_MILLIS;
         }
 
-        AddLibrary( nickname );
-        ii++;
+        wxMilliSleep( 10 );
+    }
+
+    // Finalize the threads
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii].wait();
+
+    // The tree itself is not thread safe, so libraries are added in their original order
+    // once everything has been parsed.
+    for( size_t ii = 0; ii < aNicknames.size(); ++ii )
+    {
+        if( !libErrors[ii].IsEmpty() )
+        {
+            wxLogError( wxString::Format( _( "Error loading symbol library %s.\n\n%s" ),
+                                          aNicknames[ii],
+                                          libErrors[ii] ) );
+        }
+        else
+        {
+            addLibrary( aNicknames[ii], libSymbols[ii] );
+        }
     }
 
     m_tree.AssignIntrinsicRanks();
@@ -94,7 +174,6 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname )
 {
     bool                        onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
     std::vector<LIB_PART*>      symbols;
-    std::vector<LIB_TREE_ITEM*> comp_list;
 
     try
     {
@@ -108,9 +187,16 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname )
         return;
     }
 
-    if( symbols.size() > 0 )
+    addLibrary( aLibNickname, symbols );
+}
+
+
+void SYMBOL_TREE_MODEL_ADAPTER::addLibrary( wxString const& aLibNickname,
+                                            const std::vector<LIB_PART*>& aSymbols )
+{
+    if( aSymbols.size() > 0 )
     {
-        comp_list.assign( symbols.begin(), symbols.end() );
+        std::vector<LIB_TREE_ITEM*> comp_list( aSymbols.begin(), aSymbols.end() );
         DoAddLibrary( aLibNickname, m_libs->GetDescription( aLibNickname ), comp_list, false );
     }
 }
@@ -24,6 +24,7 @@
 
 #include <lib_tree_model_adapter.h>
 
+class LIB_PART;
 class LIB_TABLE;
 class SYMBOL_LIB_TABLE;
 
@@ -46,6 +47,8 @@ public:
      * Add all the libraries in a SYMBOL_LIB_TABLE to the model.
      * Displays a progress dialog attached to the parent frame the first time it is run.
      *
+     * The libraries are parsed concurrently and then added to the tree in the order given.
+     *
      * @param aNicknames is the list of library nicknames
      * @param aParent is the parent window to display the progress dialog
      */
@@ -62,6 +65,11 @@ protected:
     SYMBOL_TREE_MODEL_ADAPTER( EDA_BASE_FRAME* aParent, LIB_TABLE* aLibs );
 
 private:
+    /**
+     * Add an already loaded list of symbols to the tree as library \a aLibNickname.
+     */
+    void addLibrary( wxString const& aLibNickname, const std::vector<LIB_PART*>& aSymbols );
+
     /**
      * Flag to only show the symbol library table load progress dialog the first time.
      */
@@ -107,7 +107,9 @@ void AM_PRIMITIVE::DrawBasicShape( const GERBER_DRAW_ITEM* aParent,
                             aShapeBuffer.Append( polybuffer[0].x, polybuffer[0].y );}
 
     // Draw the primitive shape for flashed items.
-    static std::vector<wxPoint> polybuffer;     // create a static buffer to avoid a lot of memory reallocation
+    // A buffer per thread, to avoid a lot of memory reallocation: Gerber files are loaded
+    // in parallel
+    thread_local std::vector<wxPoint> polybuffer;
     polybuffer.clear();
 
     wxPoint curPos = aShapePos;
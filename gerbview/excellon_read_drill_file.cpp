@@ -390,6 +390,8 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
 
     m_InUse = true;
 
+    ComputeBoundingBox();
+
     return true;
 }
 
@@ -37,6 +37,11 @@
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+
 // HTML Messages used more than one time:
 #define MSG_NO_MORE_LAYER _( "<b>No more available layers</b> in Gerbview to load files" )
 #define MSG_NOT_LOADED    _( "\n<b>Not loaded:</b> <i>%s</i>" )
@@ -251,6 +256,86 @@ bool GERBVIEW_FRAME::LoadGerberFiles( const wxString& aFullFileName )
 }
 
 
+void GERBVIEW_FRAME::readGerberFilesInParallel( const wxString& aPath,
+                                                const wxArrayString& aFilenameList,
+                                                const std::vector<int>* aFileType,
+                                                std::vector<std::unique_ptr<GERBER_FILE_IMAGE>>& aImages,
+                                                PROGRESS_REPORTER* aProgress )
+{
+    std::vector<wxString> gerberFiles;
+    std::vector<size_t>   gerberIndexes;
+
+    for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
+    {
+        wxFileName filename = aFilenameList[ii];
+
+        if( !filename.IsAbsolute() )
+            filename.SetPath( aPath );
+
+        // Drill files, job files and missing files are handled by the caller
+        if( aFileType && (*aFileType)[ii] == 1 )
+            continue;
+
+        if( filename.GetExt() == GerberJobFileExtension.c_str() || !filename.FileExists() )
+            continue;
+
+        gerberFiles.push_back( filename.GetFullPath() );
+        gerberIndexes.push_back( ii );
+    }
+
+    if( aProgress )
+    {
+        aProgress->Report( _( "Reading Gerber files" ) );
+        aProgress->SetMaxProgress( gerberFiles.size() );
+    }
+
+    // Reading a file requires the C locale, which is GLOBAL.  It is only thread safe to
+    // hold a LOCALE_IO on this thread for as long as the loader threads are running.
+    LOCALE_IO toggle_locale;
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), gerberFiles.size() );
+
+    std::atomic<size_t> nextFile( 0 );
+    std::atomic<size_t> filesDone( 0 );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto load_lambda = [&]() -> size_t
+    {
+        for( size_t ii = nextFile++; ii < gerberFiles.size(); ii = nextFile++ )
+        {
+            // The graphic layer is set when the image is added to the image list
+            std::unique_ptr<GERBER_FILE_IMAGE> gerber( new GERBER_FILE_IMAGE( 0 ) );
+
+            if( gerber->LoadGerberFile( gerberFiles[ii] ) )
+                aImages[ gerberIndexes[ii] ] = std::move( gerber );
+
+            if( aProgress )
+                aProgress->AdvanceProgress();
+
+            filesDone++;
+        }
+
+        return 1;
+    };
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, load_lambda );
+
+    while( filesDone.load() < gerberFiles.size() )
+    {
+        if( aProgress )
+            aProgress->KeepRefreshing();
+
+        wxMilliSleep( 20 );
+    }
+
+    // Finalize the threads
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii].wait();
+}
+
+
 bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
                                             const wxArrayString& aFilenameList,
                                             const std::vector<int>* aFileType )
@@ -269,6 +354,24 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
     // Create progress dialog (only used if more than 1 file to load
     std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
 
+    if( aFilenameList.GetCount() > 1 )
+    {
+        progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
+                        _( "Loading Gerber files..." ), 2, false );
+    }
+
+    // Gerber files are independent of each other, so they are all parsed in parallel first.
+    // The resulting images are then added to their layers in order by the loop below.
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> gerberImages( aFilenameList.GetCount() );
+
+    readGerberFilesInParallel( aPath, aFilenameList, aFileType, gerberImages, progress.get() );
+
+    if( progress )
+    {
+        progress->AdvancePhase();
+        progress->SetMaxProgress( aFilenameList.GetCount() );
+    }
+
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
         filename = aFilenameList[ii];
@@ -290,15 +393,7 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
 
         m_lastFileName = filename.GetFullPath();
 
-        if( !progress && ( aFilenameList.GetCount() > 1 ) )
-        {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
-                            _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
-        }
-        else if( progress )
+        if( progress )
         {
             progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
                                             aFilenameList.GetCount(), m_lastFileName ) );
@@ -326,8 +421,12 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
                 success = false;
                 reporter.Report( txt, RPT_SEVERITY_ERROR );
             }
-            else if( Read_GERBER_File( filename.GetFullPath() ) )
+            else if( gerberImages[ii] || Read_GERBER_File( filename.GetFullPath() ) )
             {
+                // Files already parsed only have to be added to the active layer
+                if( gerberImages[ii] )
+                    addGerberImage( gerberImages[ii].release() );
+
                 UpdateFileHistory( m_lastFileName );
 
                 layer = getNextAvailableLayer( layer );
@@ -56,19 +56,17 @@ EDA_RECT GBR_LAYOUT::ComputeBoundingBox() const
     {
         GERBER_FILE_IMAGE* gerber = GetImagesList()->GetGbrImage( layer );
 
-        if( gerber == NULL )    // Graphic layer not yet used
+        if( gerber == NULL || gerber->GetItemsCount() == 0 )    // Graphic layer not yet used
             continue;
 
-        for( GERBER_DRAW_ITEM* item : gerber->GetItems() )
+        // The image bounding box is computed once, when the file is loaded
+        if( first_item )
         {
-            if( first_item )
-            {
-                bbox = item->GetBoundingBox();
-                first_item = false;
-            }
-            else
-                bbox.Merge( item->GetBoundingBox() );
+            bbox = gerber->GetBoundingBox();
+            first_item = false;
         }
+        else
+            bbox.Merge( gerber->GetBoundingBox() );
     }
 
     bbox.Normalize();
@@ -228,6 +228,79 @@ void GERBER_FILE_IMAGE::ResetDefaultValues()
 }
 
 
+/**
+ * @return the area where GERBER_DRAW_ITEM::HitTest() can find aItem, in board (AB)
+ * coordinates as the bounding box of the item, with a margin for the pen size used by
+ * the hit test of lines and arcs.
+ */
+static EDA_RECT itemHitTestArea( const GERBER_DRAW_ITEM* aItem )
+{
+    // Same value as the min hit test radius in GERBER_DRAW_ITEM::HitTest()
+    const int MIN_HIT_TEST_RADIUS = Millimeter2iu( 0.01 );
+
+    EDA_RECT area = aItem->GetBoundingBox();
+    area.Normalize();
+    area.Inflate( std::max( aItem->m_Size.x, aItem->m_Size.y ) + MIN_HIT_TEST_RADIUS );
+
+    return area;
+}
+
+
+void GERBER_FILE_IMAGE::ComputeBoundingBox()
+{
+    bool first_item = true;
+
+    m_boundingBox = EDA_RECT();
+    m_itemsIndex.RemoveAll();
+
+    for( size_t ii = 0; ii < m_drawings.size(); ++ii )
+    {
+        GERBER_DRAW_ITEM* item = m_drawings[ii];
+
+        if( first_item )
+        {
+            m_boundingBox = item->GetBoundingBox();
+            first_item = false;
+        }
+        else
+        {
+            m_boundingBox.Merge( item->GetBoundingBox() );
+        }
+
+        EDA_RECT area = itemHitTestArea( item );
+        const int mmin[2] = { area.GetX(), area.GetY() };
+        const int mmax[2] = { area.GetRight(), area.GetBottom() };
+
+        m_itemsIndex.Insert( mmin, mmax, (int) ii );
+    }
+
+    m_boundingBox.Normalize();
+}
+
+
+void GERBER_FILE_IMAGE::QueryItems( const wxPoint& aRefPos, std::vector<GERBER_DRAW_ITEM*>& aItems )
+{
+    std::vector<int> found;
+    const int        pos[2] = { aRefPos.x, aRefPos.y };
+
+    auto visitor =
+            [&found]( int aIndex ) -> bool
+            {
+                found.push_back( aIndex );
+                return true;
+            };
+
+    m_itemsIndex.Search( pos, pos, visitor );
+
+    // The R-tree does not keep the items order, but the items must be found in drawing
+    // order, like when scanning m_drawings
+    std::sort( found.begin(), found.end() );
+
+    for( int index : found )
+        aItems.push_back( m_drawings[index] );
+}
+
+
 /* Function HasNegativeItems
  * return true if at least one item must be drawn in background color
  * used to optimize screen refresh
@@ -32,6 +32,7 @@
 #include <gerber_draw_item.h>
 #include <am_primitive.h>
 #include <gbr_netlist_metadata.h>
+#include <geometry/rtree.h>
 
 // An useful macro used when reading gerber files;
 #define IsNumber( x ) ( ( ( (x) >= '0' ) && ( (x) <='9' ) )   \
@@ -184,6 +185,11 @@ public:
 
 private:
     wxArrayString      m_messagesList;                          // A list of messages created when reading a file
+    EDA_RECT           m_boundingBox;                           // Bounding box of all the draw items, see
+                                                                // ComputeBoundingBox()
+    RTree<int, int, 2, double> m_itemsIndex;                    // Spatial index of the draw items (stores
+                                                                // their index in m_drawings), see
+                                                                // ComputeBoundingBox()
     int                m_hasNegativeItems;                      // true if the image is negative or has some negative items
                                                                 // Used to optimize drawing, because when there are no
                                                                 // negative items screen refresh does not need
@@ -264,6 +270,28 @@ public:
 
     const wxArrayString& GetMessages() const { return m_messagesList; }
 
+    /**
+     * Compute and store the bounding box of all the draw items of the image, and build
+     * the spatial index used by QueryItems().
+     * Called once the file is loaded, so this work is also done on the loader thread
+     * when several files are loaded in parallel.
+     */
+    void ComputeBoundingBox();
+
+    /**
+     * Find the draw items which can be hit at a given position, using the spatial index
+     * built by ComputeBoundingBox() instead of scanning the whole items list.
+     * The items found still have to be tested by GERBER_DRAW_ITEM::HitTest().
+     * @param aRefPos is the position to test.
+     * @param aItems is filled with the candidate items, in drawing order.
+     */
+    void QueryItems( const wxPoint& aRefPos, std::vector<GERBER_DRAW_ITEM*>& aItems );
+
+    /**
+     * @return the bounding box of the draw items, as computed when the file was loaded.
+     */
+    const EDA_RECT GetBoundingBox() const override { return m_boundingBox; }
+
     /**
      * @return the count of Dcode tools in use in the image
      */
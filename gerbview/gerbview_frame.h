@@ -34,6 +34,9 @@
 #include <gbr_display_options.h>
 #include <undo_redo_container.h>
 
+#include <memory>
+#include <vector>
+
 #define NO_AVAILABLE_LAYERS UNDEFINED_LAYER
 
 class DCODE_SELECTION_BOX;
@@ -42,6 +45,7 @@ class GBR_LAYER_BOX_SELECTOR;
 class GERBER_DRAW_ITEM;
 class GERBER_FILE_IMAGE;
 class GERBER_FILE_IMAGE_LIST;
+class PROGRESS_REPORTER;
 class REPORTER;
 class SELECTION;
 
@@ -208,6 +212,25 @@ private:
                                         const wxArrayString& aFilenameList,
                                         const std::vector<int>* aFileType = nullptr );
 
+    /**
+     * Parse the Gerber files of \a aFilenameList in parallel.  Drill files, job files and
+     * missing files are skipped.
+     * @param aImages receives the image of each file successfully read, at the index of the
+     * file in \a aFilenameList.  The images are not yet attached to a layer.
+     * @param aProgress is an optional progress reporter, advanced once per file.
+     */
+    void readGerberFilesInParallel( const wxString& aPath, const wxArrayString& aFilenameList,
+                                    const std::vector<int>* aFileType,
+                                    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>>& aImages,
+                                    PROGRESS_REPORTER* aProgress );
+
+    /**
+     * Add a loaded gerber image to the active layer (replacing the previous image, if any),
+     * display its load messages and add its items to the view.
+     * @param aGerber is the image to add.  It is owned by the image list after the call.
+     */
+    void addGerberImage( GERBER_FILE_IMAGE* aGerber );
+
 public:
     GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent );
     ~GERBVIEW_FRAME();
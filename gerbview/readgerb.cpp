@@ -35,9 +35,33 @@
 #include <html_messagebox.h>
 #include <macros.h>
 
+#include <vector>
+
 /* Read a gerber file, RS274D, RS274X or RS274X2 format.
  */
 bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
+{
+    GERBER_FILE_IMAGE* gerber = new GERBER_FILE_IMAGE( GetActiveLayer() );
+
+    // Read the gerber file. The image will be added only if it can be read
+    // to avoid broken data.
+    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
+
+    if( !success )
+    {
+        delete gerber;
+        ShowInfoBarError( wxString::Format( _( "File \"%s\" not found" ),
+                                            GERBER_FullFileName ) );
+        return false;
+    }
+
+    addGerberImage( gerber );
+
+    return true;
+}
+
+
+void GERBVIEW_FRAME::addGerberImage( GERBER_FILE_IMAGE* aGerber )
 {
     wxString msg;
 
@@ -50,19 +74,8 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         Erase_Current_DrawLayer( false );
     }
 
-    gerber = new GERBER_FILE_IMAGE( layer );
-
-    // Read the gerber file. The image will be added only if it can be read
-    // to avoid broken data.
-    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
-
-    if( !success )
-    {
-        delete gerber;
-        msg.Printf( _( "File \"%s\" not found" ), GERBER_FullFileName );
-        ShowInfoBarError( msg );
-        return false;
-    }
+    gerber = aGerber;
+    gerber->m_GraphicLayer = layer;
 
     images->AddGbrImage( gerber, layer );
 
@@ -102,8 +115,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         for( auto item : gerber->GetItems() )
             GetCanvas()->GetView()->Add( (KIGFX::VIEW_ITEM*) item );
     }
-
-    return true;
 }
 
 
@@ -111,8 +122,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -120,6 +129,11 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     int      D_commande = 0;       // command number for D commands like D02
     char*    text;
 
+    // A large buffer to store one line.  Each image has its own buffer so that several
+    // files can be loaded at the same time.
+    std::vector<char> buffer( GERBER_BUFZ + 1 );
+    char*             lineBuffer = buffer.data();
+
     ClearMessageList( );
     ResetDefaultValues();
 
@@ -221,5 +235,7 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     m_InUse = true;
 
+    ComputeBoundingBox();
+
     return true;
 }
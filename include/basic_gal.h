@@ -25,11 +25,12 @@
 #ifndef BASIC_GAL_H
 #define BASIC_GAL_H
 
+#include <mutex>
+
 #include <eda_rect.h>
 
 #include <gal/stroke_font.h>
 #include <gal/graphics_abstraction_layer.h>
-#include <newstroke_font.h>
 
 class PLOTTER;
 
@@ -167,4 +168,12 @@ private:
 
 extern BASIC_GAL basic_gal;
 
+/**
+ * basic_gal holds the attributes and the callback of the text being converted, so it
+ * can only be used by one thread at a time: texts are converted to segments from several
+ * threads by the 3D viewer.  The mutex is recursive because a callback or a plotter can
+ * draw a text itself.
+ */
+extern std::recursive_mutex basic_gal_mutex;
+
 #endif      // define BASIC_GAL_H
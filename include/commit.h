@@ -32,6 +32,7 @@
 #include <undo_redo_container.h>
 
 class EDA_ITEM;
+class PROPERTIES_UNDO_ITEM;
 
 ///> Types of changes
 enum CHANGE_TYPE {
@@ -105,6 +106,11 @@ public:
         return Stage( aItem, CHT_MODIFY );
     }
 
+    ///> Modifies only the properties (see PROPERTY_MANAGER) of a given item.
+    ///> Must be called before modification is performed.  The undo entry stores the values
+    ///> of the changed properties instead of a copy of the item, or of its parent.
+    virtual COMMIT& ModifyProperties( EDA_ITEM* aItem );
+
     ///> Creates an undo entry for an item that has been already modified. Requires a copy done
     ///> before the modification.
     COMMIT& Modified( EDA_ITEM* aItem, EDA_ITEM* aCopy )
@@ -153,6 +159,9 @@ protected:
         ///> Optional copy of the item
         EDA_ITEM* m_copy;
 
+        ///> Optional values of the properties of the item, when they are the only changes
+        PROPERTIES_UNDO_ITEM* m_properties;
+
         ///> Modification type
         CHANGE_TYPE m_type;
     };
@@ -161,11 +170,18 @@ protected:
     void clear()
     {
         m_changedItems.clear();
+        m_propertyParents.clear();
         m_changes.clear();
     }
 
     COMMIT& createModified( EDA_ITEM* aItem, EDA_ITEM* aCopy, int aExtraFlags = 0 );
 
+    /**
+     * @return a copy of \a aParent in its state before the commit.  The entries storing the
+     * properties of \a aParent and of its children are removed, the copy supersedes them.
+     */
+    EDA_ITEM* cloneWithoutPropertyChanges( EDA_ITEM* aParent );
+
     virtual void makeEntry( EDA_ITEM* aItem, CHANGE_TYPE aType, EDA_ITEM* aCopy = NULL );
 
     /**
@@ -180,6 +196,9 @@ protected:
 
     std::set<EDA_ITEM*> m_changedItems;
     std::vector<COMMIT_LINE> m_changes;
+
+    ///> Parent objects of the items having an entry storing their properties
+    std::set<EDA_ITEM*> m_propertyParents;
 };
 
 #endif
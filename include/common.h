@@ -116,6 +116,18 @@ extern KIID niluuid;
 
 KIID& NilUuid();
 
+///> Template specialization to use KIIDs as keys of unordered containers
+namespace std
+{
+    template<> struct hash<KIID>
+    {
+        size_t operator()( const KIID& aId ) const
+        {
+            return aId.Hash();
+        }
+    };
+}
+
 // declare KIID_VECT_LIST as std::vector<KIID> both for c++ and swig:
 DECL_VEC_FOR_SWIG( KIID_VECT_LIST, KIID )
 
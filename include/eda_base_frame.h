@@ -164,6 +164,7 @@ protected:
     bool            m_FlagModified;         // Indicates current drawing has been modified.
     bool            m_FlagSave;             // Indicates automatic file save.
     int             m_UndoRedoCountMax;     // undo/Redo command Max depth
+    size_t          m_UndoRedoMemoryMax;    // undo/Redo memory budget in bytes, 0 for no limit
 
     UNDO_REDO_CONTAINER m_undoList;         // Objects list for the undo command (old data)
     UNDO_REDO_CONTAINER m_redoList;         // Objects list for the redo command (old data)
@@ -620,7 +621,7 @@ public:
      * Function PushCommandToUndoList
      * add a command to undo in undo list
      * delete the very old commands when the max count of undo commands is
-     * reached
+     * reached, or when the undo commands exceed the memory budget
      * ( using ClearUndoORRedoList)
      */
     virtual void PushCommandToUndoList( PICKED_ITEMS_LIST* aItem );
@@ -629,7 +630,7 @@ public:
      * Function PushCommandToRedoList
      * add a command to redo in redo list
      * delete the very old commands when the max count of redo commands is
-     * reached
+     * reached, or when the redo commands exceed the memory budget
      * ( using ClearUndoORRedoList)
      */
     virtual void PushCommandToRedoList( PICKED_ITEMS_LIST* aItem );
@@ -651,6 +652,8 @@ public:
 
     int GetMaxUndoItems() const { return m_UndoRedoCountMax; }
 
+    size_t GetMaxUndoMemory() const { return m_UndoRedoMemoryMax; }
+
     bool NonUserClose( bool aForce )
     {
         m_isNonUserClose = true;
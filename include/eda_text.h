@@ -32,6 +32,9 @@
 #include "kicad_string.h"
 #include "painter.h"
 
+#include <memory>
+#include <mutex>
+
 class SHAPE_COMPOUND;
 class SHAPE_POLY_SET;
 
@@ -279,6 +282,35 @@ public:
      */
     void TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuffer ) const;
 
+    /**
+     * Convert the text shape to a list of segment, for a given text angle and pen width.
+     *
+     * The segments are cached with the text, they are only built again when the shown text,
+     * its attributes, its position or the conversion parameters change.
+     *
+     * @param aCornerBuffer = a buffer to store the segments, 2 wxPoints per segment
+     * @param aAngle = the text angle in 0.1 degrees (the draw rotation for footprint texts)
+     * @param aPenWidth = the pen width given to the stroke font, 0 for the bold pen width
+     */
+    void TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuffer, double aAngle,
+                                          int aPenWidth ) const;
+
+    /**
+     * Convert the text shape to a set of polygons (one per segment), inflated by a clearance.
+     *
+     * The polygons are cached with the text like the segments, so the zone filler, DRC and
+     * the 3D viewer can ask for them again without running the stroke font.
+     *
+     * @param aCornerBuffer = a buffer to append the polygons to
+     * @param aClearanceValue = the clearance around the text strokes
+     * @param aError = the maximum error to allow when approximating the stroke ends
+     * @param aAngle = the text angle in 0.1 degrees (the draw rotation for footprint texts)
+     * @param aPenWidth = the pen width given to the stroke font, 0 for the bold pen width
+     */
+    void TransformTextShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
+                                                   int aClearanceValue, int aError,
+                                                   double aAngle, int aPenWidth ) const;
+
     /**
      * Convert the text bounding box to a rectangular polygon depending on the text
      * orientation, the bounding box is not always horizontal or vertical
@@ -382,6 +414,42 @@ private:
         TE_VISIBLE,
     };
 
+    /**
+     * The strokes and outline polygons of the text, for one text angle and pen width.
+     */
+    struct SHAPE_CACHE_ENTRY
+    {
+        double                          m_angle;
+        int                             m_penWidth;
+        std::vector<wxPoint>            m_strokes;          // 2 wxPoints per segment
+
+        bool                            m_polygonsValid;
+        int                             m_clearance;
+        int                             m_error;
+        std::unique_ptr<SHAPE_POLY_SET> m_polygons;
+    };
+
+    /**
+     * The shapes of the text, with the shown text and effects they were built for.  There is
+     * one entry per angle and pen width asked for, as the callers alternate between the
+     * default bold width and the effective pen width.  A text copy starts with an empty cache.
+     */
+    struct SHAPE_CACHE
+    {
+        SHAPE_CACHE();
+        SHAPE_CACHE( const SHAPE_CACHE& aOther ) : SHAPE_CACHE() {}
+        ~SHAPE_CACHE();
+
+        SHAPE_CACHE& operator=( const SHAPE_CACHE& aOther ) { return *this; }
+
+        std::mutex                      m_lock;
+        wxString                        m_text;
+        TEXT_EFFECTS                    m_effects;
+        std::vector<SHAPE_CACHE_ENTRY>  m_entries;
+    };
+
+    mutable SHAPE_CACHE m_shapeCache;
+
 private:
     /**
      * Print each line of this EDA_TEXT.
@@ -395,6 +463,13 @@ private:
     void printOneLineOfText( RENDER_SETTINGS* aSettings, const wxPoint& aOffset, COLOR4D aColor,
                              EDA_DRAW_MODE_T aFillMode, const wxString& aText,
                              const wxPoint& aPos );
+
+    /**
+     * Build the cached strokes if the text changed or were not built for these conversion
+     * parameters.  The cache has to be locked.
+     * @return the cache entry of the parameters
+     */
+    SHAPE_CACHE_ENTRY& updateShapeCache( double aAngle, int aPenWidth ) const;
 };
 
 
@@ -0,0 +1,229 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef GAL_DISPLAY_LIST_H_
+#define GAL_DISPLAY_LIST_H_
+
+#include <deque>
+#include <vector>
+
+#include <gal/graphics_abstraction_layer.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+namespace KIGFX
+{
+
+/**
+ * A GAL recording the drawing commands it gets, to replay them later on another GAL.
+ *
+ * It lets a painter draw items from a worker thread: each thread records into its own
+ * display list, then the entries are replayed on the real GAL from the main thread.
+ * The recording is split in entries, usually one per item and layer.
+ *
+ * The geometry is copied, so the drawn objects do not need to outlive the recording.
+ * Commands that cannot be recorded (bitmaps, transform matrices, negative drawing) make
+ * the entry invalid, the caller then has to draw the item directly on the real GAL.
+ */
+class GAL_DISPLAY_LIST : public GAL
+{
+public:
+    GAL_DISPLAY_LIST( GAL_DISPLAY_OPTIONS& aOptions );
+
+    /**
+     * Copy the view settings of the GAL the entries will be replayed on, as painters
+     * read some of them (world scale, flipping, engine type).
+     */
+    void SetReplayTarget( GAL* aTarget );
+
+    /**
+     * Start recording a new entry.  The current attributes are recorded first, so the
+     * entry replays the same whatever the state of the GAL it is replayed on.
+     * @return the index of the entry.
+     */
+    int BeginEntry();
+
+    /**
+     * Finish recording the current entry.
+     * @return false if the entry could not be recorded and has been discarded.
+     */
+    bool EndEntry();
+
+    /// Discard all the recorded entries
+    void Clear();
+
+    /**
+     * Replay the entry \a aEntry on \a aGal.
+     * @param aColor, if set, replaces all the colors of the entry.
+     */
+    void Replay( int aEntry, GAL* aGal, const COLOR4D* aColor = nullptr ) const;
+
+    /**
+     * Copy the entry \a aEntry of \a aOther to a new entry.
+     * @return the index of the new entry.
+     */
+    int CopyEntry( const GAL_DISPLAY_LIST& aOther, int aEntry );
+
+    /**
+     * @return a hash of the geometry of the entry \a aEntry.  The colors are not part of it.
+     */
+    size_t HashEntry( int aEntry ) const;
+
+    /**
+     * @return true if the entry \a aEntry draws the same geometry as the entry \a aOtherEntry
+     * of \a aOther.  The colors are not compared.
+     */
+    bool SameEntry( int aEntry, const GAL_DISPLAY_LIST& aOther, int aOtherEntry ) const;
+
+    bool IsOpenGlEngine() override { return m_openGlTarget; }
+
+    bool IsCairoEngine() override { return m_cairoTarget; }
+
+    // Drawing methods
+    void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+    void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                      double aWidth ) override;
+    void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override;
+    void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
+    void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override;
+    void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override;
+    void DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                  double aEndAngle ) override;
+    void DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                         double aEndAngle, double aWidth ) override;
+    void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+    void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override;
+    void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override;
+    void DrawPolygon( const SHAPE_POLY_SET& aPolySet ) override;
+    void DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet ) override;
+    void DrawCurve( const VECTOR2D& startPoint, const VECTOR2D& controlPointA,
+                    const VECTOR2D& controlPointB, const VECTOR2D& endPoint,
+                    double aFilterValue = 0.0 ) override;
+    void DrawBitmap( const BITMAP_BASE& aBitmap ) override;
+
+    // Attributes
+    void SetIsFill( bool aIsFillEnabled ) override;
+    void SetIsStroke( bool aIsStrokeEnabled ) override;
+    void SetFillColor( const COLOR4D& aColor ) override;
+    void SetStrokeColor( const COLOR4D& aColor ) override;
+    void SetLineWidth( float aLineWidth ) override;
+    void SetLayerDepth( double aLayerDepth ) override;
+    void SetNegativeDrawMode( bool aSetting ) override;
+
+    // Texts: the stroke texts are drawn as polylines by the GAL, the bitmap texts are
+    // recorded with the text attributes
+    void BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                     double aRotationAngle ) override;
+
+    // Shape instancing: the instances refer to the templates of this GAL, they are found
+    // again in the templates of the GAL the entry is replayed on
+    void DrawShapeInstance( int aTemplate, const VECTOR2D& aPosition, double aRotation,
+                            const COLOR4D& aColor ) override;
+
+    // Transformations
+    void Transform( const MATRIX3x3D& aTransformation ) override;
+    void Rotate( double aAngle ) override;
+    void Translate( const VECTOR2D& aTranslation ) override;
+    void Scale( const VECTOR2D& aScale ) override;
+    void Save() override;
+    void Restore() override;
+
+private:
+    enum COMMAND_TYPE
+    {
+        CMD_LINE,
+        CMD_SEGMENT,
+        CMD_POLYLINE,
+        CMD_LINE_CHAIN_POLYLINE,
+        CMD_CIRCLE,
+        CMD_ARC,
+        CMD_ARC_SEGMENT,
+        CMD_RECTANGLE,
+        CMD_POLYGON,
+        CMD_POLY_SET,
+        CMD_LINE_CHAIN_POLYGON,
+        CMD_CURVE,
+        CMD_BITMAP_TEXT,
+        CMD_SHAPE_INSTANCE,
+        CMD_SET_IS_FILL,
+        CMD_SET_IS_STROKE,
+        CMD_SET_FILL_COLOR,
+        CMD_SET_STROKE_COLOR,
+        CMD_SET_LINE_WIDTH,
+        CMD_SET_LAYER_DEPTH,
+        CMD_ROTATE,
+        CMD_TRANSLATE,
+        CMD_SCALE,
+        CMD_SAVE,
+        CMD_RESTORE
+    };
+
+    struct COMMAND
+    {
+        COMMAND_TYPE m_type;
+        VECTOR2D     m_p0;
+        VECTOR2D     m_p1;
+        double       m_args[4];     ///< Radius, angles, width or color, depending on the type
+        size_t       m_data;        ///< Index of the first point or of the shape or text
+        size_t       m_count;       ///< Number of points
+    };
+
+    struct TEXT
+    {
+        wxString            m_text;
+        VECTOR2D            m_glyphSize;
+        bool                m_bold;
+        bool                m_italic;
+        bool                m_mirrored;
+        EDA_TEXT_HJUSTIFY_T m_horizontalJustify;
+        EDA_TEXT_VJUSTIFY_T m_verticalJustify;
+    };
+
+    struct ENTRY
+    {
+        size_t m_firstCommand;
+        size_t m_lastCommand;       ///< One past the last command
+    };
+
+    bool sameCommand( const COMMAND& aCmd, const GAL_DISPLAY_LIST& aOther,
+                      const COMMAND& aOtherCmd ) const;
+
+    COMMAND& addCommand( COMMAND_TYPE aType );
+    void addColor( COMMAND_TYPE aType, const COLOR4D& aColor );
+    void addPoints( COMMAND_TYPE aType, const VECTOR2D* aPoints, int aCount );
+
+    std::vector<COMMAND>         m_commands;
+    std::vector<VECTOR2D>        m_points;
+    std::deque<SHAPE_POLY_SET>   m_polySets;
+    std::deque<SHAPE_LINE_CHAIN> m_lineChains;
+    std::vector<TEXT>            m_texts;
+    std::vector<ENTRY>           m_entries;
+
+    bool m_entryValid;              ///< False if the current entry used unsupported commands
+    bool m_openGlTarget;
+    bool m_cairoTarget;
+};
+
+} // namespace KIGFX
+
+#endif // GAL_DISPLAY_LIST_H_
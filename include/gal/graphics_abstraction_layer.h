@@ -30,6 +30,8 @@
 #include <deque>
 #include <stack>
 #include <limits>
+#include <memory>
+#include <unordered_map>
 
 #include <math/matrix3x3.h>
 
@@ -37,7 +39,6 @@
 #include <gal/definitions.h>
 #include <gal/stroke_font.h>
 #include <gal/gal_display_options.h>
-#include <newstroke_font.h>
 
 class SHAPE_LINE_CHAIN;
 class SHAPE_POLY_SET;
@@ -46,6 +47,8 @@ class BITMAP_BASE;
 namespace KIGFX
 {
 
+class GAL_DISPLAY_LIST;
+
 /**
  * @brief Class GAL is the abstract interface for drawing on a 2D-surface.
  *
@@ -602,6 +605,36 @@ public:
      */
     virtual void ClearCache() {};
 
+    // --------------------------------------------
+    // Shape instancing methods
+    // ---------------------------------------------
+
+    /**
+     * @brief Find or create the template of a shape drawn many times (e.g. a pad or via shape).
+     *
+     * The templates are shared by content: two shapes with the same geometry get the same
+     * template, whatever their colors.
+     *
+     * @param aShape contains the drawing commands of the shape, in its own coordinates.
+     * @param aEntry is the entry of \a aShape defining the shape.
+     * @return the number of the template.
+     */
+    int GetShapeTemplate( const GAL_DISPLAY_LIST& aShape, int aEntry );
+
+    /**
+     * @brief Draw an instance of a shape template.
+     *
+     * The default implementation draws the template commands again. A GAL may instead keep
+     * the template geometry once and draw the instances from it.
+     *
+     * @param aTemplate is the template number, from GetShapeTemplate().
+     * @param aPosition is the position of the template origin.
+     * @param aRotation is the rotation of the template around its origin, in radians.
+     * @param aColor is the color used for the whole shape.
+     */
+    virtual void DrawShapeInstance( int aTemplate, const VECTOR2D& aPosition, double aRotation,
+                                    const COLOR4D& aColor );
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
@@ -1117,6 +1150,15 @@ protected:
     /// Instance of object that stores information about how to draw texts
     STROKE_FONT        strokeFont;
 
+    /// Forgets the shape templates, their numbers are given again from zero
+    void clearShapeTemplates();
+
+    /// Drawing commands of the shape templates, one entry per template
+    std::unique_ptr<GAL_DISPLAY_LIST>          shapeTemplates;
+
+    /// Templates numbers by hash of their content
+    std::unordered_multimap<size_t, int>       shapeTemplateIds;
+
     /// Private: use GAL_CONTEXT_LOCKER RAII object
     virtual void lockContext( int aClientCookie ) {}
 
@@ -54,6 +54,7 @@ namespace KIGFX
 {
 class SHADER;
 class GL_BITMAP_CACHE;
+class SHAPE_INSTANCER;
 
 /**
  * @brief Class OpenGL_GAL is the OpenGL implementation of the Graphics Abstraction Layer.
@@ -222,6 +223,14 @@ public:
     /// @copydoc GAL::ClearCache()
     void ClearCache() override;
 
+    // --------------------------------------------
+    // Shape instancing methods
+    // ---------------------------------------------
+
+    /// @copydoc GAL::DrawShapeInstance()
+    void DrawShapeInstance( int aTemplate, const VECTOR2D& aPosition, double aRotation,
+                            const COLOR4D& aColor ) override;
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
@@ -303,6 +312,11 @@ private:
     VERTEX_MANAGER*         cachedManager;          ///< Container for storing cached VERTEX_ITEMs
     VERTEX_MANAGER*         nonCachedManager;       ///< Container for storing non-cached VERTEX_ITEMs
     VERTEX_MANAGER*         overlayManager;         ///< Container for storing overlaid VERTEX_ITEMs
+    int                     currentGroup;           ///< Group being created, if isGrouping is set
+
+    // Shape instancing
+    std::unique_ptr<SHAPE_INSTANCER> shapeInstancer;    ///< Null if instancing is not supported
+    std::unique_ptr<VERTEX_MANAGER>  templateManager;   ///< Used to tessellate the templates
 
     // Framebuffer & compositing
     OPENGL_COMPOSITOR*      compositor;             ///< Handles multiple rendering targets
@@ -469,6 +483,13 @@ private:
      */
     unsigned int getNewGroupNumber();
 
+    /**
+     * @brief Tessellates a shape template and gives its vertices to the shape instancer.
+     *
+     * @param aTemplate is the template number.
+     */
+    void addInstancedTemplate( int aTemplate );
+
     /**
      * @brief Compute the angle step when drawing arcs/circles approximated with lines.
      */
@@ -0,0 +1,167 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef SHAPE_INSTANCER_H_
+#define SHAPE_INSTANCER_H_
+
+#include <gal/opengl/vertex_common.h>
+#include <gal/color4d.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace KIGFX
+{
+class SHADER;
+
+/**
+ * @brief Draws the shape templates of the cached groups with hardware instancing.
+ *
+ * The vertices of every template are uploaded once to the GPU.  A cached group only stores
+ * the instances it contains (position, rotation, depth and color), the vertex shader moves
+ * the template vertices to every instance.
+ */
+class SHAPE_INSTANCER
+{
+public:
+    SHAPE_INSTANCER();
+    ~SHAPE_INSTANCER();
+
+    /**
+     * Function IsSupported()
+     * @return true if the current OpenGL context can draw instances.  It has to be called
+     * after glewInit().
+     */
+    static bool IsSupported();
+
+    /**
+     * Function SetShader()
+     * sets the shader used to draw the instances.  It has to be linked already.
+     */
+    void SetShader( SHADER& aShader );
+
+    /**
+     * Function HasTemplate()
+     * @return true if the vertices of the template \a aTemplate are stored already.
+     */
+    bool HasTemplate( int aTemplate ) const
+    {
+        return m_templates.count( aTemplate ) > 0;
+    }
+
+    /**
+     * Function AddTemplate()
+     * stores the vertices of a template, in the template coordinates.
+     * @param aTemplate is the template number.
+     * @param aVertices are the vertices, three per triangle.
+     * @param aSize is the number of vertices.
+     */
+    void AddTemplate( int aTemplate, const VERTEX* aVertices, unsigned int aSize );
+
+    /**
+     * Function AddInstance()
+     * adds an instance of a template to a group.
+     * @param aGroup is the group number.
+     * @param aTemplate is the template number, added with AddTemplate().
+     * @param aPosition is the position of the template origin, in world coordinates.
+     * @param aRotation is the rotation of the template, in radians.
+     * @param aColor is the color of the instance.
+     * @param aDepth is the depth of the instance.
+     */
+    void AddInstance( int aGroup, int aTemplate, const VECTOR2D& aPosition, double aRotation,
+                      const COLOR4D& aColor, GLfloat aDepth );
+
+    /// Changes the color of all the instances of a group
+    void ChangeGroupColor( int aGroup, const COLOR4D& aColor );
+
+    /// Changes the depth of all the instances of a group
+    void ChangeGroupDepth( int aGroup, GLfloat aDepth );
+
+    /// Removes the instances of a group
+    void DeleteGroup( int aGroup );
+
+    /// Removes all the instances and the templates
+    void Clear();
+
+    /// Prepares a new frame
+    void BeginDrawing();
+
+    /// Adds the instances of a group to the current frame
+    void DrawGroup( int aGroup );
+
+    /// Draws the instances of the current frame
+    void EndDrawing();
+
+    /// Enables/disables Z buffer depth test
+    void EnableDepthTest( bool aEnabled )
+    {
+        m_enableDepthTest = aEnabled;
+    }
+
+private:
+    ///> Instance data, uploaded as is to the GPU
+    struct INSTANCE
+    {
+        GLfloat x, y, z;        // Position & depth
+        GLfloat cos, sin;       // Rotation
+        GLubyte r, g, b, a;     // Color
+    };
+
+    struct GROUP_INSTANCE
+    {
+        int      m_template;
+        INSTANCE m_instance;
+    };
+
+    struct TEMPLATE
+    {
+        unsigned int          m_offset;     ///< First vertex in the template buffer
+        unsigned int          m_size;       ///< Number of vertices
+        std::vector<INSTANCE> m_drawn;      ///< Instances of the current frame
+    };
+
+    void uploadTemplates();
+
+    std::unordered_map<int, TEMPLATE>                    m_templates;
+    std::unordered_map<int, std::vector<GROUP_INSTANCE>> m_groups;
+
+    ///> Vertices of all the templates, kept to upload them again when a template is added
+    std::vector<VERTEX> m_vertices;
+
+    SHADER* m_shader;
+    int     m_instancedParam;
+    GLint   m_shaderAttrib;
+    GLint   m_positionAttrib;
+    GLint   m_rotationAttrib;
+    GLint   m_colorAttrib;
+
+    GLuint  m_templateBuffer;
+    GLuint  m_instanceBuffer;
+    bool    m_buffersInitialized;
+    bool    m_templatesDirty;
+    bool    m_enableDepthTest;
+};
+
+} // namespace KIGFX
+
+#endif /* SHAPE_INSTANCER_H_ */
@@ -311,6 +311,16 @@ public:
      */
     VERTEX* GetVertices( const VERTEX_ITEM& aItem ) const;
 
+    /**
+     * Function GetAllVertices()
+     * returns all the vertices stored in the container, e.g. to read back the vertices drawn
+     * with a noncached manager.
+     *
+     * @param aSize is set to the number of vertices.
+     * @return Pointer to the vertices.
+     */
+    const VERTEX* GetAllVertices( unsigned int& aSize ) const;
+
     const glm::mat4& GetTransformation() const
     {
         return m_transform;
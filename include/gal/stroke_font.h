@@ -42,9 +42,6 @@ namespace KIGFX
 {
 class GAL;
 
-typedef std::vector<std::vector<VECTOR2D>*> GLYPH;
-typedef std::vector<GLYPH*>                 GLYPH_LIST;
-
 /**
  * @brief Class STROKE_FONT implements stroke font drawing.
  *
@@ -58,15 +55,6 @@ public:
     /// Constructor
     STROKE_FONT( GAL* aGal );
 
-    /**
-     * @brief Load the new stroke font.
-     *
-     * @param aNewStrokeFont is the pointer to the font data.
-     * @param aNewStrokeFontSize is the size of the font data.
-     * @return True, if the font was successfully loaded, else false.
-     */
-    bool LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize );
-
     /**
      * @brief Draw a string.
      *
@@ -115,8 +103,22 @@ public:
 
 private:
     GAL*                      m_gal;                  ///< Pointer to the GAL
-    const GLYPH_LIST*         m_glyphs;               ///< Glyph list
-    const std::vector<BOX2D>* m_glyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+
+    /**
+     * @brief Return the glyph drawn for a character, in the tables of newstroke_glyphs.h.
+     * The characters missing in the font are drawn as '?', tabs as spaces.
+     *
+     * @param aChar is the code point of the character.
+     * @return the index of the glyph.
+     */
+    static int glyphIndex( int aChar );
+
+    /**
+     * @brief Return the advance width of a glyph, for a glyph size of 1.
+     *
+     * @param aGlyph is the index of the glyph.
+     */
+    static double glyphWidth( int aGlyph );
 
     /**
      * @brief Compute the X and Y size of a given text. The text is expected to be
@@ -134,15 +136,6 @@ private:
      */
     double computeOverbarVerticalPosition() const;
 
-    /**
-     * @brief Compute the bounding box of a given glyph.
-     *
-     * @param aGlyph is the glyph.
-     * @param aGlyphWidth is the x-component of the bounding box size.
-     * @return is the complete bounding box size.
-     */
-    BOX2D computeBoundingBox( const GLYPH* aGlyph, double aGlyphWidth ) const;
-
     /**
      * @brief Draws a single line of text. Multiline texts should be split before using the
      * function.
@@ -0,0 +1,71 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __NEWSTROKE_GLYPHS_H__
+#define __NEWSTROKE_GLYPHS_H__
+
+/**
+ * The glyphs of newstroke_font, decoded at build time by newstroke_glyph_gen.
+ *
+ * The coordinates are in font units: the glyph size is NEWSTROKE_GLYPH_UNITS font units.
+ * X is relative to the start of the glyph, Y to the text base line and it grows downwards:
+ * only the descenders (j, y...) have positive coordinates.
+ */
+
+///> Number of font units in a glyph size
+#define NEWSTROKE_GLYPH_UNITS 21
+
+struct NEWSTROKE_POINT
+{
+    signed char x;
+    signed char y;
+};
+
+struct NEWSTROKE_GLYPH
+{
+    unsigned int firstStroke;       ///< Index of the first stroke in newstroke_strokes
+    unsigned int strokeCount;       ///< Number of strokes (pen down polylines)
+    signed char  width;             ///< Advance width
+    signed char  minY;              ///< Bounding box top, at most 0
+    signed char  maxY;              ///< Bounding box bottom, at least 0
+};
+
+/**
+ * Points of all the strokes
+ */
+extern const NEWSTROKE_POINT newstroke_points[];
+
+/**
+ * Index in newstroke_points of the first point of each stroke.  It has one more value than
+ * the number of strokes: the points of the stroke \a i are [newstroke_strokes[i],
+ * newstroke_strokes[i + 1]).
+ */
+extern const unsigned int newstroke_strokes[];
+
+/**
+ * The glyphs, in the order of newstroke_font: the glyph of a code point c is at c - ' '.
+ */
+extern const NEWSTROKE_GLYPH newstroke_glyphs[];
+extern const int             newstroke_glyph_count;
+
+#endif /* __NEWSTROKE_GLYPHS_H__ */
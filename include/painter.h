@@ -104,6 +104,19 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function Clone
+     * Creates a painter with the same settings, drawing on another GAL.  It lets the VIEW
+     * draw items from several threads, each one with its own painter.
+     * @param aGal is the GAL used by the new painter.
+     * @return the new painter (owned by the caller), or nullptr if the painter cannot be
+     * used from other threads.
+     */
+    virtual PAINTER* Clone( GAL* aGal ) const
+    {
+        return nullptr;
+    }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
@@ -82,6 +82,8 @@ protected:
 
     PCBNEW_SETTINGS*        m_Settings; // No ownership, just a shortcut
 
+    LSET                    m_3DViewDirtyLayers;    // Layers to rebuild on the next 3D update
+
     virtual void unitsChangeRefresh() override;
 
     /**
@@ -117,6 +119,13 @@ public:
      */
     virtual void Update3DView( bool aForceReload, const wxString* aTitle = nullptr );
 
+    /**
+     * Set the layers the next Update3DView() call will ask the 3D viewer to rebuild.
+     * Used by the commit code to only rebuild the layers of the modified items.
+     * Callers must restore LSET::AllLayersMask() after the update.
+     */
+    void Set3DViewDirtyLayers( const LSET& aLayers ) { m_3DViewDirtyLayers = aLayers; }
+
     /**
      * Function LoadFootprint
      * attempts to load \a aFootprintId from the footprint library table.
@@ -157,6 +157,32 @@ namespace S3D
      */
     SGLIB_API S3DMODEL* GetModel( SCENEGRAPH* aNode );
 
+    /**
+     * Function WriteModelCache
+     * writes the render data of a model to a binary cache file. The file is a flat
+     * array of 4 bytes wide items in native byte order: a versioned header, the
+     * materials, then for each mesh the final vertex, normal, texture coordinate,
+     * color and index arrays, so it can be read (or memory mapped) without parsing.
+     *
+     * @param aFileName is the name of the file to write; an existing file is overwritten
+     * @param aModel is the render data to write
+     * @param aPluginInfo is the PluginName:Version string of the plugin the model comes from
+     * @return true on success
+     */
+    SGLIB_API bool WriteModelCache( const char* aFileName, const S3DMODEL& aModel,
+        const char* aPluginInfo );
+
+    /**
+     * Function ReadModelCache
+     * reads a binary cache file written by WriteModelCache()
+     *
+     * @param aFileName is the name of the binary cache file to be read
+     * @return NULL on failure (including an obsolete file format or plugin version),
+     * on success the render data, to be freed with Destroy3DModel()
+     */
+    SGLIB_API S3DMODEL* ReadModelCache( const char* aFileName, void* aPluginMgr,
+        bool (*aTagCheck)( const char*, void* ) );
+
     /**
      * Function Destroy3DModel
      * frees memory used by an S3DMODEL structure and sets the pointer to
@@ -0,0 +1,94 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef PROPERTIES_UNDO_ITEM_H
+#define PROPERTIES_UNDO_ITEM_H
+
+#include <base_struct.h>
+
+#include <utility>
+#include <vector>
+
+#include <wx/any.h>
+
+class PROPERTY_BASE;
+
+
+/**
+ * The values of the properties (see PROPERTY_MANAGER) of an item, stored in the undo list
+ * instead of a copy of the item when only its properties are modified.
+ *
+ * The item is designated by its KIID, so it is found again even when it belongs to an
+ * item (e.g. a footprint) whose data is exchanged with a copy by another undo command.
+ */
+class PROPERTIES_UNDO_ITEM : public EDA_ITEM
+{
+public:
+    /**
+     * Stores the values of all the writable properties of \a aItem.
+     */
+    PROPERTIES_UNDO_ITEM( EDA_ITEM* aItem );
+
+    /**
+     * Drops the stored values which are still the values of the properties of \a aItem,
+     * i.e. keeps only the changes.
+     */
+    void Reduce( EDA_ITEM* aItem );
+
+    bool IsEmpty() const { return m_values.empty(); }
+
+    /**
+     * Exchanges the stored values with the values of the properties of \a aItem.  It undoes
+     * the changes, and calling it again redoes them.
+     */
+    void Swap( EDA_ITEM* aItem );
+
+    /**
+     * @return the item whose properties are stored: \a aParent itself or one of its children,
+     * or nullptr if it does not exist anymore.
+     */
+    EDA_ITEM* FindItem( EDA_ITEM* aParent ) const;
+
+    /**
+     * @return the approximate memory used by the stored values, in bytes.
+     */
+    size_t GetMemorySize() const;
+
+#if defined(DEBUG)
+    /// @copydoc EDA_ITEM::Show()
+    void Show( int x, std::ostream& st ) const override { }
+#endif
+
+    wxString GetClass() const override
+    {
+        return wxT( "PROPERTIES_UNDO_ITEM" );
+    }
+
+private:
+    KIID    m_itemUuid;
+    KICAD_T m_itemType;
+
+    std::vector<std::pair<PROPERTY_BASE*, wxAny>> m_values;
+};
+
+#endif /* PROPERTIES_UNDO_ITEM_H */
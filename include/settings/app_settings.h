@@ -143,6 +143,7 @@ public:
     {
         bool                  first_run_shown;
         int                   max_undo_items;
+        int                   max_undo_memory;  ///< Undo memory budget in MB, 0 for no limit
         std::vector<wxString> file_history;
         int                   units;
     };
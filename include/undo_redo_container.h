@@ -54,6 +54,8 @@ enum class UNDO_REDO {
     UNSPECIFIED = 0,     // illegal
     CHANGED,             // params of items have a value changed: undo is made by exchange
                          // values with a copy of these values
+    CHANGED_PROPERTIES,  // only properties of an item have changed: the link is a
+                         // PROPERTIES_UNDO_ITEM, undo is made by exchanging the values
     NEWITEM,             // new item, undo by changing in deleted
     DELETED,             // deleted item, undo by changing in deleted
     MOVED,               // moved item, undo by move it
@@ -137,6 +139,8 @@ public:
                                        * UNSPECIFIED */
     wxPoint     m_TransformPoint;     /* used to undo redo command by the same command: usually
                                        * need to know the rotate point or the move vector */
+    size_t      m_MemorySize;         /* estimated memory used by the copies of items, in bytes,
+                                       * or 0 if unknown */
 
 private:
     std::vector <ITEM_PICKER> m_ItemsList;
@@ -103,9 +103,12 @@ public:
      * @param aResult result of the search, containing VIEW_ITEMs associated with their layers.
      *  Sorted according to the rendering order (items that are on top of the rendering stack as
      *  first).
+     * @param aVisibleOnly false to find also the hidden items and the items of hidden layers,
+     *  i.e. to use the view as a spatial index of all its items.
      * @return Number of found items.
      */
-    virtual int Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) const;
+    virtual int Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult,
+                       bool aVisibleOnly = true ) const;
 
     /**
      * Sets the item visibility.
@@ -615,6 +618,16 @@ public:
      */
     void UpdateItems();
 
+    /**
+     * Function HasPendingGeometryUpdates()
+     * @return true if some items were added, moved or changed layers since the last
+     * UpdateItems(), so Query() may not find them where they are.
+     */
+    bool HasPendingGeometryUpdates() const
+    {
+        return m_pendingGeometryUpdates;
+    }
+
     /**
      * Updates all items in the view according to the given flags
      * @param aUpdateFlags is is according to KIGFX::VIEW_UPDATE_FLAGS
@@ -647,6 +660,25 @@ public:
         m_useDrawPriority = aFlag;
     }
 
+    /**
+     * Function IsUsingParallelUpdates()
+     * @return true if the item geometry may be drawn from several threads in UpdateItems().
+     */
+    bool IsUsingParallelUpdates() const
+    {
+        return m_parallelUpdates;
+    }
+
+    /**
+     * Function SetParallelUpdates()
+     * @param aEnable is true to let UpdateItems() draw the item geometry from several threads,
+     * when the painter supports it.
+     */
+    void SetParallelUpdates( bool aEnable )
+    {
+        m_parallelUpdates = aEnable;
+    }
+
     /**
      * Function IsDrawOrderReversed()
      * @return true if draw order is reversed
@@ -773,8 +805,11 @@ protected:
      * Manages dirty flags & redraw queueing when updating an item.
      * @param aItem is the item to be updated.
      * @param aUpdateFlags determines the way an item is refreshed.
+     * @param aGeometryUpdates, if set, receives the item layers whose geometry has to be
+     * updated, instead of updating them immediately.
      */
-    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags );
+    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags,
+                         std::vector<std::pair<VIEW_ITEM*, int>>* aGeometryUpdates = nullptr );
 
     /// Updates colors that are used for an item to be drawn
     void updateItemColor( VIEW_ITEM* aItem, int aLayer );
@@ -782,6 +817,13 @@ protected:
     /// Updates all informations needed to draw an item
     void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
 
+    /**
+     * Updates the geometry of a list of item layers.  The painter draws them from several
+     * threads into display lists, which are then replayed in the GAL groups of the items.
+     * @param aItemLayers are the item layers, the layers of an item must be consecutive.
+     */
+    void updateItemsGeometry( const std::vector<std::pair<VIEW_ITEM*, int>>& aItemLayers );
+
     /// Updates bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
 
@@ -859,6 +901,15 @@ protected:
     /// Flag to reverse the draw order when using draw priority
     bool m_reverseDrawOrder;
 
+    /// Flag to draw the item geometry from several threads in UpdateItems()
+    bool m_parallelUpdates;
+
+    /// Update flags which move items in the R-trees of the layers
+    static const int GEOMETRY_UPDATE_FLAGS = INITIAL_ADD | GEOMETRY | LAYERS;
+
+    /// Set when an item asks for a geometry update, cleared by UpdateItems()
+    bool m_pendingGeometryUpdates;
+
     /// A control for printing: m_printMode <= 0 means no printing mode (normal draw mode
     /// m_printMode > 0 is a printing mode (currently means "we are in printing mode")
     int m_printMode;
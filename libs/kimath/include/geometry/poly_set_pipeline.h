@@ -0,0 +1,120 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __POLY_SET_PIPELINE_H
+#define __POLY_SET_PIPELINE_H
+
+#include <clipper.hpp>
+#include <geometry/shape_poly_set.h>
+
+
+/**
+ * POLY_SET_PIPELINE
+ *
+ * Chains boolean operations and inflations on a polygon set.  The intermediate results are
+ * kept in the Clipper format: the contours are converted from SHAPE_LINE_CHAINs once at the
+ * start and back once at the end, instead of around each operation as SHAPE_POLY_SET does.
+ *
+ * Each operation gives the same result as the SHAPE_POLY_SET method of the same name:
+ *
+ *     POLY_SET_PIPELINE fill( aRawPolys );
+ *
+ *     fill.Subtract( holes, SHAPE_POLY_SET::PM_FAST ).Deflate( margin, segments );
+ *     fill.GetFracturedResult( aRawPolys, SHAPE_POLY_SET::PM_FAST );
+ */
+class POLY_SET_PIPELINE
+{
+public:
+    typedef SHAPE_POLY_SET::POLYGON_MODE    POLYGON_MODE;
+    typedef SHAPE_POLY_SET::CORNER_STRATEGY CORNER_STRATEGY;
+
+    /**
+     * @param aSubject the set to operate on.  It is converted by the first operation, it must
+     *                 not be changed nor destroyed before.
+     */
+    POLY_SET_PIPELINE( const SHAPE_POLY_SET& aSubject );
+
+    POLY_SET_PIPELINE( const POLY_SET_PIPELINE& ) = delete;
+    POLY_SET_PIPELINE& operator=( const POLY_SET_PIPELINE& ) = delete;
+
+    /**
+     * Restarts the pipeline from another set, e.g. after the result has been changed by
+     * a SHAPE_POLY_SET method.
+     */
+    void Reset( const SHAPE_POLY_SET& aSubject );
+
+    ///> Same as SHAPE_POLY_SET::BooleanAdd()
+    POLY_SET_PIPELINE& Add( const SHAPE_POLY_SET& aOther, POLYGON_MODE aFastMode );
+
+    ///> Same as SHAPE_POLY_SET::BooleanSubtract()
+    POLY_SET_PIPELINE& Subtract( const SHAPE_POLY_SET& aOther, POLYGON_MODE aFastMode );
+
+    ///> Same as SHAPE_POLY_SET::BooleanIntersection()
+    POLY_SET_PIPELINE& Intersect( const SHAPE_POLY_SET& aOther, POLYGON_MODE aFastMode );
+
+    ///> Same as SHAPE_POLY_SET::Simplify()
+    POLY_SET_PIPELINE& Simplify( POLYGON_MODE aFastMode );
+
+    ///> Same as SHAPE_POLY_SET::Inflate()
+    POLY_SET_PIPELINE& Inflate( int aAmount, int aCircleSegmentsCount,
+                                CORNER_STRATEGY aCornerStrategy =
+                                        SHAPE_POLY_SET::ROUND_ALL_CORNERS );
+
+    ///> Same as SHAPE_POLY_SET::Deflate()
+    POLY_SET_PIPELINE& Deflate( int aAmount, int aCircleSegmentsCount,
+                                CORNER_STRATEGY aCornerStrategy =
+                                        SHAPE_POLY_SET::ROUND_ALL_CORNERS )
+    {
+        return Inflate( -aAmount, aCircleSegmentsCount, aCornerStrategy );
+    }
+
+    /**
+     * Stores the result of the operations in aResult, which can be the subject set.
+     */
+    void GetResult( SHAPE_POLY_SET& aResult );
+
+    /**
+     * Stores the result of the operations in aResult, fractured as SHAPE_POLY_SET::Fracture()
+     * does.  The result of the last operation is not simplified again when it is already.
+     */
+    void GetFracturedResult( SHAPE_POLY_SET& aResult, POLYGON_MODE aFastMode );
+
+private:
+    ///> Adds the current contours to a boolean operation
+    void addSubject( ClipperLib::Clipper& aClipper ) const;
+
+    void booleanOp( ClipperLib::ClipType aType, const SHAPE_POLY_SET* aOther,
+                    POLYGON_MODE aFastMode );
+
+    ///> The set the pipeline starts from, until the first operation
+    const SHAPE_POLY_SET* m_subject;
+
+    ///> The result of the last operation, once there is one
+    ClipperLib::PolyTree  m_tree;
+
+    ///> Mode of the last boolean operation (PM_FAST after an inflation), tells whether the
+    ///> contours need to be simplified before being fractured
+    POLYGON_MODE          m_mode;
+};
+
+#endif // __POLY_SET_PIPELINE_H
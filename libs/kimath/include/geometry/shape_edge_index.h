@@ -0,0 +1,147 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __SHAPE_EDGE_INDEX_H
+#define __SHAPE_EDGE_INDEX_H
+
+#include <vector>
+
+#include <geometry/seg.h>
+#include <math/box2.h>
+#include <math/vector2d.h>
+
+
+/**
+ * SHAPE_EDGE_INDEX
+ *
+ * A static bounding volume hierarchy of segments (typically the edges of line chains or
+ * polygon sets), answering distance queries in logarithmic time instead of testing every
+ * segment.
+ *
+ * The index holds copies of the segments: it does not follow later changes of the shape it
+ * was built from and must be rebuilt after them.  The SEG::Index() of each segment is kept,
+ * so the owner can use it to tell where a segment comes from.
+ */
+class SHAPE_EDGE_INDEX
+{
+public:
+    typedef SEG::ecoord ecoord;
+
+    /**
+     * Builds the hierarchy.
+     * @param aEdges the segments to index (their order is not kept).
+     */
+    SHAPE_EDGE_INDEX( std::vector<SEG> aEdges );
+
+    int EdgeCount() const
+    {
+        return m_edges.size();
+    }
+
+    /**
+     * Function SquaredDistance()
+     * @param aP the point to measure the distance to.
+     * @param aStopAt the search stops as soon as a distance lower than or equal to this one is
+     *                found, without looking for the minimum.
+     * @return the minimum squared distance between aP and the segments, or
+     *         VECTOR2I::ECOORD_MAX if the index is empty.
+     */
+    ecoord SquaredDistance( const VECTOR2I& aP, ecoord aStopAt = 0 ) const;
+
+    /**
+     * Function SquaredDistance()
+     * @param aSeg the segment to measure the distance to.
+     * @param aStopAt the search stops as soon as a distance lower than or equal to this one is
+     *                found, without looking for the minimum.
+     * @return the minimum squared distance between aSeg and the segments, or
+     *         VECTOR2I::ECOORD_MAX if the index is empty.
+     */
+    ecoord SquaredDistance( const SEG& aSeg, ecoord aStopAt = 0 ) const;
+
+    /**
+     * Function QueryRay()
+     * Calls aVisitor for each segment which may cross the horizontal half line starting at aP
+     * towards positive X, i.e. the segments used by a point in polygon test.  Other segments can
+     * be visited too, the visitor has to do the exact test.
+     */
+    template <class VISITOR>
+    void QueryRay( const VECTOR2I& aP, VISITOR aVisitor ) const
+    {
+        if( m_nodes.empty() )
+            return;
+
+        int stack[MAX_DEPTH];
+        int top = 0;
+
+        stack[top++] = 0;
+
+        while( top > 0 )
+        {
+            const NODE& node = m_nodes[stack[--top]];
+
+            if( node.maxX < aP.x || node.minY > aP.y || node.maxY < aP.y )
+                continue;
+
+            if( node.count > 0 )
+            {
+                for( int i = node.first; i < node.first + node.count; i++ )
+                    aVisitor( m_edges[i] );
+            }
+            else
+            {
+                stack[top++] = node.first;
+                stack[top++] = node.first + 1;
+            }
+        }
+    }
+
+private:
+    /**
+     * A node of the hierarchy: a leaf holds the segments [first, first + count) of m_edges,
+     * an inner node (count == 0) has its two children at m_nodes[first] and m_nodes[first + 1].
+     */
+    struct NODE
+    {
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+        int first;
+        int count;
+    };
+
+    ///> Maximum number of segments in a leaf
+    static constexpr int LEAF_SIZE = 4;
+
+    ///> Traversal stack size, the hierarchy being balanced it is never reached
+    static constexpr int MAX_DEPTH = 64;
+
+    void build( int aNode, int aFirst, int aCount );
+
+    template <class BOX_DIST, class EDGE_DIST>
+    ecoord minDistance( BOX_DIST aBoxDistance, EDGE_DIST aEdgeDistance, ecoord aStopAt ) const;
+
+    std::vector<SEG>  m_edges;
+    std::vector<NODE> m_nodes;
+};
+
+#endif // __SHAPE_EDGE_INDEX_H
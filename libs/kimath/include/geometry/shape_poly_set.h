@@ -26,6 +26,8 @@
 #ifndef __SHAPE_POLY_SET_H
 #define __SHAPE_POLY_SET_H
 
+#include <atomic>
+#include <cstdint>
 #include <cstdio>
 #include <deque>                        // for deque
 #include <iosfwd>                       // for string, stringstream
@@ -58,7 +60,13 @@
  *      outline or a hole.
  *      - Vertex (or corner): each one of the points that define a contour.
  *
- * TODO: add convex partitioning & spatial index
+ * The distance and collision queries of large sets which are queried repeatedly use an
+ * index of the edges (see SHAPE_EDGE_INDEX).  It is built on demand and, like the
+ * triangulation, dropped by all the modifications, including the ones done through the
+ * non-const accessors (Outline(), Hole(), Polygon() and the iterators): do not keep a
+ * reference returned by them across queries.
+ *
+ * TODO: add convex partitioning
  */
 class SHAPE_POLY_SET : public SHAPE
 {
@@ -297,7 +305,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             const T& Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].CPoint(
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CPoint(
                         m_currentVertex );
             }
 
@@ -420,7 +428,8 @@ class SHAPE_POLY_SET : public SHAPE
 
             T Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Segment( m_currentSegment );
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CSegment(
+                        m_currentSegment );
             }
 
             T operator*()
@@ -643,6 +652,7 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aIndex-th outline in the set
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
+            markModified();
             return m_polys[aIndex][0];
         }
 
@@ -665,12 +675,14 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
+            markModified();
             return m_polys[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
         POLYGON& Polygon( int aIndex )
         {
+            markModified();
             return m_polys[aIndex];
         }
 
@@ -713,6 +725,8 @@ class SHAPE_POLY_SET : public SHAPE
         {
             ITERATOR iter;
 
+            markModified();
+
             iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -825,6 +839,8 @@ class SHAPE_POLY_SET : public SHAPE
         {
             SEGMENT_ITERATOR iter;
 
+            markModified();
+
             iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -1287,10 +1303,20 @@ class SHAPE_POLY_SET : public SHAPE
         bool IsVertexInHole( int aGlobalIdx );
 
     private:
+        friend class POLY_SET_PIPELINE;
+
         void fractureSingle( POLYGON& paths );
         void unfractureSingle ( POLYGON& path );
         void importTree( ClipperLib::PolyTree* tree );
 
+        /**
+         * Sets the arc tolerance and the miter parameters of an offset as Inflate() does.
+         * @return the join type to add the paths with.
+         */
+        static ClipperLib::JoinType setupOffset( ClipperLib::ClipperOffset& aOffset, int aAmount,
+                                                 int aCircleSegmentsCount,
+                                                 CORNER_STRATEGY aCornerStrategy );
+
         /** Function booleanOp
          * this is the engine to execute all polygon boolean transforms
          * (AND, OR, ... and polygon simplification (merging overlaping  polygons)
@@ -1357,6 +1383,23 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns true if the polygon set has any holes that touch share a vertex.
         bool hasTouchingHoles( const POLYGON& aPoly ) const;
 
+        struct EDGE_INDEX;
+
+        /**
+         * Returns the index of the edges of the set, building it if the set is large and has
+         * been queried enough times since its last change, or nullptr.
+         */
+        std::shared_ptr<const EDGE_INDEX> edgeIndex() const;
+
+        ///> Starts a new generation of the set, dropping the index of the edges and the
+        ///> triangulation: called by all the methods which can change the contours
+        void markModified()
+        {
+            m_generation++;
+            m_edgeIndex.reset();
+            m_edgeIndexQueries = 0;
+        }
+
         typedef std::vector<POLYGON> POLYSET;
 
         POLYSET m_polys;
@@ -1365,18 +1408,46 @@ class SHAPE_POLY_SET : public SHAPE
 
         SHAPE_POLY_SET& operator=( const SHAPE_POLY_SET& );
 
-        void CacheTriangulation( bool aPartition = true );
+        /**
+         * Builds the triangulation of the set, unless it is up to date.
+         * @param aPartition splits the set in 1 cm cells first, triangulating smaller outlines.
+         * @param aParallel triangulates the outlines on several threads when there are enough
+         *                  of them.  The result does not depend on it.
+         */
+        void CacheTriangulation( bool aPartition = true, bool aParallel = true );
         bool IsTriangulationUpToDate() const;
 
+        /**
+         * @return the MD5 digest of the vertices, for the uses which need a stable digest.
+         * It is computed on each call: use GetContentHash() to find out whether the contours
+         * of two sets are the same.
+         */
         MD5_HASH GetHash() const;
 
-    private:
+        /**
+         * @return a fast (not cryptographic) 64 bits hash of the contours, which can be
+         * compared to the hash of a previous state or another set to tell whether their
+         * vertices are the same.
+         */
+        uint64_t GetContentHash() const;
 
-        MD5_HASH checksum() const;
+    private:
 
         std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> m_triangulatedPolys;
         bool m_triangulationValid = false;
-        MD5_HASH m_hash;
+
+        ///> Counts the modifications of the set (see markModified())
+        uint64_t m_generation = 0;
+
+        ///> m_generation when the triangulation was built
+        uint64_t m_triangulationGeneration = 0;
+
+        ///> Edge index, shared by the copies of the set (it is never modified once built)
+        mutable std::shared_ptr<const EDGE_INDEX> m_edgeIndex;
+
+        ///> Number of distance queries since the last change, to index only the sets which
+        ///> are queried repeatedly
+        mutable std::atomic<int> m_edgeIndexQueries{ 0 };
 
 };
 
@@ -0,0 +1,174 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <geometry/poly_set_pipeline.h>
+
+using namespace ClipperLib;
+
+
+POLY_SET_PIPELINE::POLY_SET_PIPELINE( const SHAPE_POLY_SET& aSubject ) :
+        m_subject( &aSubject ),
+        m_mode( SHAPE_POLY_SET::PM_FAST )
+{
+}
+
+
+void POLY_SET_PIPELINE::Reset( const SHAPE_POLY_SET& aSubject )
+{
+    m_subject = &aSubject;
+    m_tree.Clear();
+    m_mode = SHAPE_POLY_SET::PM_FAST;
+}
+
+
+void POLY_SET_PIPELINE::addSubject( Clipper& aClipper ) const
+{
+    if( m_subject )
+    {
+        for( const SHAPE_POLY_SET::POLYGON& poly : m_subject->m_polys )
+        {
+            for( size_t i = 0; i < poly.size(); i++ )
+                aClipper.AddPath( poly[i].convertToClipper( i == 0 ), ptSubject, true );
+        }
+    }
+    else
+    {
+        // The contours of a Clipper result are already oriented (holes reversed)
+        for( PolyNode* node = m_tree.GetFirst(); node; node = node->GetNext() )
+            aClipper.AddPath( node->Contour, ptSubject, true );
+    }
+}
+
+
+void POLY_SET_PIPELINE::booleanOp( ClipType aType, const SHAPE_POLY_SET* aOther,
+                                   POLYGON_MODE aFastMode )
+{
+    Clipper c;
+
+    c.StrictlySimple( aFastMode == SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+    addSubject( c );
+
+    if( aOther )
+    {
+        for( const SHAPE_POLY_SET::POLYGON& poly : aOther->m_polys )
+        {
+            for( size_t i = 0; i < poly.size(); i++ )
+                c.AddPath( poly[i].convertToClipper( i == 0 ), ptClip, true );
+        }
+    }
+
+    c.Execute( aType, m_tree, pftNonZero, pftNonZero );
+
+    m_subject = nullptr;
+    m_mode = aFastMode;
+}
+
+
+POLY_SET_PIPELINE& POLY_SET_PIPELINE::Add( const SHAPE_POLY_SET& aOther,
+                                           POLYGON_MODE aFastMode )
+{
+    booleanOp( ctUnion, &aOther, aFastMode );
+    return *this;
+}
+
+
+POLY_SET_PIPELINE& POLY_SET_PIPELINE::Subtract( const SHAPE_POLY_SET& aOther,
+                                                POLYGON_MODE aFastMode )
+{
+    booleanOp( ctDifference, &aOther, aFastMode );
+    return *this;
+}
+
+
+POLY_SET_PIPELINE& POLY_SET_PIPELINE::Intersect( const SHAPE_POLY_SET& aOther,
+                                                 POLYGON_MODE aFastMode )
+{
+    booleanOp( ctIntersection, &aOther, aFastMode );
+    return *this;
+}
+
+
+POLY_SET_PIPELINE& POLY_SET_PIPELINE::Simplify( POLYGON_MODE aFastMode )
+{
+    booleanOp( ctUnion, nullptr, aFastMode );
+    return *this;
+}
+
+
+POLY_SET_PIPELINE& POLY_SET_PIPELINE::Inflate( int aAmount, int aCircleSegmentsCount,
+                                               CORNER_STRATEGY aCornerStrategy )
+{
+    ClipperOffset c;
+    JoinType      joinType = SHAPE_POLY_SET::setupOffset( c, aAmount, aCircleSegmentsCount,
+                                                          aCornerStrategy );
+
+    if( m_subject )
+    {
+        for( const SHAPE_POLY_SET::POLYGON& poly : m_subject->m_polys )
+        {
+            for( size_t i = 0; i < poly.size(); i++ )
+                c.AddPath( poly[i].convertToClipper( i == 0 ), joinType, etClosedPolygon );
+        }
+    }
+    else
+    {
+        for( PolyNode* node = m_tree.GetFirst(); node; node = node->GetNext() )
+            c.AddPath( node->Contour, joinType, etClosedPolygon );
+    }
+
+    // The paths are copied by AddPath(), so the result can replace them
+    c.Execute( m_tree, aAmount );
+
+    m_subject = nullptr;
+    m_mode = SHAPE_POLY_SET::PM_FAST;
+    return *this;
+}
+
+
+void POLY_SET_PIPELINE::GetResult( SHAPE_POLY_SET& aResult )
+{
+    if( m_subject )
+    {
+        if( m_subject != &aResult )
+            aResult = *m_subject;
+
+        return;
+    }
+
+    aResult.importTree( &m_tree );
+}
+
+
+void POLY_SET_PIPELINE::GetFracturedResult( SHAPE_POLY_SET& aResult, POLYGON_MODE aFastMode )
+{
+    // SHAPE_POLY_SET::Fracture() simplifies the set first, which a boolean operation in the
+    // same mode has just done
+    if( m_subject || ( aFastMode == SHAPE_POLY_SET::PM_STRICTLY_SIMPLE && m_mode != aFastMode ) )
+        Simplify( aFastMode );
+
+    aResult.importTree( &m_tree );
+
+    for( SHAPE_POLY_SET::POLYGON& paths : aResult.m_polys )
+        aResult.fractureSingle( paths );
+}
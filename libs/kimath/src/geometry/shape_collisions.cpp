@@ -36,6 +36,7 @@
 #include <geometry/shape_segment.h>
 #include <geometry/shape_simple.h>
 #include <geometry/shape_compound.h>
+#include <geometry/shape_edge_index.h>
 #include <math/vector2d.h>
 
 typedef VECTOR2I::extended_type ecoord;
@@ -242,12 +243,48 @@ static inline bool Collide( const SHAPE_CIRCLE& aA, const SHAPE_SEGMENT& aSeg, i
 }
 
 
+///> Number of segment pairs above which two line chains are tested through an edge index
+static const long long CHAIN_EDGE_INDEX_MIN_PAIRS = 4096;
+
+
 static inline bool Collide( const SHAPE_LINE_CHAIN_BASE& aA, const SHAPE_LINE_CHAIN_BASE& aB, int aClearance,
                             int* aActual, VECTOR2I* aMTV )
 {
     // TODO: why doesn't this handle MTV?
     // TODO: worse, why this doesn't handle closed shapes?
 
+    if( (long long) aA.GetSegmentCount() * aB.GetSegmentCount() > CHAIN_EDGE_INDEX_MIN_PAIRS )
+    {
+        // Index the longest chain and query it with the segments of the other one
+        bool                         indexA = aA.GetSegmentCount() >= aB.GetSegmentCount();
+        const SHAPE_LINE_CHAIN_BASE& indexed = indexA ? aA : aB;
+        const SHAPE_LINE_CHAIN_BASE& other = indexA ? aB : aA;
+        std::vector<SEG>             edges;
+
+        edges.reserve( indexed.GetSegmentCount() );
+
+        for( int i = 0; i < (int) indexed.GetSegmentCount(); i++ )
+            edges.push_back( indexed.GetSegment( i ) );
+
+        SHAPE_EDGE_INDEX index( std::move( edges ) );
+        SEG::ecoord      clearance_sq = SEG::Square( aClearance );
+        SEG::ecoord      stop_at = aActual ? 0 : std::max<SEG::ecoord>( clearance_sq - 1, 0 );
+        SEG::ecoord      dist_sq = VECTOR2I::ECOORD_MAX;
+
+        for( int i = 0; i < (int) other.GetSegmentCount() && dist_sq > stop_at; i++ )
+            dist_sq = std::min( dist_sq, index.SquaredDistance( other.GetSegment( i ), stop_at ) );
+
+        if( dist_sq == 0 || dist_sq < clearance_sq )
+        {
+            if( aActual )
+                *aActual = sqrt( dist_sq );
+
+            return true;
+        }
+
+        return false;
+    }
+
     for( int i = 0; i < aB.GetSegmentCount(); i++ )
     {
         if( aA.Collide( aB.GetSegment( i ), aClearance, aActual ) )
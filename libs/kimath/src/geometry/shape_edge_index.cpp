@@ -0,0 +1,205 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <geometry/shape_edge_index.h>
+
+
+/**
+ * Squared distance between two intervals, one of the axis of the distance between two boxes.
+ */
+static inline SEG::ecoord axisGap( int aMin, int aMax, int aOtherMin, int aOtherMax )
+{
+    SEG::ecoord gap = 0;
+
+    if( aOtherMax < aMin )
+        gap = SEG::ecoord( aMin ) - aOtherMax;
+    else if( aOtherMin > aMax )
+        gap = SEG::ecoord( aOtherMin ) - aMax;
+
+    return gap * gap;
+}
+
+
+SHAPE_EDGE_INDEX::SHAPE_EDGE_INDEX( std::vector<SEG> aEdges ) :
+        m_edges( std::move( aEdges ) )
+{
+    if( m_edges.empty() )
+        return;
+
+    // A balanced binary tree with at most LEAF_SIZE segments per leaf
+    m_nodes.reserve( 2 * ( m_edges.size() / LEAF_SIZE + 1 ) );
+    m_nodes.emplace_back();
+
+    build( 0, 0, m_edges.size() );
+}
+
+
+void SHAPE_EDGE_INDEX::build( int aNode, int aFirst, int aCount )
+{
+    int minX = std::numeric_limits<int>::max();
+    int minY = std::numeric_limits<int>::max();
+    int maxX = std::numeric_limits<int>::min();
+    int maxY = std::numeric_limits<int>::min();
+
+    for( int i = aFirst; i < aFirst + aCount; i++ )
+    {
+        const SEG& edge = m_edges[i];
+
+        minX = std::min( { minX, edge.A.x, edge.B.x } );
+        minY = std::min( { minY, edge.A.y, edge.B.y } );
+        maxX = std::max( { maxX, edge.A.x, edge.B.x } );
+        maxY = std::max( { maxY, edge.A.y, edge.B.y } );
+    }
+
+    m_nodes[aNode] = { minX, minY, maxX, maxY, aFirst, aCount };
+
+    if( aCount <= LEAF_SIZE )
+        return;
+
+    // Split the segments in two halves along the largest side of the box, sorting them by
+    // the coordinate of their middle (the sum of their ends coordinates is enough).
+    bool splitX = SEG::ecoord( maxX ) - minX >= SEG::ecoord( maxY ) - minY;
+    int  half = aCount / 2;
+
+    std::nth_element( m_edges.begin() + aFirst, m_edges.begin() + aFirst + half,
+                      m_edges.begin() + aFirst + aCount,
+                      [splitX]( const SEG& aA, const SEG& aB )
+                      {
+                          if( splitX )
+                              return SEG::ecoord( aA.A.x ) + aA.B.x
+                                     < SEG::ecoord( aB.A.x ) + aB.B.x;
+                          else
+                              return SEG::ecoord( aA.A.y ) + aA.B.y
+                                     < SEG::ecoord( aB.A.y ) + aB.B.y;
+                      } );
+
+    int children = m_nodes.size();
+
+    m_nodes.emplace_back();
+    m_nodes.emplace_back();
+
+    m_nodes[aNode].first = children;
+    m_nodes[aNode].count = 0;
+
+    build( children, aFirst, half );
+    build( children + 1, aFirst + half, aCount - half );
+}
+
+
+template <class BOX_DIST, class EDGE_DIST>
+SEG::ecoord SHAPE_EDGE_INDEX::minDistance( BOX_DIST aBoxDistance, EDGE_DIST aEdgeDistance,
+                                           ecoord aStopAt ) const
+{
+    ecoord best = VECTOR2I::ECOORD_MAX;
+
+    if( m_nodes.empty() )
+        return best;
+
+    // Depth first, nearest child first, skipping the nodes which cannot hold a segment nearer
+    // than the best one found so far
+    std::pair<int, ecoord> stack[MAX_DEPTH];
+    int                    top = 0;
+
+    stack[top++] = { 0, aBoxDistance( m_nodes[0] ) };
+
+    while( top > 0 )
+    {
+        const std::pair<int, ecoord> entry = stack[--top];
+
+        if( entry.second >= best )
+            continue;
+
+        const NODE& node = m_nodes[entry.first];
+
+        if( node.count > 0 )
+        {
+            for( int i = node.first; i < node.first + node.count; i++ )
+            {
+                best = std::min( best, aEdgeDistance( m_edges[i] ) );
+
+                if( best <= aStopAt )
+                    return best;
+            }
+
+            continue;
+        }
+
+        ecoord first = aBoxDistance( m_nodes[node.first] );
+        ecoord second = aBoxDistance( m_nodes[node.first + 1] );
+
+        // The nearest child is pushed last, so it is visited first
+        if( first <= second )
+        {
+            stack[top++] = { node.first + 1, second };
+            stack[top++] = { node.first, first };
+        }
+        else
+        {
+            stack[top++] = { node.first, first };
+            stack[top++] = { node.first + 1, second };
+        }
+    }
+
+    return best;
+}
+
+
+SEG::ecoord SHAPE_EDGE_INDEX::SquaredDistance( const VECTOR2I& aP, ecoord aStopAt ) const
+{
+    return minDistance(
+            [&aP]( const NODE& aNode )
+            {
+                return axisGap( aNode.minX, aNode.maxX, aP.x, aP.x )
+                       + axisGap( aNode.minY, aNode.maxY, aP.y, aP.y );
+            },
+            [&aP]( const SEG& aEdge )
+            {
+                return aEdge.SquaredDistance( aP );
+            },
+            aStopAt );
+}
+
+
+SEG::ecoord SHAPE_EDGE_INDEX::SquaredDistance( const SEG& aSeg, ecoord aStopAt ) const
+{
+    const int minX = std::min( aSeg.A.x, aSeg.B.x );
+    const int minY = std::min( aSeg.A.y, aSeg.B.y );
+    const int maxX = std::max( aSeg.A.x, aSeg.B.x );
+    const int maxY = std::max( aSeg.A.y, aSeg.B.y );
+
+    // The distance between the boxes is a lower bound of the distance to the segments
+    return minDistance(
+            [&]( const NODE& aNode )
+            {
+                return axisGap( aNode.minX, aNode.maxX, minX, maxX )
+                       + axisGap( aNode.minY, aNode.maxY, minY, maxY );
+            },
+            [&aSeg]( const SEG& aEdge )
+            {
+                return aEdge.SquaredDistance( aSeg );
+            },
+            aStopAt );
+}
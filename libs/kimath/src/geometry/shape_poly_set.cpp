@@ -30,11 +30,13 @@
 #include <assert.h>                          // for assert
 #include <cmath>                             // for sqrt, cos, hypot, isinf
 #include <cstdio>
+#include <future>
 #include <istream>                           // for operator<<, operator>>
 #include <limits>                            // for numeric_limits
 #include <memory>
 #include <set>
 #include <string>                            // for char_traits, operator!=
+#include <thread>
 #include <type_traits>                       // for swap, move
 #include <unordered_set>
 #include <vector>
@@ -44,6 +46,7 @@
 #include <geometry/polygon_triangulation.h>
 #include <geometry/seg.h>                    // for SEG, OPT_VECTOR2I
 #include <geometry/shape.h>
+#include <geometry/shape_edge_index.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_poly_set.h>
 #include <math/box2.h>                       // for BOX2I
@@ -68,7 +71,8 @@ SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_LINE_CHAIN& aOutline ) :
 
 
 SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther ) :
-    SHAPE( aOther ), m_polys( aOther.m_polys )
+    SHAPE( aOther ), m_polys( aOther.m_polys ),
+    m_edgeIndex( std::atomic_load( &aOther.m_edgeIndex ) )
 {
     if( aOther.IsTriangulationUpToDate() )
     {
@@ -76,13 +80,11 @@ SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther ) :
             m_triangulatedPolys.push_back(
                     std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
 
-        m_hash = aOther.GetHash();
         m_triangulationValid = true;
     }
     else
     {
         m_triangulationValid = false;
-        m_hash = MD5_HASH();
         m_triangulatedPolys.clear();
     }
 }
@@ -184,6 +186,8 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
 int SHAPE_POLY_SET::NewOutline()
 {
+    markModified();
+
     SHAPE_LINE_CHAIN empty_path;
     POLYGON poly;
 
@@ -196,6 +200,8 @@ int SHAPE_POLY_SET::NewOutline()
 
 int SHAPE_POLY_SET::NewHole( int aOutline )
 {
+    markModified();
+
     SHAPE_LINE_CHAIN empty_path;
 
     empty_path.SetClosed( true );
@@ -213,6 +219,8 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
 
 int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDuplication )
 {
+    markModified();
+
     assert( m_polys.size() );
 
     if( aOutline < 0 )
@@ -236,6 +244,8 @@ int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDu
 
 void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
 {
+    markModified();
+
     VERTEX_INDEX index;
 
     if( aGlobalIndex < 0 )
@@ -421,6 +431,8 @@ bool SHAPE_POLY_SET::IsSelfIntersecting() const
 
 int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 {
+    markModified();
+
     assert( aOutline.IsClosed() );
 
     POLYGON poly;
@@ -435,6 +447,8 @@ int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 
 int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 {
+    markModified();
+
     assert( m_polys.size() );
 
     if( aOutline < 0 )
@@ -539,8 +553,9 @@ void SHAPE_POLY_SET::InflateWithLinkedHoles( int aFactor, int aCircleSegmentsCou
 }
 
 
-void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
-                              CORNER_STRATEGY aCornerStrategy )
+ClipperLib::JoinType SHAPE_POLY_SET::setupOffset( ClipperLib::ClipperOffset& aOffset,
+                                                  int aAmount, int aCircleSegmentsCount,
+                                                  CORNER_STRATEGY aCornerStrategy )
 {
     // A static table to avoid repetitive calculations of the coefficient
     // 1.0 - cos( M_PI / aCircleSegmentsCount )
@@ -548,8 +563,6 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
     #define SEG_CNT_MAX 64
     static double arc_tolerance_factor[SEG_CNT_MAX + 1];
 
-    ClipperOffset c;
-
     // N.B. see the Clipper documentation for jtSquare/jtMiter/jtRound.  They are poorly named
     // and are not what you'd think they are.
     // http://www.angusj.com/delphi/clipper/documentation/Docs/Units/ClipperLib/Types/JoinType.htm
@@ -586,14 +599,6 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
         break;
     }
 
-    for( const POLYGON& poly : m_polys )
-    {
-        for( size_t i = 0; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), joinType, etClosedPolygon );
-    }
-
-    PolyTree solution;
-
     // Calculate the arc tolerance (arc error) from the seg count by circle. The seg count is
     // nn = M_PI / acos(1.0 - c.ArcTolerance / abs(aAmount))
     // http://www.angusj.com/delphi/clipper/documentation/Docs/Units/ClipperLib/Classes/ClipperOffset/Properties/ArcTolerance.htm
@@ -613,9 +618,28 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
     else
         coeff = arc_tolerance_factor[aCircleSegmentsCount];
 
-    c.ArcTolerance = std::abs( aAmount ) * coeff;
-    c.MiterLimit = miterLimit;
-    c.MiterFallback = miterFallback;
+    aOffset.ArcTolerance = std::abs( aAmount ) * coeff;
+    aOffset.MiterLimit = miterLimit;
+    aOffset.MiterFallback = miterFallback;
+
+    return joinType;
+}
+
+
+void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
+                              CORNER_STRATEGY aCornerStrategy )
+{
+    ClipperOffset c;
+    JoinType      joinType = setupOffset( c, aAmount, aCircleSegmentsCount, aCornerStrategy );
+
+    for( const POLYGON& poly : m_polys )
+    {
+        for( size_t i = 0; i < poly.size(); i++ )
+            c.AddPath( poly[i].convertToClipper( i == 0 ), joinType, etClosedPolygon );
+    }
+
+    PolyTree solution;
+
     c.Execute( solution, aAmount );
 
     importTree( &solution );
@@ -624,6 +648,8 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
 
 void SHAPE_POLY_SET::importTree( PolyTree* tree )
 {
+    markModified();
+
     m_polys.clear();
 
     for( PolyNode* n = tree->GetFirst(); n; n = n->GetNext() )
@@ -853,6 +879,8 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
 void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
 {
+    markModified();
+
     Simplify( aFastMode );    // remove overlapping holes/degeneracy
 
     for( POLYGON& paths : m_polys )
@@ -1040,6 +1068,8 @@ bool SHAPE_POLY_SET::HasHoles() const
 
 void SHAPE_POLY_SET::Unfracture( POLYGON_MODE aFastMode )
 {
+    markModified();
+
     for( POLYGON& path : m_polys )
     {
         unfractureSingle( path );
@@ -1117,6 +1147,8 @@ const std::string SHAPE_POLY_SET::Format() const
 
 bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
 {
+    markModified();
+
     std::string tmp;
 
     aStream >> tmp;
@@ -1258,12 +1290,16 @@ bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance, int* aActual )
 
 void SHAPE_POLY_SET::RemoveAllContours()
 {
+    markModified();
+
     m_polys.clear();
 }
 
 
 void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
 {
+    markModified();
+
     // Default polygon is the last one
     if( aPolygonIdx < 0 )
         aPolygonIdx += m_polys.size();
@@ -1327,12 +1363,16 @@ int SHAPE_POLY_SET::RemoveNullSegments()
 
 void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 {
+    markModified();
+
     m_polys.erase( m_polys.begin() + aIdx );
 }
 
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
+    markModified();
+
     m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
 }
 
@@ -1458,6 +1498,8 @@ void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 
 void SHAPE_POLY_SET::RemoveVertex( VERTEX_INDEX aIndex )
 {
+    markModified();
+
     m_polys[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
 }
 
@@ -1475,6 +1517,8 @@ void SHAPE_POLY_SET::SetVertex( int aGlobalIndex, const VECTOR2I& aPos )
 
 void SHAPE_POLY_SET::SetVertex( const VERTEX_INDEX& aIndex, const VECTOR2I& aPos )
 {
+    markModified();
+
     m_polys[aIndex.m_polygon][aIndex.m_contour].SetPoint( aIndex.m_vertex, aPos );
 }
 
@@ -1505,6 +1549,8 @@ bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int
 
 void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 {
+    markModified();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1514,12 +1560,15 @@ void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
     for( auto& tri : m_triangulatedPolys )
         tri->Move( aVector );
 
-    m_hash = checksum();
+    // The triangulation has been moved with the contours
+    m_triangulationGeneration = m_generation;
 }
 
 
 void SHAPE_POLY_SET::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 {
+    markModified();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1532,6 +1581,8 @@ void SHAPE_POLY_SET::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 
 void SHAPE_POLY_SET::Rotate( double aAngle, const VECTOR2I& aCenter )
 {
+    markModified();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1571,6 +1622,149 @@ SHAPE_POLY_SET::POLYGON SHAPE_POLY_SET::FilletPolygon( unsigned int aRadius, int
 }
 
 
+///> Minimum number of vertices of a set for its distance queries to use an edge index
+static const int EDGE_INDEX_MIN_VERTICES = 256;
+
+///> Number of distance queries of an unchanged set before its edge index is built
+static const int EDGE_INDEX_MIN_QUERIES = 8;
+
+
+/**
+ * The edges of all the contours of a SHAPE_POLY_SET, with what is needed to tell whether
+ * a point is inside the set.  The SEG::Index() of the edges is their contour.
+ */
+struct SHAPE_POLY_SET::EDGE_INDEX
+{
+    struct CONTOUR
+    {
+        int  m_polygon;
+        bool m_isHole;
+        bool m_canContain;      ///< false for the contours PointInside() always rejects
+    };
+
+    EDGE_INDEX( const POLYSET& aPolys ) :
+            m_edges( collectEdges( aPolys, m_contours ) )
+    {
+    }
+
+    /**
+     * Same result as testing SHAPE_POLY_SET::containsSingle( aP, polygon, 1 ) for all the
+     * polygons, only the edges crossed by the horizontal half line from aP being visited.
+     */
+    bool Contains( const VECTOR2I& aP ) const
+    {
+        std::vector<int> crossed;
+
+        // Same crossing test as SHAPE_LINE_CHAIN_BASE::PointInside()
+        m_edges.QueryRay( aP,
+                [&]( const SEG& aEdge )
+                {
+                    const VECTOR2I diff = aEdge.B - aEdge.A;
+
+                    if( diff.y != 0 && ( aEdge.A.y > aP.y ) != ( aEdge.B.y > aP.y )
+                            && aP.x - aEdge.A.x < rescale( diff.x, ( aP.y - aEdge.A.y ), diff.y ) )
+                    {
+                        crossed.push_back( aEdge.Index() );
+                    }
+                } );
+
+        // The point is inside the contours crossed an odd number of times
+        std::vector<int> inside;
+
+        std::sort( crossed.begin(), crossed.end() );
+
+        for( size_t ii = 0; ii < crossed.size(); )
+        {
+            size_t next = ii;
+
+            while( next < crossed.size() && crossed[next] == crossed[ii] )
+                next++;
+
+            if( ( next - ii ) % 2 && m_contours[crossed[ii]].m_canContain )
+                inside.push_back( crossed[ii] );
+
+            ii = next;
+        }
+
+        for( int outline : inside )
+        {
+            if( m_contours[outline].m_isHole )
+                continue;
+
+            bool inHole = false;
+
+            for( int hole : inside )
+            {
+                if( m_contours[hole].m_isHole
+                        && m_contours[hole].m_polygon == m_contours[outline].m_polygon )
+                {
+                    inHole = true;
+                }
+            }
+
+            if( !inHole )
+                return true;
+        }
+
+        return false;
+    }
+
+    std::vector<CONTOUR> m_contours;
+    SHAPE_EDGE_INDEX     m_edges;
+
+private:
+    static std::vector<SEG> collectEdges( const POLYSET& aPolys, std::vector<CONTOUR>& aContours )
+    {
+        std::vector<SEG> edges;
+
+        for( size_t polygon = 0; polygon < aPolys.size(); polygon++ )
+        {
+            for( size_t contour = 0; contour < aPolys[polygon].size(); contour++ )
+            {
+                const SHAPE_LINE_CHAIN& chain = aPolys[polygon][contour];
+                int                     id = aContours.size();
+
+                aContours.push_back( { (int) polygon, contour > 0,
+                                       chain.IsClosed() && chain.PointCount() >= 3 } );
+
+                for( int ii = 0; ii < chain.SegmentCount(); ii++ )
+                {
+                    const SEG seg = chain.CSegment( ii );
+                    edges.emplace_back( seg.A, seg.B, id );
+                }
+            }
+        }
+
+        return edges;
+    }
+};
+
+
+std::shared_ptr<const SHAPE_POLY_SET::EDGE_INDEX> SHAPE_POLY_SET::edgeIndex() const
+{
+    std::shared_ptr<const EDGE_INDEX> index = std::atomic_load( &m_edgeIndex );
+
+    if( index )
+        return index;
+
+    // Building the index costs a few linear searches: only do it for the large sets which
+    // are queried repeatedly without being modified
+    if( ++m_edgeIndexQueries < EDGE_INDEX_MIN_QUERIES
+            || TotalVertices() < EDGE_INDEX_MIN_VERTICES )
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<const EDGE_INDEX> built = std::make_shared<const EDGE_INDEX>( m_polys );
+
+    // Another thread may have built it meanwhile, keep the first one
+    if( !std::atomic_compare_exchange_strong( &m_edgeIndex, &index, built ) )
+        return index;
+
+    return built;
+}
+
+
 SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( VECTOR2I aPoint, int aPolygonIndex ) const
 {
     // We calculate the min dist between the segment and each outline segment.  However, if the
@@ -1623,6 +1817,11 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( const SEG& aSegment, int a
 
 SEG::ecoord SHAPE_POLY_SET::SquaredDistance( VECTOR2I aPoint ) const
 {
+    std::shared_ptr<const EDGE_INDEX> index = edgeIndex();
+
+    if( index )
+        return index->Contains( aPoint ) ? 0 : index->m_edges.SquaredDistance( aPoint );
+
     SEG::ecoord currentDistance;
     SEG::ecoord minDistance = SquaredDistanceToPolygon( aPoint, 0 );
 
@@ -1641,6 +1840,12 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistance( VECTOR2I aPoint ) const
 
 SEG::ecoord SHAPE_POLY_SET::SquaredDistance( const SEG& aSegment ) const
 {
+    std::shared_ptr<const EDGE_INDEX> index = edgeIndex();
+
+    // As in SquaredDistanceToPolygon(), testing one end of the segment is enough
+    if( index )
+        return index->Contains( aSegment.A ) ? 0 : index->m_edges.SquaredDistance( aSegment );
+
     SEG::ecoord currentDistance;
     SEG::ecoord minDistance = SquaredDistanceToPolygon( aSegment, 0 );
 
@@ -1856,9 +2061,11 @@ SHAPE_POLY_SET::POLYGON SHAPE_POLY_SET::chamferFilletPolygon( CORNER_MODE aMode,
 SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
 {
     static_cast<SHAPE&>(*this) = aOther;
+    markModified();
     m_polys = aOther.m_polys;
     m_triangulatedPolys.clear();
     m_triangulationValid = false;
+    m_edgeIndex = std::atomic_load( &aOther.m_edgeIndex );
 
     if( aOther.IsTriangulationUpToDate() )
     {
@@ -1866,8 +2073,8 @@ SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
             m_triangulatedPolys.push_back(
                     std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
 
-        m_hash = aOther.GetHash();
         m_triangulationValid = true;
+        m_triangulationGeneration = m_generation;
     }
 
     return *this;
@@ -1875,24 +2082,98 @@ SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
 
 MD5_HASH SHAPE_POLY_SET::GetHash() const
 {
-    if( !m_hash.IsValid() )
-        return checksum();
+    MD5_HASH hash;
+
+    hash.Hash( m_polys.size() );
+
+    for( const POLYGON& polygon : m_polys )
+    {
+        hash.Hash( polygon.size() );
+
+        for( const SHAPE_LINE_CHAIN& lc : polygon )
+        {
+            const std::vector<VECTOR2I>& points = lc.CPoints();
+
+            // The same bytes as hashing the coordinates one by one, in a single update
+            hash.Hash( points.size() );
+            hash.Hash( (uint8_t*) points.data(), points.size() * sizeof( VECTOR2I ) );
+        }
+    }
+
+    hash.Finalize();
+
+    return hash;
+}
+
+
+/**
+ * Mixes a value into one of the lanes of SHAPE_POLY_SET::GetContentHash() (the round of
+ * xxHash64).
+ */
+static inline uint64_t hashRound( uint64_t aLane, uint64_t aValue )
+{
+    aLane += aValue * 0xC2B2AE3D27D4EB4FULL;
+    aLane = ( aLane << 31 ) | ( aLane >> 33 );
 
-    return m_hash;
+    return aLane * 0x9E3779B185EBCA87ULL;
 }
 
 
-bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
+uint64_t SHAPE_POLY_SET::GetContentHash() const
 {
-    if( !m_triangulationValid )
-        return false;
+    uint64_t hash = hashRound( 0, m_polys.size() );
 
-    if( !m_hash.IsValid() )
-        return false;
+    for( const POLYGON& polygon : m_polys )
+    {
+        hash = hashRound( hash, polygon.size() );
+
+        for( const SHAPE_LINE_CHAIN& lc : polygon )
+        {
+            const std::vector<VECTOR2I>& points = lc.CPoints();
+            const size_t                 count = points.size();
 
-    auto hash = checksum();
+            // Four independent lanes, so the rounds of consecutive points are computed in
+            // parallel (and vectorized where 64 bits multiplications are available)
+            uint64_t lanes[4] = { count, count + 1, count + 2, count + 3 };
+            size_t   ii = 0;
 
-    return hash == m_hash;
+            for( ; ii + 4 <= count; ii += 4 )
+            {
+                for( int lane = 0; lane < 4; lane++ )
+                {
+                    const VECTOR2I& p = points[ii + lane];
+                    lanes[lane] = hashRound( lanes[lane],
+                                             ( uint64_t( uint32_t( p.x ) ) << 32 )
+                                                     | uint32_t( p.y ) );
+                }
+            }
+
+            for( ; ii < count; ii++ )
+            {
+                const VECTOR2I& p = points[ii];
+                lanes[0] = hashRound( lanes[0],
+                                      ( uint64_t( uint32_t( p.x ) ) << 32 ) | uint32_t( p.y ) );
+            }
+
+            for( uint64_t lane : lanes )
+                hash = hashRound( hash, lane );
+        }
+    }
+
+    // Final avalanche, so close contents give unrelated hashes
+    hash ^= hash >> 33;
+    hash *= 0xC2B2AE3D27D4EB4FULL;
+    hash ^= hash >> 29;
+    hash *= 0x165667B19E3779F9ULL;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+
+bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
+{
+    return m_triangulationValid && m_triangulationGeneration == m_generation;
 }
 
 
@@ -1965,26 +2246,47 @@ static void partitionPolyIntoRegularCellGrid(
 }
 
 
-void SHAPE_POLY_SET::CacheTriangulation( bool aPartition )
-{
-    bool recalculate = !m_hash.IsValid();
-    MD5_HASH hash;
+///> Minimum number of outlines to triangulate in parallel, smaller sets are done faster than
+///> the threads are started
+static const int PARALLEL_TRIANGULATION_MIN_POLYS = 16;
+
 
-    if( !m_triangulationValid )
-        recalculate = true;
+/**
+ * Triangulates the outlines of a fractured set into aResult, one TRIANGULATED_POLYGON per
+ * outline.
+ * @return false if the set could not be triangulated.
+ */
+static bool triangulateOutlines( SHAPE_POLY_SET& aSet,
+        std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>>& aResult )
+{
+    bool valid = true;
 
-    if( !recalculate )
+    while( aSet.OutlineCount() > 0 )
     {
-        hash = checksum();
+        aResult.push_back( std::make_unique<SHAPE_POLY_SET::TRIANGULATED_POLYGON>() );
+        PolygonTriangulation tess( *aResult.back() );
 
-        if( m_hash != hash )
+        // If the tesselation fails, we re-fracture the polygon, which will
+        // first simplify the system before fracturing and removing the holes
+        // This may result in multiple, disjoint polygons.
+        if( !tess.TesselatePolygon( aSet.COutline( 0 ) ) )
         {
-            m_hash = hash;
-            recalculate = true;
+            aSet.Fracture( SHAPE_POLY_SET::PM_FAST );
+            valid = false;
+            continue;
         }
+
+        aSet.DeletePolygon( 0 );
+        valid = true;
     }
 
-    if( !recalculate )
+    return valid;
+}
+
+
+void SHAPE_POLY_SET::CacheTriangulation( bool aPartition, bool aParallel )
+{
+    if( IsTriangulationUpToDate() )
         return;
 
     SHAPE_POLY_SET tmpSet;
@@ -2001,57 +2303,61 @@ void SHAPE_POLY_SET::CacheTriangulation( bool aPartition )
     }
 
     m_triangulatedPolys.clear();
-    m_triangulationValid = true;
 
-    while( tmpSet.OutlineCount() > 0 )
+    const int polyCount = tmpSet.OutlineCount();
+    size_t    parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                      polyCount );
+
+    if( !aParallel || polyCount < PARALLEL_TRIANGULATION_MIN_POLYS || parallelThreadCount < 2 )
     {
-        m_triangulatedPolys.push_back( std::make_unique<TRIANGULATED_POLYGON>() );
-        PolygonTriangulation tess( *m_triangulatedPolys.back() );
+        m_triangulationValid = triangulateOutlines( tmpSet, m_triangulatedPolys );
+    }
+    else
+    {
+        // The outlines are independent: each one is triangulated into its own list, and the
+        // lists are appended in the order of the outlines, whatever the order the threads
+        // finish them
+        std::vector<std::vector<std::unique_ptr<TRIANGULATED_POLYGON>>> results( polyCount );
+        std::vector<char>   valid( polyCount, false );
+        std::atomic<int>    nextPoly( 0 );
 
-        // If the tesselation fails, we re-fracture the polygon, which will
-        // first simplify the system before fracturing and removing the holes
-        // This may result in multiple, disjoint polygons.
-        if( !tess.TesselatePolygon( tmpSet.Polygon( 0 ).front() ) )
+        auto tri_lambda = [&]() -> size_t
         {
-            tmpSet.Fracture( PM_FAST );
-            m_triangulationValid = false;
-            continue;
-        }
+            size_t num = 0;
 
-        tmpSet.DeletePolygon( 0 );
-        m_triangulationValid = true;
-    }
+            for( int ii = nextPoly++; ii < polyCount; ii = nextPoly++ )
+            {
+                SHAPE_POLY_SET outline( tmpSet.COutline( ii ) );
 
-    if( m_triangulationValid )
-        m_hash = checksum();
-}
+                valid[ii] = triangulateOutlines( outline, results[ii] );
+                num++;
+            }
 
+            return num;
+        };
 
-MD5_HASH SHAPE_POLY_SET::checksum() const
-{
-    MD5_HASH hash;
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
 
-    hash.Hash( m_polys.size() );
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, tri_lambda );
 
-    for( const auto& outline : m_polys )
-    {
-        hash.Hash( outline.size() );
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
 
-        for( const auto& lc : outline )
-        {
-            hash.Hash( lc.PointCount() );
+        m_triangulationValid = std::all_of( valid.begin(), valid.end(),
+                                            []( char aValid )
+                                            {
+                                                return aValid;
+                                            } );
 
-            for( int i = 0; i < lc.PointCount(); i++ )
-            {
-                hash.Hash( lc.CPoint( i ).x );
-                hash.Hash( lc.CPoint( i ).y );
-            }
+        for( std::vector<std::unique_ptr<TRIANGULATED_POLYGON>>& result : results )
+        {
+            for( std::unique_ptr<TRIANGULATED_POLYGON>& triangulated : result )
+                m_triangulatedPolys.push_back( std::move( triangulated ) );
         }
     }
 
-    hash.Finalize();
-
-    return hash;
+    m_triangulationGeneration = m_generation;
 }
 
 
@@ -24,6 +24,7 @@
 
 #include <class_board.h>
 #include <class_module.h>
+#include <class_pad.h>
 #include <pcb_edit_frame.h>
 #include <tool/tool_manager.h>
 #include <tools/selection_tool.h>
@@ -32,6 +33,7 @@
 #include <tools/pcb_tool_base.h>
 #include <tools/pcb_actions.h>
 #include <connectivity/connectivity_data.h>
+#include <properties_undo_item.h>
 
 #include <functional>
 using namespace std::placeholders;
@@ -71,6 +73,15 @@ COMMIT& BOARD_COMMIT::Stage( EDA_ITEM* aItem, CHANGE_TYPE aChangeType )
     return COMMIT::Stage( aItem, aChangeType );
 }
 
+COMMIT& BOARD_COMMIT::ModifyProperties( EDA_ITEM* aItem )
+{
+    // The footprint editor undo entries are always copies of the footprint
+    if( m_editModules )
+        return Stage( aItem, CHT_MODIFY );
+
+    return COMMIT::ModifyProperties( aItem );
+}
+
 COMMIT& BOARD_COMMIT::Stage( std::vector<EDA_ITEM*>& container, CHANGE_TYPE aChangeType )
 {
     return COMMIT::Stage( container, aChangeType );
@@ -81,6 +92,50 @@ COMMIT& BOARD_COMMIT::Stage( const PICKED_ITEMS_LIST& aItems, UNDO_REDO aModFlag
     return COMMIT::Stage( aItems, aModFlag );
 }
 
+/**
+ * @return the layers that can be affected by a change of \a aItem, used to tell the 3D viewer
+ * which layers have to be rebuilt.
+ */
+static LSET changedLayers( const EDA_ITEM* aItem )
+{
+    if( !aItem )
+        return LSET();
+
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+    {
+        const MODULE* module = static_cast<const MODULE*>( aItem );
+        LSET          layers( 2, module->Reference().GetLayer(), module->Value().GetLayer() );
+
+        for( const D_PAD* pad : module->Pads() )
+            layers |= pad->GetLayerSet();
+
+        for( const BOARD_ITEM* item : module->GraphicalItems() )
+            layers |= item->GetLayerSet();
+
+        for( const MODULE_ZONE_CONTAINER* zone : module->Zones() )
+            layers |= zone->GetLayerSet();
+
+        return layers;
+    }
+
+    case PCB_NETINFO_T:
+        return LSET();
+
+    case PCB_GROUP_T:
+        // A group change can move any of its members
+        return LSET::AllLayersMask();
+
+    default:
+        if( const BOARD_ITEM* boardItem = dynamic_cast<const BOARD_ITEM*>( aItem ) )
+            return boardItem->GetLayerSet();
+
+        return LSET::AllLayersMask();
+    }
+}
+
+
 void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool aSetDirtyBit )
 {
     // Objects potentially interested in changes:
@@ -92,6 +147,10 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
     std::set<EDA_ITEM*> savedModules;
     SELECTION_TOOL*     selTool = m_toolMgr->GetTool<SELECTION_TOOL>();
     bool                itemsDeselected = false;
+    LSET                dirtyLayers;
+
+    // Items removed from the board in a single pass, see BOARD::RemoveMany()
+    std::vector<BOARD_ITEM*> bulkRemovedItems;
 
     if( Empty() )
         return;
@@ -102,6 +161,25 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
         int changeFlags = ent.m_type & CHT_FLAGS;
         BOARD_ITEM* boardItem = static_cast<BOARD_ITEM*>( ent.m_item );
 
+        // Both the old and the new state of the item are to be redrawn by the 3D viewer
+        dirtyLayers |= changedLayers( ent.m_item );
+        dirtyLayers |= changedLayers( ent.m_copy );
+
+        if( ent.m_properties )
+        {
+            // Keep only the changed values
+            ent.m_properties->Reduce( boardItem );
+
+            // Visit the old state of the item
+            ent.m_properties->Swap( boardItem );
+            dirtyLayers |= changedLayers( boardItem );
+
+            if( boardItem->IsConnected() )
+                connectivity->MarkItemNetAsDirty( boardItem );
+
+            ent.m_properties->Swap( boardItem );
+        }
+
         // Module items need to be saved in the undo buffer before modification
         if( m_editModules )
         {
@@ -138,6 +216,13 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
         {
             case CHT_ADD:
             {
+                // An item can be removed and added back by the same commit
+                if( !bulkRemovedItems.empty() )
+                {
+                    board->RemoveMany( bulkRemovedItems );
+                    bulkRemovedItems.clear();
+                }
+
                 if( m_editModules )
                 {
                     // modules inside modules are not supported yet
@@ -228,7 +313,7 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                     view->Remove( boardItem );
 
                     if( !( changeFlags & CHT_DONE ) )
-                        board->Remove( boardItem );
+                        bulkRemovedItems.push_back( boardItem );
 
                     break;
 
@@ -242,7 +327,7 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                     module->ClearFlags();
 
                     if( !( changeFlags & CHT_DONE ) )
-                        board->Remove( module );        // handles connectivity
+                        bulkRemovedItems.push_back( module );   // handles connectivity
                 }
                 break;
 
@@ -262,7 +347,23 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
             case CHT_MODIFY:
             {
-                if( !m_editModules && aCreateUndoEntry )
+                if( ent.m_properties )
+                {
+                    // The entry is stored with the top level item, the properties designate
+                    // the item within it
+                    if( aCreateUndoEntry && !ent.m_properties->IsEmpty() )
+                    {
+                        ITEM_PICKER itemWrapper( nullptr, parentObject( boardItem ),
+                                                 UNDO_REDO::CHANGED_PROPERTIES );
+                        itemWrapper.SetLink( ent.m_properties );
+                        undoList.PushItem( itemWrapper );
+                    }
+                    else
+                    {
+                        delete ent.m_properties;
+                    }
+                }
+                else if( !m_editModules && aCreateUndoEntry )
                 {
                     ITEM_PICKER itemWrapper( nullptr, boardItem, UNDO_REDO::CHANGED );
                     wxASSERT( ent.m_copy );
@@ -290,6 +391,9 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
         }
     }
 
+    if( !bulkRemovedItems.empty() )
+        board->RemoveMany( bulkRemovedItems );
+
     if ( !m_editModules )
     {
         size_t num_changes = m_changes.size();
@@ -335,7 +439,11 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
         m_toolMgr->PostEvent( EVENTS::UnselectedEvent );
 
     if( aSetDirtyBit )
+    {
+        frame->Set3DViewDirtyLayers( dirtyLayers );
         frame->OnModify();
+        frame->Set3DViewDirtyLayers( LSET::AllLayersMask() );
+    }
 
     frame->UpdateMsgPanel();
 
@@ -402,6 +510,17 @@ void BOARD_COMMIT::Revert()
 
         case CHT_MODIFY:
         {
+            if( ent.m_properties )
+            {
+                ent.m_properties->Swap( item );
+                delete ent.m_properties;
+
+                connectivity->Update( item );
+                view->Update( item );
+                board->OnItemChanged( item );
+                break;
+            }
+
             view->Remove( item );
             connectivity->Remove( item );
 
@@ -46,6 +46,7 @@ public:
                        bool aCreateUndoEntry = true, bool aSetDirtyBit = true ) override;
 
     virtual void Revert() override;
+    COMMIT&      ModifyProperties( EDA_ITEM* aItem ) override;
     COMMIT&      Stage( EDA_ITEM* aItem, CHANGE_TYPE aChangeType ) override;
     COMMIT&      Stage( std::vector<EDA_ITEM*>& container, CHANGE_TYPE aChangeType ) override;
     COMMIT&      Stage(
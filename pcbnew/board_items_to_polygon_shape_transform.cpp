@@ -26,7 +26,6 @@
 #include <vector>
 #include <bezier_curves.h>
 #include <base_units.h>     // for IU_PER_MM
-#include <gr_text.h>
 #include <pcbnew.h>
 #include <pcb_edit_frame.h>
 #include <trigo.h>
@@ -44,26 +43,6 @@
 #include <math/util.h>      // for KiROUND
 
 
-// A helper struct for the callback function
-// These variables are parameters used in addTextSegmToPoly.
-// But addTextSegmToPoly is a call-back function,
-// so we cannot send them as arguments.
-struct TSEGM_2_POLY_PRMS {
-    int m_textWidth;
-    int m_error;
-    SHAPE_POLY_SET* m_cornerBuffer;
-};
-TSEGM_2_POLY_PRMS prms;
-
-// This is a call back function, used by GRText to draw the 3D text shape:
-static void addTextSegmToPoly( int x0, int y0, int xf, int yf, void* aData )
-{
-    TSEGM_2_POLY_PRMS* prm = static_cast<TSEGM_2_POLY_PRMS*>( aData );
-    TransformOvalToPolygon( *prm->m_cornerBuffer, wxPoint( x0, y0 ), wxPoint( xf, yf ),
-                            prm->m_textWidth, prm->m_error );
-}
-
-
 void BOARD::ConvertBrdLayerToPolygonalContours( PCB_LAYER_ID aLayer, SHAPE_POLY_SET& aOutlines )
 {
     // convert tracks and vias:
@@ -248,24 +227,12 @@ void MODULE::TransformGraphicShapesWithClearanceToPolygonSet( PCB_LAYER_ID aLaye
             texts.push_back( &Value() );
     }
 
-    prms.m_cornerBuffer = &aCornerBuffer;
-
     for( TEXTE_MODULE* textmod : texts )
     {
-        bool forceBold = true;
-        int  penWidth = 0;      // force max width for bold text
-
-        prms.m_textWidth  = textmod->GetEffectiveTextPenWidth() + ( 2 * aInflateValue );
-        prms.m_error = aError;
-        wxSize size = textmod->GetTextSize();
-
-        if( textmod->IsMirrored() )
-            size.x = -size.x;
+        int penWidth = 0;      // force max width for bold text
 
-        GRText( NULL, textmod->GetTextPos(), BLACK, textmod->GetShownText(),
-                textmod->GetDrawRotation(), size, textmod->GetHorizJustify(),
-                textmod->GetVertJustify(), penWidth, textmod->IsItalic(), forceBold,
-                addTextSegmToPoly, &prms );
+        textmod->TransformTextShapeWithClearanceToPolygon( aCornerBuffer, aInflateValue, aError,
+                                                           textmod->GetDrawRotation(), penWidth );
     }
 }
 
@@ -343,39 +310,8 @@ void EDA_TEXT::TransformBoundingBoxWithClearanceToPolygon( SHAPE_POLY_SET* aCorn
 void TEXTE_PCB::TransformShapeWithClearanceToPolygonSet( SHAPE_POLY_SET& aCornerBuffer,
                                                          int aClearanceValue, int aError ) const
 {
-    wxSize size = GetTextSize();
-
-    if( IsMirrored() )
-        size.x = -size.x;
-
-    bool forceBold = true;
-    int  penWidth = GetEffectiveTextPenWidth();
-
-    prms.m_cornerBuffer = &aCornerBuffer;
-    prms.m_textWidth = GetEffectiveTextPenWidth() + ( 2 * aClearanceValue );
-    prms.m_error = aError;
-    COLOR4D color = COLOR4D::BLACK;  // not actually used, but needed by GRText
-
-    if( IsMultilineAllowed() )
-    {
-        wxArrayString strings_list;
-        wxStringSplit( GetShownText(), strings_list, '\n' );
-        std::vector<wxPoint> positions;
-        positions.reserve( strings_list.Count() );
-        GetLinePositions( positions, strings_list.Count() );
-
-        for( unsigned ii = 0; ii < strings_list.Count(); ii++ )
-        {
-            wxString txt = strings_list.Item( ii );
-            GRText( NULL, positions[ii], color, txt, GetTextAngle(), size, GetHorizJustify(),
-                    GetVertJustify(), penWidth, IsItalic(), forceBold, addTextSegmToPoly, &prms );
-        }
-    }
-    else
-    {
-        GRText( NULL, GetTextPos(), color, GetShownText(), GetTextAngle(), size, GetHorizJustify(),
-                GetVertJustify(), penWidth, IsItalic(), forceBold, addTextSegmToPoly, &prms );
-    }
+    TransformTextShapeWithClearanceToPolygon( aCornerBuffer, aClearanceValue, aError,
+                                              GetTextAngle(), GetEffectiveTextPenWidth() );
 }
 
 
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <unordered_set>
 #include <fctsys.h>
 #include <pcb_base_frame.h>
 #include <reporter.h>
@@ -610,6 +611,9 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
     aBoardItem->ClearEditFlags();
     m_connectivity->Add( aBoardItem );
 
+    if( aBoardItem->Type() != PCB_NETINFO_T )
+        IndexItem( aBoardItem );
+
     InvokeListeners( &BOARD_LISTENER::OnBoardItemAdded, *this, aBoardItem );
 }
 
@@ -691,10 +695,117 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem )
 
     m_connectivity->Remove( aBoardItem );
 
+    if( aBoardItem->Type() != PCB_NETINFO_T )
+        UnindexItem( aBoardItem );
+
     InvokeListeners( &BOARD_LISTENER::OnBoardItemRemoved, *this, aBoardItem );
 }
 
 
+void BOARD::RemoveMany( const std::vector<BOARD_ITEM*>& aItems )
+{
+    std::unordered_set<BOARD_ITEM*> removed;
+    bool                            fromMarkers = false;
+    bool                            fromGroups = false;
+    bool                            fromZones = false;
+    bool                            fromModules = false;
+    bool                            fromTracks = false;
+    bool                            fromDrawings = false;
+
+    for( BOARD_ITEM* item : aItems )
+    {
+        wxASSERT( item );
+
+        switch( item->Type() )
+        {
+        case PCB_NETINFO_T:
+            // Nets are not stored in the containers below
+            Remove( item );
+            continue;
+
+        case PCB_MARKER_T:
+            fromMarkers = true;
+            break;
+
+        case PCB_GROUP_T:
+            fromGroups = true;
+            break;
+
+        case PCB_ZONE_AREA_T:
+            fromZones = true;
+            break;
+
+        case PCB_MODULE_T:
+            fromModules = true;
+            break;
+
+        case PCB_TRACE_T:
+        case PCB_ARC_T:
+        case PCB_VIA_T:
+            fromTracks = true;
+            break;
+
+        case PCB_DIM_ALIGNED_T:
+        case PCB_DIM_CENTER_T:
+        case PCB_DIM_ORTHOGONAL_T:
+        case PCB_DIM_LEADER_T:
+        case PCB_LINE_T:
+        case PCB_TEXT_T:
+        case PCB_TARGET_T:
+            fromDrawings = true;
+            break;
+
+        default:
+            wxFAIL_MSG( wxT( "BOARD::RemoveMany() needs more ::Type() support" ) );
+            continue;
+        }
+
+        removed.insert( item );
+    }
+
+    // A single pass over each container, instead of one per removed item
+    auto removeFrom =
+            [&]( auto& aContainer )
+            {
+                aContainer.erase( std::remove_if( aContainer.begin(), aContainer.end(),
+                                                  [&]( BOARD_ITEM* aItem )
+                                                  {
+                                                      return removed.count( aItem ) > 0;
+                                                  } ),
+                                  aContainer.end() );
+            };
+
+    if( fromMarkers )
+        removeFrom( m_markers );
+
+    if( fromGroups )
+        removeFrom( m_groups );
+
+    if( fromZones )
+        removeFrom( m_zones );
+
+    if( fromModules )
+        removeFrom( m_modules );
+
+    if( fromTracks )
+        removeFrom( m_tracks );
+
+    if( fromDrawings )
+        removeFrom( m_drawings );
+
+    for( BOARD_ITEM* item : aItems )
+    {
+        if( !removed.erase( item ) )
+            continue;
+
+        m_connectivity->Remove( item );
+        UnindexItem( item );
+
+        InvokeListeners( &BOARD_LISTENER::OnBoardItemRemoved, *this, item );
+    }
+}
+
+
 wxString BOARD::GetSelectMenuText( EDA_UNITS aUnits ) const
 {
     return wxString::Format( _( "PCB" ) );
@@ -705,7 +816,10 @@ void BOARD::DeleteMARKERs()
 {
     // the vector does not know how to delete the MARKER_PCB, it holds pointers
     for( MARKER_PCB* marker : m_markers )
+    {
+        UnindexItem( marker );
         delete marker;
+    }
 
     m_markers.clear();
 }
@@ -721,6 +835,7 @@ void BOARD::DeleteMARKERs( bool aWarningsAndErrors, bool aExclusions )
         if( ( marker->IsExcluded() && aExclusions )
                 || ( !marker->IsExcluded() && aWarningsAndErrors ) )
         {
+            UnindexItem( marker );
             delete marker;
         }
         else
@@ -738,58 +853,32 @@ BOARD_ITEM* BOARD::GetItem( const KIID& aID )
     if( aID == niluuid )
         return nullptr;
 
-    for( TRACK* track : Tracks() )
-    {
-        if( track->m_Uuid == aID )
-            return track;
-    }
+    auto range = m_itemByUuid.equal_range( aID );
 
-    for( MODULE* module : Modules() )
+    if( range.first != range.second )
     {
-        if( module->m_Uuid == aID )
-            return module;
+        wxASSERT_MSG( range.first->second->m_Uuid == aID,
+                      wxT( "BOARD::GetItem(): stale UUID index" ) );
 
-        for( D_PAD* pad : module->Pads() )
-        {
-            if( pad->m_Uuid == aID )
-                return pad;
-        }
-
-        if( module->Reference().m_Uuid == aID )
-            return &module->Reference();
-
-        if( module->Value().m_Uuid == aID )
-            return &module->Value();
-
-        for( BOARD_ITEM* drawing : module->GraphicalItems() )
-        {
-            if( drawing->m_Uuid == aID )
-                return drawing;
-        }
-    }
+        if( std::next( range.first ) == range.second )
+            return range.first->second;
 
-    for( ZONE_CONTAINER* zone : Zones() )
-    {
-        if( zone->m_Uuid == aID )
-            return zone;
-    }
+        // Several items have this UUID: the first one in the board order is returned
+        std::unordered_set<BOARD_ITEM*> candidates;
+        BOARD_ITEM*                     first = nullptr;
 
-    for( BOARD_ITEM* drawing : Drawings() )
-    {
-        if( drawing->m_Uuid == aID )
-            return drawing;
-    }
+        for( auto it = range.first; it != range.second; ++it )
+            candidates.insert( it->second );
 
-    for( MARKER_PCB* marker : m_markers )
-    {
-        if( marker->m_Uuid == aID )
-            return marker;
-    }
+        runOnIndexedItems(
+                [&]( BOARD_ITEM* aItem )
+                {
+                    if( !first && candidates.count( aItem ) )
+                        first = aItem;
+                } );
 
-    for( PCB_GROUP* group : m_groups )
-    {
-        if( group->m_Uuid == aID )
-            return group;
+        if( first )
+            return first;
     }
 
     if( m_Uuid == aID )
@@ -802,40 +891,128 @@ BOARD_ITEM* BOARD::GetItem( const KIID& aID )
 
 void BOARD::FillItemMap( std::map<KIID, EDA_ITEM*>& aMap )
 {
+#if defined(DEBUG)
+    checkItemIndex();
+#endif
+
     // the board itself
     aMap[ this->m_Uuid ] = this;
 
-    for( TRACK* track : Tracks() )
-        aMap[ track->m_Uuid ] = track;
-
-    for( MODULE* module : Modules() )
+    // The items which share a UUID are mapped as GetItem() finds them
+    for( const std::pair<const KIID, BOARD_ITEM*>& entry : m_itemByUuid )
     {
-        aMap[ module->m_Uuid ] = module;
+        if( !aMap.count( entry.first ) )
+            aMap[ entry.first ] = GetItem( entry.first );
+    }
+}
 
-        for( D_PAD* pad : module->Pads() )
-            aMap[ pad->m_Uuid ] = pad;
 
-        aMap[ module->Reference().m_Uuid ] = &module->Reference();
-        aMap[ module->Value().m_Uuid ] = &module->Value();
+void BOARD::IndexItem( BOARD_ITEM* aItem )
+{
+    // An item indexed twice would stay in the index after its removal
+    auto index =
+            [&]( BOARD_ITEM* aIndexed )
+            {
+                if( !IsIndexed( aIndexed ) )
+                    m_itemByUuid.emplace( aIndexed->m_Uuid, aIndexed );
+            };
 
-        for( BOARD_ITEM* drawing : module->GraphicalItems() )
-            aMap[ drawing->m_Uuid ] = drawing;
+    index( aItem );
+
+    if( aItem->Type() == PCB_MODULE_T )
+        static_cast<MODULE*>( aItem )->RunOnChildren( index );
+}
+
+
+void BOARD::UnindexItem( BOARD_ITEM* aItem )
+{
+    // Only this item is removed, the other items with the same UUID stay indexed
+    auto unindex =
+            [&]( BOARD_ITEM* aIndexed )
+            {
+                auto range = m_itemByUuid.equal_range( aIndexed->m_Uuid );
+
+                for( auto it = range.first; it != range.second; ++it )
+                {
+                    if( it->second == aIndexed )
+                    {
+                        m_itemByUuid.erase( it );
+                        break;
+                    }
+                }
+            };
+
+    unindex( aItem );
+
+    if( aItem->Type() == PCB_MODULE_T )
+        static_cast<MODULE*>( aItem )->RunOnChildren( unindex );
+}
+
+
+void BOARD::runOnIndexedItems( const std::function<void( BOARD_ITEM* )>& aFunction )
+{
+    for( TRACK* track : m_tracks )
+        aFunction( track );
+
+    for( MODULE* module : m_modules )
+    {
+        aFunction( module );
+        module->RunOnChildren( aFunction );
     }
 
-    for( ZONE_CONTAINER* zone : Zones() )
-        aMap[ zone->m_Uuid ] = zone;
+    for( ZONE_CONTAINER* zone : m_zones )
+        aFunction( zone );
 
-    for( BOARD_ITEM* drawing : Drawings() )
-        aMap[ drawing->m_Uuid ] = drawing;
+    for( BOARD_ITEM* drawing : m_drawings )
+        aFunction( drawing );
 
     for( MARKER_PCB* marker : m_markers )
-        aMap[ marker->m_Uuid ] = marker;
+        aFunction( marker );
 
     for( PCB_GROUP* group : m_groups )
-        aMap[ group->m_Uuid ] = group;
+        aFunction( group );
+}
+
+
+void BOARD::RebuildItemIndex()
+{
+    m_itemByUuid.clear();
+
+    runOnIndexedItems(
+            [&]( BOARD_ITEM* aItem )
+            {
+                m_itemByUuid.emplace( aItem->m_Uuid, aItem );
+            } );
 }
 
 
+#if defined(DEBUG)
+void BOARD::checkItemIndex()
+{
+    std::unordered_set<const BOARD_ITEM*> items;
+
+    runOnIndexedItems(
+            [&]( BOARD_ITEM* aItem )
+            {
+                wxASSERT_MSG( IsIndexed( aItem ), wxT( "BOARD item missing from the UUID index" ) );
+
+                items.insert( aItem );
+            } );
+
+    wxASSERT_MSG( m_itemByUuid.size() == items.size(),
+                  wxT( "BOARD UUID index holds items not on the board" ) );
+
+    for( const std::pair<const KIID, BOARD_ITEM*>& entry : m_itemByUuid )
+    {
+        wxASSERT_MSG( items.count( entry.second ),
+                      wxT( "BOARD UUID index holds a removed item" ) );
+        wxASSERT_MSG( entry.second->m_Uuid == entry.first,
+                      wxT( "BOARD UUID index holds an item under an old UUID" ) );
+    }
+}
+#endif
+
+
 wxString BOARD::ConvertCrossReferencesToKIIDs( const wxString& aSource )
 {
     wxString newbuf;
@@ -1050,17 +1227,20 @@ void BOARD::GetMsgPanelInfo( EDA_DRAW_FRAME* aFrame, std::vector<MSG_PANEL_ITEM>
 }
 
 
-SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[] )
+/**
+ * Visit the given containers of \a aBoard items, in the order of the kinds of items given by
+ * \a scanTypes.  It is the implementation of BOARD::Visit() and BOARD::VisitItems().
+ */
+static SEARCH_RESULT visitBoardItems( BOARD* aBoard, INSPECTOR inspector, void* testData,
+                                      const KICAD_T scanTypes[], MODULES& aModules,
+                                      DRAWINGS& aDrawings, TRACKS& aTracks, MARKERS& aMarkers,
+                                      ZONE_CONTAINERS& aZones, GROUPS& aGroups )
 {
     KICAD_T        stype;
     SEARCH_RESULT  result = SEARCH_RESULT::CONTINUE;
     const KICAD_T* p      = scanTypes;
     bool           done   = false;
 
-#if 0 && defined(DEBUG)
-    std::cout << GetClass().mb_str() << ' ';
-#endif
-
     while( !done )
     {
         stype = *p;
@@ -1068,7 +1248,7 @@ SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T s
         switch( stype )
         {
         case PCB_T:
-            result = inspector( this, testData );  // inspect me
+            result = inspector( aBoard, testData );  // inspect me
             // skip over any types handled in the above call.
             ++p;
             break;
@@ -1087,7 +1267,7 @@ SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T s
         case PCB_MODULE_ZONE_AREA_T:
 
             // this calls MODULE::Visit() on each module.
-            result = IterateForward<MODULE*>( m_modules, inspector, testData, p );
+            result = EDA_ITEM::IterateForward<MODULE*>( aModules, inspector, testData, p );
 
             // skip over any types handled in the above call.
             for( ; ; )
@@ -1117,7 +1297,7 @@ SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T s
         case PCB_DIM_ORTHOGONAL_T:
         case PCB_DIM_LEADER_T:
         case PCB_TARGET_T:
-            result = IterateForward<BOARD_ITEM*>( m_drawings, inspector, testData, p );
+            result = EDA_ITEM::IterateForward<BOARD_ITEM*>( aDrawings, inspector, testData, p );
 
             // skip over any types handled in the above call.
             for( ; ; )
@@ -1143,18 +1323,18 @@ SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T s
             break;
 
         case PCB_VIA_T:
-            result = IterateForward<TRACK*>( m_tracks, inspector, testData, p );
+            result = EDA_ITEM::IterateForward<TRACK*>( aTracks, inspector, testData, p );
             ++p;
             break;
 
         case PCB_TRACE_T:
         case PCB_ARC_T:
-            result = IterateForward<TRACK*>( m_tracks, inspector, testData, p );
+            result = EDA_ITEM::IterateForward<TRACK*>( aTracks, inspector, testData, p );
             ++p;
             break;
 
         case PCB_MARKER_T:
-            for( MARKER_PCB* marker : m_markers )
+            for( MARKER_PCB* marker : aMarkers )
             {
                 result = marker->Visit( inspector, testData, p );
 
@@ -1166,7 +1346,7 @@ SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T s
             break;
 
         case PCB_ZONE_AREA_T:
-            for( ZONE_CONTAINER* zone : m_zones)
+            for( ZONE_CONTAINER* zone : aZones )
             {
                 result = zone->Visit( inspector, testData, p );
 
@@ -1178,7 +1358,7 @@ SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T s
             break;
 
         case PCB_GROUP_T:
-            result = IterateForward<PCB_GROUP*>( m_groups, inspector, testData, p );
+            result = EDA_ITEM::IterateForward<PCB_GROUP*>( aGroups, inspector, testData, p );
             ++p;
             break;
 
@@ -1195,6 +1375,69 @@ SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T s
 }
 
 
+SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[] )
+{
+    return visitBoardItems( this, inspector, testData, scanTypes, m_modules, m_drawings, m_tracks,
+                            m_markers, m_zones, m_groups );
+}
+
+
+SEARCH_RESULT BOARD::VisitItems( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[],
+                                 const std::vector<BOARD_ITEM*>& aItems )
+{
+    MODULES         modules;
+    DRAWINGS        drawings;
+    TRACKS          tracks;
+    MARKERS         markers;
+    ZONE_CONTAINERS zones;
+    GROUPS          groups;
+
+    for( BOARD_ITEM* item : aItems )
+    {
+        switch( item->Type() )
+        {
+        case PCB_MODULE_T:
+            modules.push_back( static_cast<MODULE*>( item ) );
+            break;
+
+        case PCB_LINE_T:
+        case PCB_TEXT_T:
+        case PCB_DIM_ALIGNED_T:
+        case PCB_DIM_CENTER_T:
+        case PCB_DIM_ORTHOGONAL_T:
+        case PCB_DIM_LEADER_T:
+        case PCB_TARGET_T:
+            drawings.push_back( item );
+            break;
+
+        case PCB_TRACE_T:
+        case PCB_ARC_T:
+        case PCB_VIA_T:
+            tracks.push_back( static_cast<TRACK*>( item ) );
+            break;
+
+        case PCB_MARKER_T:
+            markers.push_back( static_cast<MARKER_PCB*>( item ) );
+            break;
+
+        case PCB_ZONE_AREA_T:
+            zones.push_back( static_cast<ZONE_CONTAINER*>( item ) );
+            break;
+
+        case PCB_GROUP_T:
+            groups.push_back( static_cast<PCB_GROUP*>( item ) );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return visitBoardItems( this, inspector, testData, scanTypes, modules, drawings, tracks,
+                            markers, zones, groups );
+}
+
+
 NETINFO_ITEM* BOARD::FindNet( int aNetcode ) const
 {
     // the first valid netcode is 1 and the last is m_NetInfo.GetCount()-1.
@@ -1730,6 +1973,7 @@ ZONE_CONTAINER* BOARD::AddArea( PICKED_ITEMS_LIST* aNewZonesList, int aNetcode,
     new_area->SetLayer( aLayer );
 
     m_zones.push_back( new_area );
+    IndexItem( new_area );
 
     new_area->SetHatchStyle( (ZONE_BORDER_DISPLAY_STYLE) aHatch );
 
@@ -2044,7 +2288,10 @@ wxString BOARD::GroupsSanityCheckInternal( bool repair )
         if( testItem != groups[idx] )
         {
             if( repair )
+            {
+                board.UnindexItem( groups[idx] );
                 board.Groups().erase( board.Groups().begin() + idx );
+            }
 
             return  wxString::Format( _( "Group Uuid %s maps to 2 different BOARD_ITEMS: %p and %p" ),
                                       group.m_Uuid.AsString(),
@@ -2130,7 +2377,10 @@ wxString BOARD::GroupsSanityCheckInternal( bool repair )
         if( group.GetItems().size() == 0 )
         {
             if( repair )
+            {
+                board.UnindexItem( groups[idx] );
                 board.Groups().erase( board.Groups().begin() + idx );
+            }
 
             return wxString::Format( _( "Group must have at least one member: %s" ), group.m_Uuid.AsString() );
         }
@@ -2169,7 +2419,10 @@ wxString BOARD::GroupsSanityCheckInternal( bool repair )
             if( currentChainGroups.find( currIdx ) != currentChainGroups.end() )
             {
                 if( repair )
+                {
+                    board.UnindexItem( groups[currIdx] );
                     board.Groups().erase( board.Groups().begin() + currIdx );
+                }
 
                 return "Cycle detected in group membership";
             }
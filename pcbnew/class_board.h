@@ -36,6 +36,8 @@
 #include <title_block.h>
 #include <tools/pcbnew_selection.h>
 
+#include <unordered_map>
+
 class BOARD_COMMIT;
 class PCB_BASE_FRAME;
 class PCB_EDIT_FRAME;
@@ -188,6 +190,10 @@ private:
     GROUPS                  m_groups;
     ZONE_CONTAINERS         m_zones;
 
+    ///> The items above and the children of the footprints, by UUID.  Several items may have
+    ///> the same UUID, e.g. the children of a pasted footprint until they are given new ones.
+    std::unordered_multimap<KIID, BOARD_ITEM*> m_itemByUuid;
+
     LAYER                   m_Layer[PCB_LAYER_ID_COUNT];
 
                                                         // if true m_highLight_NetCode is used
@@ -233,6 +239,14 @@ private:
             ( l->*aFunc )( std::forward<Args>( args )... );
     }
 
+    ///> Runs aFunction on the items of the UUID index, in the order GetItem() searched them
+    void runOnIndexedItems( const std::function<void( BOARD_ITEM* )>& aFunction );
+
+#if defined(DEBUG)
+    ///> Checks that m_itemByUuid holds the items of the board and nothing else
+    void checkItemIndex();
+#endif
+
 public:
     static inline bool ClassOf( const EDA_ITEM* aItem )
     {
@@ -303,6 +317,12 @@ public:
 
     void Remove( BOARD_ITEM* aBoardItem ) override;
 
+    /**
+     * Removes several items, as Remove() does for each of them, but going through each
+     * container of the board once.
+     */
+    void RemoveMany( const std::vector<BOARD_ITEM*>& aItems );
+
     /**
      * Gets the first module in the list (used in footprint viewer/editor) or NULL if none
      * @return first module or null pointer
@@ -318,7 +338,10 @@ public:
     void DeleteAllModules()
     {
         for( MODULE* mod : m_modules )
+        {
+            UnindexItem( mod );
             delete mod;
+        }
 
         m_modules.clear();
     }
@@ -331,6 +354,36 @@ public:
 
     void FillItemMap( std::map<KIID, EDA_ITEM*>& aMap );
 
+    /**
+     * Adds an item to the UUID index used by GetItem().  Add() and Remove() maintain the index
+     * for the items of the board, and MODULE for the children of a footprint on the board.
+     * Indexing a footprint indexes its children too.
+     */
+    void IndexItem( BOARD_ITEM* aItem );
+
+    ///> Removes an item (and the children of a footprint) from the UUID index
+    void UnindexItem( BOARD_ITEM* aItem );
+
+    ///> @return true if aItem is in the UUID index
+    bool IsIndexed( const BOARD_ITEM* aItem ) const
+    {
+        auto range = m_itemByUuid.equal_range( aItem->m_Uuid );
+
+        for( auto it = range.first; it != range.second; ++it )
+        {
+            if( it->second == aItem )
+                return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Rebuilds the UUID index from the items of the board.  Needed after changing the UUID of
+     * items already on the board.
+     */
+    void RebuildItemIndex();
+
     /**
      * Convert cross-references back and forth between ${refDes:field} and ${kiid:field}
      */
@@ -791,6 +844,22 @@ public:
      */
     SEARCH_RESULT Visit( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[] ) override;
 
+    /**
+     * Function VisitItems
+     * visits some of the board items like Visit() does for all of them.  It lets the callers
+     * which already know the candidates, e.g. from the view, avoid walking the whole board.
+     * @param inspector An INSPECTOR instance to use in the inspection.
+     * @param testData Arbitrary data used by the inspector.
+     * @param scanTypes Which KICAD_T types are of interest and the order
+     *  is significant too, terminated by EOT.
+     * @param aItems The top level items of this board to visit, in the order they are visited
+     *  within a kind of items.  Their children (pads, module texts...) are visited as usual.
+     * @return SEARCH_RESULT - SEARCH_QUIT if the Iterator is to stop the scan,
+     *  else SCAN_CONTINUE, and determined by the inspector.
+     */
+    SEARCH_RESULT VisitItems( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[],
+                              const std::vector<BOARD_ITEM*>& aItems );
+
     /**
      * Function FindModuleByReference
      * searches for a MODULE within this board with the given reference designator.
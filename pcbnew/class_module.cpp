@@ -439,6 +439,9 @@ void MODULE::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
 
     aBoardItem->ClearEditFlags();
     aBoardItem->SetParent( this );
+
+    if( BOARD* board = indexingBoard() )
+        board->IndexItem( aBoardItem );
 }
 
 
@@ -495,8 +498,25 @@ void MODULE::Remove( BOARD_ITEM* aBoardItem )
         msg.Printf( wxT( "MODULE::Remove() needs work: BOARD_ITEM type (%d) not handled" ),
                     aBoardItem->Type() );
         wxFAIL_MSG( msg );
+        return;
     }
     }
+
+    if( BOARD* board = indexingBoard() )
+        board->UnindexItem( aBoardItem );
+}
+
+
+BOARD* MODULE::indexingBoard() const
+{
+    BOARD* board = GetBoard();
+
+    // A copy of a footprint has its parent, but only the footprint added to the board is
+    // indexed
+    if( board && board->IsIndexed( this ) )
+        return board;
+
+    return nullptr;
 }
 
 
@@ -1411,8 +1431,13 @@ BOARD_ITEM* MODULE::DuplicateItem( const BOARD_ITEM* aItem, bool aAddToModule )
         const_cast<KIID&>( new_pad->m_Uuid ) = KIID();
 
         if( aAddToModule )
+        {
             m_pads.push_back( new_pad );
 
+            if( BOARD* board = indexingBoard() )
+                board->IndexItem( new_pad );
+        }
+
         new_item = new_pad;
         break;
     }
@@ -1423,8 +1448,13 @@ BOARD_ITEM* MODULE::DuplicateItem( const BOARD_ITEM* aItem, bool aAddToModule )
         const_cast<KIID&>( new_zone->m_Uuid ) = KIID();
 
         if( aAddToModule )
+        {
             m_fp_zones.push_back( new_zone );
 
+            if( BOARD* board = indexingBoard() )
+                board->IndexItem( new_zone );
+        }
+
         new_item = new_zone;
         break;
     }
@@ -1655,7 +1685,16 @@ void MODULE::SwapData( BOARD_ITEM* aImage )
 {
     assert( aImage->Type() == PCB_MODULE_T );
 
+    // The children are swapped with the ones of the image
+    BOARD* board = indexingBoard();
+
+    if( board )
+        board->UnindexItem( this );
+
     std::swap( *((MODULE*) this), *((MODULE*) aImage) );
+
+    if( board )
+        board->IndexItem( this );
 }
 
 
@@ -710,6 +710,9 @@ public:
 #endif
 
 private:
+    ///> @return the board indexing the children of the footprint by UUID, if it is on one
+    BOARD* indexingBoard() const;
+
     DRAWINGS               m_drawings;  // BOARD_ITEMs for drawings on the board, owned by pointer.
     PADS                   m_pads;      // D_PAD items, owned by pointer
     MODULE_ZONE_CONTAINERS m_fp_zones;  // MODULE_ZONE_CONTAINER items, owned by pointer
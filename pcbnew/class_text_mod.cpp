@@ -471,5 +471,8 @@ static struct TEXTE_MODULE_DESC
         propMgr.AddTypeCast( new TYPE_CAST<TEXTE_MODULE, EDA_TEXT> );
         propMgr.InheritsAfter( TYPE_HASH( TEXTE_MODULE ), TYPE_HASH( BOARD_ITEM ) );
         propMgr.InheritsAfter( TYPE_HASH( TEXTE_MODULE ), TYPE_HASH( EDA_TEXT ) );
+
+        propMgr.AddProperty( new PROPERTY<TEXTE_MODULE, bool>( _( "Keep Upright" ),
+                    &TEXTE_MODULE::SetKeepUpright, &TEXTE_MODULE::IsKeepUpright ) );
     }
 } _TEXTE_MODULE_DESC;
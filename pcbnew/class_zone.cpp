@@ -1089,17 +1089,17 @@ void ZONE_CONTAINER::SwapData( BOARD_ITEM* aImage )
 }
 
 
-void ZONE_CONTAINER::CacheTriangulation( PCB_LAYER_ID aLayer )
+void ZONE_CONTAINER::CacheTriangulation( PCB_LAYER_ID aLayer, bool aParallel )
 {
     if( aLayer == UNDEFINED_LAYER )
     {
         for( std::pair<const PCB_LAYER_ID, SHAPE_POLY_SET>& pair : m_FilledPolysList )
-            pair.second.CacheTriangulation();
+            pair.second.CacheTriangulation( true, aParallel );
     }
     else
     {
         if( m_FilledPolysList.count( aLayer ) )
-            m_FilledPolysList[ aLayer ].CacheTriangulation();
+            m_FilledPolysList[ aLayer ].CacheTriangulation( true, aParallel );
     }
 }
 
@@ -625,8 +625,9 @@ public:
 
     /** (re)create a list of triangles that "fill" the solid areas.
      * used for instance to draw these solid areas on opengl
+     * @param aParallel = false when the caller already triangulates zones on several threads
      */
-    void CacheTriangulation( PCB_LAYER_ID aLayer = UNDEFINED_LAYER );
+    void CacheTriangulation( PCB_LAYER_ID aLayer = UNDEFINED_LAYER, bool aParallel = true );
 
    /**
      * Function SetFilledPolysList
@@ -790,10 +791,10 @@ public:
     /** @return the hash value previously calculated by BuildHashValue().
      * used in zone filling calculations
      */
-    MD5_HASH GetHashValue( PCB_LAYER_ID aLayer )
+    uint64_t GetHashValue( PCB_LAYER_ID aLayer )
     {
         if( !m_filledPolysHash.count( aLayer ) )
-            return MD5_HASH();
+            return 0;
 
         return m_filledPolysHash.at( aLayer );
     }
@@ -807,7 +808,7 @@ public:
         if( !m_FilledPolysList.count( aLayer ) )
             return;
 
-        m_filledPolysHash[aLayer] = m_FilledPolysList.at( aLayer ).GetHash();
+        m_filledPolysHash[aLayer] = m_FilledPolysList.at( aLayer ).GetContentHash();
     }
 
 
@@ -916,7 +917,7 @@ protected:
     std::map<PCB_LAYER_ID, bool>           m_fillFlags;
 
     /// A hash value used in zone filling calculations to see if the filled areas are up to date
-    std::map<PCB_LAYER_ID, MD5_HASH>       m_filledPolysHash;
+    std::map<PCB_LAYER_ID, uint64_t>       m_filledPolysHash;
 
     ZONE_BORDER_DISPLAY_STYLE m_borderStyle;       // border display style, see enum above
     int                       m_borderHatchPitch;  // for DIAGONAL_EDGE, distance between 2 lines
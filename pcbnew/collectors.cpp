@@ -24,6 +24,7 @@
 
 #include <collectors.h>
 #include <class_board_item.h>             // class BOARD_ITEM
+#include <class_board.h>
 
 #include <class_module.h>
 #include <class_edge_mod.h>
@@ -36,6 +37,8 @@
 #include <macros.h>
 #include <math/util.h>      // for KiROUND
 
+#include <unordered_set>
+
 
 /* This module contains out of line member functions for classes given in
  * collectors.h.  Those classes augment the functionality of class PCB_EDIT_FRAME.
@@ -571,6 +574,41 @@ exit:
 }
 
 
+std::vector<BOARD_ITEM*> GENERAL_COLLECTOR::collectCandidates( BOARD* aBoard ) const
+{
+    // Inspect() accepts items up to 2 * 5 pixels from the reference position (zone corners)
+    int   margin = KiROUND( 10 * m_Guide->OnePixelInIU() ) + 1;
+    BOX2I area( VECTOR2I( m_RefPos.x - margin, m_RefPos.y - margin ),
+                VECTOR2I( 2 * margin, 2 * margin ) );
+
+    std::vector<KIGFX::VIEW::LAYER_ITEM_PAIR> found;
+
+    // The guide decides which layers and items are eligible, not the view
+    m_Guide->GetView()->Query( area, found, false );
+
+    std::vector<BOARD_ITEM*>        candidates;
+    std::unordered_set<BOARD_ITEM*> known;
+
+    for( const KIGFX::VIEW::LAYER_ITEM_PAIR& pair : found )
+    {
+        BOARD_ITEM* item = dynamic_cast<BOARD_ITEM*>( pair.first );
+
+        // Pads, module texts... are visited through their module
+        while( item && item->GetParent() != aBoard )
+            item = dynamic_cast<BOARD_ITEM*>( item->GetParent() );
+
+        if( item && known.insert( item ).second )
+            candidates.push_back( item );
+    }
+
+    // The groups are not in the view, and they are few
+    for( PCB_GROUP* group : aBoard->Groups() )
+        candidates.push_back( group );
+
+    return candidates;
+}
+
+
 void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
                                  const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide )
 {
@@ -586,7 +624,18 @@ void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
     // the Inspect() function.
     SetRefPos( aRefPos );
 
-    aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    // The view only finds the items where they were at its last update
+    if( aItem->Type() == PCB_T && aGuide.GetView()
+            && !aGuide.GetView()->HasPendingGeometryUpdates() )
+    {
+        BOARD* board = static_cast<BOARD*>( aItem );
+
+        board->VisitItems( m_inspector, NULL, m_ScanTypes, collectCandidates( board ) );
+    }
+    else
+    {
+        aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    }
 
     // record the length of the primary list before concatenating on to it.
     m_PrimaryLength = m_List.size();
@@ -191,6 +191,12 @@ public:
 
     virtual     double OnePixelInIU() const = 0;
 
+    /**
+     * @return the view showing the board items, used as a spatial index to find the items
+     * near the reference position, or nullptr to inspect all the board items.
+     */
+    virtual     const KIGFX::VIEW* GetView() const = 0;
+
     /**
      * @return bool - true if Inspect() should use BOARD_ITEM::HitTest()
      *             or false if Inspect() should use BOARD_ITEM::BoundsTest().
@@ -259,6 +265,13 @@ protected:
      */
     int                         m_PrimaryLength;
 
+    /**
+     * @return the top level items of \a aBoard found in the view of the guide near the
+     * reference position, and all the groups.  They are the only items Inspect() may accept.
+     * The view must not have pending geometry updates.
+     */
+    std::vector<BOARD_ITEM*> collectCandidates( BOARD* aBoard ) const;
+
 public:
 
     /**
@@ -376,7 +389,8 @@ public:
      *  what is to be collected and the priority order of the resultant
      *  collection in "m_List".
      * @param aRefPos A wxPoint to use in hit-testing.
-     * @param aGuide The COLLECTORS_GUIDE to use in collecting items.
+     * @param aGuide The COLLECTORS_GUIDE to use in collecting items.  When it has a view and
+     *  aItem is a BOARD, only the items the view finds near aRefPos are inspected.
      */
     void Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
                  const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide );
@@ -423,6 +437,8 @@ private:
 
     double  m_OnePixelInIU;
 
+    const KIGFX::VIEW* m_View;
+
 public:
 
     /**
@@ -471,6 +487,7 @@ public:
         m_IgnoreZoneFills           = true;
 
         m_OnePixelInIU              = abs( aView->ToWorld( one, false ).x );
+        m_View                      = aView;
     }
 
     /**
@@ -615,6 +632,9 @@ public:
     void SetIgnoreZoneFills( bool ignore ) { m_IgnoreZoneFills = ignore; }
 
     double OnePixelInIU() const override { return m_OnePixelInIU; }
+
+    const KIGFX::VIEW* GetView() const override { return m_View; }
+    void SetView( const KIGFX::VIEW* aView ) { m_View = aView; }
 };
 
 
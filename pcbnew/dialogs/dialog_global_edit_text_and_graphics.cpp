@@ -268,7 +268,8 @@ void DIALOG_GLOBAL_EDIT_TEXT_AND_GRAPHICS::OnUpdateUI( wxUpdateUIEvent&  )
 
 void DIALOG_GLOBAL_EDIT_TEXT_AND_GRAPHICS::processItem( BOARD_COMMIT& aCommit, BOARD_ITEM* aItem )
 {
-    aCommit.Modify( aItem );
+    // Only properties are changed: the undo entry does not need a copy of the footprints
+    aCommit.ModifyProperties( aItem );
 
     auto textItem = dynamic_cast<EDA_TEXT*>( aItem );
     auto drawItem = dynamic_cast<DRAWSEGMENT*>( aItem );
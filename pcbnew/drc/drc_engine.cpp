@@ -443,6 +443,7 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
     const BOARD_CONNECTED_ITEM* connectedB = dynamic_cast<const BOARD_CONNECTED_ITEM*>( b );
     const DRC_CONSTRAINT*       constraintRef = nullptr;
     bool                        implicit = false;
+    wxString                    source;     // Local, as the painters may call us from threads
 
     // Local overrides take precedence
     if( aConstraintId == DRC_CONSTRAINT_TYPE_CLEARANCE )
@@ -452,7 +453,7 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
 
         if( connectedA && connectedA->GetLocalClearanceOverrides( nullptr ) > 0 )
         {
-            overrideA = connectedA->GetLocalClearanceOverrides( &m_msg );
+            overrideA = connectedA->GetLocalClearanceOverrides( &source );
 
             REPORT( "" )
             REPORT( wxString::Format( _( "Local override on %s; clearance: %s." ),
@@ -462,7 +463,7 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
 
         if( connectedB && connectedB->GetLocalClearanceOverrides( nullptr ) > 0 )
         {
-            overrideB = connectedB->GetLocalClearanceOverrides( &m_msg );
+            overrideB = connectedB->GetLocalClearanceOverrides( &source );
 
             REPORT( "" )
             REPORT( wxString::Format( _( "Local override on %s; clearance: %s." ),
@@ -472,7 +473,7 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
 
         if( overrideA || overrideB )
         {
-            DRC_CONSTRAINT constraint( DRC_CONSTRAINT_TYPE_CLEARANCE, m_msg );
+            DRC_CONSTRAINT constraint( DRC_CONSTRAINT_TYPE_CLEARANCE, source );
             constraint.m_Value.SetMin( std::max( overrideA, overrideB ) );
             return constraint;
         }
@@ -569,7 +570,7 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
                                       MessageTextFromValue( UNITS, localA, true ) ) )
 
             if( localA > clearance )
-                clearance = connectedA->GetLocalClearance( &m_msg );
+                clearance = connectedA->GetLocalClearance( &source );
         }
 
         if( localB > 0 )
@@ -580,12 +581,12 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
                                       MessageTextFromValue( UNITS, localB, true ) ) )
 
             if( localB > clearance )
-                clearance = connectedB->GetLocalClearance( &m_msg );
+                clearance = connectedB->GetLocalClearance( &source );
         }
 
         if( localA > global || localB > global )
         {
-            DRC_CONSTRAINT constraint( DRC_CONSTRAINT_TYPE_CLEARANCE, m_msg );
+            DRC_CONSTRAINT constraint( DRC_CONSTRAINT_TYPE_CLEARANCE, source );
             constraint.m_Value.SetMin( clearance );
             return constraint;
         }
@@ -593,10 +594,7 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
 
     // fixme: return optional<drc_constraint>, let the particular test decide what to do if no matching constraint
     // is found
-    static DRC_CONSTRAINT nullConstraint;
-    nullConstraint.m_DisallowFlags = 0;
-
-    return constraintRef ? *constraintRef : nullConstraint;
+    return constraintRef ? *constraintRef : DRC_CONSTRAINT();
 
 #undef REPORT
 #undef UNITS
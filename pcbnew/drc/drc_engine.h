@@ -215,7 +215,6 @@ protected:
     REPORTER*                        m_reporter;
     PROGRESS_REPORTER*               m_progressReporter;
 
-    wxString m_msg;  // Allocating strings gets expensive enough to want to avoid it
 };
 
 #endif // DRC_H
@@ -37,10 +37,16 @@
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
+#include <algorithm>
+#include <set>
 #include <thread>
 #include <mutex>
 
 
+/// First line of the footprint info cache file.  Bump when the file layout changes.
+static const wxChar FP_INFO_CACHE_VERSION[] = wxT( "fp-info-cache v2" );
+
+
 void FOOTPRINT_INFO_IMPL::load()
 {
     FP_LIB_TABLE* fptable = m_owner->GetTable();
@@ -167,9 +173,14 @@ bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxStri
     }
 
     if( m_cancelled )
+    {
         m_list_timestamp = 0;       // God knows what we got before we were cancelled
+        m_lib_timestamps.clear();
+    }
     else
+    {
         m_list_timestamp = generatedTimestamp;
+    }
 
     return m_errors.empty();
 }
@@ -184,19 +195,51 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     // Clear data before reading files
     m_count_finished.store( 0 );
     m_errors.clear();
-    m_list.clear();
     m_threads.clear();
     m_queue_in.clear();
     m_queue_out.clear();
 
+    std::map<wxString, long long> libTimestamps;
+
     if( aNickname )
+    {
+        m_list.clear();
+        libTimestamps[ *aNickname ] = aTable->GenerateTimestamp( aNickname );
         m_queue_in.push( *aNickname );
+    }
     else
     {
-        for( auto const& nickname : aTable->GetLogicalLibs() )
-            m_queue_in.push( nickname );
+        // Only libraries which changed since they were last read (or cached) are read again;
+        // the footprints of the other libraries are kept as they are.
+        std::set<wxString> reload;
+
+        for( const wxString& nickname : aTable->GetLogicalLibs() )
+        {
+            long long timestamp = aTable->GenerateTimestamp( &nickname );
+            auto      cached = m_lib_timestamps.find( nickname );
+
+            libTimestamps[ nickname ] = timestamp;
+
+            if( cached == m_lib_timestamps.end() || cached->second != timestamp )
+            {
+                reload.insert( nickname );
+                m_queue_in.push( nickname );
+            }
+        }
+
+        m_list.erase( std::remove_if( m_list.begin(), m_list.end(),
+                                      [&]( const std::unique_ptr<FOOTPRINT_INFO>& aInfo )
+                                      {
+                                          const wxString& nickname = aInfo->GetLibNickname();
+
+                                          return reload.count( nickname )
+                                                    || !libTimestamps.count( nickname );
+                                      } ),
+                      m_list.end() );
     }
 
+    m_lib_timestamps = std::move( libTimestamps );
+
     m_loader->m_total_libs = m_queue_in.size();
 
     for( unsigned i = 0; i < aNThreads; ++i )
@@ -222,7 +265,10 @@ void FOOTPRINT_LIST_IMPL::StopWorkers()
 
     // If we have cancelled in the middle of a load, clear our timestamp to re-load next time
     if( m_cancelled )
+    {
         m_list_timestamp = 0;
+        m_lib_timestamps.clear();
+    }
 }
 
 bool FOOTPRINT_LIST_IMPL::JoinWorkers()
@@ -355,8 +401,18 @@ void FOOTPRINT_LIST_IMPL::WriteCacheToFile( wxTextFile* aCacheFile )
             return;
     }
 
+    aCacheFile->AddLine( FP_INFO_CACHE_VERSION );
     aCacheFile->AddLine( wxString::Format( "%lld", m_list_timestamp ) );
 
+    // Per-library timestamps, so that only the libraries which changed are read again
+    aCacheFile->AddLine( wxString::Format( "%zu", m_lib_timestamps.size() ) );
+
+    for( const std::pair<const wxString, long long>& lib : m_lib_timestamps )
+    {
+        aCacheFile->AddLine( lib.first );
+        aCacheFile->AddLine( wxString::Format( "%lld", lib.second ) );
+    }
+
     for( auto& fpinfo : m_list )
     {
         aCacheFile->AddLine( fpinfo->GetLibNickname() );
@@ -376,13 +432,29 @@ void FOOTPRINT_LIST_IMPL::WriteCacheToFile( wxTextFile* aCacheFile )
 void FOOTPRINT_LIST_IMPL::ReadCacheFromFile( wxTextFile* aCacheFile )
 {
     m_list_timestamp = 0;
+    m_lib_timestamps.clear();
     m_list.clear();
 
     try
     {
-        if( aCacheFile->Exists() && aCacheFile->Open() )
+        // Cache files without a version header predate the per-library timestamps; they
+        // are simply ignored and rebuilt.
+        if( aCacheFile->Exists() && aCacheFile->Open()
+                && aCacheFile->GetFirstLine() == FP_INFO_CACHE_VERSION )
         {
-            aCacheFile->GetFirstLine().ToLongLong( &m_list_timestamp );
+            aCacheFile->GetNextLine().ToLongLong( &m_list_timestamp );
+
+            long libCount = 0;
+            aCacheFile->GetNextLine().ToLong( &libCount );
+
+            for( long ii = 0; ii < libCount && !aCacheFile->Eof(); ++ii )
+            {
+                wxString  libNickname = aCacheFile->GetNextLine();
+                long long timestamp = 0;
+
+                aCacheFile->GetNextLine().ToLongLong( &timestamp );
+                m_lib_timestamps[ libNickname ] = timestamp;
+            }
 
             while( aCacheFile->GetCurrentLine() + 6 < aCacheFile->GetLineCount() )
             {
@@ -404,11 +476,15 @@ void FOOTPRINT_LIST_IMPL::ReadCacheFromFile( wxTextFile* aCacheFile )
     {
         // whatever went wrong, invalidate the cache
         m_list_timestamp = 0;
+        m_lib_timestamps.clear();
     }
 
     // Sanity check: an empty list is very unlikely to be correct.
     if( m_list.size() == 0 )
+    {
         m_list_timestamp = 0;
+        m_lib_timestamps.clear();
+    }
 
     if( aCacheFile->IsOpened() )
         aCacheFile->Close();
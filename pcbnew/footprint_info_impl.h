@@ -22,6 +22,7 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -89,6 +90,9 @@ class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
     SYNC_QUEUE<wxString>     m_queue_out;
     std::atomic_size_t       m_count_finished;
     long long                m_list_timestamp;
+
+    /// Timestamp of each library in m_list when it was read, see FP_LIB_TABLE::GenerateTimestamp
+    std::map<wxString, long long> m_lib_timestamps;
     PROGRESS_REPORTER*       m_progress_reporter;
     std::atomic_bool         m_cancelled;
     std::mutex               m_join;
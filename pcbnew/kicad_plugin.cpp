@@ -57,23 +57,43 @@ using namespace PCB_KEYS_T;
  * that contain a single module per file.  This class is a helper only for the
  * footprint portion of the PLUGIN API, and only for the #PCB_IO plugin.  It is
  * private to this implementation file so it is not placed into a header.
+ *
+ * The footprint file is not parsed until the footprint is first needed, so an item
+ * created without a MODULE is only a placeholder for its file.
  */
 class FP_CACHE_ITEM
 {
     WX_FILENAME             m_filename;
     std::unique_ptr<MODULE> m_module;
+    bool                    m_parsed;       // false until the footprint file has been read
 
 public:
     FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName );
 
     const WX_FILENAME& GetFileName() const { return m_filename; }
     const MODULE*      GetModule()   const { return m_module.get(); }
+
+    /**
+     * @return true if the footprint file has been read (successfully or not).
+     */
+    bool IsParsed() const { return m_parsed; }
+
+    /**
+     * Store the result of reading the footprint file.  \a aModule is NULL if the file
+     * failed to parse.
+     */
+    void SetModule( MODULE* aModule )
+    {
+        m_module.reset( aModule );
+        m_parsed = true;
+    }
 };
 
 
 FP_CACHE_ITEM::FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName ) :
     m_filename( aFileName ),
-    m_module( aModule )
+    m_module( aModule ),
+    m_parsed( aModule != nullptr )
 { }
 
 
@@ -114,8 +134,28 @@ public:
      */
     void Save( MODULE* aModule = NULL );
 
+    /**
+     * Function Load
+     * Read the list of footprint files in the library.  The footprints themselves are only
+     * parsed on demand, see GetModule() and ParseAll().
+     */
     void Load();
 
+    /**
+     * Function GetModule
+     * @return the footprint \a aFootprintName, parsing its file first if required, or NULL
+     *         if there is no such footprint or its file could not be parsed.
+     */
+    const MODULE* GetModule( const wxString& aFootprintName );
+
+    /**
+     * Function ParseAll
+     * Parse every footprint file not yet read.
+     *
+     * @throw IO_ERROR with all the parser errors if any of the files failed to parse.
+     */
+    void ParseAll();
+
     void Remove( const wxString& aFootprintName );
 
     /**
@@ -145,6 +185,14 @@ public:
      * @return true if \a aPath is the same as the cache path.
      */
     bool IsPath( const wxString& aPath ) const;
+
+private:
+    /**
+     * Parse the footprint file of \a aItem and store the result in the item.
+     *
+     * @throw IO_ERROR if the file could not be read or parsed.
+     */
+    void parseItem( const wxString& aFootprintName, FP_CACHE_ITEM* aItem );
 };
 
 
@@ -181,6 +229,13 @@ void FP_CACHE::Save( MODULE* aModule )
 
         WX_FILENAME fn = it->second->GetFileName();
 
+        // Footprints never read from disk (or which failed to parse) have nothing new to save.
+        if( !it->second->GetModule() )
+        {
+            m_cache_timestamp += fn.GetTimestamp();
+            continue;
+        }
+
         wxString tempFileName =
 #ifdef USE_TMP_FILE
         wxFileName::CreateTempFileName( fn.GetPath() );
@@ -251,39 +306,88 @@ void FP_CACHE::Load()
 
     if( dir.GetFirst( &fullName, fileSpec ) )
     {
-        wxString cacheError;
-
         do
         {
             fn.SetFullName( fullName );
 
-            // Queue I/O errors so only files that fail to parse don't get loaded.
-            try
-            {
-                FILE_LINE_READER    reader( fn.GetFullPath() );
+            m_modules.insert( fn.GetName(), new FP_CACHE_ITEM( nullptr, fn ) );
+
+            m_cache_timestamp += fn.GetTimestamp();
+        } while( dir.GetNext( &fullName ) );
+    }
+}
 
-                m_owner->m_parser->SetLineReader( &reader );
 
-                MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
-                wxString    fpName = fn.GetName();
+void FP_CACHE::parseItem( const wxString& aFootprintName, FP_CACHE_ITEM* aItem )
+{
+    try
+    {
+        FILE_LINE_READER    reader( aItem->GetFileName().GetFullPath() );
 
-                footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
-                m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, fn ) );
+        m_owner->m_parser->SetLineReader( &reader );
 
-                m_cache_timestamp += fn.GetTimestamp();
-            }
-            catch( const IO_ERROR& ioe )
-            {
-                if( !cacheError.IsEmpty() )
-                    cacheError += "\n\n";
+        MODULE* footprint = (MODULE*) m_owner->m_parser->Parse();
+
+        footprint->SetFPID( LIB_ID( wxEmptyString, aFootprintName ) );
+        aItem->SetModule( footprint );
+    }
+    catch( const IO_ERROR& )
+    {
+        // Don't try to parse a broken file again; the error is only reported once.
+        aItem->SetModule( nullptr );
+        throw;
+    }
+}
 
-                cacheError += ioe.What();
-            }
-        } while( dir.GetNext( &fullName ) );
 
-        if( !cacheError.IsEmpty() )
-            THROW_IO_ERROR( cacheError );
+const MODULE* FP_CACHE::GetModule( const wxString& aFootprintName )
+{
+    MODULE_ITER it = m_modules.find( aFootprintName );
+
+    if( it == m_modules.end() )
+        return nullptr;
+
+    if( !it->second->IsParsed() )
+    {
+        try
+        {
+            parseItem( it->first, it->second );
+        }
+        catch( const IO_ERROR& )
+        {
+            // do nothing with the error
+        }
     }
+
+    return it->second->GetModule();
+}
+
+
+void FP_CACHE::ParseAll()
+{
+    wxString cacheError;
+
+    for( MODULE_ITER it = m_modules.begin();  it != m_modules.end();  ++it )
+    {
+        if( it->second->IsParsed() )
+            continue;
+
+        // Queue I/O errors so only files that fail to parse don't get loaded.
+        try
+        {
+            parseItem( it->first, it->second );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            if( !cacheError.IsEmpty() )
+                cacheError += "\n\n";
+
+            cacheError += ioe.What();
+        }
+    }
+
+    if( !cacheError.IsEmpty() )
+        THROW_IO_ERROR( cacheError );
 }
 
 
@@ -2116,6 +2220,10 @@ void PCB_IO::FootprintEnumerate( wxArrayString& aFootprintNames, const wxString&
     try
     {
         validateCache( aLibPath );
+
+        // Enumeration is followed by reading the footprint details (keywords, pad counts...),
+        // so parse the whole library now to report all the broken files at once.
+        m_cache->ParseAll();
     }
     catch( const IO_ERROR& ioe )
     {
@@ -2126,7 +2234,10 @@ void PCB_IO::FootprintEnumerate( wxArrayString& aFootprintNames, const wxString&
     // the library.
 
     for( MODULE_CITER it = m_cache->GetModules().begin(); it != m_cache->GetModules().end(); ++it )
-        aFootprintNames.Add( it->first );
+    {
+        if( it->second->GetModule() )
+            aFootprintNames.Add( it->first );
+    }
 
     if( !errorMsg.IsEmpty() && !aBestEfforts )
         THROW_IO_ERROR( errorMsg );
@@ -2151,14 +2262,8 @@ const MODULE* PCB_IO::getFootprint( const wxString& aLibraryPath,
         // do nothing with the error
     }
 
-    const MODULE_MAP& mods = m_cache->GetModules();
-
-    MODULE_CITER it = mods.find( aFootprintName );
-
-    if( it == mods.end() )
-        return nullptr;
-
-    return it->second->GetModule();
+    // Only the requested footprint is parsed if the library has not been enumerated yet.
+    return m_cache->GetModule( aFootprintName );
 }
 
 
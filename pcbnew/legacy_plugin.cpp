@@ -2113,8 +2113,7 @@ void LEGACY_PLUGIN::loadPCB_TEXT()
     char    text[1024];
 
     // maybe someday a constructor that takes all this data in one call?
-    TEXTE_PCB*  pcbtxt = new TEXTE_PCB( m_board );
-    m_board->Add( pcbtxt, ADD_MODE::APPEND );
+    unique_ptr<TEXTE_PCB> pcbtxt( new TEXTE_PCB( m_board ) );
 
     char*   line;
 
@@ -2191,6 +2190,8 @@ void LEGACY_PLUGIN::loadPCB_TEXT()
 
         else if( TESTLINE( "$EndTEXTPCB" ) )
         {
+            // Added once its UUID is known, the board indexes its items by UUID
+            m_board->Add( pcbtxt.release(), ADD_MODE::APPEND );
             return;     // preferred exit
         }
     }
@@ -2922,9 +2923,9 @@ void LEGACY_PLUGIN::loadPCB_TARGET()
 
             PCB_TARGET* t = new PCB_TARGET( m_board, shape, leg_layer2new( m_cu_count,  layer_num ),
                                             wxPoint( pos_x, pos_y ), size, width );
-            m_board->Add( t, ADD_MODE::APPEND );
 
             const_cast<KIID&>( t->m_Uuid ) = KIID( uuid );
+            m_board->Add( t, ADD_MODE::APPEND );
         }
     }
 
@@ -49,6 +49,42 @@
 
 #include <pcb_edit_frame.h>
 
+#include <unordered_set>
+
+
+NETLIST_FOOTPRINT_INDEX::NETLIST_FOOTPRINT_INDEX( const MODULES& aFootprints, bool aByPath ) :
+    m_byPath( aByPath )
+{
+    for( MODULE* footprint : aFootprints )
+    {
+        if( m_byPath )
+            m_footprintsByPath[ footprint->GetPath() ].push_back( footprint );
+        else
+            m_footprintsByReference[ footprint->GetReference().Lower() ].push_back( footprint );
+    }
+}
+
+
+const std::vector<MODULE*>& NETLIST_FOOTPRINT_INDEX::Find( const COMPONENT& aComponent ) const
+{
+    if( m_byPath )
+    {
+        auto it = m_footprintsByPath.find( aComponent.GetPath() );
+
+        if( it != m_footprintsByPath.end() )
+            return it->second;
+    }
+    else
+    {
+        auto it = m_footprintsByReference.find( aComponent.GetReference().Lower() );
+
+        if( it != m_footprintsByReference.end() )
+            return it->second;
+    }
+
+    return m_noFootprints;
+}
+
 
 BOARD_NETLIST_UPDATER::BOARD_NETLIST_UPDATER( PCB_EDIT_FRAME* aFrame, BOARD* aBoard ) :
     m_frame( aFrame ),
@@ -747,21 +783,36 @@ bool BOARD_NETLIST_UPDATER::testConnectivity( NETLIST& aNetlist )
     wxString msg;
     wxString padname;
 
+    // The first footprint of each reference, as BOARD::FindModuleByReference() finds
+    std::unordered_map<wxString, MODULE*> footprintsByReference;
+
+    for( MODULE* footprint : m_board->Modules() )
+        footprintsByReference.emplace( footprint->GetReference(), footprint );
+
+    std::unordered_set<wxString> padNames;
+
     for( int i = 0; i < (int) aNetlist.GetCount(); i++ )
     {
         const COMPONENT* component = aNetlist.GetComponent( i );
-        MODULE* footprint = m_board->FindModuleByReference( component->GetReference() );
+        auto             it = footprintsByReference.find( component->GetReference() );
 
-        if( footprint == NULL )    // It can be missing in partial designs
+        if( it == footprintsByReference.end() )    // It can be missing in partial designs
             continue;
 
+        MODULE* footprint = it->second;
+
+        padNames.clear();
+
+        for( D_PAD* pad : footprint->Pads() )
+            padNames.insert( pad->GetName() );
+
         // Explore all pins/pads in component
         for( unsigned jj = 0; jj < component->GetNetCount(); jj++ )
         {
             const COMPONENT_NET& net = component->GetNet( jj );
             padname = net.GetPinName();
 
-            if( footprint->FindPadByName( padname ) )
+            if( padNames.count( padname ) )
                 continue;   // OK, pad found
 
             // not found: bad footprint, report error
@@ -784,10 +835,13 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
     m_errorCount = 0;
     m_warningCount = 0;
     m_newFootprintsCount = 0;
-    MODULE* lastPreexistingFootprint = m_board->Modules().empty() ? NULL : m_board->Modules().back();
 
     cacheCopperZoneConnections();
 
+    // The footprints added or exchanged by the update are committed at the end, only the
+    // footprints already on the board are matched
+    NETLIST_FOOTPRINT_INDEX preexistingFootprints( m_board->Modules(), m_lookupByTimestamp );
+
     if( !m_isDryRun )
     {
         m_board->SetStatus( 0 );
@@ -812,39 +866,20 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
                     component->GetFPID().Format().wx_str() );
         m_reporter->Report( msg, RPT_SEVERITY_INFO );
 
-        for( auto footprint : m_board->Modules() )
+        for( MODULE* footprint : preexistingFootprints.Find( *component ) )
         {
-            bool     match = false;
+            tmp = footprint;
 
-            if( footprint )
-            {
-                if( m_lookupByTimestamp )
-                    match = footprint->GetPath() == component->GetPath();
-                else
-                    match = footprint->GetReference().CmpNoCase( component->GetReference() ) == 0;
-            }
+            if( m_replaceFootprints && component->GetFPID() != footprint->GetFPID() )
+                tmp = replaceComponent( aNetlist, footprint, component );
 
-            if( match )
+            if( tmp )
             {
-                tmp = footprint;
-
-                if( m_replaceFootprints && component->GetFPID() != footprint->GetFPID() )
-                    tmp = replaceComponent( aNetlist, footprint, component );
-
-                if( tmp )
-                {
-                    updateComponentParameters( tmp, component );
-                    updateComponentPadConnections( tmp, component );
-                }
-
-                matchCount++;
+                updateComponentParameters( tmp, component );
+                updateComponentPadConnections( tmp, component );
             }
 
-            if( footprint == lastPreexistingFootprint )
-            {
-                // No sense going through the newly-created footprints: end of loop
-                break;
-            }
+            matchCount++;
         }
 
         if( matchCount == 0 )
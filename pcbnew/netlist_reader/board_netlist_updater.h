@@ -42,6 +42,37 @@ class MODULE;
 class PCB_EDIT_FRAME;
 
 #include <board_commit.h>
+#include <class_module.h>
+
+#include <map>
+#include <unordered_map>
+
+
+/**
+ * NETLIST_FOOTPRINT_INDEX
+ * indexes footprints by reference designator (case insensitive) or by symbol path, to find
+ * the footprints of the netlist components without scanning the board for each of them.
+ */
+class NETLIST_FOOTPRINT_INDEX
+{
+public:
+    /**
+     * @param aFootprints the footprints to index.
+     * @param aByPath true to match the components by path, false by reference designator.
+     */
+    NETLIST_FOOTPRINT_INDEX( const MODULES& aFootprints, bool aByPath );
+
+    /**
+     * @return the footprints matching \a aComponent, in the order of the indexed list.
+     */
+    const std::vector<MODULE*>& Find( const COMPONENT& aComponent ) const;
+
+private:
+    bool                                               m_byPath;
+    std::unordered_map<wxString, std::vector<MODULE*>> m_footprintsByReference;
+    std::map<KIID_PATH, std::vector<MODULE*>>          m_footprintsByPath;
+    std::vector<MODULE*>                               m_noFootprints;
+};
 
 /**
  * BOARD_NETLIST_UPDATER
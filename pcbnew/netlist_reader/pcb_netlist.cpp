@@ -57,16 +57,26 @@ COMPONENT_NET COMPONENT::m_emptyNet;
 
 const COMPONENT_NET& COMPONENT::GetNet( const wxString& aPinName ) const
 {
-    for( const COMPONENT_NET& net : m_nets )
-    {
-        if( net.GetPinName() == aPinName )
-            return net;
-    }
+    auto it = m_netIndexByPin.find( aPinName );
+
+    if( it != m_netIndexByPin.end() )
+        return m_nets[ it->second ];
 
     return m_emptyNet;
 }
 
 
+void COMPONENT::SortPins()
+{
+    sort( m_nets.begin(), m_nets.end() );
+
+    m_netIndexByPin.clear();
+
+    for( unsigned i = 0; i < m_nets.size(); i++ )
+        m_netIndexByPin.emplace( m_nets[i].GetPinName(), i );
+}
+
+
 void COMPONENT::Format( OUTPUTFORMATTER* aOut, int aNestLevel, int aCtl )
 {
     int nl = aNestLevel;
@@ -138,35 +148,39 @@ void NETLIST::Format( const char* aDocName, OUTPUTFORMATTER* aOut, int aNestLeve
 void NETLIST::AddComponent( COMPONENT* aComponent )
 {
     m_components.push_back( aComponent );
+
+    // The first component of a reference or path is the one found
+    m_componentsByReference.emplace( aComponent->GetReference(), aComponent );
+    m_componentsByPath.emplace( aComponent->GetPath(), aComponent );
 }
 
 
-COMPONENT* NETLIST::GetComponentByReference( const wxString& aReference )
+void NETLIST::indexComponents()
 {
-    COMPONENT* component = NULL;
+    m_componentsByReference.clear();
+    m_componentsByPath.clear();
 
-    for( unsigned i = 0;  i < m_components.size();  i++ )
+    for( COMPONENT& component : m_components )
     {
-        if( m_components[i].GetReference() == aReference )
-        {
-            component = &m_components[i];
-            break;
-        }
+        m_componentsByReference.emplace( component.GetReference(), &component );
+        m_componentsByPath.emplace( component.GetPath(), &component );
     }
+}
+
 
-    return component;
+COMPONENT* NETLIST::GetComponentByReference( const wxString& aReference )
+{
+    auto it = m_componentsByReference.find( aReference );
+
+    return it != m_componentsByReference.end() ? it->second : nullptr;
 }
 
 
 COMPONENT* NETLIST::GetComponentByPath( const KIID_PATH& aUuidPath )
 {
-    for( COMPONENT& component : m_components )
-    {
-        if( component.GetPath() == aUuidPath )
-            return &component;
-    }
+    auto it = m_componentsByPath.find( aUuidPath );
 
-    return nullptr;
+    return it != m_componentsByPath.end() ? it->second : nullptr;
 }
 
 
@@ -183,6 +197,7 @@ static bool ByFPID( const COMPONENT& ref, const COMPONENT& cmp )
 void NETLIST::SortByFPID()
 {
     m_components.sort( ByFPID );
+    indexComponents();
 }
 
 
@@ -199,6 +214,7 @@ bool operator < ( const COMPONENT& item1, const COMPONENT& item2 )
 void NETLIST::SortByReference()
 {
     m_components.sort();
+    indexComponents();
 }
 
 
@@ -29,6 +29,9 @@
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <wx/arrstr.h>
 
+#include <map>
+#include <unordered_map>
+
 #include <lib_id.h>
 #include <class_module.h>
 
@@ -108,6 +111,9 @@ class COMPONENT
     /// Component-specific properties found in the netlist.
     std::map<wxString, wxString> m_properties;
 
+    /// Index in #m_nets of the first net of each pin name.
+    std::unordered_map<wxString, unsigned> m_netIndexByPin;
+
     static COMPONENT_NET    m_emptyNet;
 
 public:
@@ -127,6 +133,7 @@ public:
 
     void AddNet( const wxString& aPinName, const wxString& aNetName, const wxString& aPinFunction )
     {
+        m_netIndexByPin.emplace( aPinName, m_nets.size() );
         m_nets.push_back( COMPONENT_NET( aPinName, aNetName, aPinFunction ) );
     }
 
@@ -136,7 +143,7 @@ public:
 
     const COMPONENT_NET& GetNet( const wxString& aPinName ) const;
 
-    void SortPins() { sort( m_nets.begin(), m_nets.end() ); }
+    void SortPins();
 
     void SetName( const wxString& aName ) { m_name = aName;}
     const wxString& GetName() const { return m_name; }
@@ -195,6 +202,13 @@ class NETLIST
 {
     COMPONENTS m_components;          // Components found in the netlist.
 
+    // The first component of each reference and path, for GetComponentByReference() and
+    // GetComponentByPath()
+    std::unordered_map<wxString, COMPONENT*> m_componentsByReference;
+    std::map<KIID_PATH, COMPONENT*>          m_componentsByPath;
+
+    void indexComponents();
+
     bool       m_findByTimeStamp;     // Associate components by KIID (or refdes if false)
     bool       m_replaceFootprints;   // Update footprints to match footprints defined in netlist
 
@@ -215,7 +229,12 @@ public:
      * Function Clear
      * removes all components from the netlist.
      */
-    void Clear() { m_components.clear(); }
+    void Clear()
+    {
+        m_components.clear();
+        m_componentsByReference.clear();
+        m_componentsByPath.clear();
+    }
 
     /**
      * Function GetCount
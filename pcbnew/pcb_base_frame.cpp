@@ -60,7 +60,8 @@ PCB_BASE_FRAME::PCB_BASE_FRAME( KIWAY* aKiway, wxWindow* aParent, FRAME_T aFrame
         long aStyle, const wxString & aFrameName ) :
     EDA_DRAW_FRAME( aKiway, aParent, aFrameType, aTitle, aPos, aSize, aStyle, aFrameName ),
     m_Pcb( nullptr ),
-    m_OriginTransforms( *this )
+    m_OriginTransforms( *this ),
+    m_3DViewDirtyLayers( LSET::AllLayersMask() )
 {
     m_Settings = static_cast<PCBNEW_SETTINGS*>( Kiface().KifaceSettings() );
 }
@@ -90,7 +91,7 @@ void PCB_BASE_FRAME::Update3DView( bool aForceReload, const wxString* aTitle )
         if( aTitle )
             draw3DFrame->SetTitle( *aTitle );
 
-        draw3DFrame->NewDisplay( aForceReload );
+        draw3DFrame->NewDisplay( aForceReload, m_3DViewDirtyLayers );
     }
 }
 
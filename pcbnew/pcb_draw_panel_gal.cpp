@@ -161,7 +161,7 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
         std::thread t = std::thread( [ &count_done, &next, &zones ]( )
         {
             for( size_t i = next.fetch_add( 1 ); i < zones.size(); i = next.fetch_add( 1 ) )
-                zones[i]->CacheTriangulation();
+                zones[i]->CacheTriangulation( UNDEFINED_LAYER, false );
 
             count_done++;
         } );
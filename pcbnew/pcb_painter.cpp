@@ -43,7 +43,9 @@
 
 #include <convert_basic_shapes_to_polygon.h>
 #include <gal/graphics_abstraction_layer.h>
+#include <gal/gal_display_list.h>
 #include <geometry/geometry_utils.h>
+#include <trigo.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_segment.h>
 #include <geometry/shape_circle.h>
@@ -353,11 +355,79 @@ COLOR4D PCB_RENDER_SETTINGS::GetColor( const VIEW_ITEM* aItem, int aLayer ) cons
 
 
 PCB_PAINTER::PCB_PAINTER( GAL* aGal ) :
-    PAINTER( aGal )
+    PAINTER( aGal ),
+    m_isClone( false )
 {
 }
 
 
+PCB_PAINTER::~PCB_PAINTER()
+{
+}
+
+
+PAINTER* PCB_PAINTER::Clone( GAL* aGal ) const
+{
+    // The items only read the settings, so each copy can draw from its own thread
+    PCB_PAINTER* painter = new PCB_PAINTER( aGal );
+    painter->m_pcbSettings = m_pcbSettings;
+    painter->m_brightenedColor = m_brightenedColor;
+
+    return painter;
+}
+
+
+bool PCB_PAINTER::drawShapeInstance( const VECTOR2D& aPosition, double aOrientation,
+                                     const COLOR4D& aColor, bool aSketch,
+                                     const std::function<void()>& aDrawShape )
+{
+    // Only the OpenGL GAL draws the instances from a single copy of the shape
+    if( !m_gal->IsOpenGlEngine() )
+        return false;
+
+    if( !m_shapeRecorder )
+        m_shapeRecorder = std::make_unique<GAL_DISPLAY_LIST>( m_shapeOptions );
+
+    m_shapeRecorder->Clear();
+    m_shapeRecorder->SetReplayTarget( m_gal );
+
+    // The attributes are part of the template, they do not depend on the previous items
+    m_shapeRecorder->SetIsFill( !aSketch );
+    m_shapeRecorder->SetIsStroke( aSketch );
+    m_shapeRecorder->SetLineWidth( aSketch ? m_pcbSettings.m_outlineWidth : 0.0 );
+    m_shapeRecorder->SetFillColor( aColor );
+    m_shapeRecorder->SetStrokeColor( aColor );
+
+    GAL* gal = m_gal;
+    int  entry = m_shapeRecorder->BeginEntry();
+
+    m_gal = m_shapeRecorder.get();
+    aDrawShape();
+    m_gal = gal;
+
+    if( !m_shapeRecorder->EndEntry() )
+        return false;
+
+    m_gal->DrawShapeInstance( m_gal->GetShapeTemplate( *m_shapeRecorder, entry ), aPosition,
+                              -DECIDEG2RAD( aOrientation ), aColor );
+    return true;
+}
+
+
+/**
+ * Return a point of a pad shape in the pad coordinates: around the pad position and without
+ * the pad rotation.  RotatePoint() is exact for multiples of 90 degrees, so the pads of the
+ * same footprint usually get the same shape.
+ */
+static VECTOR2I toPadCoords( const D_PAD* aPad, const VECTOR2I& aPoint )
+{
+    VECTOR2I point = aPoint - VECTOR2I( aPad->GetPosition() );
+    RotatePoint( point, -aPad->GetOrientation() );
+
+    return point;
+}
+
+
 int PCB_PAINTER::getLineThickness( int aActualThickness ) const
 {
     // if items have 0 thickness, draw them with the outline
@@ -395,6 +465,10 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
     if( !item )
         return false;
 
+    // Leave the clearance outlines to the painter of the main thread
+    if( m_isClone && drawsClearance( item ) )
+        return false;
+
     // the "cast" applied in here clarifies which overloaded draw() is called
     switch( item->Type() )
     {
@@ -467,6 +541,28 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 }
 
 
+bool PCB_PAINTER::drawsClearance( const EDA_ITEM* aItem ) const
+{
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+        return ( m_pcbSettings.m_clearance & PCB_RENDER_SETTINGS::CL_EXISTING )
+                && ( m_pcbSettings.m_clearance & PCB_RENDER_SETTINGS::CL_TRACKS );
+
+    case PCB_VIA_T:
+        return ( m_pcbSettings.m_clearance & PCB_RENDER_SETTINGS::CL_EXISTING )
+                && ( m_pcbSettings.m_clearance & PCB_RENDER_SETTINGS::CL_VIAS );
+
+    case PCB_PAD_T:
+        return m_pcbSettings.m_clearance & PCB_RENDER_SETTINGS::CL_PADS;
+
+    default:
+        return false;
+    }
+}
+
+
 void PCB_PAINTER::draw( const TRACK* aTrack, int aLayer )
 {
     VECTOR2D start( aTrack->GetStart() );
@@ -707,7 +803,13 @@ void PCB_PAINTER::draw( const VIA* aVia, int aLayer )
     else
     {
         // Draw the outer circles of normal vias and the holes for all vias
-        m_gal->DrawCircle( center, radius );
+        auto drawCircle = [&]()
+                          {
+                              m_gal->DrawCircle( VECTOR2D( 0.0, 0.0 ), radius );
+                          };
+
+        if( !drawShapeInstance( center, 0.0, color, sketchMode, drawCircle ) )
+            m_gal->DrawCircle( center, radius );
     }
 
     // Clearance lines
@@ -837,7 +939,9 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
     else
         color = m_pcbSettings.GetColor( aPad, aLayer );
 
-    if( m_pcbSettings.m_sketchMode[LAYER_PADS_TH] )
+    bool sketchMode = m_pcbSettings.m_sketchMode[LAYER_PADS_TH];
+
+    if( sketchMode )
     {
         // Outline mode
         m_gal->SetIsFill( false );
@@ -857,11 +961,25 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
     if( aLayer == LAYER_PADS_PLATEDHOLES || aLayer == LAYER_NON_PLATEDHOLES )
     {
         const SHAPE_SEGMENT* seg = aPad->GetEffectiveHoleShape();
-
-        if( seg->GetSeg().A == seg->GetSeg().B )    // Circular hole
-            m_gal->DrawCircle( seg->GetSeg().A, seg->GetWidth()/2 );
-        else
-            m_gal->DrawSegment( seg->GetSeg().A, seg->GetSeg().B, seg->GetWidth() );
+        const VECTOR2I       a = toPadCoords( aPad, seg->GetSeg().A );
+        const VECTOR2I       b = toPadCoords( aPad, seg->GetSeg().B );
+
+        auto drawHole = [&]()
+                        {
+                            if( a == b )    // Circular hole
+                                m_gal->DrawCircle( a, seg->GetWidth() / 2 );
+                            else
+                                m_gal->DrawSegment( a, b, seg->GetWidth() );
+                        };
+
+        if( !drawShapeInstance( aPad->GetPosition(), aPad->GetOrientation(), color, sketchMode,
+                                drawHole ) )
+        {
+            if( seg->GetSeg().A == seg->GetSeg().B )    // Circular hole
+                m_gal->DrawCircle( seg->GetSeg().A, seg->GetWidth()/2 );
+            else
+                m_gal->DrawSegment( seg->GetSeg().A, seg->GetSeg().B, seg->GetWidth() );
+        }
     }
     else
     {
@@ -900,18 +1018,70 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
         if( shapes && shapes->Size() == 1 && shapes->Shapes()[0]->Type() == SH_SEGMENT )
         {
             const SHAPE_SEGMENT* seg = (SHAPE_SEGMENT*) shapes->Shapes()[0];
-            m_gal->DrawSegment( seg->GetSeg().A, seg->GetSeg().B, seg->GetWidth() + 2 * margin.x );
+            const VECTOR2I       a = toPadCoords( aPad, seg->GetSeg().A );
+            const VECTOR2I       b = toPadCoords( aPad, seg->GetSeg().B );
+
+            auto drawSegment = [&]()
+                               {
+                                   m_gal->DrawSegment( a, b, seg->GetWidth() + 2 * margin.x );
+                               };
+
+            if( !drawShapeInstance( aPad->GetPosition(), aPad->GetOrientation(), color,
+                                    sketchMode, drawSegment ) )
+            {
+                m_gal->DrawSegment( seg->GetSeg().A, seg->GetSeg().B,
+                                    seg->GetWidth() + 2 * margin.x );
+            }
         }
         else if( shapes && shapes->Size() == 1 && shapes->Shapes()[0]->Type() == SH_CIRCLE )
         {
             const SHAPE_CIRCLE* circle = (SHAPE_CIRCLE*) shapes->Shapes()[0];
-            m_gal->DrawCircle( circle->GetCenter(), circle->GetRadius() + margin.x );
+            const VECTOR2I      center = toPadCoords( aPad, circle->GetCenter() );
+
+            auto drawCircle = [&]()
+                              {
+                                  m_gal->DrawCircle( center, circle->GetRadius() + margin.x );
+                              };
+
+            if( !drawShapeInstance( aPad->GetPosition(), aPad->GetOrientation(), color,
+                                    sketchMode, drawCircle ) )
+            {
+                m_gal->DrawCircle( circle->GetCenter(), circle->GetRadius() + margin.x );
+            }
         }
         else
         {
             SHAPE_POLY_SET polySet;
             aPad->TransformShapeWithClearanceToPolygon( polySet, ToLAYER_ID( aLayer ), margin.x );
-            m_gal->DrawPolygon( polySet );
+
+            auto drawPolygon = [&]()
+                               {
+                                   SHAPE_POLY_SET padPolySet = polySet;
+
+                                   for( int ii = 0; ii < padPolySet.OutlineCount(); ++ii )
+                                   {
+                                       for( int jj = -1; jj < padPolySet.HoleCount( ii ); ++jj )
+                                       {
+                                           SHAPE_LINE_CHAIN& chain =
+                                                   jj < 0 ? padPolySet.Outline( ii )
+                                                          : padPolySet.Hole( ii, jj );
+
+                                           for( int kk = 0; kk < chain.PointCount(); ++kk )
+                                           {
+                                               chain.SetPoint( kk, toPadCoords( aPad,
+                                                                        chain.CPoint( kk ) ) );
+                                           }
+                                       }
+                                   }
+
+                                   m_gal->DrawPolygon( padPolySet );
+                               };
+
+            if( !drawShapeInstance( aPad->GetPosition(), aPad->GetOrientation(), color,
+                                    sketchMode, drawPolygon ) )
+            {
+                m_gal->DrawPolygon( polySet );
+            }
         }
 
         if( aPad->GetSize() != pad_size )
@@ -1034,7 +1204,8 @@ void PCB_PAINTER::draw( const DRAWSEGMENT* aSegment, int aLayer )
         // GLU tesselation is much slower, so currently we are using our tesselation.
         if( m_gal->IsOpenGlEngine() && !shape.IsTriangulationUpToDate() )
         {
-            shape.CacheTriangulation();
+            // The copies of the painter already draw on several threads
+            shape.CacheTriangulation( true, !m_isClone );
         }
 
         m_gal->Save();
@@ -29,7 +29,9 @@
 
 #include <painter.h>
 #include <pcb_display_options.h>
+#include <gal/gal_display_options.h>
 #include <math/vector2d.h>
+#include <functional>
 #include <memory>
 
 
@@ -56,6 +58,7 @@ class NETINFO_LIST;
 namespace KIGFX
 {
 class GAL;
+class GAL_DISPLAY_LIST;
 
 /**
  * PCB_RENDER_SETTINGS
@@ -261,6 +264,7 @@ class PCB_PAINTER : public PAINTER
 {
 public:
     PCB_PAINTER( GAL* aGal );
+    virtual ~PCB_PAINTER();
 
     /// @copydoc PAINTER::ApplySettings()
     virtual void ApplySettings( const RENDER_SETTINGS* aSettings ) override
@@ -277,6 +281,9 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::Clone()
+    virtual PAINTER* Clone( GAL* aGal ) const override;
+
 protected:
     PCB_RENDER_SETTINGS m_pcbSettings;
 
@@ -318,6 +325,32 @@ protected:
      * Return drill diameter for a via (internal units).
      */
     virtual int getDrillSize( const VIA* aVia ) const;
+
+    /**
+     * Draw a shape as an instance of a template shared by all the shapes of the same geometry,
+     * when the GAL draws the instances faster than the shapes themselves (e.g. pads and vias).
+     * The fill, stroke and line width attributes are set from \a aSketch.
+     * @param aPosition is the position of the shape origin.
+     * @param aOrientation is the rotation of the shape, in decidegrees.
+     * @param aColor is the color of the shape.
+     * @param aSketch tells if the shape is drawn in outline mode.
+     * @param aDrawShape draws the shape around its origin, on m_gal.
+     * @return false if the shape has not been drawn.
+     */
+    bool drawShapeInstance( const VECTOR2D& aPosition, double aOrientation, const COLOR4D& aColor,
+                            bool aSketch, const std::function<void()>& aDrawShape );
+
+    /**
+     * @return true if drawing \a aItem evaluates the design rules to outline its clearance.
+     */
+    bool drawsClearance( const EDA_ITEM* aItem ) const;
+
+    /// Set for the copies made by Clone(), which draw from worker threads
+    bool                              m_isClone;
+
+    /// Records the shapes drawn by drawShapeInstance()
+    GAL_DISPLAY_OPTIONS               m_shapeOptions;
+    std::unique_ptr<GAL_DISPLAY_LIST> m_shapeRecorder;
 };
 } // namespace KIGFX
 
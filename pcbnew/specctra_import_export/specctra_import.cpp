@@ -332,7 +332,8 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard )
         THROW_IO_ERROR( _("Session file is missing the \"library_out\" section") );
 
     // delete all the old tracks and vias
-    aBoard->Tracks().clear();
+    aBoard->RemoveMany( std::vector<BOARD_ITEM*>( aBoard->Tracks().begin(),
+                                                  aBoard->Tracks().end() ) );
 
     aBoard->DeleteMARKERs();
 
@@ -485,6 +485,9 @@ int PCB_EDITOR_CONTROL::RepairBoard( const TOOL_EVENT& aEvent )
     {
         errors += duplicates;
         details += wxString::Format( _( "%d duplicate IDs replaced.\n" ), duplicates );
+
+        // The items are indexed by their former IDs
+        board()->RebuildItemIndex();
     }
 
     /*******************************
@@ -23,7 +23,14 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <unordered_map>
+
 #include <fctsys.h>
+#include <hash_eda.h>
 #include <reporter.h>
 #include <board_commit.h>
 #include <cleanup_item.h>
@@ -35,6 +42,42 @@
 #include <tracks_cleaner.h>
 
 
+/**
+ * The layer, width and ends of a track segment, the ends being sorted: two segments having
+ * the same key are superimposed, whichever direction they were drawn in.
+ */
+struct SEGMENT_KEY
+{
+    SEGMENT_KEY( PCB_LAYER_ID aLayer, int aWidth, const wxPoint& aEnd1, const wxPoint& aEnd2 ) :
+            m_layer( aLayer ),
+            m_width( aWidth ),
+            m_a( std::less<wxPoint>()( aEnd2, aEnd1 ) ? aEnd2 : aEnd1 ),
+            m_b( std::less<wxPoint>()( aEnd2, aEnd1 ) ? aEnd1 : aEnd2 )
+    {
+    }
+
+    bool operator==( const SEGMENT_KEY& aOther ) const
+    {
+        return m_layer == aOther.m_layer && m_width == aOther.m_width
+                && m_a == aOther.m_a && m_b == aOther.m_b;
+    }
+
+    PCB_LAYER_ID m_layer;
+    int          m_width;
+    wxPoint      m_a;
+    wxPoint      m_b;
+};
+
+
+struct SEGMENT_KEY_HASH
+{
+    size_t operator()( const SEGMENT_KEY& aKey ) const
+    {
+        return hash_val( static_cast<int>( aKey.m_layer ), aKey.m_width, aKey.m_a, aKey.m_b );
+    }
+};
+
+
 TRACKS_CLEANER::TRACKS_CLEANER( BOARD* aPcb, BOARD_COMMIT& aCommit ) :
         m_brd( aPcb ),
         m_commit( aCommit ),
@@ -158,9 +201,17 @@ void TRACKS_CLEANER::cleanupVias()
             vias.push_back( static_cast<VIA*>( track ) );
     }
 
-    for( auto via1_it = vias.begin(); via1_it != vias.end(); via1_it++ )
+    // Indices of the vias at each position, in increasing order
+    std::unordered_map<wxPoint, std::vector<size_t>> viasByPosition;
+
+    for( size_t ii = 0; ii < vias.size(); ii++ )
+        viasByPosition[ vias[ii]->GetPosition() ].push_back( ii );
+
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_brd->GetConnectivity();
+
+    for( size_t ii = 0; ii < vias.size(); ii++ )
     {
-        VIA* via1 = *via1_it;
+        VIA* via1 = vias[ii];
 
         if( via1->IsLocked() )
             continue;
@@ -172,7 +223,7 @@ void TRACKS_CLEANER::cleanupVias()
         // Examine the list of connected pads:
         // if a through pad is found, the via can be removed
 
-        const std::vector<D_PAD*> pads = m_brd->GetConnectivity()->GetConnectedPads( via1 );
+        const std::vector<D_PAD*> pads = connectivity->GetConnectedPads( via1 );
 
         for( D_PAD* pad : pads )
         {
@@ -190,11 +241,15 @@ void TRACKS_CLEANER::cleanupVias()
             }
         }
 
-        for( auto via2_it = via1_it + 1; via2_it != vias.end(); via2_it++ )
+        // Only the vias after via1 at its position are candidates
+        const std::vector<size_t>& sameVias = viasByPosition[ via1->GetPosition() ];
+
+        for( auto it = std::upper_bound( sameVias.begin(), sameVias.end(), ii );
+             it != sameVias.end(); it++ )
         {
-            VIA* via2 = *via2_it;
+            VIA* via2 = vias[*it];
 
-            if( via1->GetPosition() != via2->GetPosition() || via2->IsLocked() )
+            if( via2->IsLocked() )
                 continue;
 
             if( via1->GetViaType() == via2->GetViaType() )
@@ -332,31 +387,84 @@ void TRACKS_CLEANER::deleteTracksInPads()
     // Delete tracks that start and end on the same pad
     std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_brd->GetConnectivity();
 
+    // The pads connected to the tracks are collected first, the connectivity data is not
+    // thread safe.  Their shapes are built here too, before being shared by the threads.
+    std::vector<TRACK*>              tracks;
+    std::vector<std::vector<D_PAD*>> trackPads;
+
     for( TRACK* track : m_brd->Tracks() )
     {
         if( track->Type() == PCB_VIA_T )
             continue;
 
-        // Mark track if connected to pads
-        for( D_PAD* pad : connectivity->GetConnectedPads( track ) )
-        {
-            if( pad->HitTest( track->GetStart() ) && pad->HitTest( track->GetEnd() ) )
-            {
-                SHAPE_POLY_SET poly;
-                track->TransformShapeWithClearanceToPolygon( poly, track->GetLayer(), 0 );
+        std::vector<D_PAD*> pads = connectivity->GetConnectedPads( track );
+
+        if( pads.empty() )
+            continue;
+
+        for( D_PAD* pad : pads )
+            pad->GetEffectivePolygon();
+
+        tracks.push_back( track );
+        trackPads.push_back( std::move( pads ) );
+    }
 
-                poly.BooleanSubtract( *pad->GetEffectivePolygon(), SHAPE_POLY_SET::PM_FAST );
+    // Number of connected pads each track is fully inside of
+    std::vector<int> insidePadCounts( tracks.size(), 0 );
 
-                if( poly.IsEmpty() )
+    // We don't want to spin up a new thread for fewer than 8 tracks (overhead costs)
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+            ( tracks.size() + 7 ) / 8 );
+
+    std::atomic<size_t> nextTrack( 0 );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto test_lambda = [&nextTrack, &tracks, &trackPads, &insidePadCounts]() -> size_t
+    {
+        for( size_t i = nextTrack++; i < tracks.size(); i = nextTrack++ )
+        {
+            TRACK* track = tracks[i];
+
+            for( D_PAD* pad : trackPads[i] )
             {
-                std::shared_ptr<CLEANUP_ITEM> item( new CLEANUP_ITEM( CLEANUP_TRACK_IN_PAD ) );
-                item->SetItems( track );
-                m_itemsList->push_back( item );
+                if( pad->HitTest( track->GetStart() ) && pad->HitTest( track->GetEnd() ) )
+                {
+                    SHAPE_POLY_SET poly;
+                    track->TransformShapeWithClearanceToPolygon( poly, track->GetLayer(), 0 );
+
+                    poly.BooleanSubtract( *pad->GetEffectivePolygon(), SHAPE_POLY_SET::PM_FAST );
 
-                toRemove.insert( track );
+                    if( poly.IsEmpty() )
+                        insidePadCounts[i]++;
                 }
             }
         }
+
+        return 1;
+    };
+
+    if( parallelThreadCount <= 1 )
+        test_lambda();
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, test_lambda );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    // Report the tracks in the board order, once per pad as they were found
+    for( size_t ii = 0; ii < tracks.size(); ii++ )
+    {
+        for( int jj = 0; jj < insidePadCounts[ii]; jj++ )
+        {
+            std::shared_ptr<CLEANUP_ITEM> item( new CLEANUP_ITEM( CLEANUP_TRACK_IN_PAD ) );
+            item->SetItems( tracks[ii] );
+            m_itemsList->push_back( item );
+
+            toRemove.insert( tracks[ii] );
+        }
     }
 
     if( !m_dryRun )
@@ -373,32 +481,72 @@ void TRACKS_CLEANER::cleanupSegments()
     std::set<BOARD_ITEM*> toRemove;
 
     // Remove duplicate segments (2 superimposed identical segments):
-    for( auto it = m_brd->Tracks().begin(); it != m_brd->Tracks().end(); it++ )
+    // a segment is the duplicate of an earlier one when both its ends are ends of the earlier
+    // segment, i.e. when it has the same ends or is a point on one of them.
+    std::vector<TRACK*> tracks( m_brd->Tracks().begin(), m_brd->Tracks().end() );
+    std::unordered_map<SEGMENT_KEY, std::vector<size_t>, SEGMENT_KEY_HASH> tracksByKey;
+
+    for( size_t ii = 0; ii < tracks.size(); ii++ )
     {
-        TRACK* track1 = *it;
+        TRACK* track = tracks[ii];
+
+        tracksByKey[ SEGMENT_KEY( track->GetLayer(), track->GetWidth(), track->GetStart(),
+                                  track->GetEnd() ) ].push_back( ii );
+    }
+
+    std::vector<size_t> duplicates;
+
+    for( size_t ii = 0; ii < tracks.size(); ii++ )
+    {
+        TRACK* track1 = tracks[ii];
 
         if( track1->Type() != PCB_TRACE_T || track1->HasFlag( IS_DELETED ) || track1->IsLocked() )
             continue;
 
-        for( auto it2 = it + 1; it2 != m_brd->Tracks().end(); it2++ )
+        const wxPoint& start = track1->GetStart();
+        const wxPoint& end = track1->GetEnd();
+        PCB_LAYER_ID   layer = track1->GetLayer();
+        int            width = track1->GetWidth();
+
+        std::vector<SEGMENT_KEY> keys = { SEGMENT_KEY( layer, width, start, end ) };
+
+        if( start != end )
+        {
+            keys.emplace_back( layer, width, start, start );
+            keys.emplace_back( layer, width, end, end );
+        }
+
+        // The later tracks having one of the keys, in the board order
+        duplicates.clear();
+
+        for( const SEGMENT_KEY& key : keys )
         {
-            TRACK* track2 = *it2;
+            auto candidates = tracksByKey.find( key );
+
+            if( candidates == tracksByKey.end() )
+                continue;
+
+            duplicates.insert( duplicates.end(),
+                               std::upper_bound( candidates->second.begin(),
+                                                 candidates->second.end(), ii ),
+                               candidates->second.end() );
+        }
+
+        std::sort( duplicates.begin(), duplicates.end() );
+
+        for( size_t jj : duplicates )
+        {
+            TRACK* track2 = tracks[jj];
 
             if( track2->HasFlag( IS_DELETED ) )
                 continue;
 
-            if( track1->IsPointOnEnds( track2->GetStart() )
-                    && track1->IsPointOnEnds( track2->GetEnd() )
-                    && track1->GetWidth() == track2->GetWidth()
-                    && track1->GetLayer() == track2->GetLayer() )
-            {
-                std::shared_ptr<CLEANUP_ITEM> item( new CLEANUP_ITEM( CLEANUP_DUPLICATE_TRACK ) );
-                item->SetItems( track2 );
-                m_itemsList->push_back( item );
+            std::shared_ptr<CLEANUP_ITEM> item( new CLEANUP_ITEM( CLEANUP_DUPLICATE_TRACK ) );
+            item->SetItems( track2 );
+            m_itemsList->push_back( item );
 
-                track2->SetFlags( IS_DELETED );
-                toRemove.insert( track2 );
-            }
+            track2->SetFlags( IS_DELETED );
+            toRemove.insert( track2 );
         }
     }
 
@@ -532,9 +680,8 @@ bool TRACKS_CLEANER::mergeCollinearSegments( TRACK* aSeg1, TRACK* aSeg2 )
 
 void TRACKS_CLEANER::removeItems( std::set<BOARD_ITEM*>& aItems )
 {
-    for( auto item : aItems )
-    {
-        m_brd->Remove( item );
+    m_brd->RemoveMany( std::vector<BOARD_ITEM*>( aItems.begin(), aItems.end() ) );
+
+    for( BOARD_ITEM* item : aItems )
         m_commit.Removed( item );
-    }
 }
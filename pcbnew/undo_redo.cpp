@@ -46,6 +46,7 @@ using namespace std::placeholders;
 #include <tools/pcbnew_control.h>
 #include <tools/pcb_editor_control.h>
 #include <ws_proxy_undo_item.h>
+#include <properties_undo_item.h>
 
 /* Functions to undo and redo edit commands.
  *  commands to undo are stored in CurrentScreen->m_UndoList
@@ -181,6 +182,59 @@ static void SwapItemData( BOARD_ITEM* aItem, BOARD_ITEM* aImage )
     aItem->SetParent( parent );
 }
 
+/**
+ * @return the approximate memory used by a copy of an item stored in the undo list, in bytes.
+ */
+static size_t undoCopySize( EDA_ITEM* aCopy )
+{
+    if( PROPERTIES_UNDO_ITEM* properties = dynamic_cast<PROPERTIES_UNDO_ITEM*>( aCopy ) )
+        return properties->GetMemorySize();
+
+    switch( aCopy->Type() )
+    {
+    case PCB_MODULE_T:
+    {
+        MODULE* module = static_cast<MODULE*>( aCopy );
+        size_t  size = sizeof( MODULE ) + 2 * sizeof( TEXTE_MODULE );
+
+        size += module->Pads().size() * sizeof( D_PAD );
+        size += module->GraphicalItems().size() * sizeof( TEXTE_MODULE );
+
+        for( MODULE_ZONE_CONTAINER* zone : module->Zones() )
+            size += undoCopySize( zone );
+
+        return size;
+    }
+
+    case PCB_ZONE_AREA_T:
+    case PCB_MODULE_ZONE_AREA_T:
+    {
+        ZONE_CONTAINER* zone = static_cast<ZONE_CONTAINER*>( aCopy );
+        size_t          vertices = zone->Outline()->TotalVertices();
+
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+        {
+            if( zone->HasFilledPolysForLayer( layer ) )
+                vertices += zone->GetFilledPolysList( layer ).TotalVertices();
+        }
+
+        return sizeof( ZONE_CONTAINER ) + vertices * sizeof( VECTOR2I );
+    }
+
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+    case PCB_VIA_T:
+        return sizeof( VIA );
+
+    case PCB_TEXT_T:
+        return sizeof( TEXTE_PCB );
+
+    default:
+        return sizeof( DRAWSEGMENT );
+    }
+}
+
+
 void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( EDA_ITEM* aItem, UNDO_REDO aCommandType,
                                               const wxPoint& aTransformPoint )
 {
@@ -296,6 +350,10 @@ void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsLis
             }
             break;
 
+        case UNDO_REDO::CHANGED_PROPERTIES:
+            wxASSERT( commandToUndo->GetPickedItemLink( ii ) );
+            break;
+
         case UNDO_REDO::MOVED:
         case UNDO_REDO::ROTATED:
         case UNDO_REDO::ROTATED_CLOCKWISE:
@@ -315,6 +373,12 @@ void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsLis
         }
     }
 
+    for( unsigned ii = 0; ii < commandToUndo->GetCount(); ii++ )
+    {
+        if( EDA_ITEM* copy = commandToUndo->GetPickedItemLink( ii ) )
+            commandToUndo->m_MemorySize += undoCopySize( copy );
+    }
+
     if( commandToUndo->GetCount() )
     {
         /* Save the copy in undo list */
@@ -484,6 +548,22 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
         }
         break;
 
+        case UNDO_REDO::CHANGED_PROPERTIES:    /* Exchange old and new property values */
+        {
+            PROPERTIES_UNDO_ITEM* properties =
+                    static_cast<PROPERTIES_UNDO_ITEM*>( aList->GetPickedItemLink( ii ) );
+            BOARD_ITEM* item = static_cast<BOARD_ITEM*>( properties->FindItem( eda_item ) );
+
+            wxCHECK2( item, break );
+
+            properties->Swap( item );
+
+            view->Update( item );
+            connectivity->Update( item );
+            item->GetBoard()->OnItemChanged( item );
+        }
+        break;
+
         case UNDO_REDO::NEWITEM:        /* new items are deleted */
             aList->SetPickedItemStatus( UNDO_REDO::DELETED, ii );
             GetModel()->Remove( (BOARD_ITEM*) eda_item );
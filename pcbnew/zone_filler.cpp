@@ -40,6 +40,7 @@
 #include <convert_basic_shapes_to_polygon.h>
 #include <board_commit.h>
 #include <widgets/progress_reporter.h>
+#include <geometry/poly_set_pipeline.h>
 #include <geometry/shape_poly_set.h>
 #include <geometry/shape_file_io.h>
 #include <geometry/convex_hull.h>
@@ -370,10 +371,10 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck,
 
             for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
             {
-                MD5_HASH was = zone->GetHashValue( layer );
+                uint64_t was = zone->GetHashValue( layer );
                 zone->CacheTriangulation( layer );
                 zone->BuildHashValue( layer );
-                MD5_HASH is = zone->GetHashValue( layer );
+                uint64_t is = zone->GetHashValue( layer );
 
                 if( is != was )
                     outOfDate = true;
@@ -408,7 +409,8 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck,
 
                 for( size_t i = nextItem++; i < islandsList.size(); i = nextItem++ )
                 {
-                    islandsList[i].m_zone->CacheTriangulation();
+                    // Each thread triangulates its own zones
+                    islandsList[i].m_zone->CacheTriangulation( UNDEFINED_LAYER, false );
                     num++;
 
                     if( m_progressReporter )
@@ -911,16 +913,20 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone, PCB_LAYER_I
     // Create a temporary zone that we can hit-test spoke-ends against.  It's only temporary
     // because the "real" subtract-clearance-holes has to be done after the spokes are added.
     static const bool USE_BBOX_CACHES = true;
-    SHAPE_POLY_SET testAreas = aRawPolys;
-    testAreas.BooleanSubtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
+    SHAPE_POLY_SET    testAreas;
+    POLY_SET_PIPELINE testAreasPipeline( aRawPolys );
+
+    testAreasPipeline.Subtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
 
     // Prune features that don't meet minimum-width criteria
     if( half_min_width - epsilon > epsilon )
     {
-        testAreas.Deflate( half_min_width - epsilon, numSegs, cornerStrategy );
-        testAreas.Inflate( half_min_width - epsilon, numSegs, cornerStrategy );
+        testAreasPipeline.Deflate( half_min_width - epsilon, numSegs, cornerStrategy );
+        testAreasPipeline.Inflate( half_min_width - epsilon, numSegs, cornerStrategy );
     }
 
+    testAreasPipeline.GetResult( testAreas );
+
     if( m_progressReporter && m_progressReporter->IsCancelled() )
         return;
 
@@ -968,24 +974,35 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone, PCB_LAYER_I
     if( m_progressReporter && m_progressReporter->IsCancelled() )
         return;
 
-    aRawPolys.BooleanSubtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
+    // The following operations are chained in the Clipper format, the polygons are only
+    // built when the hatching or the dump needs them
+    POLY_SET_PIPELINE solidAreas( aRawPolys );
+
+    solidAreas.Subtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
 
     // Prune features that don't meet minimum-width criteria
     if( half_min_width - epsilon > epsilon )
-        aRawPolys.Deflate( half_min_width - epsilon, numSegs, cornerStrategy );
+        solidAreas.Deflate( half_min_width - epsilon, numSegs, cornerStrategy );
 
-    if( s_DumpZonesWhenFilling )
-        dumper->Write( &aRawPolys, "solid-areas-before-hatching" );
+    if( s_DumpZonesWhenFilling || aZone->GetFillMode() == ZONE_FILL_MODE::HATCH_PATTERN )
+    {
+        solidAreas.GetResult( aRawPolys );
 
-    if( m_progressReporter && m_progressReporter->IsCancelled() )
-        return;
+        if( s_DumpZonesWhenFilling )
+            dumper->Write( &aRawPolys, "solid-areas-before-hatching" );
 
-    // Now remove the non filled areas due to the hatch pattern
-    if( aZone->GetFillMode() == ZONE_FILL_MODE::HATCH_PATTERN )
-        addHatchFillTypeOnZone( aZone, aLayer, aRawPolys );
+        if( m_progressReporter && m_progressReporter->IsCancelled() )
+            return;
 
-    if( s_DumpZonesWhenFilling )
-        dumper->Write( &aRawPolys, "solid-areas-after-hatching" );
+        // Now remove the non filled areas due to the hatch pattern
+        if( aZone->GetFillMode() == ZONE_FILL_MODE::HATCH_PATTERN )
+            addHatchFillTypeOnZone( aZone, aLayer, aRawPolys );
+
+        if( s_DumpZonesWhenFilling )
+            dumper->Write( &aRawPolys, "solid-areas-after-hatching" );
+
+        solidAreas.Reset( aRawPolys );
+    }
 
     if( m_progressReporter && m_progressReporter->IsCancelled() )
         return;
@@ -998,15 +1015,15 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone, PCB_LAYER_I
     }
     else if( half_min_width - epsilon > epsilon )
     {
-        aRawPolys.Inflate( half_min_width - epsilon, numSegs, cornerStrategy );
+        solidAreas.Inflate( half_min_width - epsilon, numSegs, cornerStrategy );
     }
 
     // Ensure additive changes (thermal stubs and particularly inflating acute corners) do not
     // add copper outside the zone boundary or inside the clearance holes
-    aRawPolys.BooleanIntersection( aSmoothedOutline, SHAPE_POLY_SET::PM_FAST );
-    aRawPolys.BooleanSubtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
+    solidAreas.Intersect( aSmoothedOutline, SHAPE_POLY_SET::PM_FAST );
+    solidAreas.Subtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
 
-    aRawPolys.Fracture( SHAPE_POLY_SET::PM_FAST );
+    solidAreas.GetFracturedResult( aRawPolys, SHAPE_POLY_SET::PM_FAST );
 
     if( s_DumpZonesWhenFilling )
         dumper->Write( &aRawPolys, "areas_fractured" );
@@ -0,0 +1,227 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <gal/gal_display_list.h>
+#include <gal/gal_display_options.h>
+
+
+// All these tests are of a class in KIGFX
+using namespace KIGFX;
+
+
+/**
+ * A GAL collecting the circles and segments it draws, in world coordinates.
+ */
+class RECORDING_GAL : public GAL
+{
+public:
+    struct SHAPE
+    {
+        VECTOR2D m_a;
+        VECTOR2D m_b;
+        double   m_size;        ///< Radius or width
+        COLOR4D  m_color;
+    };
+
+    RECORDING_GAL( GAL_DISPLAY_OPTIONS& aOptions ) : GAL( aOptions ), m_angle( 0.0 )
+    {
+    }
+
+    void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override
+    {
+        m_shapes.push_back( { toWorld( aCenterPoint ), toWorld( aCenterPoint ), aRadius,
+                              fillColor } );
+    }
+
+    void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                      double aWidth ) override
+    {
+        m_shapes.push_back( { toWorld( aStartPoint ), toWorld( aEndPoint ), aWidth,
+                              fillColor } );
+    }
+
+    void Rotate( double aAngle ) override
+    {
+        m_angle += aAngle;
+    }
+
+    void Translate( const VECTOR2D& aTranslation ) override
+    {
+        m_origin += aTranslation.Rotate( m_angle );
+    }
+
+    void Save() override
+    {
+        m_stack.emplace_back( m_origin, m_angle );
+    }
+
+    void Restore() override
+    {
+        m_origin = m_stack.back().first;
+        m_angle = m_stack.back().second;
+        m_stack.pop_back();
+    }
+
+    std::vector<SHAPE> m_shapes;
+
+private:
+    VECTOR2D toWorld( const VECTOR2D& aPoint ) const
+    {
+        return m_origin + aPoint.Rotate( m_angle );
+    }
+
+    VECTOR2D                                   m_origin;
+    double                                     m_angle;
+    std::vector<std::pair<VECTOR2D, double>>   m_stack;
+};
+
+
+static void checkPoint( const VECTOR2D& aPoint, const VECTOR2D& aExpected )
+{
+    BOOST_CHECK_SMALL( ( aPoint - aExpected ).EuclideanNorm(), 1e-9 );
+}
+
+
+struct SHAPE_INSTANCING_FIXTURE
+{
+    SHAPE_INSTANCING_FIXTURE() : m_gal( m_options ), m_shapes( m_options )
+    {
+    }
+
+    /// Record a pad-like shape: a segment along X with a circle above it
+    int recordShape( const COLOR4D& aColor, double aRadius )
+    {
+        m_shapes.SetIsFill( true );
+        m_shapes.SetIsStroke( false );
+        m_shapes.SetFillColor( aColor );
+
+        int entry = m_shapes.BeginEntry();
+        m_shapes.DrawSegment( VECTOR2D( -1, 0 ), VECTOR2D( 1, 0 ), 0.5 );
+        m_shapes.DrawCircle( VECTOR2D( 0, 1 ), aRadius );
+        BOOST_REQUIRE( m_shapes.EndEntry() );
+
+        return entry;
+    }
+
+    GAL_DISPLAY_OPTIONS m_options;
+    RECORDING_GAL       m_gal;
+    GAL_DISPLAY_LIST    m_shapes;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ShapeInstancing, SHAPE_INSTANCING_FIXTURE )
+
+
+/**
+ * An instance draws the template moved and rotated, in the instance color
+ */
+BOOST_AUTO_TEST_CASE( InstanceGeometry )
+{
+    int shapeTemplate = m_gal.GetShapeTemplate( m_shapes, recordShape( COLOR4D::WHITE, 0.2 ) );
+
+    m_gal.DrawShapeInstance( shapeTemplate, VECTOR2D( 10, 5 ), M_PI / 2, COLOR4D( RED ) );
+
+    BOOST_REQUIRE_EQUAL( m_gal.m_shapes.size(), 2u );
+
+    const RECORDING_GAL::SHAPE& segment = m_gal.m_shapes[0];
+    checkPoint( segment.m_a, VECTOR2D( 10, 4 ) );
+    checkPoint( segment.m_b, VECTOR2D( 10, 6 ) );
+    BOOST_CHECK_EQUAL( segment.m_size, 0.5 );
+    BOOST_CHECK_EQUAL( segment.m_color, COLOR4D( RED ) );
+
+    const RECORDING_GAL::SHAPE& circle = m_gal.m_shapes[1];
+    checkPoint( circle.m_a, VECTOR2D( 9, 5 ) );
+    BOOST_CHECK_EQUAL( circle.m_size, 0.2 );
+    BOOST_CHECK_EQUAL( circle.m_color, COLOR4D( RED ) );
+}
+
+
+/**
+ * The templates are shared by the shapes of the same geometry, whatever their color
+ */
+BOOST_AUTO_TEST_CASE( TemplateSharing )
+{
+    int first = m_gal.GetShapeTemplate( m_shapes, recordShape( COLOR4D::WHITE, 0.2 ) );
+    int sameGeometry = m_gal.GetShapeTemplate( m_shapes, recordShape( COLOR4D( RED ), 0.2 ) );
+    int otherGeometry = m_gal.GetShapeTemplate( m_shapes, recordShape( COLOR4D::WHITE, 0.3 ) );
+
+    BOOST_CHECK_EQUAL( first, sameGeometry );
+    BOOST_CHECK_NE( first, otherGeometry );
+
+    // The templates are copies, the shapes may be discarded
+    m_shapes.Clear();
+
+    BOOST_CHECK_EQUAL( m_gal.GetShapeTemplate( m_shapes, recordShape( COLOR4D( RED ), 0.3 ) ),
+                       otherGeometry );
+}
+
+
+/**
+ * Drawing an instance does not change the attributes of the GAL
+ */
+BOOST_AUTO_TEST_CASE( InstanceAttributes )
+{
+    int shapeTemplate = m_gal.GetShapeTemplate( m_shapes, recordShape( COLOR4D::WHITE, 0.2 ) );
+
+    m_gal.SetFillColor( COLOR4D( GREEN ) );
+    m_gal.SetStrokeColor( COLOR4D( BLUE ) );
+    m_gal.SetLineWidth( 3.0 );
+
+    m_gal.DrawShapeInstance( shapeTemplate, VECTOR2D( 0, 0 ), 0.0, COLOR4D( RED ) );
+
+    BOOST_CHECK_EQUAL( m_gal.GetFillColor(), COLOR4D( GREEN ) );
+    BOOST_CHECK_EQUAL( m_gal.GetStrokeColor(), COLOR4D( BLUE ) );
+    BOOST_CHECK_EQUAL( m_gal.GetLineWidth(), 3.0 );
+}
+
+
+/**
+ * An instance recorded in a display list refers to the templates of the display list, it is
+ * drawn with the matching template of the GAL it is replayed on
+ */
+BOOST_AUTO_TEST_CASE( ReplayedInstance )
+{
+    GAL_DISPLAY_LIST items( m_options );
+
+    int shapeTemplate = items.GetShapeTemplate( m_shapes, recordShape( COLOR4D::WHITE, 0.2 ) );
+    int entry = items.BeginEntry();
+    items.DrawShapeInstance( shapeTemplate, VECTOR2D( -3, 2 ), M_PI, COLOR4D( GREEN ) );
+    BOOST_REQUIRE( items.EndEntry() );
+
+    items.Replay( entry, &m_gal );
+
+    BOOST_REQUIRE_EQUAL( m_gal.m_shapes.size(), 2u );
+    checkPoint( m_gal.m_shapes[0].m_a, VECTOR2D( -2, 2 ) );
+    checkPoint( m_gal.m_shapes[0].m_b, VECTOR2D( -4, 2 ) );
+    checkPoint( m_gal.m_shapes[1].m_a, VECTOR2D( -3, 1 ) );
+    BOOST_CHECK_EQUAL( m_gal.m_shapes[1].m_color, COLOR4D( GREEN ) );
+
+    // The GAL now owns a template of the same geometry
+    BOOST_CHECK_EQUAL( m_gal.GetShapeTemplate( m_shapes, recordShape( COLOR4D::WHITE, 0.2 ) ),
+                       0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,152 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the cached text shapes of EDA_TEXT
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <eda_text.h>
+
+#include <geometry/shape_poly_set.h>
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_AUTO_TEST_SUITE( EdaTextShapes )
+
+
+static std::vector<wxPoint> textSegments( const EDA_TEXT& aText )
+{
+    std::vector<wxPoint> segments;
+    aText.TransformTextShapeToSegmentList( segments );
+    return segments;
+}
+
+
+/**
+ * The cached segments follow the text edits
+ */
+BOOST_AUTO_TEST_CASE( SegmentsFollowEdits )
+{
+    EDA_TEXT text( "AB" );
+
+    const std::vector<wxPoint> initial = textSegments( text );
+
+    BOOST_REQUIRE( !initial.empty() );
+    BOOST_CHECK( textSegments( text ) == initial );
+
+    const wxPoint offset( 1000, -500 );
+    text.Offset( offset );
+
+    std::vector<wxPoint> moved = textSegments( text );
+
+    BOOST_REQUIRE_EQUAL( moved.size(), initial.size() );
+
+    for( size_t ii = 0; ii < moved.size(); ++ii )
+        BOOST_CHECK_EQUAL( moved[ii], initial[ii] + offset );
+
+    text.SetText( "ABC" );
+    BOOST_CHECK_GT( textSegments( text ).size(), initial.size() );
+
+    text.SetText( "AB" );
+    text.SetItalic( true );
+    BOOST_CHECK( textSegments( text ) != moved );
+}
+
+
+/**
+ * A copy of a text draws the same shape
+ */
+BOOST_AUTO_TEST_CASE( CopiedText )
+{
+    EDA_TEXT text( "Copy" );
+    const std::vector<wxPoint> segments = textSegments( text );
+
+    EDA_TEXT copy( text );
+    BOOST_CHECK( textSegments( copy ) == segments );
+
+    EDA_TEXT assigned;
+    assigned = text;
+    BOOST_CHECK( textSegments( assigned ) == segments );
+}
+
+
+/**
+ * The polygons are built again when the clearance changes
+ */
+BOOST_AUTO_TEST_CASE( PolygonClearance )
+{
+    EDA_TEXT       text( "W" );
+    SHAPE_POLY_SET tight;
+    SHAPE_POLY_SET loose;
+    SHAPE_POLY_SET again;
+
+    text.TransformTextShapeWithClearanceToPolygon( tight, 0, 100, 0.0, 0 );
+    text.TransformTextShapeWithClearanceToPolygon( loose, 1000, 100, 0.0, 0 );
+    text.TransformTextShapeWithClearanceToPolygon( again, 0, 100, 0.0, 0 );
+
+    BOOST_REQUIRE_GT( tight.OutlineCount(), 0 );
+    BOOST_CHECK_EQUAL( loose.OutlineCount(), tight.OutlineCount() );
+    BOOST_CHECK_GT( loose.BBox().GetWidth(), tight.BBox().GetWidth() );
+
+    BOOST_CHECK_EQUAL( again.OutlineCount(), tight.OutlineCount() );
+    BOOST_CHECK_EQUAL( again.TotalVertices(), tight.TotalVertices() );
+    BOOST_CHECK( again.BBox() == tight.BBox() );
+}
+
+
+/**
+ * Alternating pen widths give the shape of each width, as built from scratch
+ */
+BOOST_AUTO_TEST_CASE( AlternatePenWidths )
+{
+    EDA_TEXT text( "Width" );
+    EDA_TEXT reference( text );
+
+    std::vector<wxPoint> bold;
+    std::vector<wxPoint> thin;
+    std::vector<wxPoint> expectedThin;
+
+    text.TransformTextShapeToSegmentList( bold, 0.0, 0 );
+    text.TransformTextShapeToSegmentList( thin, 0.0, 10 );
+    reference.TransformTextShapeToSegmentList( expectedThin, 0.0, 10 );
+
+    BOOST_CHECK( thin == expectedThin );
+
+    std::vector<wxPoint> boldAgain;
+    std::vector<wxPoint> thinAgain;
+
+    text.TransformTextShapeToSegmentList( boldAgain, 0.0, 0 );
+    text.TransformTextShapeToSegmentList( thinAgain, 0.0, 10 );
+
+    BOOST_CHECK( boldAgain == bold );
+    BOOST_CHECK( thinAgain == thin );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,155 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file
+ * Test suite for PROPERTIES_UNDO_ITEM
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <properties_undo_item.h>
+
+#include <property_mgr.h>
+
+
+class UNDO_TEST_ITEM : public EDA_ITEM
+{
+public:
+    UNDO_TEST_ITEM() :
+            EDA_ITEM( NOT_USED ),
+            m_width( 0 ),
+            m_visible( true )
+    {
+    }
+
+    void SetWidth( int aWidth ) { m_width = aWidth; }
+    int GetWidth() const { return m_width; }
+
+    void SetName( const wxString& aName ) { m_name = aName; }
+    const wxString& GetName() const { return m_name; }
+
+    void SetVisible( bool aVisible ) { m_visible = aVisible; }
+    bool IsVisible() const { return m_visible; }
+
+    wxString GetClass() const override { return wxT( "UNDO_TEST_ITEM" ); }
+
+#if defined(DEBUG)
+    void Show( int x, std::ostream& st ) const override { }
+#endif
+
+private:
+    int      m_width;
+    wxString m_name;
+    bool     m_visible;
+};
+
+
+static struct UNDO_TEST_ITEM_DESC
+{
+    UNDO_TEST_ITEM_DESC()
+    {
+        PROPERTY_MANAGER& propMgr = PROPERTY_MANAGER::Instance();
+        REGISTER_TYPE( UNDO_TEST_ITEM );
+        propMgr.InheritsAfter( TYPE_HASH( UNDO_TEST_ITEM ), TYPE_HASH( EDA_ITEM ) );
+        propMgr.AddProperty( new PROPERTY<UNDO_TEST_ITEM, int>( "Width",
+                    &UNDO_TEST_ITEM::SetWidth, &UNDO_TEST_ITEM::GetWidth ) );
+        propMgr.AddProperty( new PROPERTY<UNDO_TEST_ITEM, wxString>( "Name",
+                    &UNDO_TEST_ITEM::SetName, &UNDO_TEST_ITEM::GetName ) );
+        propMgr.AddProperty( new PROPERTY<UNDO_TEST_ITEM, bool>( "Visible",
+                    &UNDO_TEST_ITEM::SetVisible, &UNDO_TEST_ITEM::IsVisible ) );
+    }
+} _UNDO_TEST_ITEM_DESC;
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_AUTO_TEST_SUITE( PropertiesUndoItem )
+
+
+/**
+ * Only the changed values are kept, and swapping them undoes then redoes the changes
+ */
+BOOST_AUTO_TEST_CASE( ReduceAndSwap )
+{
+    PROPERTY_MANAGER::Instance().Rebuild();
+
+    UNDO_TEST_ITEM item;
+    item.SetWidth( 10 );
+    item.SetName( wxT( "before" ) );
+
+    PROPERTIES_UNDO_ITEM undo( &item );
+    size_t               fullSize = undo.GetMemorySize();
+
+    item.SetWidth( 20 );
+    item.SetName( wxT( "after" ) );
+    undo.Reduce( &item );
+
+    BOOST_CHECK( !undo.IsEmpty() );
+    BOOST_CHECK_LT( undo.GetMemorySize(), fullSize );
+
+    undo.Swap( &item );
+    BOOST_CHECK_EQUAL( item.GetWidth(), 10 );
+    BOOST_CHECK( item.GetName() == wxT( "before" ) );
+    BOOST_CHECK( item.IsVisible() );
+
+    undo.Swap( &item );
+    BOOST_CHECK_EQUAL( item.GetWidth(), 20 );
+    BOOST_CHECK( item.GetName() == wxT( "after" ) );
+    BOOST_CHECK( item.IsVisible() );
+}
+
+
+/**
+ * An unchanged item leaves nothing to store
+ */
+BOOST_AUTO_TEST_CASE( NoChange )
+{
+    UNDO_TEST_ITEM item;
+
+    PROPERTIES_UNDO_ITEM undo( &item );
+    undo.Reduce( &item );
+
+    BOOST_CHECK( undo.IsEmpty() );
+}
+
+
+/**
+ * The item is found by its KIID, not by its address
+ */
+BOOST_AUTO_TEST_CASE( FindItem )
+{
+    UNDO_TEST_ITEM item;
+    UNDO_TEST_ITEM other;
+
+    PROPERTIES_UNDO_ITEM undo( &item );
+
+    BOOST_CHECK_EQUAL( undo.FindItem( &item ), &item );
+    BOOST_CHECK( undo.FindItem( &other ) == nullptr );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
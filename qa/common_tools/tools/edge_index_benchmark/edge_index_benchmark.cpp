@@ -0,0 +1,180 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file edge_index_benchmark.cpp
+ * Compare the distance and collision queries of large polygon sets and line chains with
+ * and without their edge index (SHAPE_EDGE_INDEX).
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include <wx/string.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+using CLOCK = std::chrono::steady_clock;
+using TIME_PT = std::chrono::time_point<CLOCK>;
+
+
+/**
+ * A closed chain approximating a circle with a wavy radius, like a zone fill outline
+ */
+static SHAPE_LINE_CHAIN buildWavyCircle( const VECTOR2I& aCenter, int aRadius, int aPointCount )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    for( int i = 0; i < aPointCount; i++ )
+    {
+        double angle = 2 * M_PI * i / aPointCount;
+        double radius = aRadius * ( 1.0 + 0.1 * std::sin( 64 * angle ) );
+
+        chain.Append( aCenter.x + KiROUND( radius * std::cos( angle ) ),
+                      aCenter.y + KiROUND( radius * std::sin( angle ) ) );
+    }
+
+    chain.SetClosed( true );
+
+    return chain;
+}
+
+
+static void printReport( const wxString& aName, unsigned aQueries, SEG::ecoord aChecksum,
+                         std::chrono::microseconds aDuration )
+{
+    std::cout << wxString::Format( "%-28s %u queries in %lld us (checksum %lld)", aName,
+                                   aQueries, (long long) aDuration.count(),
+                                   (long long) aChecksum )
+              << std::endl;
+}
+
+
+int edge_index_benchmark_func( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc > 3 )
+    {
+        os << "Usage: " << argv[0] << " [VERTICES] [QUERIES]\n\n";
+        os << "  VERTICES is the number of vertices of the polygon (default 100000),\n";
+        os << "  QUERIES the number of distance queries (default 10000).\n";
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long vertices = 100000;
+    long queries = 10000;
+
+    if( argc > 1 )
+        wxString( argv[1] ).ToLong( &vertices );
+
+    if( argc > 2 )
+        wxString( argv[2] ).ToLong( &queries );
+
+    const int      radius = 100000000;     // 100 mm
+    SHAPE_POLY_SET polyset;
+
+    polyset.AddOutline( buildWavyCircle( { 0, 0 }, radius, vertices ) );
+    polyset.AddHole( buildWavyCircle( { 0, 0 }, radius / 2, vertices / 2 ) );
+
+    std::mt19937                       rng( 1 );
+    std::uniform_int_distribution<int> coord( -radius * 3 / 2, radius * 3 / 2 );
+    std::vector<SEG>                   segs;
+
+    for( long i = 0; i < queries; i++ )
+    {
+        VECTOR2I p( coord( rng ), coord( rng ) );
+        segs.emplace_back( p, p + VECTOR2I( 200000, 100000 ) );
+    }
+
+    os << "Edge index benchmark" << std::endl;
+    os << "  Polygon vertices: " << polyset.TotalVertices() << std::endl;
+    os << "  Queries:          " << queries << std::endl;
+    os << std::endl;
+
+    using std::chrono::microseconds;
+    using std::chrono::duration_cast;
+
+    // Without index: SquaredDistanceToPolygon() visits all the edges of the polygon
+    SEG::ecoord linearSum = 0;
+    TIME_PT     start = CLOCK::now();
+
+    for( const SEG& seg : segs )
+        linearSum += polyset.SquaredDistanceToPolygon( seg, 0 ) > 0;
+
+    microseconds linearDur = duration_cast<microseconds>( CLOCK::now() - start );
+    printReport( "Polygon, linear", queries, linearSum, linearDur );
+
+    // With index: built by the first queries
+    SEG::ecoord indexedSum = 0;
+    start = CLOCK::now();
+
+    for( const SEG& seg : segs )
+        indexedSum += polyset.SquaredDistance( seg ) > 0;
+
+    microseconds indexedDur = duration_cast<microseconds>( CLOCK::now() - start );
+    printReport( "Polygon, indexed", queries, indexedSum, indexedDur );
+
+    if( indexedSum != linearSum )
+        os << "Results differ!" << std::endl;
+
+    if( indexedDur.count() > 0 )
+    {
+        os << wxString::Format( "Speedup: %.1fx",
+                                (double) linearDur.count() / indexedDur.count() )
+           << std::endl;
+    }
+
+    os << std::endl;
+
+    // Line chain collisions: the chains are indexed by each call
+    const SHAPE_LINE_CHAIN& outline = polyset.COutline( 0 );
+    const SHAPE&            outlineShape = outline;
+    SHAPE_LINE_CHAIN        other = buildWavyCircle( { 2 * radius + 1000000, 0 }, radius,
+                                                     std::max( 1L, vertices / 10 ) );
+    int                     actual = 0;
+
+    start = CLOCK::now();
+    bool collide = outlineShape.Collide( &other, 1000000, &actual );
+
+    os << wxString::Format( "Chain collision (%d x %d segments): %s, distance %d in %lld us",
+                            outline.SegmentCount(), other.SegmentCount(),
+                            collide ? "collide" : "clear", actual,
+                            (long long) duration_cast<microseconds>( CLOCK::now()
+                                                                     - start ).count() )
+       << std::endl;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "edge_index_benchmark",
+        "Benchmark the edge index of polygon sets and line chains",
+        edge_index_benchmark_func,
+} );
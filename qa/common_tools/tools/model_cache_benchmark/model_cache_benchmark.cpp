@@ -0,0 +1,233 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file model_cache_benchmark.cpp
+ * Compare the load time of the 3D models from the scene graph cache files (.3dc)
+ * and from the render data cache files (.3dm).
+ */
+
+#include <wx/dir.h>
+#include <wx/filename.h>
+
+#include <chrono>
+#include <iostream>
+
+#include <plugins/3dapi/ifsg_api.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+using CLOCK = std::chrono::steady_clock;
+using TIME_PT = std::chrono::time_point<CLOCK>;
+
+
+struct MODEL_CACHE_BENCH_REPORT
+{
+    unsigned models;    ///< Number of models read
+    unsigned meshes;    ///< Number of meshes, to check the same models are read
+    unsigned vertices;  ///< Number of vertices, to check the same models are read
+
+    std::chrono::milliseconds benchDurMs;
+};
+
+
+static void accumulate( const S3DMODEL& aModel, MODEL_CACHE_BENCH_REPORT& aReport )
+{
+    aReport.models++;
+    aReport.meshes += aModel.m_MeshesSize;
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+        aReport.vertices += aModel.m_Meshes[i].m_VertexSize;
+}
+
+
+/**
+ * Read the scene graph cache files and convert them to render data,
+ * as done by S3D_CACHE without render data cache
+ */
+static void bench_scene_cache( const wxArrayString& aFiles, int aReps,
+                               MODEL_CACHE_BENCH_REPORT& aReport )
+{
+    for( int i = 0; i < aReps; ++i )
+    {
+        for( const wxString& file : aFiles )
+        {
+            SGNODE* scene = S3D::ReadCache( file.ToUTF8(), nullptr, nullptr );
+
+            if( !scene )
+                continue;
+
+            S3DMODEL* model = S3D::GetModel( (SCENEGRAPH*) scene );
+
+            if( model )
+                accumulate( *model, aReport );
+
+            S3D::Destroy3DModel( &model );
+            S3D::DestroyNode( scene );
+        }
+    }
+}
+
+
+/**
+ * Read the render data cache files
+ */
+static void bench_model_cache( const wxArrayString& aFiles, int aReps,
+                               MODEL_CACHE_BENCH_REPORT& aReport )
+{
+    for( int i = 0; i < aReps; ++i )
+    {
+        for( const wxString& file : aFiles )
+        {
+            S3DMODEL* model = S3D::ReadModelCache( file.ToUTF8(), nullptr, nullptr );
+
+            if( model )
+                accumulate( *model, aReport );
+
+            S3D::Destroy3DModel( &model );
+        }
+    }
+}
+
+
+/**
+ * Write the render data cache files of the scene graph cache files to
+ * a temporary directory
+ */
+static wxArrayString createModelCacheFiles( const wxArrayString& aSceneFiles,
+                                            const wxString& aDir )
+{
+    wxArrayString modelFiles;
+
+    for( const wxString& file : aSceneFiles )
+    {
+        SGNODE* scene = S3D::ReadCache( file.ToUTF8(), nullptr, nullptr );
+
+        if( !scene )
+            continue;
+
+        S3DMODEL* model = S3D::GetModel( (SCENEGRAPH*) scene );
+
+        if( model )
+        {
+            wxFileName fn( aDir, wxFileName( file ).GetName(), wxT( "3dm" ) );
+
+            if( S3D::WriteModelCache( fn.GetFullPath().ToUTF8(), *model, nullptr ) )
+                modelFiles.Add( fn.GetFullPath() );
+        }
+
+        S3D::Destroy3DModel( &model );
+        S3D::DestroyNode( scene );
+    }
+
+    return modelFiles;
+}
+
+
+static void printReport( const wxString& aName, const MODEL_CACHE_BENCH_REPORT& aReport )
+{
+    std::cout << wxString::Format( "%-24s %u models, %u meshes, %u vertices in %u ms",
+                                   aName, aReport.models, aReport.meshes, aReport.vertices,
+                                   (unsigned) aReport.benchDurMs.count() )
+              << std::endl;
+}
+
+
+int model_cache_benchmark_func( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 2 )
+    {
+        os << "Usage: " << argv[0] << " <CACHE_DIR> [REPS]\n\n";
+        os << "  CACHE_DIR is a 3D model cache directory holding .3dc files,\n";
+        os << "  for instance ~/.cache/kicad/3d after opening boards in the 3D viewer.\n";
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    wxString cacheDir = wxString::FromUTF8( argv[1] );
+    long     reps = 1;
+
+    if( argc > 2 )
+        wxString( argv[2] ).ToLong( &reps );
+
+    wxArrayString sceneFiles;
+    wxDir::GetAllFiles( cacheDir, &sceneFiles, wxT( "*.3dc" ), wxDIR_FILES );
+
+    if( sceneFiles.empty() )
+    {
+        os << "No .3dc file in " << cacheDir << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    wxFileName tmpDir( wxFileName::CreateTempFileName( wxT( "kicad_3dm" ) ) );
+    wxRemoveFile( tmpDir.GetFullPath() );
+    wxFileName::Mkdir( tmpDir.GetFullPath() );
+
+    wxArrayString modelFiles = createModelCacheFiles( sceneFiles, tmpDir.GetFullPath() );
+
+    os << "3D model cache benchmark" << std::endl;
+    os << "  Cache directory: " << cacheDir << std::endl;
+    os << "  Models:          " << sceneFiles.size() << std::endl;
+    os << "  Repetitions:     " << (int) reps << std::endl;
+    os << std::endl;
+
+    using std::chrono::milliseconds;
+    using std::chrono::duration_cast;
+
+    MODEL_CACHE_BENCH_REPORT sceneReport = {};
+    TIME_PT                  start = CLOCK::now();
+
+    bench_scene_cache( sceneFiles, reps, sceneReport );
+    sceneReport.benchDurMs = duration_cast<milliseconds>( CLOCK::now() - start );
+    printReport( ".3dc + S3D::GetModel", sceneReport );
+
+    MODEL_CACHE_BENCH_REPORT modelReport = {};
+    start = CLOCK::now();
+
+    bench_model_cache( modelFiles, reps, modelReport );
+    modelReport.benchDurMs = duration_cast<milliseconds>( CLOCK::now() - start );
+    printReport( ".3dm", modelReport );
+
+    if( modelReport.benchDurMs.count() > 0 )
+    {
+        os << wxString::Format( "Speedup: %.1fx",
+                                (double) sceneReport.benchDurMs.count()
+                                        / modelReport.benchDurMs.count() )
+           << std::endl;
+    }
+
+    for( const wxString& file : modelFiles )
+        wxRemoveFile( file );
+
+    wxFileName::Rmdir( tmpDir.GetFullPath() );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "model_cache_benchmark",
+        "Benchmark the 3D model cache file formats",
+        model_cache_benchmark_func,
+} );
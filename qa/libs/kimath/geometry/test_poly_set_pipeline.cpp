@@ -0,0 +1,193 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for POLY_SET_PIPELINE: the chained operations must give the same polygons as
+ * the SHAPE_POLY_SET methods applied one after the other.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/poly_set_pipeline.h>
+#include <geometry/shape_poly_set.h>
+
+#include <qa_utils/geometry/poly_set_construction.h>
+
+#include <cmath>
+
+
+BOOST_AUTO_TEST_SUITE( PolySetPipeline )
+
+
+/**
+ * A 10 mm square with a 4 mm square hole, and a second square overlapping it
+ */
+static SHAPE_POLY_SET buildSubject()
+{
+    namespace KT = KI_TEST;
+
+    SHAPE_POLY_SET set = KT::BuildPolyset( {
+            KT::BuildSquareChain( 10000000 ),
+            KT::BuildSquareChain( 6000000, { 6000000, 6000000 } ),
+    } );
+
+    set.AddHole( KT::BuildSquareChain( 4000000 ), 0 );
+
+    return set;
+}
+
+
+/**
+ * A row of small squares, crossing the subject
+ */
+static SHAPE_POLY_SET buildHoles()
+{
+    SHAPE_POLY_SET holes;
+
+    for( int ii = -5; ii <= 5; ii++ )
+        holes.AddOutline( KI_TEST::BuildSquareChain( 1000000, { ii * 2000000, 3000000 } ) );
+
+    return holes;
+}
+
+
+static double area( const SHAPE_POLY_SET& aSet )
+{
+    double area = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+    {
+        area += std::abs( aSet.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < aSet.HoleCount( ii ); jj++ )
+            area -= std::abs( aSet.CHole( ii, jj ).Area() );
+    }
+
+    return area;
+}
+
+
+/**
+ * Checks that two sets cover the same area, up to the rounding of the vertices
+ */
+static void checkSameArea( const SHAPE_POLY_SET& aFirst, const SHAPE_POLY_SET& aSecond )
+{
+    SHAPE_POLY_SET firstOnly( aFirst );
+    SHAPE_POLY_SET secondOnly( aSecond );
+
+    firstOnly.BooleanSubtract( aSecond, SHAPE_POLY_SET::PM_FAST );
+    secondOnly.BooleanSubtract( aFirst, SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK_GT( area( aFirst ), 0.0 );
+    BOOST_CHECK_CLOSE( area( aFirst ), area( aSecond ), 1e-6 );
+    BOOST_CHECK_LT( area( firstOnly ), 1e3 );
+    BOOST_CHECK_LT( area( secondOnly ), 1e3 );
+}
+
+
+BOOST_AUTO_TEST_CASE( BooleanChain )
+{
+    const SHAPE_POLY_SET subject = buildSubject();
+    const SHAPE_POLY_SET holes = buildHoles();
+    const SHAPE_POLY_SET clip = KI_TEST::BuildPolyset( {
+            KI_TEST::BuildSquareChain( 14000000, { 2000000, 2000000 } ),
+    } );
+
+    SHAPE_POLY_SET expected( subject );
+    expected.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
+    expected.Inflate( 200000, 16 );
+    expected.BooleanIntersection( clip, SHAPE_POLY_SET::PM_FAST );
+    expected.Deflate( 100000, 16, SHAPE_POLY_SET::CHAMFER_ALL_CORNERS );
+    expected.BooleanAdd( holes, SHAPE_POLY_SET::PM_FAST );
+
+    POLY_SET_PIPELINE pipeline( subject );
+    SHAPE_POLY_SET    result;
+
+    pipeline.Subtract( holes, SHAPE_POLY_SET::PM_FAST )
+            .Inflate( 200000, 16 )
+            .Intersect( clip, SHAPE_POLY_SET::PM_FAST )
+            .Deflate( 100000, 16, SHAPE_POLY_SET::CHAMFER_ALL_CORNERS )
+            .Add( holes, SHAPE_POLY_SET::PM_FAST );
+
+    pipeline.GetResult( result );
+
+    BOOST_CHECK_EQUAL( result.OutlineCount(), expected.OutlineCount() );
+    BOOST_CHECK_EQUAL( result.TotalVertices(), expected.TotalVertices() );
+    checkSameArea( result, expected );
+}
+
+
+BOOST_AUTO_TEST_CASE( Fracture )
+{
+    const SHAPE_POLY_SET subject = buildSubject();
+    const SHAPE_POLY_SET holes = buildHoles();
+
+    for( SHAPE_POLY_SET::POLYGON_MODE mode : { SHAPE_POLY_SET::PM_FAST,
+                                               SHAPE_POLY_SET::PM_STRICTLY_SIMPLE } )
+    {
+        SHAPE_POLY_SET expected( subject );
+        expected.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
+        expected.Fracture( mode );
+
+        POLY_SET_PIPELINE pipeline( subject );
+        SHAPE_POLY_SET    result;
+
+        pipeline.Subtract( holes, SHAPE_POLY_SET::PM_FAST );
+        pipeline.GetFracturedResult( result, mode );
+
+        BOOST_CHECK( !result.HasHoles() );
+        BOOST_CHECK_EQUAL( result.OutlineCount(), expected.OutlineCount() );
+        checkSameArea( result, expected );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( ResultInPlace )
+{
+    SHAPE_POLY_SET       set = buildSubject();
+    const SHAPE_POLY_SET holes = buildHoles();
+    const double         initialArea = area( set );
+
+    // Without any operation the result is the subject
+    POLY_SET_PIPELINE pipeline( set );
+    pipeline.GetResult( set );
+    BOOST_CHECK_CLOSE( area( set ), initialArea, 1e-9 );
+
+    SHAPE_POLY_SET expected( set );
+    expected.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
+    expected.Inflate( 50000, 32 );
+
+    pipeline.Subtract( holes, SHAPE_POLY_SET::PM_FAST );
+    pipeline.GetResult( set );
+
+    // Restart from the changed set
+    pipeline.Reset( set );
+    pipeline.Inflate( 50000, 32 );
+    pipeline.GetResult( set );
+
+    checkSameArea( set, expected );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
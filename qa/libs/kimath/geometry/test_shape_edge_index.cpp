@@ -0,0 +1,230 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file
+ * Test suite for SHAPE_EDGE_INDEX and the indexed distance queries of the shapes.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_edge_index.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include <cmath>
+#include <random>
+
+
+BOOST_AUTO_TEST_SUITE( ShapeEdgeIndex )
+
+
+/**
+ * A closed chain approximating a circle, with a wavy radius so that it is not convex
+ */
+static SHAPE_LINE_CHAIN buildWavyCircle( const VECTOR2I& aCenter, int aRadius, int aPointCount )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    for( int i = 0; i < aPointCount; i++ )
+    {
+        double angle = 2 * M_PI * i / aPointCount;
+        double radius = aRadius * ( 1.0 + 0.1 * std::sin( 12 * angle ) );
+
+        chain.Append( aCenter.x + KiROUND( radius * std::cos( angle ) ),
+                      aCenter.y + KiROUND( radius * std::sin( angle ) ) );
+    }
+
+    chain.SetClosed( true );
+
+    return chain;
+}
+
+
+/**
+ * Two polygons (one of them with a hole) large enough for their queries to be indexed
+ */
+static SHAPE_POLY_SET buildLargePolySet()
+{
+    SHAPE_POLY_SET polyset;
+
+    polyset.AddOutline( buildWavyCircle( { 0, 0 }, 10000000, 1000 ) );
+    polyset.AddHole( buildWavyCircle( { 0, 0 }, 5000000, 500 ) );
+    polyset.AddOutline( buildWavyCircle( { 25000000, 0 }, 5000000, 500 ) );
+
+    return polyset;
+}
+
+
+/**
+ * The distances of a SHAPE_POLY_SET computed polygon by polygon, without index
+ */
+template <class T>
+static SEG::ecoord polySetDistance( const SHAPE_POLY_SET& aPolySet, const T& aItem )
+{
+    SEG::ecoord dist = VECTOR2I::ECOORD_MAX;
+
+    for( int i = 0; i < aPolySet.OutlineCount(); i++ )
+        dist = std::min( dist, aPolySet.SquaredDistanceToPolygon( aItem, i ) );
+
+    return dist;
+}
+
+
+/**
+ * Check the distances of the index against testing every segment
+ */
+BOOST_AUTO_TEST_CASE( DistanceToSegments )
+{
+    std::mt19937                       rng( 42 );
+    std::uniform_int_distribution<int> coord( -1000000, 1000000 );
+    std::uniform_int_distribution<int> delta( -20000, 20000 );
+    std::vector<SEG>                   segs;
+
+    for( int i = 0; i < 2000; i++ )
+    {
+        VECTOR2I a( coord( rng ), coord( rng ) );
+        segs.emplace_back( a, a + VECTOR2I( delta( rng ), delta( rng ) ), i );
+    }
+
+    SHAPE_EDGE_INDEX index( segs );
+
+    BOOST_CHECK_EQUAL( index.EdgeCount(), 2000 );
+
+    for( int i = 0; i < 200; i++ )
+    {
+        VECTOR2I    p( coord( rng ), coord( rng ) );
+        SEG         s( p, p + VECTOR2I( delta( rng ), delta( rng ) ) );
+        SEG::ecoord pointDist = VECTOR2I::ECOORD_MAX;
+        SEG::ecoord segDist = VECTOR2I::ECOORD_MAX;
+
+        for( const SEG& seg : segs )
+        {
+            pointDist = std::min( pointDist, seg.SquaredDistance( p ) );
+            segDist = std::min( segDist, seg.SquaredDistance( s ) );
+        }
+
+        BOOST_CHECK_EQUAL( index.SquaredDistance( p ), pointDist );
+        BOOST_CHECK_EQUAL( index.SquaredDistance( s ), segDist );
+
+        // Stopping early returns a distance which is small enough, not always the minimum
+        BOOST_CHECK_LE( index.SquaredDistance( p, pointDist + 1 ), pointDist + 1 );
+    }
+
+    SEG::ecoord noEdge = VECTOR2I::ECOORD_MAX;
+
+    BOOST_CHECK_EQUAL( SHAPE_EDGE_INDEX( {} ).SquaredDistance( VECTOR2I( 0, 0 ) ), noEdge );
+}
+
+
+/**
+ * Check the indexed distances of a polygon set, including the points inside the polygons
+ * and in their holes
+ */
+BOOST_AUTO_TEST_CASE( PolySetDistance )
+{
+    const SHAPE_POLY_SET polyset = buildLargePolySet();
+
+    for( int x = -15000000; x <= 35000000; x += 700000 )
+    {
+        for( int y = -15000000; y <= 15000000; y += 700000 )
+        {
+            VECTOR2I p( x, y );
+            SEG      s( p, p + VECTOR2I( 300000, -200000 ) );
+
+            BOOST_TEST_CONTEXT( "Point " << x << ", " << y )
+            {
+                BOOST_CHECK_EQUAL( polyset.SquaredDistance( p ), polySetDistance( polyset, p ) );
+                BOOST_CHECK_EQUAL( polyset.SquaredDistance( s ), polySetDistance( polyset, s ) );
+            }
+        }
+    }
+}
+
+
+/**
+ * Check the index is not used anymore once the polygon set is modified
+ */
+BOOST_AUTO_TEST_CASE( PolySetChanges )
+{
+    SHAPE_POLY_SET polyset = buildLargePolySet();
+    const VECTOR2I p( 0, 0 );
+
+    // Inside the hole
+    for( int i = 0; i < 20; i++ )
+        BOOST_CHECK_GT( polyset.SquaredDistance( p ), 0 );
+
+    polyset.Move( VECTOR2I( 7500000, 0 ) );
+
+    // Inside the polygon
+    BOOST_CHECK_EQUAL( polyset.SquaredDistance( p ), 0 );
+
+    for( int i = 0; i < 20; i++ )
+        BOOST_CHECK_EQUAL( polyset.SquaredDistance( p ), 0 );
+
+    // Changing a vertex through the accessors drops the index too
+    polyset.Outline( 0 ).SetPoint( 0, VECTOR2I( 20000000, 0 ) );
+
+    BOOST_CHECK_EQUAL( polyset.SquaredDistance( SEG( { 18000000, 0 }, { 19000000, 0 } ) ),
+                       polySetDistance( polyset, SEG( { 18000000, 0 }, { 19000000, 0 } ) ) );
+
+    // A copy shares the index of the original
+    SHAPE_POLY_SET copy( polyset );
+
+    BOOST_CHECK_EQUAL( copy.SquaredDistance( p ), 0 );
+}
+
+
+/**
+ * Check the collisions of long line chains
+ */
+BOOST_AUTO_TEST_CASE( LineChainCollide )
+{
+    const SHAPE_LINE_CHAIN a = buildWavyCircle( { 0, 0 }, 10000000, 1000 );
+    const SHAPE_LINE_CHAIN b = buildWavyCircle( { 21500000, 0 }, 10000000, 800 );
+
+    SEG::ecoord expected = VECTOR2I::ECOORD_MAX;
+
+    for( int i = 0; i < a.SegmentCount(); i++ )
+    {
+        for( int j = 0; j < b.SegmentCount(); j++ )
+            expected = std::min( expected, a.CSegment( i ).SquaredDistance( b.CSegment( j ) ) );
+    }
+
+    // SHAPE_LINE_CHAIN hides the SHAPE overloads
+    const SHAPE& shapeA = a;
+    const SHAPE& shapeB = b;
+    int          expectedDist = sqrt( expected );
+    int          actual = 0;
+
+    BOOST_CHECK( shapeA.Collide( &b, expectedDist + 10, &actual ) );
+    BOOST_CHECK_EQUAL( actual, expectedDist );
+
+    BOOST_CHECK( shapeB.Collide( &a, expectedDist + 10 ) );
+    BOOST_CHECK( !shapeA.Collide( &b, expectedDist - 10 ) );
+    BOOST_CHECK( !shapeB.Collide( &a, expectedDist - 10, &actual ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
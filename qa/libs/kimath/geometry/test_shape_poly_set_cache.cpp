@@ -0,0 +1,160 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_poly_set.h>
+
+#include <qa_utils/geometry/poly_set_construction.h>
+
+
+/**
+ * Tests of the change tracking of SHAPE_POLY_SET: the triangulation validity and the hashes.
+ */
+BOOST_AUTO_TEST_SUITE( SPSCache )
+
+
+static SHAPE_POLY_SET buildSquares()
+{
+    namespace KT = KI_TEST;
+
+    return KT::BuildPolyset( {
+            KT::BuildSquareChain( 10000 ),
+            KT::BuildSquareChain( 10000, { 20000, 0 } ),
+    } );
+}
+
+
+/**
+ * The MD5 digest as it was computed one value at a time
+ */
+static MD5_HASH referenceDigest( const SHAPE_POLY_SET& aSet )
+{
+    MD5_HASH hash;
+
+    hash.Hash( aSet.OutlineCount() );
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& polygon = aSet.CPolygon( ii );
+
+        hash.Hash( polygon.size() );
+
+        for( const SHAPE_LINE_CHAIN& lc : polygon )
+        {
+            hash.Hash( lc.PointCount() );
+
+            for( int jj = 0; jj < lc.PointCount(); jj++ )
+            {
+                hash.Hash( lc.CPoint( jj ).x );
+                hash.Hash( lc.CPoint( jj ).y );
+            }
+        }
+    }
+
+    hash.Finalize();
+
+    return hash;
+}
+
+
+BOOST_AUTO_TEST_CASE( TriangulationTracksChanges )
+{
+    SHAPE_POLY_SET set = buildSquares();
+
+    BOOST_CHECK( !set.IsTriangulationUpToDate() );
+
+    set.CacheTriangulation();
+    BOOST_CHECK( set.IsTriangulationUpToDate() );
+
+    // Copies keep the triangulation
+    SHAPE_POLY_SET copy( set );
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+
+    SHAPE_POLY_SET assigned;
+    assigned = set;
+    BOOST_CHECK( assigned.IsTriangulationUpToDate() );
+
+    // Moving moves the triangulation too
+    set.Move( { 100, 100 } );
+    BOOST_CHECK( set.IsTriangulationUpToDate() );
+
+    // Any other change invalidates it, including through the non-const accessors
+    set.Append( 30000, 30000, 0 );
+    BOOST_CHECK( !set.IsTriangulationUpToDate() );
+
+    set.CacheTriangulation();
+    BOOST_CHECK( set.IsTriangulationUpToDate() );
+
+    set.Outline( 1 ).Move( { 10, 0 } );
+    BOOST_CHECK( !set.IsTriangulationUpToDate() );
+
+    // The copies are not affected by the changes of the original
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+
+    // Nor by the const accessors
+    copy.COutline( 0 );
+    copy.CPolygon( 1 );
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+}
+
+
+BOOST_AUTO_TEST_CASE( ContentHash )
+{
+    SHAPE_POLY_SET set = buildSquares();
+    SHAPE_POLY_SET same = buildSquares();
+
+    BOOST_CHECK_EQUAL( set.GetContentHash(), same.GetContentHash() );
+
+    same.Move( { 1, 0 } );
+    BOOST_CHECK_NE( set.GetContentHash(), same.GetContentHash() );
+
+    same.Move( { -1, 0 } );
+    BOOST_CHECK_EQUAL( set.GetContentHash(), same.GetContentHash() );
+
+    // The same vertices split differently into contours
+    SHAPE_POLY_SET other;
+    other.NewOutline();
+
+    for( int ii = 0; ii < set.OutlineCount(); ii++ )
+    {
+        for( const VECTOR2I& p : set.COutline( ii ).CPoints() )
+            other.Append( p );
+    }
+
+    BOOST_CHECK_NE( set.GetContentHash(), other.GetContentHash() );
+}
+
+
+BOOST_AUTO_TEST_CASE( Digest )
+{
+    SHAPE_POLY_SET set = buildSquares();
+
+    BOOST_CHECK( set.GetHash() == referenceDigest( set ) );
+
+    set.Append( 30000, 30000, 0 );
+    BOOST_CHECK( set.GetHash() == referenceDigest( set ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,216 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the UUID index of BOARD: BOARD::GetItem() must find the items of the board
+ * and the children of its footprints, and only them, including after BOARD::RemoveMany().
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+
+
+BOOST_AUTO_TEST_SUITE( BoardItemIndex )
+
+
+static bool isDeleted( BOARD_ITEM* aItem )
+{
+    return aItem && aItem->Type() == NOT_USED;
+}
+
+
+BOOST_AUTO_TEST_CASE( AddRemove )
+{
+    BOARD  board;
+    TRACK* track = new TRACK( &board );
+
+    BOOST_CHECK( board.GetItem( niluuid ) == nullptr );
+    BOOST_CHECK( board.GetItem( board.m_Uuid ) == &board );
+    BOOST_CHECK( isDeleted( board.GetItem( track->m_Uuid ) ) );
+
+    board.Add( track );
+    BOOST_CHECK( board.GetItem( track->m_Uuid ) == track );
+
+    board.Remove( track );
+    BOOST_CHECK( isDeleted( board.GetItem( track->m_Uuid ) ) );
+
+    delete track;
+}
+
+
+BOOST_AUTO_TEST_CASE( FootprintChildren )
+{
+    BOARD   board;
+    MODULE* module = new MODULE( &board );
+    D_PAD*  pad = new D_PAD( module );
+
+    // Children added before and after the footprint is placed on the board
+    module->Add( pad );
+    board.Add( module );
+
+    D_PAD* otherPad = new D_PAD( module );
+    module->Add( otherPad );
+
+    BOOST_CHECK( board.GetItem( module->m_Uuid ) == module );
+    BOOST_CHECK( board.GetItem( pad->m_Uuid ) == pad );
+    BOOST_CHECK( board.GetItem( otherPad->m_Uuid ) == otherPad );
+    BOOST_CHECK( board.GetItem( module->Reference().m_Uuid ) == &module->Reference() );
+    BOOST_CHECK( board.GetItem( module->Value().m_Uuid ) == &module->Value() );
+
+    // A copy has the same UUIDs, but is not on the board
+    MODULE copy( *module );
+    BOOST_CHECK( board.GetItem( pad->m_Uuid ) == pad );
+
+    module->Remove( otherPad );
+    BOOST_CHECK( isDeleted( board.GetItem( otherPad->m_Uuid ) ) );
+    delete otherPad;
+
+    std::map<KIID, EDA_ITEM*> itemMap;
+    board.FillItemMap( itemMap );
+    BOOST_CHECK( itemMap[ pad->m_Uuid ] == pad );
+
+    board.Remove( module );
+    BOOST_CHECK( isDeleted( board.GetItem( module->m_Uuid ) ) );
+    BOOST_CHECK( isDeleted( board.GetItem( pad->m_Uuid ) ) );
+
+    delete module;
+}
+
+
+BOOST_AUTO_TEST_CASE( SwapData )
+{
+    BOARD   board;
+    MODULE* module = new MODULE( &board );
+
+    module->Add( new D_PAD( module ) );
+    board.Add( module );
+
+    // As the undo does: the image is a copy, with the same UUIDs
+    MODULE* image = static_cast<MODULE*>( module->Clone() );
+    D_PAD*  oldPad = module->Pads().front();
+
+    module->SwapData( image );
+
+    D_PAD* newPad = module->Pads().front();
+
+    BOOST_CHECK( newPad != oldPad );
+    BOOST_CHECK( board.GetItem( newPad->m_Uuid ) == newPad );
+    BOOST_CHECK( board.GetItem( module->m_Uuid ) == module );
+
+    delete image;
+}
+
+
+BOOST_AUTO_TEST_CASE( DuplicateUuids )
+{
+    BOARD  board;
+    TRACK* first = new TRACK( &board );
+    TRACK* second = new TRACK( &board );
+
+    const_cast<KIID&>( second->m_Uuid ) = first->m_Uuid;
+
+    // The first item in the board order is found, whatever the order of the additions
+    board.Add( second, ADD_MODE::APPEND );
+    board.Add( first, ADD_MODE::INSERT );
+    BOOST_CHECK( board.GetItem( first->m_Uuid ) == first );
+
+    std::map<KIID, EDA_ITEM*> itemMap;
+    board.FillItemMap( itemMap );
+    BOOST_CHECK( itemMap[ first->m_Uuid ] == first );
+
+    // Removing one of them leaves the other one indexed
+    board.Remove( first );
+    BOOST_CHECK( board.GetItem( second->m_Uuid ) == second );
+
+    board.Add( first, ADD_MODE::APPEND );
+    board.Remove( second );
+    BOOST_CHECK( board.GetItem( first->m_Uuid ) == first );
+
+    board.Remove( first );
+    BOOST_CHECK( isDeleted( board.GetItem( first->m_Uuid ) ) );
+
+    delete first;
+    delete second;
+
+    // A pasted footprint keeps the UUIDs of the children of the original one
+    MODULE* module = new MODULE( &board );
+    D_PAD*  pad = new D_PAD( module );
+
+    module->Add( pad );
+    board.Add( module, ADD_MODE::APPEND );
+
+    MODULE* pasted = new MODULE( *module );
+    D_PAD*  pastedPad = pasted->Pads().front();
+
+    board.Add( pasted, ADD_MODE::APPEND );
+    BOOST_CHECK( board.GetItem( pad->m_Uuid ) == pad );
+
+    board.Remove( module );
+    BOOST_CHECK( board.GetItem( pad->m_Uuid ) == pastedPad );
+
+    delete module;
+}
+
+
+BOOST_AUTO_TEST_CASE( RemoveMany )
+{
+    BOARD               board;
+    std::vector<TRACK*> tracks;
+
+    for( int ii = 0; ii < 10; ii++ )
+    {
+        tracks.push_back( new TRACK( &board ) );
+        board.Add( tracks.back(), ADD_MODE::APPEND );
+    }
+
+    MODULE* module = new MODULE( &board );
+    board.Add( module );
+
+    // Every other track, and the footprint
+    std::vector<BOARD_ITEM*> removed = { module };
+
+    for( size_t ii = 0; ii < tracks.size(); ii += 2 )
+        removed.push_back( tracks[ii] );
+
+    board.RemoveMany( removed );
+
+    BOOST_CHECK( board.Modules().empty() );
+    BOOST_REQUIRE_EQUAL( board.Tracks().size(), tracks.size() / 2 );
+
+    // The remaining tracks keep their order
+    for( size_t ii = 0; ii < board.Tracks().size(); ii++ )
+        BOOST_CHECK( board.Tracks()[ii] == tracks[2 * ii + 1] );
+
+    for( BOARD_ITEM* item : removed )
+    {
+        BOOST_CHECK( isDeleted( board.GetItem( item->m_Uuid ) ) );
+        delete item;
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
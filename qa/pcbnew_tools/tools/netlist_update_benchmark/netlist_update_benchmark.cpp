@@ -0,0 +1,245 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file netlist_update_benchmark.cpp
+ * Compare the lookups done by the netlist update on a synthetic board and netlist: the
+ * linear scans the update used to do, and the indexes it uses now.
+ *
+ * The update itself needs an edit frame (to load the footprints), so only the matching of
+ * the footprints, the pin nets and the netlist components are timed.
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include <qa_utils/utility_registry.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <netlist_reader/board_netlist_updater.h>
+#include <netlist_reader/pcb_netlist.h>
+
+
+using CLOCK = std::chrono::steady_clock;
+
+
+static double elapsedMs( const CLOCK::time_point& aStart )
+{
+    return std::chrono::duration<double, std::milli>( CLOCK::now() - aStart ).count();
+}
+
+
+/**
+ * Builds a board of aCount footprints with aPadCount pads each, and the netlist matching it
+ */
+static void buildDesign( BOARD& aBoard, NETLIST& aNetlist, int aCount, int aPadCount )
+{
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        const wxString reference = wxString::Format( "U%d", ii + 1 );
+        KIID_PATH      path;
+
+        path.push_back( KIID() );
+
+        COMPONENT* component = new COMPONENT( LIB_ID(), reference, wxT( "value" ), path );
+        MODULE*    footprint = new MODULE( &aBoard );
+
+        footprint->SetReference( reference );
+        footprint->SetPath( path );
+
+        for( int jj = 0; jj < aPadCount; jj++ )
+        {
+            const wxString padName = wxString::Format( "%d", jj + 1 );
+            D_PAD*         pad = new D_PAD( footprint );
+
+            pad->SetName( padName );
+            footprint->Add( pad, ADD_MODE::APPEND );
+
+            component->AddNet( padName, wxString::Format( "Net-%d-%d", ii, jj ), wxEmptyString );
+        }
+
+        aBoard.Add( footprint, ADD_MODE::APPEND );
+        aNetlist.AddComponent( component );
+    }
+}
+
+
+int netlist_update_benchmark_func( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+    long  count = 15000;
+    long  padCount = 16;
+
+    if( argc > 1 && !wxString( argv[1] ).ToLong( &count ) )
+    {
+        os << "Usage: " << argv[0] << " [COMPONENTS] [PADS]\n\n";
+        os << "  COMPONENTS is the number of components of the synthetic design (15000),\n";
+        os << "  PADS the number of pads of each footprint (16).\n";
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    if( argc > 2 )
+        wxString( argv[2] ).ToLong( &padCount );
+
+    if( count <= 0 || padCount <= 0 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    BOARD   board;
+    NETLIST netlist;
+
+    buildDesign( board, netlist, count, padCount );
+
+    os << "Netlist update benchmark" << std::endl;
+    os << "  Components:  " << count << std::endl;
+    os << "  Pads:        " << padCount << " per footprint" << std::endl;
+    os << std::endl;
+
+    auto report =
+            [&]( const char* aName, double aLinearMs, double aIndexedMs, bool aSame )
+            {
+                os << wxString::Format( "%-20s linear %10.2f ms, indexed %8.2f ms, speedup %.1fx%s",
+                                        aName, aLinearMs, aIndexedMs,
+                                        aIndexedMs > 0.0 ? aLinearMs / aIndexedMs : 0.0,
+                                        aSame ? "" : "  MISMATCH" )
+                   << std::endl;
+            };
+
+    // Footprints of the components, by reference and by path
+    for( bool byPath : { false, true } )
+    {
+        size_t linearMatches = 0;
+        size_t indexedMatches = 0;
+
+        CLOCK::time_point start = CLOCK::now();
+
+        for( unsigned ii = 0; ii < netlist.GetCount(); ii++ )
+        {
+            const COMPONENT* component = netlist.GetComponent( ii );
+
+            for( MODULE* footprint : board.Modules() )
+            {
+                if( byPath ? footprint->GetPath() == component->GetPath()
+                           : footprint->GetReference().CmpNoCase( component->GetReference() ) == 0 )
+                {
+                    linearMatches++;
+                }
+            }
+        }
+
+        double linearMs = elapsedMs( start );
+
+        start = CLOCK::now();
+
+        NETLIST_FOOTPRINT_INDEX index( board.Modules(), byPath );
+
+        for( unsigned ii = 0; ii < netlist.GetCount(); ii++ )
+            indexedMatches += index.Find( *netlist.GetComponent( ii ) ).size();
+
+        report( byPath ? "footprints by path" : "footprints by ref", linearMs, elapsedMs( start ),
+                linearMatches == indexedMatches );
+    }
+
+    // Nets of the pads of each footprint
+    {
+        size_t linearNets = 0;
+        size_t indexedNets = 0;
+
+        CLOCK::time_point start = CLOCK::now();
+
+        for( MODULE* footprint : board.Modules() )
+        {
+            const COMPONENT* component = netlist.GetComponentByReference( footprint->GetReference() );
+
+            for( D_PAD* pad : footprint->Pads() )
+            {
+                for( unsigned jj = 0; jj < component->GetNetCount(); jj++ )
+                {
+                    if( component->GetNet( jj ).GetPinName() == pad->GetName() )
+                    {
+                        linearNets++;
+                        break;
+                    }
+                }
+            }
+        }
+
+        double linearMs = elapsedMs( start );
+
+        start = CLOCK::now();
+
+        for( MODULE* footprint : board.Modules() )
+        {
+            const COMPONENT* component = netlist.GetComponentByReference( footprint->GetReference() );
+
+            for( D_PAD* pad : footprint->Pads() )
+            {
+                if( component->GetNet( pad->GetName() ).IsValid() )
+                    indexedNets++;
+            }
+        }
+
+        report( "pad nets", linearMs, elapsedMs( start ), linearNets == indexedNets );
+    }
+
+    // Components of the footprints, as searched for the unused footprints
+    {
+        size_t linearFound = 0;
+        size_t indexedFound = 0;
+
+        CLOCK::time_point start = CLOCK::now();
+
+        for( MODULE* footprint : board.Modules() )
+        {
+            for( unsigned ii = 0; ii < netlist.GetCount(); ii++ )
+            {
+                if( netlist.GetComponent( ii )->GetReference() == footprint->GetReference() )
+                {
+                    linearFound++;
+                    break;
+                }
+            }
+        }
+
+        double linearMs = elapsedMs( start );
+
+        start = CLOCK::now();
+
+        for( MODULE* footprint : board.Modules() )
+        {
+            if( netlist.GetComponentByReference( footprint->GetReference() ) )
+                indexedFound++;
+        }
+
+        report( "components by ref", linearMs, elapsedMs( start ), linearFound == indexedFound );
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "netlist_update_benchmark",
+        "Benchmark the footprint and net lookups of the netlist update on a synthetic design",
+        netlist_update_benchmark_func,
+} );
@@ -35,10 +35,10 @@
 #include <class_zone.h>
 #include <profile.h>
 
-#include <atomic>
-#include <thread>
+#include <iostream>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 
 void unfracture( SHAPE_POLY_SET::POLYGON* aPoly, SHAPE_POLY_SET::POLYGON* aResult )
@@ -217,58 +217,47 @@ int polygon_triangulation_main( int argc, char *argv[] )
         return POLY_TRI_RET_CODES::LOAD_FAILED;
 
 
-    PROF_COUNTER cnt( "allBoard" );
+    // Copies of the filled areas without their cached triangulation
+    std::vector<SHAPE_POLY_SET> polys;
 
+    for( int areaId = 0; areaId < brd->GetAreaCount(); areaId++ )
+    {
+        ZONE_CONTAINER* zone = brd->GetArea( areaId );
 
-    std::atomic<size_t> zonesToTriangulate( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+        {
+            polys.emplace_back();
+            polys.back().Append( zone->GetFilledPolysList( layer ) );
+        }
+    }
 
-    size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [&brd, &zonesToTriangulate, &threadsFinished]() {
-            for( size_t areaId = zonesToTriangulate.fetch_add( 1 );
-                        areaId < static_cast<size_t>( brd->GetAreaCount() );
-                        areaId = zonesToTriangulate.fetch_add( 1 ) )
-            {
-                auto zone = brd->GetArea( areaId );
-
-                // NOTE: this could be refactored to do multiple layers from the same zone in
-                // parallel, but since the test case doesn't have any of these, I'm not bothering
-                // to do that right now.
-                for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
-                {
-                    SHAPE_POLY_SET poly = zone->GetFilledPolysList( layer );
-
-                    poly.CacheTriangulation();
-
-                    (void) poly;
-#if 0
-                PROF_COUNTER unfrac("unfrac");
-                poly.Unfracture( SHAPE_POLY_SET::PM_FAST );
-                unfrac.Show();
-
-                PROF_COUNTER triangulate("triangulate");
-
-                for(int i =0; i< poly.OutlineCount(); i++)
-                {
-                    poly.triangulatePoly( &poly.Polygon(i) );
-                }
-                triangulate.Show();
-#endif
-                }
-            }
+    // Triangulate them once with the cells of each area done one after the other, then with
+    // the cells done in parallel
+    std::vector<SHAPE_POLY_SET> sequentialPolys( polys );
+    PROF_COUNTER                sequential( "allBoard, sequential cells" );
 
-            threadsFinished++;
-        } );
+    for( SHAPE_POLY_SET& poly : sequentialPolys )
+        poly.CacheTriangulation( true, false );
 
-        t.detach();
-    }
+    sequential.Show();
+
+    std::vector<SHAPE_POLY_SET> parallelPolys( polys );
+    PROF_COUNTER                parallel( "allBoard, parallel cells" );
+
+    for( SHAPE_POLY_SET& poly : parallelPolys )
+        poly.CacheTriangulation( true, true );
+
+    parallel.Show();
 
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    size_t triangles = 0;
+
+    for( const SHAPE_POLY_SET& poly : parallelPolys )
+    {
+        for( unsigned ii = 0; ii < poly.TriangulatedPolyCount(); ii++ )
+            triangles += poly.TriangulatedPolygon( ii )->GetTriangleCount();
+    }
 
-    cnt.Show();
+    std::cout << polys.size() << " filled areas, " << triangles << " triangles" << std::endl;
 
     return KI_TEST::RET_CODES::OK;
 }
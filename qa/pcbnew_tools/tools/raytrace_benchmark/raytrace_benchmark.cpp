@@ -0,0 +1,149 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file raytrace_benchmark.cpp
+ * Compare the time to trace the first hits of the 3D view of a board with
+ * each instruction set of the ray packet kernels.
+ */
+
+#include <wx/image.h>
+
+#include <chrono>
+#include <iostream>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <3d_canvas/board_adapter.h>
+#include <3d_rendering/ctrack_ball.h>
+#include <3d_rendering/3d_render_raytracing/c3d_render_raytracing.h>
+#include <3d_rendering/3d_render_raytracing/raypacket_kernels.h>
+#include <class_board.h>
+#include <settings/color_settings.h>
+
+
+using CLOCK = std::chrono::steady_clock;
+
+
+int raytrace_benchmark_func( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 3 )
+    {
+        os << "Usage: " << argv[0] << " <BOARD> <IMAGE> [WIDTH HEIGHT] [REPS]\n\n";
+        os << "  BOARD is the board file to render, IMAGE the PNG file written with\n";
+        os << "  the first hits of the rays, shaded by their normal.\n";
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const std::string filename = argv[1];
+    const wxString    imageFile = wxString::FromUTF8( argv[2] );
+    long              width = 1024;
+    long              height = 768;
+    long              reps = 5;
+
+    if( argc > 4 )
+    {
+        wxString( argv[3] ).ToLong( &width );
+        wxString( argv[4] ).ToLong( &height );
+    }
+
+    if( argc > 5 )
+        wxString( argv[5] ).ToLong( &reps );
+
+    if( width <= 0 || height <= 0 || reps <= 0 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    auto brd = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !brd )
+        return KI_TEST::RET_CODES::TOOL_SPECIFIC;
+
+    COLOR_SETTINGS colors;
+    colors.ResetToDefaults();
+
+    BOARD_ADAPTER adapter;
+    adapter.SetBoard( brd.get() );
+    adapter.SetColorSettings( &colors );
+
+    CTRACK_BALL           camera( 2.0f * RANGE_SCALE_3D );
+    C3D_RENDER_RAYTRACING renderer( adapter, camera );
+    const wxSize          size( width, height );
+    wxImage               image;
+
+    // The first render builds the scene and is not part of the timings
+    renderer.RenderFirstHits( size, image );
+
+    os << "Raytracing first hits benchmark" << std::endl;
+    os << "  Board:       " << filename << std::endl;
+    os << "  Image size:  " << width << "x" << height << std::endl;
+    os << "  Repetitions: " << (int) reps << std::endl;
+    os << std::endl;
+
+    const RAYPACKET_ISA bestISA = RAYPACKET_GetBestKernelISA();
+    double              scalarMs = 0.0;
+
+    for( int isa = (int) RAYPACKET_ISA::SCALAR; isa <= (int) bestISA; ++isa )
+    {
+        RAYPACKET_SetKernelISA( (RAYPACKET_ISA) isa );
+
+        const auto start = CLOCK::now();
+
+        for( long i = 0; i < reps; ++i )
+            renderer.RenderFirstHits( size, image );
+
+        const double ms =
+                std::chrono::duration<double, std::milli>( CLOCK::now() - start ).count() / reps;
+
+        if( isa == (int) RAYPACKET_ISA::SCALAR )
+            scalarMs = ms;
+
+        os << wxString::Format( "%-8s %8.2f ms/frame, speedup %.2fx",
+                                RAYPACKET_GetKernelISAName( (RAYPACKET_ISA) isa ), ms,
+                                ms > 0.0 ? scalarMs / ms : 0.0 )
+           << std::endl;
+    }
+
+    RAYPACKET_SetKernelISA( bestISA );
+
+    if( !wxImage::FindHandler( wxBITMAP_TYPE_PNG ) )
+        wxImage::AddHandler( new wxPNGHandler );
+
+    if( !image.SaveFile( imageFile, wxBITMAP_TYPE_PNG ) )
+    {
+        os << "Cannot write " << imageFile << std::endl;
+        return KI_TEST::RET_CODES::TOOL_SPECIFIC;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "raytrace_benchmark",
+        "Benchmark the ray packet kernels of the 3D raytracer",
+        raytrace_benchmark_func,
+} );
@@ -0,0 +1,149 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file raytrace_render.cpp
+ * Render a board with the 3D raytracer to a PNG file, without display.
+ */
+
+#include <wx/image.h>
+
+#include <chrono>
+#include <iostream>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <3d_canvas/board_adapter.h>
+#include <3d_rendering/ctrack_ball.h>
+#include <3d_rendering/3d_render_raytracing/c3d_render_raytracing.h>
+#include <class_board.h>
+#include <settings/color_settings.h>
+#include <widgets/progress_reporter.h>
+
+
+/**
+ * Print the progress of the render on the console
+ */
+class CONSOLE_PROGRESS_REPORTER : public PROGRESS_REPORTER
+{
+public:
+    CONSOLE_PROGRESS_REPORTER() :
+            PROGRESS_REPORTER( 1 )
+    {
+    }
+
+private:
+    bool updateUI() override
+    {
+        std::cout << wxString::Format( "\r%s %3.0f %%", m_rptMessage,
+                                       currentProgress() / 10.0 )
+                  << std::flush;
+        return true;
+    }
+};
+
+
+int raytrace_render_func( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 3 )
+    {
+        os << "Usage: " << argv[0] << " <BOARD> <IMAGE> [WIDTH HEIGHT] [ROT_X ROT_Y ROT_Z]\n\n";
+        os << "  BOARD is the board file to render, IMAGE the PNG file to write.\n";
+        os << "  ROT_X, ROT_Y and ROT_Z rotate the camera from the top view, in degrees.\n";
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const std::string filename = argv[1];
+    const wxString    imageFile = wxString::FromUTF8( argv[2] );
+    long              width = 1920;
+    long              height = 1080;
+    double            rotation[3] = { 0.0, 0.0, 0.0 };
+
+    if( argc > 4 )
+    {
+        wxString( argv[3] ).ToLong( &width );
+        wxString( argv[4] ).ToLong( &height );
+    }
+
+    for( int i = 0; i < 3 && argc > 5 + i; ++i )
+        wxString( argv[5 + i] ).ToDouble( &rotation[i] );
+
+    if( width <= 0 || height <= 0 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    auto brd = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !brd )
+        return KI_TEST::RET_CODES::TOOL_SPECIFIC;
+
+    COLOR_SETTINGS colors;
+    colors.ResetToDefaults();
+
+    BOARD_ADAPTER adapter;
+    adapter.SetBoard( brd.get() );
+    adapter.SetColorSettings( &colors );
+    adapter.SetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING, true );
+
+    CTRACK_BALL camera( 2.0f * RANGE_SCALE_3D );
+
+    camera.RotateX( glm::radians( rotation[0] ) );
+    camera.RotateY( glm::radians( rotation[1] ) );
+    camera.RotateZ( glm::radians( rotation[2] ) );
+
+    C3D_RENDER_RAYTRACING     renderer( adapter, camera );
+    CONSOLE_PROGRESS_REPORTER reporter;
+    wxImage                   image;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    if( !renderer.RenderToImage( wxSize( width, height ), image, &reporter ) )
+        return KI_TEST::RET_CODES::TOOL_SPECIFIC;
+
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now()
+                                                          - start ).count();
+
+    os << wxString::Format( "\nRendered %ldx%ld in %.2f s", width, height, seconds )
+       << std::endl;
+
+    if( !wxImage::FindHandler( wxBITMAP_TYPE_PNG ) )
+        wxImage::AddHandler( new wxPNGHandler );
+
+    if( !image.SaveFile( imageFile, wxBITMAP_TYPE_PNG ) )
+    {
+        os << "Cannot write " << imageFile << std::endl;
+        return KI_TEST::RET_CODES::TOOL_SPECIFIC;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "raytrace_render",
+        "Render a board with the 3D raytracer to a PNG file",
+        raytrace_render_func,
+} );
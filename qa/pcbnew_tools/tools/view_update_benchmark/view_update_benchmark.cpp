@@ -0,0 +1,363 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file view_update_benchmark.cpp
+ * Compare the time to recache all the items of a board in a VIEW, with the
+ * item geometry drawn serially and from several threads.
+ *
+ * The view draws on a GAL without window, which turns the shapes into triangles
+ * on the CPU as the OpenGL GAL does.  This work stays on the main thread in both
+ * modes: with threads, it happens when the display lists are replayed, which is
+ * timed apart from their recording.  The upload of the geometry to the GPU is
+ * not timed.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <gal/gal_display_options.h>
+#include <gal/graphics_abstraction_layer.h>
+#include <pcb_painter.h>
+#include <pcb_view.h>
+#include <settings/color_settings.h>
+
+
+using CLOCK = std::chrono::steady_clock;
+
+
+/**
+ * A GAL producing the triangles of the shapes it draws, as the OpenGL GAL does before
+ * uploading them: segments and circles are quads and triangles drawn by the shaders, the
+ * polygons which are not triangulated yet are tessellated, the shape instances only add
+ * their position.
+ *
+ * It also records when the first group of an update is begun: with threads, the items are
+ * recorded before, and replayed after.
+ */
+class TESSELLATING_GAL : public KIGFX::GAL
+{
+public:
+    TESSELLATING_GAL( KIGFX::GAL_DISPLAY_OPTIONS& aOptions ) :
+            GAL( aOptions )
+    {
+        ResetFirstGroup();
+    }
+
+    bool IsOpenGlEngine() override { return true; }
+
+    /// Forgets the time of the first group, before an update
+    void ResetFirstGroup() { m_firstGroupTime = CLOCK::time_point::max(); }
+
+    /// @return the time the first group was begun since ResetFirstGroup(), or the maximum
+    /// time point if none was
+    CLOCK::time_point GetFirstGroupTime() const { return m_firstGroupTime; }
+
+    int BeginGroup() override
+    {
+        if( m_firstGroupTime == CLOCK::time_point::max() )
+            m_firstGroupTime = CLOCK::now();
+
+        // The vertices of the previous groups would have been uploaded
+        m_vertices.clear();
+        return 0;
+    }
+
+    void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override
+    {
+        addQuad( aStartPoint, aEndPoint );
+    }
+
+    void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                      double aWidth ) override
+    {
+        addQuad( aStartPoint, aEndPoint );
+    }
+
+    void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override
+    {
+        for( size_t ii = 1; ii < aPointList.size(); ++ii )
+            addQuad( aPointList[ii - 1], aPointList[ii] );
+    }
+
+    void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override
+    {
+        for( int ii = 1; ii < aListSize; ++ii )
+            addQuad( aPointList[ii - 1], aPointList[ii] );
+    }
+
+    void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override
+    {
+        for( int ii = 0; ii < aLineChain.SegmentCount(); ++ii )
+            addQuad( aLineChain.CSegment( ii ).A, aLineChain.CSegment( ii ).B );
+    }
+
+    void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override
+    {
+        for( int ii = 0; ii < 3; ++ii )
+            m_vertices.push_back( aCenterPoint );
+    }
+
+    void DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                  double aEndAngle ) override
+    {
+        addArc( aCenterPoint, aRadius, aStartAngle, aEndAngle );
+    }
+
+    void DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                         double aEndAngle, double aWidth ) override
+    {
+        addArc( aCenterPoint, aRadius, aStartAngle, aEndAngle );
+    }
+
+    void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override
+    {
+        addQuad( aStartPoint, aEndPoint );
+    }
+
+    void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override
+    {
+        SHAPE_LINE_CHAIN outline;
+
+        for( const VECTOR2D& point : aPointList )
+            outline.Append( VECTOR2I( point ) );
+
+        DrawPolygon( outline );
+    }
+
+    void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override
+    {
+        SHAPE_LINE_CHAIN outline;
+
+        for( int ii = 0; ii < aListSize; ++ii )
+            outline.Append( VECTOR2I( aPointList[ii] ) );
+
+        DrawPolygon( outline );
+    }
+
+    void DrawPolygon( const SHAPE_POLY_SET& aPolySet ) override
+    {
+        if( aPolySet.IsTriangulationUpToDate() )
+        {
+            addTriangles( aPolySet );
+            return;
+        }
+
+        for( int ii = 0; ii < aPolySet.OutlineCount(); ++ii )
+            DrawPolygon( aPolySet.COutline( ii ) );
+    }
+
+    void DrawPolygon( const SHAPE_LINE_CHAIN& aPolygon ) override
+    {
+        if( aPolygon.PointCount() < 3 )
+            return;
+
+        // The OpenGL GAL uses the GLU tessellator there
+        SHAPE_POLY_SET polySet;
+        polySet.AddOutline( aPolygon );
+        polySet.Outline( 0 ).SetClosed( true );
+        polySet.CacheTriangulation( false, false );
+
+        addTriangles( polySet );
+    }
+
+    void DrawShapeInstance( int aTemplate, const VECTOR2D& aPosition, double aRotation,
+                            const KIGFX::COLOR4D& aColor ) override
+    {
+        // The instancer tessellates the template once, and keeps one position per instance
+        m_vertices.push_back( aPosition );
+    }
+
+private:
+    void addQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+    {
+        for( int ii = 0; ii < 3; ++ii )
+        {
+            m_vertices.push_back( aStartPoint );
+            m_vertices.push_back( aEndPoint );
+        }
+    }
+
+    void addArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                 double aEndAngle )
+    {
+        const double step = 2.0 * M_PI / 64;
+        int          segments = std::max( 1, KiROUND( std::abs( aEndAngle - aStartAngle ) / step ) );
+        VECTOR2D     last = aCenterPoint + VECTOR2D( aRadius, 0.0 ).Rotate( aStartAngle );
+
+        for( int ii = 1; ii <= segments; ++ii )
+        {
+            double   angle = aStartAngle + ( aEndAngle - aStartAngle ) * ii / segments;
+            VECTOR2D point = aCenterPoint + VECTOR2D( aRadius, 0.0 ).Rotate( angle );
+
+            addQuad( last, point );
+            last = point;
+        }
+    }
+
+    void addTriangles( const SHAPE_POLY_SET& aPolySet )
+    {
+        for( unsigned int jj = 0; jj < aPolySet.TriangulatedPolyCount(); ++jj )
+        {
+            const SHAPE_POLY_SET::TRIANGULATED_POLYGON* triPoly =
+                    aPolySet.TriangulatedPolygon( jj );
+
+            for( size_t ii = 0; ii < triPoly->GetTriangleCount(); ii++ )
+            {
+                VECTOR2I a, b, c;
+                triPoly->GetTriangle( ii, a, b, c );
+                m_vertices.emplace_back( a );
+                m_vertices.emplace_back( b );
+                m_vertices.emplace_back( c );
+            }
+        }
+    }
+
+    std::vector<VECTOR2D> m_vertices;
+    CLOCK::time_point     m_firstGroupTime;
+};
+
+
+int view_update_benchmark_func( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 2 )
+    {
+        os << "Usage: " << argv[0] << " <BOARD> [REPS]\n\n";
+        os << "  BOARD is the board file whose items are recached REPS times.\n";
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const std::string filename = argv[1];
+    long              reps = 5;
+
+    if( argc > 2 )
+        wxString( argv[2] ).ToLong( &reps );
+
+    if( reps <= 0 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    auto brd = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !brd )
+        return KI_TEST::RET_CODES::TOOL_SPECIFIC;
+
+    COLOR_SETTINGS colors;
+    colors.ResetToDefaults();
+
+    KIGFX::GAL_DISPLAY_OPTIONS galOptions;
+    TESSELLATING_GAL           gal( galOptions );
+    KIGFX::PCB_PAINTER         painter( &gal );
+    KIGFX::PCB_VIEW            view;
+
+    painter.GetSettings()->LoadColors( &colors );
+    view.SetGAL( &gal );
+    view.SetPainter( &painter );
+
+    for( BOARD_ITEM* drawing : brd->Drawings() )
+        view.Add( drawing );
+
+    for( TRACK* track : brd->Tracks() )
+        view.Add( track );
+
+    for( MODULE* module : brd->Modules() )
+        view.Add( module );
+
+    for( ZONE_CONTAINER* zone : brd->Zones() )
+    {
+        zone->CacheTriangulation();
+        view.Add( zone );
+    }
+
+    // The first update caches the items and is not part of the timings
+    view.UpdateItems();
+
+    os << "View update benchmark" << std::endl;
+    os << "  Board:       " << filename << std::endl;
+    os << "  Repetitions: " << (int) reps << std::endl;
+    os << std::endl;
+
+    double serialMs = 0.0;
+
+    for( bool parallel : { false, true } )
+    {
+        view.SetParallelUpdates( parallel );
+
+        double ms = 0.0;
+        double recordMs = 0.0;
+
+        for( long i = 0; i < reps; ++i )
+        {
+            view.RecacheAllItems();
+            gal.ResetFirstGroup();
+
+            const auto start = CLOCK::now();
+            view.UpdateItems();
+            const auto end = CLOCK::now();
+
+            // The items are invalidated and recorded before the first group is begun
+            ms += std::chrono::duration<double, std::milli>( end - start ).count();
+            recordMs += std::chrono::duration<double, std::milli>(
+                                std::min( gal.GetFirstGroupTime(), end ) - start ).count();
+        }
+
+        ms /= reps;
+        recordMs /= reps;
+
+        if( !parallel )
+        {
+            serialMs = ms;
+
+            os << wxString::Format( "%-8s %8.2f ms/update", "serial", ms ) << std::endl;
+        }
+        else
+        {
+            // The replay, tessellation included, runs on the main thread
+            os << wxString::Format( "%-8s %8.2f ms/update (record %.2f ms, replay %.2f ms), "
+                                    "speedup %.2fx",
+                                    "parallel", ms, recordMs, ms - recordMs,
+                                    ms > 0.0 ? serialMs / ms : 0.0 )
+               << std::endl;
+        }
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "view_update_benchmark",
+        "Benchmark the serial and parallel recaching of the items of a board view",
+        view_update_benchmark_func,
+} );